@@ -822,7 +822,7 @@ bool square_is_monster_walkable(struct chunk *c, struct loc grid)
  */
 bool square_ispassable(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_passable(square(c, grid)->feat);
+	return square_layer_has(c, LAYER_PASSABLE, grid.x, grid.y);
 }
 
 /**
@@ -830,7 +830,7 @@ bool square_ispassable(struct chunk *c, struct loc grid) {
  */
 bool square_isprojectable(struct chunk *c, struct loc grid) {
 	if (!square_in_bounds(c, grid)) return false;
-	return feat_is_projectable(square(c, grid)->feat);
+	return square_layer_has(c, LAYER_PROJECT, grid.x, grid.y);
 }
 
 /**
@@ -838,7 +838,7 @@ bool square_isprojectable(struct chunk *c, struct loc grid) {
  */
 bool square_allowslos(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return feat_is_los(square(c, grid)->feat);
+	return square_layer_has(c, LAYER_LOS, grid.x, grid.y);
 }
 
 /**
@@ -1077,7 +1077,7 @@ bool square_allows_summon(struct chunk *c, struct loc grid)
  */
 bool square_seen_by_keen_senses(struct chunk *c, struct loc grid)
 {
-	if (player_active_ability(player, "Keen Senses") &&
+	if (player_active_ability(player, PA_KEEN_SENSES) &&
 		square_isview(c, grid) && (square_light(c, grid) == 0)) {
 		int d;
 		for (d = 0; d < 8; d++) {
@@ -1396,6 +1396,8 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 
 	/* Make the change */
 	c->squares[grid.y][grid.x].feat = feat;
+	square_set_layers(c, grid);
+	c->terrain_stamp++;
 
 	/* Light bright terrain */
 	if (feat_is_bright(feat)) {
@@ -1425,6 +1427,32 @@ static void square_set_known_feat(struct chunk *c, struct loc grid, int feat)
 {
 	if (c != cave) return;
 	player->cave->squares[grid.y][grid.x].feat = feat;
+	square_set_layers(player->cave, grid);
+}
+
+/**
+ * Bring the packed layers of a square into line with its terrain; anything
+ * writing terrain other than through square_set_feat() must call this.
+ */
+void square_set_layers(struct chunk *c, struct loc grid)
+{
+	int feat = square(c, grid)->feat;
+	size_t word = (size_t) grid.y * c->layer_stride + (grid.x >> 5);
+	size_t layer_size = (size_t) c->height * c->layer_stride;
+	uint32_t bit = 1U << (grid.x & 31);
+	bool has[LAYER_MAX];
+	int layer;
+
+	has[LAYER_PROJECT] = feat_is_projectable(feat);
+	has[LAYER_PASSABLE] = feat_is_passable(feat);
+	has[LAYER_LOS] = feat_is_los(feat);
+	for (layer = 0; layer < LAYER_MAX; layer++) {
+		if (has[layer]) {
+			c->layers[layer * layer_size + word] |= bit;
+		} else {
+			c->layers[layer * layer_size + word] &= ~bit;
+		}
+	}
 }
 
 /**
@@ -1449,6 +1477,7 @@ void square_set_obj(struct chunk *c, struct loc grid, struct object *obj)
 void square_set_trap(struct chunk *c, struct loc grid, struct trap *trap)
 {
 	c->squares[grid.y][grid.x].trap = trap;
+	c->terrain_stamp++;
 }
 
 void square_add_trap(struct chunk *c, struct loc grid)
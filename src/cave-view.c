@@ -50,6 +50,37 @@ int distance(struct loc grid1, struct loc grid2)
 }
 
 
+/**
+ * Whether grid (x, y) is in the chunk and can be seen through, read straight
+ * from the packed projectable layer
+ */
+#define los_clear(c, x, y) \
+	(((x) >= 0) && ((x) < (c)->width) && ((y) >= 0) && ((y) < (c)->height) \
+	 && square_layer_has(c, LAYER_PROJECT, x, y))
+
+/**
+ * Whether every grid of row y from x1 to x2 can be seen through, testing a
+ * word of the projectable layer at a time
+ */
+static bool los_row_clear(struct chunk *c, int y, int x1, int x2)
+{
+	const uint32_t *row;
+	int word;
+
+	if (x1 > x2) return true;
+	if ((y < 0) || (y >= c->height) || (x1 < 0) || (x2 >= c->width)) {
+		return false;
+	}
+	row = &c->layers[(LAYER_PROJECT * c->height + y) * c->layer_stride];
+	for (word = x1 >> 5; word <= x2 >> 5; word++) {
+		uint32_t mask = 0xFFFFFFFFU;
+		if (word == x1 >> 5) mask &= 0xFFFFFFFFU << (x1 & 31);
+		if (word == x2 >> 5) mask &= 0xFFFFFFFFU >> (31 - (x2 & 31));
+		if ((row[word] & mask) != mask) return false;
+	}
+	return true;
+}
+
 /**
  * A simple, fast, integer-based line-of-sight algorithm.  By Joseph Hall,
  * 4116 Brewster Drive, Raleigh NC 27606.  Email to jnh@ecemwl.ncsu.edu.
@@ -125,29 +156,23 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 		/* South -- check for walls */
 		if (dy > 0) {
 			for (ty = grid1.y + 1; ty < grid2.y; ty++)
-				if (!square_isprojectable(c, loc(grid1.x, ty))) return (false);
+				if (!los_clear(c, grid1.x, ty)) return (false);
 		} else { /* North -- check for walls */
 			for (ty = grid1.y - 1; ty > grid2.y; ty--)
-				if (!square_isprojectable(c, loc(grid1.x, ty))) return (false);
+				if (!los_clear(c, grid1.x, ty)) return (false);
 		}
 
 		/* Assume los */
 		return (true);
 	}
 
-	/* Directly East/West */
+	/* Directly East/West -- check for walls a word at a time */
 	if (!dy) {
-		/* East -- check for walls */
 		if (dx > 0) {
-			for (tx = grid1.x + 1; tx < grid2.x; tx++)
-				if (!square_isprojectable(c, loc(tx, grid1.y))) return (false);
-		} else { /* West -- check for walls */
-			for (tx = grid1.x - 1; tx > grid2.x; tx--)
-				if (!square_isprojectable(c, loc(tx, grid1.y))) return (false);
+			return los_row_clear(c, grid1.y, grid1.x + 1, grid2.x - 1);
+		} else {
+			return los_row_clear(c, grid1.y, grid2.x + 1, grid1.x - 1);
 		}
-
-		/* Assume los */
-		return (true);
 	}
 
 
@@ -157,10 +182,10 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 
 	/* Vertical and horizontal "knights" */
 	if ((ax == 1) && (ay == 2) &&
-		square_isprojectable(c, loc(grid1.x, grid1.y + sy))) {
+		los_clear(c, grid1.x, grid1.y + sy)) {
 		return (true);
 	} else if ((ay == 1) && (ax == 2) &&
-			   square_isprojectable(c, loc(grid1.x + sx, grid1.y))) {
+			   los_clear(c, grid1.x + sx, grid1.y)) {
 		return (true);
 	}
 
@@ -190,7 +215,7 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 		/* Note (below) the case (qy == f2), where */
 		/* the LOS exactly meets the corner of a tile. */
 		while (grid2.x - tx) {
-			if (!square_isprojectable(c, loc(tx, ty)))
+			if (!los_clear(c, tx, ty))
 				return (false);
 
 			qy += m;
@@ -199,7 +224,7 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 				tx += sx;
 			} else if (qy > f2) {
 				ty += sy;
-				if (!square_isprojectable(c, loc(tx, ty)))
+				if (!los_clear(c, tx, ty))
 					return (false);
 				qy -= f1;
 				tx += sx;
@@ -226,7 +251,7 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 		/* Note (below) the case (qx == f2), where */
 		/* the LOS exactly meets the corner of a tile. */
 		while (grid2.y - ty) {
-			if (!square_isprojectable(c, loc(tx, ty)))
+			if (!los_clear(c, tx, ty))
 				return (false);
 
 			qx += m;
@@ -235,7 +260,7 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 				ty += sy;
 			} else if (qx > f2) {
 				tx += sx;
-				if (!square_isprojectable(c, loc(tx, ty)))
+				if (!los_clear(c, tx, ty))
 					return (false);
 				qx -= f1;
 				ty += sy;
@@ -434,14 +459,15 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
 
 
 /**
- * Mark the currently seen grids, then wipe in preparation for recalculating
+ * Mark the currently seen grids, then wipe in preparation for recalculating;
+ * only grids between min and max can be in the view
  */
-static void mark_wasseen(struct chunk *c)
+static void mark_wasseen(struct chunk *c, struct loc min, struct loc max)
 {
 	int x, y;
 	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
+	for (y = min.y; y <= max.y; y++) {
+		for (x = min.x; x <= max.x; x++) {
 			struct loc grid = loc(x, y);
 			if (square_isseen(c, grid))
 				sqinfo_on(square(c, grid)->info, SQUARE_WASSEEN);
@@ -623,7 +649,7 @@ static void add_light(struct chunk *c, struct player *p, struct loc sgrid,
 	int bonus_light = 0;
 
 	/* Handle Inner Light */
-	if (loc_eq(sgrid, p->grid) && player_active_ability(p, "Inner Light")) {
+	if (loc_eq(sgrid, p->grid) && player_active_ability(p, PA_INNER_LIGHT)) {
 		bonus_light = 1;
 	}
 
@@ -707,13 +733,10 @@ static void calc_lighting(struct chunk *c, struct player *p)
 	add_light(c, p, p->grid, radius, light);
 
 	/* Scan monster list and add monster light or darkness */
-	for (k = 1; k < mon_max; k++) {
+	for (k = live_monster_after(0); k; k = live_monster_after(k)) {
 		/* Check the k'th monster */
 		struct monster *mon = monster(k);
 
-		/* Skip dead or stored monsters */
-		if (!mon->race || monster_is_stored(mon)) continue;
-
 		/* Get light info for this monster */
 		light = mon->race->light;
 		radius = ABS(light);
@@ -818,10 +841,205 @@ static void become_viewable(struct chunk *c, struct loc grid, struct player *p,
 	}
 }
 
+/**
+ * A shadow cast within an octant by a grid which blocks line of sight, as the
+ * open range of slopes (minor offset over major offset) that it covers
+ */
+struct view_shadow {
+	int low_n, low_d;
+	int high_n, high_d;
+};
+
+/**
+ * Shadows cast so far in an octant, sorted and not overlapping, with room
+ * to merge in the next column
+ */
+struct view_shadows {
+	struct view_shadow *list;
+	struct view_shadow *merged;
+	int num;
+	int max;
+};
+
+/**
+ * Whether slope n1 / d1 is less than slope n2 / d2, for positive d1 and d2
+ */
+static bool slope_less(int n1, int d1, int n2, int d2)
+{
+	return n1 * d2 < n2 * d1;
+}
+
+/**
+ * Add the shadows cast by one column of an octant, sorted by slope, to those
+ * cast before, merging any which overlap
+ */
+static void add_shadows(struct view_shadows *shadows, int first)
+{
+	struct view_shadow *swap;
+	int i = 0, j = first, num = 0;
+
+	while ((i < first) || (j < shadows->num)) {
+		struct view_shadow *next;
+
+		if ((j == shadows->num) || ((i < first) &&
+				slope_less(shadows->list[i].low_n, shadows->list[i].low_d,
+						   shadows->list[j].low_n, shadows->list[j].low_d))) {
+			next = &shadows->list[i++];
+		} else {
+			next = &shadows->list[j++];
+		}
+
+		/* Shadows only merge if they overlap, as a shared end is a corner
+		 * which sight can pass */
+		if (num && slope_less(next->low_n, next->low_d,
+							  shadows->merged[num - 1].high_n,
+							  shadows->merged[num - 1].high_d)) {
+			struct view_shadow *last = &shadows->merged[num - 1];
+			if (slope_less(last->high_n, last->high_d, next->high_n,
+						   next->high_d)) {
+				last->high_n = next->high_n;
+				last->high_d = next->high_d;
+			}
+		} else {
+			shadows->merged[num++] = *next;
+		}
+	}
+
+	/* The merged list becomes the current one */
+	swap = shadows->list;
+	shadows->list = shadows->merged;
+	shadows->merged = swap;
+	shadows->num = num;
+}
+
+/**
+ * Find line of sight from the centre to the grids of one octant, the grids
+ * major * col + minor * row away from it for 0 <= row <= col, exactly as los()
+ * would find it for each grid.
+ *
+ * los() follows the line between grid centres, and is blocked by those non-
+ * projectable grids whose inside the line enters, but not by those whose
+ * corner it only brushes.  Seen from the centre, such a grid col columns out
+ * covers the open range of slopes from (2 * row - 1) / (2 * col + 1) to
+ * (2 * row + 1) / (2 * col - 1), and can only stand in the way of grids in
+ * later columns.  So going out a column at a time, a grid is in line of sight
+ * just when its slope row / col lies in none of the shadows cast so far.
+ */
+static void view_octant(struct chunk *c, struct loc centre, struct loc major,
+						struct loc minor, int range, bool *sight,
+						struct view_shadows *shadows)
+{
+	int col, row;
+
+	shadows->num = 0;
+	for (col = 1; col <= range; col++) {
+		struct loc start = loc(centre.x + major.x * col,
+							   centre.y + major.y * col);
+		int i = 0, first = shadows->num;
+
+		if (!square_in_bounds(c, start)) return;
+
+		/* Everything further out is in shadow */
+		if ((shadows->num == 1) && (shadows->list[0].low_n < 0) &&
+			(shadows->list[0].high_n > shadows->list[0].high_d)) {
+			return;
+		}
+
+		/* Make room for this column's shadows to be added */
+		if (shadows->num + col + 1 > shadows->max) {
+			shadows->max = 2 * (shadows->num + col + 1);
+			shadows->list = mem_realloc(shadows->list, shadows->max *
+										sizeof(struct view_shadow));
+			shadows->merged = mem_realloc(shadows->merged, shadows->max *
+										  sizeof(struct view_shadow));
+		}
+
+		for (row = 0; row <= col; row++) {
+			struct loc grid = loc(start.x + minor.x * row,
+								  start.y + minor.y * row);
+
+			if (!square_in_bounds(c, grid)) break;
+
+			/* Skip shadows wholly below this grid's slope */
+			while ((i < first) && !slope_less(row, col,
+											  shadows->list[i].high_n,
+											  shadows->list[i].high_d)) {
+				i++;
+			}
+			if ((i == first) || !slope_less(shadows->list[i].low_n,
+											shadows->list[i].low_d, row,
+											col)) {
+				sight[grid.y * c->width + grid.x] = true;
+			}
+
+			/* Note the shadow this grid casts, joining it to the last one
+			 * from this column if they overlap */
+			if (!square_layer_has(c, LAYER_PROJECT, grid.x, grid.y)) {
+				if ((shadows->num > first) &&
+					(shadows->list[shadows->num - 1].high_n == 2 * row - 1)) {
+					shadows->list[shadows->num - 1].high_n = 2 * row + 1;
+				} else {
+					struct view_shadow *shadow = &shadows->list[shadows->num++];
+					shadow->low_n = 2 * row - 1;
+					shadow->low_d = 2 * col + 1;
+					shadow->high_n = 2 * row + 1;
+					shadow->high_d = 2 * col - 1;
+				}
+			}
+		}
+		add_shadows(shadows, first);
+	}
+}
+
+/**
+ * Line of sight from the player to each grid, kept from one update of the
+ * view to the next
+ */
+static bool *view_sight;
+static size_t view_sight_size;
+
+/**
+ * Find which grids within range of the player los() would find to be in line
+ * of sight, for the whole view at once
+ */
+static void calc_sight(struct chunk *c, struct player *p, bool *sight)
+{
+	struct view_shadows shadows = { NULL, NULL, 0, 0 };
+	int i, dy, dx;
+
+	/* Each octant, given by the direction away from the player along its
+	 * major axis and the direction its rows run along the minor axis */
+	for (i = 0; i < 8; i++) {
+		struct loc major = ddgrid_ddd[i % 4];
+		struct loc minor = loc(major.y, major.x);
+
+		if (i >= 4) {
+			minor = loc(-minor.x, -minor.y);
+		}
+		view_octant(c, p->grid, major, minor, z_info->max_sight, sight,
+					&shadows);
+	}
+	mem_free(shadows.list);
+	mem_free(shadows.merged);
+
+	/* The player grid, and knight's moves, which los() allows specially */
+	sight[p->grid.y * c->width + p->grid.x] = true;
+	for (dy = -2; dy <= 2; dy++) {
+		for (dx = -2; dx <= 2; dx++) {
+			struct loc grid = loc(p->grid.x + dx, p->grid.y + dy);
+			if ((ABS(dx) + ABS(dy) != 3) || !square_in_bounds(c, grid)) {
+				continue;
+			}
+			sight[grid.y * c->width + grid.x] = los(c, p->grid, grid);
+		}
+	}
+}
+
 /**
  * Decide whether to include a square in the current view
  */
-static void update_view_one(struct chunk *c, struct loc grid, struct player *p)
+static void update_view_one(struct chunk *c, struct loc grid, struct player *p,
+							const bool *sight)
 {
 	int x = grid.x;
 	int y = grid.y;
@@ -879,7 +1097,7 @@ static void update_view_one(struct chunk *c, struct loc grid, struct player *p)
 		}
 	}
 
-	if (los(c, p->grid, loc(xc, yc)))
+	if (sight[yc * c->width + xc])
 		become_viewable(c, grid, p, close);
 }
 
@@ -907,15 +1125,39 @@ static void update_one(struct chunk *c, struct loc grid, struct player *p)
 	sqinfo_off(square(c, grid)->info, SQUARE_WASSEEN);
 }
 
+/**
+ * Make the next view update look at the whole of a chunk, for when grid info
+ * (which may include view flags) has been written to it wholesale
+ */
+void forget_view(struct chunk *c)
+{
+	c->view_min = loc(0, 0);
+	c->view_max = loc(c->width - 1, c->height - 1);
+}
+
 /**
  * Update the player's current view
+ *
+ * Line of sight to every grid in range is found in one sweep out from the
+ * player, rather than by calling los() for each grid.  Only grids within
+ * z_info->max_sight of the player can come into view, and only those the
+ * last update left in view need removing from it, so the rest of the work is
+ * confined to the box around the player and the one kept from last time.
  */
 void update_view(struct chunk *c, struct player *p)
 {
 	int x, y;
+	struct loc old_min = c->view_min, old_max = c->view_max;
+	struct loc min, max;
+
+	/* The grids which may come into view */
+	min.x = MAX(p->grid.x - z_info->max_sight, 0);
+	min.y = MAX(p->grid.y - z_info->max_sight, 0);
+	max.x = MIN(p->grid.x + z_info->max_sight, c->width - 1);
+	max.y = MIN(p->grid.y + z_info->max_sight, c->height - 1);
 
 	/* Record the current view */
-	mark_wasseen(c);
+	mark_wasseen(c, old_min, old_max);
 
 	/* Calculate light levels */
 	calc_lighting(c, p);
@@ -938,21 +1180,44 @@ void update_view(struct chunk *c, struct player *p)
 		square_forget(c, p->grid);
 	}
 
-	/* Squares we have LOS to get marked as in the view, and perhaps seen */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
-			update_view_one(c, loc(x, y), p);
-
-	/* Update each grid */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	/* Squares we have LOS to get marked as in the view, and perhaps seen;
+	 * line of sight is only found, and only read, within range */
+	if (view_sight_size < (size_t) c->height * c->width) {
+		view_sight_size = (size_t) c->height * c->width;
+		mem_free(view_sight);
+		view_sight = mem_alloc(view_sight_size * sizeof(bool));
+	}
+	for (y = min.y; y <= max.y; y++) {
+		memset(&view_sight[y * c->width + min.x], 0,
+			   (max.x - min.x + 1) * sizeof(bool));
+	}
+	calc_sight(c, p, view_sight);
+	for (y = min.y; y <= max.y; y++)
+		for (x = min.x; x <= max.x; x++)
+			update_view_one(c, loc(x, y), p, view_sight);
+
+	/* Update each grid in the old or new view */
+	for (y = MIN(min.y, old_min.y); y <= MAX(max.y, old_max.y); y++)
+		for (x = MIN(min.x, old_min.x); x <= MAX(max.x, old_max.x); x++)
 			update_one(c, loc(x, y), p);
+	c->view_min = min;
+	c->view_max = max;
 
 	/* Update field-of-fire (using the old view algorithm for now - NRM) */
 	update_fire(c, p);
 }
 
 
+/**
+ * Free the line of sight kept between updates of the view
+ */
+void view_free(void)
+{
+	mem_free(view_sight);
+	view_sight = NULL;
+	view_sight_size = 0;
+}
+
 /**
  * Returns true if the player's grid is dark
  */
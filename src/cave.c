@@ -400,59 +400,84 @@ const char *get_feat_code_name(int idx)
 }
 
 /**
- * Allocate a new flow
+ * Allocate a new flow; the row pointers and the rows are one block
  */
 void flow_new(struct chunk *c, struct flow *flow) {
 	int y;
-	flow->grids = mem_zalloc(c->height * sizeof(uint16_t*));
+	uint16_t *rows;
+
+	flow->grids = mem_zalloc(c->height * sizeof(uint16_t*)
+							 + c->height * c->width * sizeof(uint16_t));
+	rows = (uint16_t *) (flow->grids + c->height);
 	for (y = 0; y < c->height; y++) {
-		flow->grids[y] = mem_zalloc(c->width * sizeof(uint16_t));
+		flow->grids[y] = rows + y * c->width;
 	}
+	flow->last_centre = loc(0, 0);
+	flow->terrain = 0;
 }
 
 /**
  * Free a flow
  */
 void flow_free(struct chunk *c, struct flow *flow) {
-	int y;
-	for (y = 0; y < c->height; y++) {
-		mem_free(flow->grids[y]);
-	}
 	mem_free(flow->grids);
+	flow->grids = NULL;
 }
 
 /**
- * Allocate a new chunk of the world
+ * Allocate a new chunk of the world; it has no flows until it is made live
  */
 struct chunk *chunk_new(int height, int width)
 {
 	int y, x;
+	size_t grids = (size_t) height * width;
+	struct square *square_row;
+	bitflag *info;
 
 	struct chunk *c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
 	c->feat_count = mem_zalloc((FEAT_MAX + 1) * sizeof(int));
 
-	c->squares = mem_zalloc(c->height * sizeof(struct square*));
-
-	flow_new(c, &c->player_noise);
-	flow_new(c, &c->monster_noise);
-	flow_new(c, &c->scent);
-
+	/* The row pointers, squares and square info are one block */
+	c->squares = mem_zalloc(c->height * sizeof(struct square*)
+							+ grids * sizeof(struct square)
+							+ grids * SQUARE_SIZE * sizeof(bitflag));
+	square_row = (struct square *) (c->squares + c->height);
+	info = (bitflag *) (square_row + grids);
 	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
+		c->squares[y] = square_row + y * c->width;
 		for (x = 0; x < c->width; x++) {
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
+			c->squares[y][x].info = info + (y * c->width + x) * SQUARE_SIZE;
 		}
 	}
 
+	/* Unknown grids, as all start out, are set in no layer */
+	c->layer_stride = (c->width + 31) / 32;
+	c->layers = mem_zalloc(LAYER_MAX * c->height * c->layer_stride
+						   * sizeof(uint32_t));
+
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
+	forget_view(c);
 
 	c->turn = turn;
 	return c;
 }
 
+/**
+ * Make a chunk the live playing arena, allocating the noise and scent flows
+ * which are only needed while it is being played in
+ */
+void chunk_set_live(struct chunk *c)
+{
+	if (c->live) return;
+	flow_new(c, &c->player_noise);
+	flow_new(c, &c->monster_noise);
+	flow_new(c, &c->scent);
+	c->live = true;
+}
+
 /**
  * Wipe the actual details of a chunk
  */
@@ -472,19 +497,22 @@ void chunk_wipe(struct chunk *c)
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
 			if (c->squares[y][x].trap)
 				square_free_trap(c, loc(x, y));
 			if (c->squares[y][x].obj)
 				object_pile_free(c, p_c, c->squares[y][x].obj);
 		}
-		mem_free(c->squares[y]);
 	}
 	mem_free(c->squares);
+	mem_free(c->layers);
 
-	flow_free(c, &c->player_noise);
-	flow_free(c, &c->monster_noise);
-	flow_free(c, &c->scent);
+	if (c->live) {
+		flow_free(c, &c->player_noise);
+		flow_free(c, &c->monster_noise);
+		flow_free(c, &c->scent);
+	}
+	flow_cache_free(c);
+	mem_free(c->wander_grids);
 
 	mem_free(c->feat_count);
 	mem_free(c->objects);
@@ -493,6 +521,31 @@ void chunk_wipe(struct chunk *c)
 	mem_free(c);
 }
 
+/**
+ * Memory used by the flows of a live chunk, whether or not this one has them
+ */
+size_t chunk_flow_memory(const struct chunk *c)
+{
+	return 3 * (c->height * sizeof(uint16_t*)
+				+ (size_t) c->height * c->width * sizeof(uint16_t));
+}
+
+/**
+ * Estimate the memory used by a chunk's own allocations; objects, traps and
+ * monsters are not included
+ */
+size_t chunk_memory(const struct chunk *c)
+{
+	size_t grids = (size_t) c->height * c->width;
+	size_t squares = c->height * sizeof(struct square*)
+		+ grids * (sizeof(struct square) + SQUARE_SIZE * sizeof(bitflag));
+	size_t layers = LAYER_MAX * c->height * c->layer_stride * sizeof(uint32_t);
+
+	return sizeof(*c) + (FEAT_MAX + 1) * sizeof(int) + squares + layers
+		+ (c->live ? chunk_flow_memory(c) : 0)
+		+ (c->obj_max + 1) * sizeof(struct object*);
+}
+
 /**
  * Enter an object in the list of objects for the current level/chunk.  This
  * function is robust against listing of duplicates or non-objects
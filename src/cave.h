@@ -25,6 +25,7 @@
 struct player;
 struct monster;
 struct monster_group;
+struct flow_cache;
 
 extern const int16_t ddd[9];
 extern const uint8_t cycle[17];
@@ -107,6 +108,21 @@ enum
 
 #define tf_has(f, flag)        flag_has_dbg(f, TF_SIZE, flag, #f, #flag)
 
+/**
+ * Packed layers of one bit per grid, which say the same as the terrain flags
+ * of the same names, for the tests made most often
+ */
+enum grid_layer {
+	LAYER_PROJECT,
+	LAYER_PASSABLE,
+	LAYER_LOS,
+	LAYER_MAX
+};
+
+#define square_layer_has(c, layer, x, y) \
+	(((c)->layers[((layer) * (c)->height + (y)) * (c)->layer_stride \
+				  + ((x) >> 5)] >> ((x) & 31)) & 1)
+
 /**
  * Information about terrain features.
  *
@@ -182,6 +198,8 @@ struct square {
 struct flow {
 	struct loc centre;
 	uint16_t **grids;
+	struct loc last_centre;	/**< Centre of the last noise flow calculation */
+	uint32_t terrain;		/**< Terrain stamp of the last calculation */
 };
 
 struct chunk {
@@ -195,8 +213,19 @@ struct chunk {
 	int *feat_count;
 
 	struct loc project_path_ignore;
+	struct loc view_min;	/**< Top left of the grids that may be in view */
+	struct loc view_max;	/**< Bottom right of the grids that may be in view */
 
 	struct square **squares;
+	uint32_t *layers;	/**< Each grid_layer in turn, row by row */
+	int layer_stride;	/**< Words in a row of a layer */
+	uint32_t terrain_stamp;	/**< Changes whenever terrain, traps or room
+							 * marks change */
+	bool live;			/**< Has the flows needed for play */
+	struct flow_cache *flow_cache;	/**< Monster flows and costs to share */
+	struct loc *wander_grids;	/**< Room floor grids outside vaults */
+	int wander_num;
+	uint32_t wander_terrain;	/**< Terrain stamp wander_grids was found for */
 	struct flow player_noise;
 	struct flow monster_noise;
 	struct flow scent;
@@ -229,7 +258,9 @@ int project_path(struct chunk *c, struct loc *gp, int range, struct loc grid1,
 /* cave-view.c */
 int distance(struct loc grid1, struct loc grid2);
 bool los(struct chunk *c, struct loc grid1, struct loc grid2);
+void forget_view(struct chunk *c);
 void update_view(struct chunk *c, struct player *p);
+void view_free(void);
 bool no_light(const struct player *p);
 
 /* cave-map.c */
@@ -407,6 +438,7 @@ int square_num_walls_diagonal(struct chunk *c, struct loc grid);
 
 /* Feature placers */
 void square_set_feat(struct chunk *c, struct loc grid, int feat);
+void square_set_layers(struct chunk *c, struct loc grid);
 void square_set_mon(struct chunk *c, struct loc grid, int midx);
 void square_set_obj(struct chunk *c, struct loc grid, struct object *obj);
 void square_set_trap(struct chunk *c, struct loc grid, struct trap *trap);
@@ -453,7 +485,10 @@ const char *get_feat_code_name(int idx);
 void flow_new(struct chunk *c, struct flow *flow);
 void flow_free(struct chunk *c, struct flow *flow);
 struct chunk *chunk_new(int height, int width);
+void chunk_set_live(struct chunk *c);
 void chunk_wipe(struct chunk *c);
+size_t chunk_flow_memory(const struct chunk *c);
+size_t chunk_memory(const struct chunk *c);
 void list_object(struct chunk *c, struct object *obj);
 void delist_object(struct chunk *c, struct object *obj);
 void object_lists_check_integrity(struct chunk *c, struct chunk *c_k);
@@ -569,7 +569,7 @@ void do_cmd_exchange(struct command *cmd)
 	struct monster *mon;
 	char m_name[80];
 
-	if (!player_active_ability(player, "Exchange Places")) {
+	if (!player_active_ability(player, PA_EXCHANGE_PLACES)) {
 		msg("You need the ability 'exchange places' to use this command.");
 		return;
 	}
@@ -1411,7 +1411,7 @@ static void do_cmd_alter_aux(int dir)
 		/* Close door */
 		more = do_cmd_close_aux(grid);
 	} else if (square_isswim(cave, grid) &&
-			   player_active_ability(player, "Fishing")) {
+			   player_active_ability(player, PA_FISHING)) {
 		/* Catch fish */
 		more = do_cmd_fish_aux(grid);
 	} else if ((dir == DIR_NONE) && player_is_riding(player)) {
@@ -1594,7 +1594,7 @@ void move_player(int dir, bool disarm)
 	if (mon) {
 		if (monster_is_tame(mon) && monster_is_rideable(mon)) {
 			/* Ride monster */
-			if (player_active_ability(player, "Horse Riding")) {
+			if (player_active_ability(player, PA_HORSE_RIDING)) {
 				player_mount(player, mon, dir);
 			} else {
 				msg("You cannot ride!");
@@ -2104,7 +2104,7 @@ void do_cmd_speak(struct command *cmd)
 	/* Animal or speaking */
 	if (language == LANGUAGE_ANIMAL) {
 		/* There is only one option */
-		assert(player_active_ability(player, "Tame Creature"));
+		assert(player_active_ability(player, PA_TAME_CREATURE));
 
 		/* Check speech skill against monster will */
 		result = skill_check(source_player(), skill, resistance,
@@ -2123,7 +2123,7 @@ void do_cmd_speak(struct command *cmd)
 		}
 	} else {
 		/* There is only one option for now */
-		if (!player_active_ability(player, "Greeting")) {
+		if (!player_active_ability(player, PA_GREETING)) {
 			msg("You need to learn the correct form of greeting.");
 		}
 
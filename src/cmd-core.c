@@ -150,7 +150,9 @@ static const struct command_info game_cmds[] =
 	{ CMD_WIZ_PERFORM_EFFECT, "perform an effect", do_cmd_wiz_perform_effect, false, 0 },
 	{ CMD_WIZ_PLAY_ITEM, "play with item", do_cmd_wiz_play_item, false, 0 },
 	{ CMD_WIZ_PUSH_OBJECT, "push objects from square", do_cmd_wiz_push_object, false, 0 },
+	{ CMD_WIZ_QUERY_CHUNK_CACHE, "show chunk cache statistics", do_cmd_wiz_query_chunk_cache, false, 0 },
 	{ CMD_WIZ_QUERY_FEATURE, "highlight specific feature", do_cmd_wiz_query_feature, false, 0 },
+	{ CMD_WIZ_QUERY_MEMORY_POOLS, "show memory pool statistics", do_cmd_wiz_query_memory_pools, false, 0 },
 	{ CMD_WIZ_QUERY_SQUARE_FLAG, "query square flag", do_cmd_wiz_query_square_flag, false, 0 },
 	{ CMD_WIZ_QUIT_NO_SAVE, "quit without saving", do_cmd_wiz_quit_no_save, false, 0 },
 	{ CMD_WIZ_RECALL_MONSTER, "recall monster", do_cmd_wiz_recall_monster, false, 0 },
@@ -140,7 +140,9 @@ typedef enum cmd_code {
 	CMD_WIZ_PERFORM_EFFECT,
 	CMD_WIZ_PLAY_ITEM,
 	CMD_WIZ_PUSH_OBJECT,
+	CMD_WIZ_QUERY_CHUNK_CACHE,
 	CMD_WIZ_QUERY_FEATURE,
+	CMD_WIZ_QUERY_MEMORY_POOLS,
 	CMD_WIZ_QUERY_SQUARE_FLAG,
 	CMD_WIZ_QUIT_NO_SAVE,
 	CMD_WIZ_RECALL_MONSTER,
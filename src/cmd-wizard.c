@@ -1214,6 +1214,7 @@ void do_cmd_wiz_jump_level(struct command *cmd)
 		}
 	}
 	player_place(chunk, player, loc(ARENA_SIDE / 2, ARENA_SIDE / 2));
+	chunk_set_live(chunk);
 	cave = chunk;
 
 	/* Allocate new known level */
@@ -1742,6 +1743,45 @@ void do_cmd_wiz_push_object(struct command *cmd)
 }
 
 
+/**
+ * Display statistics for the chunk list acting as a cache of stored chunks
+ * (CMD_WIZ_QUERY_CHUNK_CACHE).  Takes no arguments from cmd.
+ */
+void do_cmd_wiz_query_chunk_cache(struct command *cmd)
+{
+	const struct chunk_cache_stats *stats = &chunk_cache_stats;
+	uint32_t lookups = stats->hits + stats->misses;
+	size_t arena = chunk_memory(cave) + chunk_memory(player->cave);
+	size_t saved = 0;
+	int i;
+
+	/* Stored chunks are not live, so have no flows */
+	for (i = 0; i < chunk_max; i++) {
+		struct chunk_ref *ref = &chunk_list[i];
+		if (!ref->chunk) continue;
+		saved += chunk_flow_memory(ref->chunk)
+			+ chunk_flow_memory(ref->p_chunk);
+	}
+
+	msg("Chunk list: %d of %d entries, %lu KB stored (budget %lu KB).",
+		chunk_cnt, MAX_CHUNKS, (unsigned long) (stats->bytes / 1024),
+		(unsigned long) z_info->chunk_cache_kb);
+	msg("%lu hits, %lu misses (%lu regenerated), %d%% hit rate, %lu evictions.",
+		(unsigned long) stats->hits, (unsigned long) stats->misses,
+		(unsigned long) stats->regenerations,
+		lookups ? (int) ((100 * (uint64_t) stats->hits) / lookups) : 0,
+		(unsigned long) stats->evictions);
+	msg("%lu chunks generated ahead of the player, %lu of them used.",
+		(unsigned long) stats->pregenerated,
+		(unsigned long) stats->pregen_used);
+	msg("Current arena %lu KB; stored chunks save %lu KB by having no flows.",
+		(unsigned long) (arena / 1024), (unsigned long) (saved / 1024));
+	msg("Monster flows: %lu shared, %lu calculated.",
+		(unsigned long) flow_cache_stats.shared,
+		(unsigned long) flow_cache_stats.calculated);
+}
+
+
 struct wiz_query_feature_closure {
 	const int *features;
 	int n;
@@ -1931,6 +1971,29 @@ void do_cmd_wiz_query_feature(struct command *cmd)
 }
 
 
+/**
+ * Display statistics for the memory pools (CMD_WIZ_QUERY_MEMORY_POOLS).
+ * Takes no arguments from cmd.
+ */
+void do_cmd_wiz_query_memory_pools(struct command *cmd)
+{
+	struct mem_pool_stats stats[16];
+	size_t i, n = mem_pool_stats(stats, N_ELEMENTS(stats));
+
+	if (!n) {
+		msg("No memory pools are in use.");
+		return;
+	}
+	for (i = 0; i < MIN(n, N_ELEMENTS(stats)); i++) {
+		msg("%s: %lu in use, peak %lu, %lu KB held (%lu bytes each).",
+			stats[i].name, (unsigned long) stats[i].live,
+			(unsigned long) stats[i].peak,
+			(unsigned long) (stats[i].bytes / 1024),
+			(unsigned long) stats[i].size);
+	}
+}
+
+
 /**
  * Is a helper function passed by do_cmd_wiz_query_square_flag() to
  * wiz_hack_map().
@@ -114,7 +114,9 @@ void do_cmd_wiz_peek_noise_scent(struct command *cmd);
 void do_cmd_wiz_perform_effect(struct command *cmd);
 void do_cmd_wiz_play_item(struct command *cmd);
 void do_cmd_wiz_push_object(struct command *cmd);
+void do_cmd_wiz_query_chunk_cache(struct command *cmd);
 void do_cmd_wiz_query_feature(struct command *cmd);
+void do_cmd_wiz_query_memory_pools(struct command *cmd);
 void do_cmd_wiz_query_square_flag(struct command *cmd);
 void do_cmd_wiz_quit_no_save(struct command *cmd);
 void do_cmd_wiz_recall_monster(struct command *cmd);
@@ -245,7 +245,7 @@ static int concentration_bonus(struct player *p, struct loc grid)
 	int midx = square_monster(cave, grid) ? square_monster(cave, grid)->midx :0;
 	
 	/* Deal with 'concentration' ability */
-	if (player_active_ability(p, "Concentration") &&
+	if (player_active_ability(p, PA_CONCENTRATION) &&
 		(p->last_attack_m_idx == midx)) {
 		bonus = MIN(p->consecutive_attacks,
 					p->state.skill_use[SKILL_PERCEPTION] / 2);
@@ -270,7 +270,7 @@ static int focused_attack_bonus(struct player *p)
 	if (p->focused) {
 		p->focused = false;
 		
-		if (player_active_ability(p, "Focused Attack")) {
+		if (player_active_ability(p, PA_FOCUSED_ATTACK)) {
 			return (p->state.skill_use[SKILL_PERCEPTION] / 2);
 		}
 	}
@@ -287,7 +287,7 @@ static int master_hunter_bonus(struct player *p, struct monster *mon)
 	struct monster_lore *lore = get_lore(mon->race);
 
 	/* Master hunter bonus */
-	if (player_active_ability(p, "Master Hunter")) {
+	if (player_active_ability(p, PA_MASTER_HUNTER)) {
 		return MIN(lore->pkills, p->state.skill_use[SKILL_PERCEPTION] / 4);
 	}
 	return 0;
@@ -478,7 +478,7 @@ int stealth_melee_bonus(const struct monster *mon)
 {
 	int stealth_bonus = 0;
 		
-	if (player_active_ability(player, "Assassination")) {
+	if (player_active_ability(player, PA_ASSASSINATION)) {
 		if ((mon->alertness < ALERTNESS_ALERT) && monster_is_visible(mon) &&
 			!player->timed[TMD_CONFUSED]) {
 			stealth_bonus = player->state.skill_use[SKILL_STEALTH];
@@ -545,7 +545,7 @@ int overwhelming_att_mod(struct player *p, struct monster *mon)
 	}
 	
 	/* Adjust for crowd fighting ability */
-	if (player_active_ability(p, "Crowd Fighting")) {
+	if (player_active_ability(p, PA_CROWD_FIGHTING)) {
 		mod /= 2;
 	}
 	
@@ -625,32 +625,32 @@ int crit_bonus(struct player *p, int hit_result, int weight,
 		/* Changes to melee criticals */
 		if (skill_type == SKILL_MELEE) {
 			/* Can have improved criticals for melee */
-			if (player_active_ability(p, "Finesse")) {
+			if (player_active_ability(p, PA_FINESSE)) {
 				crit_separation -= 10;
 			}
 
 			/* Can have improved criticals for melee with one handed weapons */
-			if (player_active_ability(p, "Subtlety") && !thrown &&
+			if (player_active_ability(p, PA_SUBTLETY) && !thrown &&
 				!two_handed_melee(p) &&
 				!equipped_item_by_slot_name(p, "arm")) {
 				crit_separation -= 20;
 			}
 
 			/* Can have inferior criticals for melee */
-			if (player_active_ability(p, "Power")) {
+			if (player_active_ability(p, PA_POWER)) {
 				crit_separation += 10;
 			}
 		}
 
 		/* Can have improved criticals for archery */
 		if ((skill_type == SKILL_ARCHERY) &&
-			player_active_ability(p, "Precision")) {
+			player_active_ability(p, PA_PRECISION)) {
 			crit_separation -= 10;
 		}
 	} else {
 		/* When attacking the player... */
 		/* Resistance to criticals increases what they need for each bonus die*/
-		if (player_active_ability(p, "Critical Resistance")) {
+		if (player_active_ability(p, PA_CRITICAL_RESISTANCE)) {
 			crit_separation += (p->state.skill_use[SKILL_WILL] / 5) * 10;	
 		}
 	}
@@ -693,7 +693,7 @@ int protection_roll(struct player *p, int typ, bool melee, aspect prot_aspect)
 		prt += damcalc(1, MAX(1, bonus), prot_aspect);
 	}
 	
-	if (player_active_ability(p, "Hardiness")) {
+	if (player_active_ability(p, PA_HARDINESS)) {
 		prt += damcalc(1, p->state.skill_use[SKILL_WILL] / 6, prot_aspect);
 	}
 	
@@ -713,7 +713,7 @@ int protection_roll(struct player *p, int typ, bool melee, aspect prot_aspect)
 		/* Fire and cold and generic 'hurt' all check the shield */
 		if (slot_type_is(p, i, EQUIP_SHIELD)) {
 			if ((typ == PROJ_HURT) || (typ == PROJ_FIRE) || (typ == PROJ_COLD)){
-				if (player_active_ability(p, "Blocking") &&
+				if (player_active_ability(p, PA_BLOCKING) &&
 					(!melee || ((p->previous_action[0] == ACTION_STAND) ||
 								((p->previous_action[0] == ACTION_NOTHING) &&
 								 (p->previous_action[1] == ACTION_STAND))))) {
@@ -733,7 +733,7 @@ int protection_roll(struct player *p, int typ, bool melee, aspect prot_aspect)
 	}
 
 	/* Heavy armour bonus */
-	if (player_active_ability(p, "Heavy Armour") && (typ == PROJ_HURT)) {
+	if (player_active_ability(p, PA_HEAVY_ARMOUR) && (typ == PROJ_HURT)) {
 		prt += damcalc(1, MIN(1, armour_weight / 150), prot_aspect);
 	}
 
@@ -88,13 +88,13 @@ errr parse_file_quit_not_found(struct parser *p, const char *filename) {
 }
 
 /**
- * The basic file parsing function.
+ * Open the file a parser reads for the given name, which may be a customised
+ * one in the user directory.  Returns NULL if there is none.
  */
-errr parse_file(struct parser *p, const char *filename, const char *dir) {
+ang_file *parse_file_open(const char *filename, const char *dir)
+{
 	char path[1024];
-	char buf[1024];
 	ang_file *fh;
-	errr r = 0;
 
 	if (dir) {
 		path_build(path, sizeof(path), dir, format("%s.txt", filename));
@@ -120,6 +120,17 @@ errr parse_file(struct parser *p, const char *filename, const char *dir) {
 		}
 	}
 
+	return fh;
+}
+
+/**
+ * The basic file parsing function.
+ */
+errr parse_file(struct parser *p, const char *filename, const char *dir) {
+	char buf[1024];
+	ang_file *fh = parse_file_open(filename, dir);
+	errr r = 0;
+
 	/* File wasn't found, return the error */
 	if (!fh)
 		return PARSE_ERROR_NO_FILE_FOUND;
@@ -524,7 +524,7 @@ bool effect_handler_DETECT_DOORS(effect_handler_context_t *context)
 			/* Detect secret doors */
 			if (square_issecretdoor(cave, grid)) {
 				/* Put an actual door */
-				place_closed_door(cave, grid);
+				place_closed_door(cave, Rand_ctx, grid);
 
 				/* Memorize */
 				square_memorize(cave, grid);
@@ -1081,7 +1081,7 @@ bool effect_handler_SONG_OF_FREEDOM(effect_handler_context_t *context)
 				int diff = base_diff + flow_dist(cave->player_noise, grid);
 				if (skill_check(source_player(), score, diff, source_none())
 					> 0) {
-					place_closed_door(cave, grid);
+					place_closed_door(cave, Rand_ctx, grid);
 					if (square_isseen(cave, grid)) {
 						msg("You have found a secret door.");
 						disturb(player, false);
@@ -279,7 +279,7 @@ static int32_t effect_value_base_player_max_hp(void)
 static int32_t effect_value_base_player_will(void)
 {
 	int will = player->state.skill_use[SKILL_WILL];
-	if (player_active_ability(player, "Channeling")) {
+	if (player_active_ability(player, PA_CHANNELING)) {
 		will += 5;
 	}
 	return will;
@@ -81,6 +81,7 @@ typedef enum game_event_type
 	EVENT_COMMAND_REPEAT,
 	EVENT_ANIMATE,
 	EVENT_CHEAT_DEATH,
+	EVENT_SAVEFILE_WRITTEN,	/* has flag in event data indicating success */
 	EVENT_POEM,
 	EVENT_DEATH,
 
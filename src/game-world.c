@@ -41,16 +41,17 @@
 #include "target.h"
 #include "trap.h"
 #include "tutorial.h"
-#include "z-queue.h"
 
 uint16_t daycount = 0;
 uint32_t seed_randart;		/* Consistent random artifacts */
 uint32_t seed_flavor;		/* Consistent object colors */
+uint32_t seed_world;		/* Consistent surface locations */
 int32_t turn;			/* Current game turn */
 bool character_generated;	/* The character exists */
 bool character_dungeon;		/* The character has a dungeon */
+static bool skip_idle = true;	/* Skip over turns when nothing happens */
+static bool skip_rest = true;	/* Fast-forward through undisturbed rests */
 struct world_region *region_info;
-struct square_mile **square_miles;
 struct landmark *landmark_info;
 struct river *river_info;
 struct gen_loc *gen_loc_list;	/* List of generated locations */
@@ -80,12 +81,141 @@ const uint8_t extract_energy[8] =
  * ------------------------------------------------------------------------
  * Map-related functions
  * ------------------------------------------------------------------------ */
+/**
+ * Index of the generated locations list by position.  Each slot holds one more
+ * than the index of a location in gen_loc_list, or 0 if it is empty; the
+ * table is kept at most half full so probe runs stay short.
+ */
+static uint32_t *gen_loc_index;
+static uint32_t gen_loc_index_size;
+
+/**
+ * Hash a generation location position into the index
+ */
+static uint32_t gen_loc_hash(int x_pos, int y_pos, int z_pos)
+{
+	uint32_t hash = (uint32_t) x_pos * 0x9E3779B1U;
+	hash ^= (uint32_t) y_pos * 0x85EBCA77U;
+	hash ^= (uint32_t) z_pos * 0xC2B2AE3DU;
+	hash ^= hash >> 15;
+	hash *= 0x2C1B3C6DU;
+	hash ^= hash >> 12;
+	return hash & (gen_loc_index_size - 1);
+}
+
+/**
+ * Enter the location at the given place in gen_loc_list into the index
+ */
+static void gen_loc_index_add(uint32_t idx)
+{
+	struct gen_loc *location = &gen_loc_list[idx];
+	uint32_t slot = gen_loc_hash(location->x_pos, location->y_pos,
+								 location->z_pos);
+
+	while (gen_loc_index[slot]) {
+		slot = (slot + 1) & (gen_loc_index_size - 1);
+	}
+	gen_loc_index[slot] = idx + 1;
+}
+
+/**
+ * Make sure the generated locations list has room for the given number of
+ * locations
+ */
+void gen_loc_list_reserve(uint32_t count)
+{
+	uint32_t old_max = gen_loc_max;
+
+	if (count <= gen_loc_max) return;
+	while (gen_loc_max < count) {
+		gen_loc_max *= 2;
+	}
+	gen_loc_list = mem_realloc(gen_loc_list,
+							   gen_loc_max * sizeof(struct gen_loc));
+	memset(&gen_loc_list[old_max], 0,
+		   (gen_loc_max - old_max) * sizeof(struct gen_loc));
+}
+
+/**
+ * Rebuild the index of the generated locations list from scratch; this is
+ * needed whenever the list is filled or emptied other than by gen_loc_make()
+ */
+void gen_loc_list_reindex(void)
+{
+	uint32_t i, size = 2 * GEN_LOC_INCR;
+
+	while (size < 2 * gen_loc_cnt) {
+		size *= 2;
+	}
+	if (size != gen_loc_index_size) {
+		mem_free(gen_loc_index);
+		gen_loc_index = mem_zalloc(size * sizeof(uint32_t));
+		gen_loc_index_size = size;
+	} else {
+		memset(gen_loc_index, 0, size * sizeof(uint32_t));
+	}
+	for (i = 0; i < gen_loc_cnt; i++) {
+		gen_loc_index_add(i);
+	}
+}
+
 /**
  * Initialise the generated locations list
  */
 void gen_loc_list_init(void)
 {
-	gen_loc_list = mem_zalloc(GEN_LOC_INCR * sizeof(struct gen_loc));
+	gen_loc_cnt = 0;
+	gen_loc_max = GEN_LOC_INCR;
+	gen_loc_list = mem_zalloc(gen_loc_max * sizeof(struct gen_loc));
+	gen_loc_list_reindex();
+}
+
+static struct mem_pool terrain_change_pool =
+	MEM_POOL_INIT("terrain changes", struct terrain_change);
+static struct mem_pool river_grid_pool =
+	MEM_POOL_INIT("river grids", struct river_grid);
+
+/**
+ * Allocate a terrain change.
+ */
+struct terrain_change *terrain_change_new(void)
+{
+	return mem_pool_alloc(&terrain_change_pool);
+}
+
+/**
+ * Allocate a river grid.
+ */
+struct river_grid *river_grid_new(void)
+{
+	return mem_pool_alloc(&river_grid_pool);
+}
+
+/**
+ * Free everything a generated location points to
+ */
+void gen_loc_wipe(struct gen_loc *loc)
+{
+	struct terrain_change *change = loc->change;
+
+	while (change) {
+		struct terrain_change *next = change->next;
+		mem_pool_free(&terrain_change_pool, change);
+		change = next;
+	}
+	loc->change = NULL;
+	connectors_free(loc->join);
+	loc->join = NULL;
+	if (loc->river_piece) {
+		struct river_grid *rgrid = loc->river_piece->grids;
+		while (rgrid) {
+			struct river_grid *next = rgrid->next;
+			mem_pool_free(&river_grid_pool, rgrid);
+			rgrid = next;
+		}
+		mem_free(loc->river_piece);
+		loc->river_piece = NULL;
+	}
 }
 
 /**
@@ -97,200 +227,329 @@ void gen_loc_list_cleanup(void)
 
 	/* Free the locations list */
 	for (i = 0; i < gen_loc_cnt; i++) {
-		if (gen_loc_list[i].change) {
-			struct terrain_change *change = gen_loc_list[i].change;
-			while (change) {
-				change = change->next;
-				mem_free(change);
-			}
-		}
-		connectors_free(gen_loc_list[i].join);
+		gen_loc_wipe(&gen_loc_list[i]);
 	}
 	mem_free(gen_loc_list);
 	gen_loc_list = NULL;
+	mem_free(gen_loc_index);
+	gen_loc_index = NULL;
+	gen_loc_index_size = 0;
+	mem_pool_release(&terrain_change_pool);
+	mem_pool_release(&river_grid_pool);
 }
 
 /**
- * Compare two generation locations for their place in gen_loc_list, which is
- * ordered by x position low to high, then y position low to high, then
- * z position low to high.
+ * Find a given generation location in the list.
  *
- * Return -1 if gen_loc1 is before gen_loc2, 1 if gen_loc2 is before gen_loc1,
- * and 0 if they are equal.
+ * Locations keep their place in gen_loc_list once made, and new ones always
+ * go on the end.  If the location is in the list return true, and store its
+ * position in both below and above.  If not, store the position it will have
+ * when it is made (the current end of the list) in both.
  */
-static int gen_loc_cmp(struct gen_loc gen_loc1, struct gen_loc gen_loc2)
+bool gen_loc_find(int x_pos, int y_pos, int z_pos, int *below, int *above)
 {
-	/* Split by x position */
-	if (gen_loc1.x_pos < gen_loc2.x_pos) {
-		return -1;
-	} else if (gen_loc1.x_pos > gen_loc2.x_pos) {
-		return 1;
-	} else {
-		/* x positions equal, split by y positions */
-		if (gen_loc1.y_pos < gen_loc2.y_pos) {
-			return -1;
-		} else if (gen_loc1.y_pos > gen_loc2.y_pos) {
-			return 1;
-		} else {
-			/* y positions equal, split by z positions */
-			if (gen_loc1.z_pos < gen_loc2.z_pos) {
-				return -1;
-			} else if (gen_loc1.z_pos > gen_loc2.z_pos) {
-				return 1;
-			}
+	uint32_t slot = gen_loc_hash(x_pos, y_pos, z_pos);
+
+	while (gen_loc_index[slot]) {
+		uint32_t idx = gen_loc_index[slot] - 1;
+		struct gen_loc *location = &gen_loc_list[idx];
+		if ((location->x_pos == x_pos) && (location->y_pos == y_pos) &&
+			(location->z_pos == z_pos)) {
+			*above = *below = idx;
+			return true;
 		}
+		slot = (slot + 1) & (gen_loc_index_size - 1);
 	}
 
-	/* Must be equal */
-	return 0;
+	/* Not there, so it will go last */
+	*above = *below = gen_loc_cnt;
+	return false;
 }
 
 /**
- * Find a given generation location in the list, or the locations either side
- * of where it should go.
- *
- * If the location is in the list return true, and store its position in both
- * below and above.  If not, store the last location earlier than it in below,
- * and the first location later than it in above.
+ * Enter a given generation location in the list at the given spot, which
+ * must be the one given by gen_loc_find()
  */
-bool gen_loc_find(int x_pos, int y_pos, int z_pos, int *below, int *above)
+void gen_loc_make(int x_pos, int y_pos, int z_pos, int idx)
 {
-	struct gen_loc gen_loc = { 0, x_pos, y_pos, z_pos, 0, NULL, NULL, NULL,
-		NULL };
-	int idx;
-
-	/* Exhaust for small values to avoid edge effects */
-	if (gen_loc_cnt < 16) {
-		size_t i;
-		for (i = 0; i < gen_loc_cnt; i++) {
-			/* gen_loc is still larger, keep going */
-			if (gen_loc_cmp(gen_loc_list[i], gen_loc) == -1) continue;
-
-			/* Found it */
-			if (gen_loc_cmp(gen_loc_list[i], gen_loc) == 0) {
-				*above = *below = i;
-				return true;
-			}
+	struct gen_loc *location;
 
-			/* Gone past, so it's between this one and the last one (if any) */
-			if (gen_loc_cmp(gen_loc_list[i], gen_loc) == 1) {
-				if (!i) {
-					/* Needs to go before the first element */
-					*above = *below = 0;
-					return false;
-				}
-				*above = i;
-				*below = i - 1;
-				return false;
-			}
-		}
+	/* New locations always go on the end */
+	assert(idx == (int) gen_loc_cnt);
 
-		/* Failed to find it or anything later, so it needs to go last */
-		*above = *below= gen_loc_cnt;
-		return false;
+	/* Extend the array if necessary */
+	gen_loc_list_reserve(gen_loc_cnt + 1);
+
+	/* Copy the new data in */
+	location = &gen_loc_list[idx];
+	location->type = square_mile_biome(loc(x_pos / CPM, y_pos / CPM));
+	location->x_pos = x_pos;
+	location->y_pos = y_pos;
+	location->z_pos = z_pos;
+	location->seed = 0;
+	location->change = NULL;
+	location->join = NULL;
+	location->river_piece = NULL;
+	location->road_edge = NULL;
+	location->dirty = true;
+	gen_loc_cnt++;
+
+	/* Index it, growing the index if it is getting full */
+	if (2 * gen_loc_cnt > gen_loc_index_size) {
+		gen_loc_list_reindex();
+	} else {
+		gen_loc_index_add(idx);
 	}
+}
 
-	/* For larger values, do a bisection search on x, then y, then z */
-	*above = MAX(1, gen_loc_cnt - 1);
-	*below = 0;
+/**
+ * ------------------------------------------------------------------------
+ * Square miles
+ * ------------------------------------------------------------------------ */
+/**
+ * The square miles are kept as planes indexed by map grid, as there are
+ * several hundred thousand of them and little to each:
+ * - the biome of each square mile
+ * - the index in region_info of its region, 0 if it has none
+ * - a bit for each saying whether its rivers have been mapped
+ * - the river miles of the few with rivers, in a table indexed like
+ *   gen_loc_index, with one more than the map grid index as the key
+ */
+static uint8_t *square_mile_biomes;
+static uint16_t *square_mile_regions;
+static uint8_t *square_mile_mapped;
 
-	idx = gen_loc_cnt / 2;
-	while (gen_loc_cmp(gen_loc_list[idx], gen_loc) != 0) {
-		if (*below + 1 == *above)
-			break;
+struct square_mile_rivers {
+	uint32_t key;
+	struct river_mile *river_miles;
+};
 
-		if (gen_loc_cmp(gen_loc_list[idx], gen_loc) == 1) {
-			*above = idx;
-			idx = (*above + *below) / 2;
-			continue;
-		} else if (gen_loc_cmp(gen_loc_list[idx], gen_loc) == -1) {
-			*below = idx;
-			idx = (*above + *below) / 2;
-			continue;
-		}
-	}
+static struct square_mile_rivers *square_mile_rivers;
+static uint32_t square_mile_rivers_size;
+static uint32_t square_mile_rivers_cnt;
 
-	/* Found without having to break */
-	if (*below + 1 != *above) {
-		*below = idx;
-		*above = idx;
-		return true;
+/**
+ * Index of a map grid in the square mile planes, or -1 if it is off the map
+ */
+static int square_mile_idx(struct loc grid)
+{
+	if ((grid.y < 0) || (grid.y >= MAX_Y_REGION) || (grid.x < 0) ||
+		(grid.x >= MAX_X_REGION)) {
+		return -1;
 	}
+	return grid.y * MAX_X_REGION + grid.x;
+}
 
-	/* Check below */
-	if (gen_loc_cmp(gen_loc_list[*below], gen_loc) == 0) {
-		*above = *below;
-		return true;
-	}
+/**
+ * Find the slot for a square mile in the river miles table
+ */
+static uint32_t square_mile_rivers_slot(uint32_t key)
+{
+	uint32_t slot = key * 0x9E3779B1U;
 
-	/* Check above */
-	if (gen_loc_cmp(gen_loc_list[*above], gen_loc) == 0) {
-		*below = *above;
-		return true;
+	slot ^= slot >> 15;
+	slot &= square_mile_rivers_size - 1;
+	while (square_mile_rivers[slot].key &&
+		   (square_mile_rivers[slot].key != key)) {
+		slot = (slot + 1) & (square_mile_rivers_size - 1);
 	}
+	return slot;
+}
 
-	/* Needs to go after the last element */
-	if (gen_loc_cmp(gen_loc_list[*above], gen_loc) == -1) {
-		*above = gen_loc_cnt;
-		return false;
-	}
+/**
+ * Make the square miles for the whole map, all of them ocean with no region
+ */
+void square_miles_init(void)
+{
+	size_t count = MAX_Y_REGION * MAX_X_REGION;
+
+	square_miles_cleanup();
+	square_mile_biomes = mem_alloc(count);
+	memset(square_mile_biomes, BIOME_OCEAN, count);
+	square_mile_regions = mem_zalloc(count * sizeof(uint16_t));
+	square_mile_mapped = mem_zalloc((count + 7) / 8);
+	square_mile_rivers_size = 256;
+	square_mile_rivers_cnt = 0;
+	square_mile_rivers = mem_zalloc(square_mile_rivers_size *
+									sizeof(*square_mile_rivers));
+}
 
-	/* Needs to go before the first element */
-	if (gen_loc_cmp(gen_loc_list[*below], gen_loc) == 1) {
-		*above = 0;
-		return false;
-	}
+/**
+ * Free the square miles
+ */
+void square_miles_cleanup(void)
+{
+	mem_free(square_mile_biomes);
+	square_mile_biomes = NULL;
+	mem_free(square_mile_regions);
+	square_mile_regions = NULL;
+	mem_free(square_mile_mapped);
+	square_mile_mapped = NULL;
+	mem_free(square_mile_rivers);
+	square_mile_rivers = NULL;
+	square_mile_rivers_size = 0;
+	square_mile_rivers_cnt = 0;
+}
 
-	/* Needs to go between above and below */
-	return false;
+/**
+ * Write the biomes and regions of all the square miles to a file
+ */
+bool square_miles_write(ang_file *f)
+{
+	size_t count = MAX_Y_REGION * MAX_X_REGION;
 
+	return file_write(f, (const char *) square_mile_biomes, count) &&
+		file_write(f, (const char *) square_mile_regions,
+				   count * sizeof(uint16_t));
 }
 
 /**
- * Enter a given generation location in the list at the given spot
+ * Read the biomes and regions of all the square miles straight from a file
+ * written by square_miles_write()
  */
-void gen_loc_make(int x_pos, int y_pos, int z_pos, int idx)
+bool square_miles_read(ang_file *f)
 {
-	int i;
+	size_t count = MAX_Y_REGION * MAX_X_REGION;
 
-	/* Increase the count, extend the array if necessary */
-	gen_loc_cnt++;
-	if ((gen_loc_cnt % GEN_LOC_INCR) == 0) {
-		gen_loc_max += GEN_LOC_INCR;
-		gen_loc_list = mem_realloc(gen_loc_list,
-								   gen_loc_max * sizeof(struct gen_loc));
-		for (i = gen_loc_max - GEN_LOC_INCR; i < (int) gen_loc_max; i++) {
-			memset(&gen_loc_list[i], 0, sizeof(struct gen_loc));
-		}
-	}
+	return (file_read(f, (char *) square_mile_biomes, count) == (int) count) &&
+		(file_read(f, (char *) square_mile_regions, count * sizeof(uint16_t))
+		 == (int) (count * sizeof(uint16_t)));
+}
+
+/**
+ * Get the map grid of a square mile from its map square and its position in
+ * that map square
+ */
+struct loc square_mile_grid(wchar_t letter, int number, int y, int x)
+{
+	int letter_trans = letter > L'I' ? letter - L'B' : letter - L'A';
+	return loc(MPS * (number - 1) + x, MPS * letter_trans + y);
+}
+
+/**
+ * Get a view of the square mile at the given map grid
+ */
+struct square_mile square_mile(struct loc grid)
+{
+	struct square_mile sq_mile;
+	int idx = square_mile_idx(grid);
+	char letter = 'A' + grid.y / MPS;
+
+	assert(idx >= 0);
+	if (letter >= 'I') letter++;
+	sq_mile.biome = square_mile_biomes[idx];
+	sq_mile.region = square_mile_regions[idx] ?
+		&region_info[square_mile_regions[idx]] : NULL;
+	sq_mile.map_square.letter = letter;
+	sq_mile.map_square.number = grid.x / MPS + 1;
+	sq_mile.map_square_grid = loc(grid.x % MPS, grid.y % MPS);
+	sq_mile.map_grid = grid;
+	sq_mile.river_miles = square_mile_river_miles(grid);
+	sq_mile.mapped = square_mile_is_mapped(grid);
+	return sq_mile;
+}
+
+/**
+ * Get the biome of the square mile at the given map grid; off the map is
+ * ocean
+ */
+enum biome_type square_mile_biome(struct loc grid)
+{
+	int idx = square_mile_idx(grid);
+	return idx < 0 ? BIOME_OCEAN : square_mile_biomes[idx];
+}
+
+/**
+ * Get the index in region_info of the region of the square mile at the given
+ * map grid, or 0 if it has none
+ */
+int square_mile_region(struct loc grid)
+{
+	int idx = square_mile_idx(grid);
+	return idx < 0 ? 0 : square_mile_regions[idx];
+}
+
+/**
+ * Set the biome and region of the square mile at the given map grid
+ */
+void square_mile_set_terrain(struct loc grid, enum biome_type biome,
+							 int region)
+{
+	int idx = square_mile_idx(grid);
+
+	assert(idx >= 0);
+	square_mile_biomes[idx] = biome;
+	square_mile_regions[idx] = region;
+}
 
-	/* Move everything along one to make space */
-	for (i = gen_loc_cnt; i > idx; i--)
-		memcpy(&gen_loc_list[i], &gen_loc_list[i - 1], sizeof(struct gen_loc));
+/**
+ * Get the river miles in the square mile at the given map grid
+ */
+struct river_mile *square_mile_river_miles(struct loc grid)
+{
+	int idx = square_mile_idx(grid);
+	uint32_t slot;
 
-	/* Relabel any live chunks */
-	for (i = 0; i < MAX_CHUNKS; i++) {
-		if ((int) chunk_list[i].gen_loc_idx >= idx) {
-			chunk_list[i].gen_loc_idx++;
+	if (idx < 0) return NULL;
+	slot = square_mile_rivers_slot(idx + 1);
+	return square_mile_rivers[slot].river_miles;
+}
+
+/**
+ * Set the river miles in the square mile at the given map grid
+ */
+void square_mile_set_river_miles(struct loc grid,
+								 struct river_mile *river_miles)
+{
+	int idx = square_mile_idx(grid);
+	uint32_t slot;
+
+	assert(idx >= 0);
+	slot = square_mile_rivers_slot(idx + 1);
+	if (!square_mile_rivers[slot].key) {
+		/* Grow the table if it is getting full */
+		if (2 * (square_mile_rivers_cnt + 1) > square_mile_rivers_size) {
+			struct square_mile_rivers *old = square_mile_rivers;
+			uint32_t i, old_size = square_mile_rivers_size;
+
+			square_mile_rivers_size *= 2;
+			square_mile_rivers = mem_zalloc(square_mile_rivers_size *
+											sizeof(*square_mile_rivers));
+			for (i = 0; i < old_size; i++) {
+				if (old[i].key) {
+					square_mile_rivers[square_mile_rivers_slot(old[i].key)] =
+						old[i];
+				}
+			}
+			mem_free(old);
+			slot = square_mile_rivers_slot(idx + 1);
 		}
+		square_mile_rivers[slot].key = idx + 1;
+		square_mile_rivers_cnt++;
 	}
+	square_mile_rivers[slot].river_miles = river_miles;
+}
 
-	/* Copy the new data in */
-	gen_loc_list[idx].type = square_miles[y_pos / CPM][x_pos / CPM].biome;
-	gen_loc_list[idx].x_pos = x_pos;
-	gen_loc_list[idx].y_pos = y_pos;
-	gen_loc_list[idx].z_pos = z_pos;
-	gen_loc_list[idx].seed = 0;
-	gen_loc_list[idx].change = NULL;
-	gen_loc_list[idx].join = NULL;
-	gen_loc_list[idx].river_piece = NULL;
-	gen_loc_list[idx].road_edge = NULL;
+/**
+ * Check whether the rivers and roads of the square mile at the given map grid
+ * have been plotted
+ */
+bool square_mile_is_mapped(struct loc grid)
+{
+	int idx = square_mile_idx(grid);
+	return idx >= 0 && (square_mile_mapped[idx / 8] & (1 << (idx % 8)));
 }
 
-struct square_mile *square_mile(wchar_t letter, int number, int y, int x)
+/**
+ * Note that the rivers and roads of the square mile at the given map grid
+ * have been plotted
+ */
+void square_mile_set_mapped(struct loc grid)
 {
-	int letter_trans = letter > L'I' ? letter - L'B' : letter - L'A';
-	return &square_miles[MPS * letter_trans + y][MPS * (number - 1) + x];
+	int idx = square_mile_idx(grid);
+
+	assert(idx >= 0);
+	square_mile_mapped[idx / 8] |= 1 << (idx % 8);
 }
 
 /**
@@ -414,6 +673,25 @@ int regen_amount(int turn_number, int max, int period)
 	return regen_next - regen_so_far;
 }
 
+/**
+ * The total of regen_amount() over the turn numbers from 'from' up to but not
+ * including 'to', worked out directly; the amounts up to a turn number n add
+ * up to max * (n / period) + (max * (n % period)) / period.
+ */
+int regen_amount_over(int from, int to, int max, int period)
+{
+	int64_t total;
+
+	/* Nothing is regenerated on the first turn of the game */
+	if (from < 1) from = 1;
+	if (to <= from) return 0;
+
+	total = (int64_t) max * ((to - 1) / period - (from - 1) / period) +
+		(max * ((to - 1) % period)) / period -
+		(max * ((from - 1) % period)) / period;
+	return (int) MIN(total, INT32_MAX);
+}
+
 /**
  * Represents the different levels of health.
  * Note that it is a bit odd with fewer health levels in the SOMEWHAT_WOUNDED
@@ -466,8 +744,9 @@ void play_ambient_sound(void)
 
 /**
  * Helper for process_world -- decrement player->timed[] and curse effect fields
+ * for num player turns
  */
-static void decrease_timeouts(void)
+static void decrease_timeouts(int num)
 {
 	int i;
 
@@ -479,11 +758,54 @@ static void decrease_timeouts(void)
 			continue;
 
 		/* Decrement the effect */
-		player_dec_timed(player, i, decr, false, true);
+		player_dec_timed(player, i, decr * num, false, true);
 	}
 }
 
 
+/**
+ * Get the additional cost to a monster's flow of a grid it has the given
+ * chance of entering
+ */
+static int monster_flow_cost(struct chunk *c, struct loc grid,
+							 struct monster *mon, int chance, bool bash)
+{
+	int cost = 0;
+
+	/* If there is no chance, just skip this square */
+	if (chance <= 0) return -1;
+
+	/* Convert the chance to a number of turns */
+	cost += (100 / chance) - 1;
+
+	/* Add an extra turn for unlocking/opening doors as
+	 * this action doesn't move the monster */
+	if (square_iscloseddoor(c, grid)) {
+		if (!(bash ||
+				rf_has(mon->race->flags, RF_PASS_DOOR) ||
+				rf_has(mon->race->flags, RF_PASS_WALL))) {
+			cost += 1;
+		}
+	} else if (square_isdiggable(c, grid) &&
+			rf_has(mon->race->flags, RF_TUNNEL_WALL)) {
+		/* Add extra turn(s) for tunneling through rubble/walls as
+		 * this action doesn't move the monster */
+		if (square_isrubble(c, grid)) {
+			/* An extra turn to dig through */
+			cost += 1;
+		} else {
+			/* Two extra turns to dig through granite/quartz */
+			cost += 2;
+		}
+	} else if (square_iswall(c, grid) &&
+			   rf_has(mon->race->flags, RF_KILL_WALL)) {
+		/* Pretend it would take an extra turn (to prefer routes
+		 * with less wall destruction */
+		cost += 1; 
+	}
+	return cost;
+}
+
 /**
  * Get the additional cost to monster or noise flow due to terrain
  */
@@ -499,39 +821,7 @@ static int square_flow_cost(struct chunk *c, struct loc grid,
 		 * to move onto that square */
 		int chance = monster_entry_chance(c, mon, grid, &bash);
 
-		/* If there is any chance, then convert it to a number of turns */
-		if (chance > 0) {
-			cost += (100 / chance) - 1;
-
-			/* Add an extra turn for unlocking/opening doors as
-			 * this action doesn't move the monster */
-			if (square_iscloseddoor(c, grid)) {
-				if (!(bash ||
-						rf_has(mon->race->flags, RF_PASS_DOOR) ||
-						rf_has(mon->race->flags, RF_PASS_WALL))) {
-					cost += 1;
-				}
-			} else if (square_isdiggable(c, grid) &&
-					rf_has(mon->race->flags, RF_TUNNEL_WALL)) {
-				/* Add extra turn(s) for tunneling through rubble/walls as
-				 * this action doesn't move the monster */
-				if (square_isrubble(c, grid)) {
-					/* An extra turn to dig through */
-					cost += 1;
-				} else {
-					/* Two extra turns to dig through granite/quartz */
-					cost += 2;
-				}
-			} else if (square_iswall(c, grid) &&
-					   rf_has(mon->race->flags, RF_KILL_WALL)) {
-				/* Pretend it would take an extra turn (to prefer routes
-				 * with less wall destruction */
-				cost += 1; 
-			}
-		} else {
-			/* If there is no chance, just skip this square */
-			return -1;
-		}
+		return monster_flow_cost(c, grid, mon, chance, bash);
 	} else {
 		/* Deal with noise flows */
 		/* Ignore walls */
@@ -570,6 +860,398 @@ static void i_to_grid(int i, int w, struct loc *grid)
 	grid->x = i % w;
 }
 
+/**
+ * Grid indices waiting to be expanded in a flow calculation, bucketed by the
+ * value at which they expand.  The buffers are kept between calls.
+ */
+static struct {
+	int *head;		/**< First grid in each bucket, -1 if empty */
+	int *next;		/**< Next grid in the same bucket */
+	int buckets;	/**< Number of buckets */
+	int grids;		/**< Number of grids there is room for */
+} flow_queue;
+
+/**
+ * Make sure the flow queue has room for a chunk and the current flow_max
+ */
+static void flow_queue_reserve(int grids, int buckets)
+{
+	if (grids > flow_queue.grids) {
+		flow_queue.next = mem_realloc(flow_queue.next, grids * sizeof(int));
+		flow_queue.grids = grids;
+	}
+	if (buckets > flow_queue.buckets) {
+		flow_queue.head = mem_realloc(flow_queue.head, buckets * sizeof(int));
+		flow_queue.buckets = buckets;
+	}
+}
+
+/**
+ * Free the flow queue
+ */
+void flow_queue_free(void)
+{
+	mem_free(flow_queue.head);
+	mem_free(flow_queue.next);
+	memset(&flow_queue, 0, sizeof(flow_queue));
+}
+
+/**
+ * Check whether a grid was reached by the last calculation of a flow, so
+ * that a monster there would have had its target reset
+ */
+static bool flow_reached(struct chunk *c, struct flow *flow, struct loc grid)
+{
+	int d;
+
+	/* The centre and the edges are never reached */
+	if (loc_eq(grid, flow->centre) || !square_in_bounds_fully(c, grid)) {
+		return false;
+	}
+
+	/* Interior grids not at the maximum were reached */
+	if (flow->grids[grid.y][grid.x] != z_info->flow_max) return true;
+
+	/* Otherwise the grid must be passable with a neighbour that expanded */
+	if (square_flow_cost(c, grid, NULL) < 0) return false;
+	for (d = 0; d < 8; d++) {
+		struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+		int value, cost;
+
+		if (loc_eq(adj, flow->centre)) return true;
+		if (!square_in_bounds_fully(c, adj)) continue;
+		value = flow->grids[adj.y][adj.x];
+		if (value >= z_info->flow_max) continue;
+		cost = square_flow_cost(c, adj, NULL);
+		if (value - cost + MAX(cost, 1) < z_info->flow_max) return true;
+	}
+	return false;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Monster flows shared by monsters which move alike
+ * ------------------------------------------------------------------------ */
+/**
+ * Number of cost layers, and of flows, kept for each live chunk
+ */
+#define FLOW_CACHE_SIZE 8
+
+/**
+ * Cost layer value for a grid whose cost hasn't been worked out
+ */
+#define FLOW_COST_UNKNOWN -2
+
+struct flow_cache_stats flow_cache_stats;
+
+/**
+ * Race flags which change the cost of terrain to a monster
+ */
+static const int flow_sig_flags[] = {
+	RF_FLYING,
+	RF_PASS_WALL,
+	RF_KILL_WALL,
+	RF_TUNNEL_WALL,
+	RF_PASS_DOOR,
+	RF_OPEN_DOOR,
+	RF_UNLOCK_DOOR,
+	RF_BASH_DOOR
+};
+
+/**
+ * Cost to monsters with a given signature of each grid if it were empty
+ */
+struct flow_costs {
+	struct flow_sig sig;
+	uint32_t terrain;	/**< Terrain stamp the costs were found for */
+	uint32_t used;		/**< When the layer was last used */
+	int8_t *cost;		/**< Cost of each grid, or FLOW_COST_UNKNOWN */
+};
+
+/**
+ * An occupied grid whose cost was used in calculating a shared flow
+ */
+struct flow_occupant {
+	int grid;
+	int cost;
+};
+
+/**
+ * A flow calculated for one monster, which may be given to any other with
+ * the same signature while the grids it depends on are unchanged
+ */
+struct flow_shared {
+	struct flow_sig sig;
+	struct loc centre;	/**< Centre of the flow, (0, 0) if unused */
+	uint32_t terrain;	/**< Terrain stamp the flow was calculated for */
+	uint32_t used;		/**< When the flow was last used */
+	uint16_t *grids;	/**< Flow values */
+	uint8_t *touched;	/**< Grids whose cost was used in the calculation */
+	struct flow_occupant *occupants;	/**< Occupied touched grids */
+	int num_occupants;
+	int max_occupants;
+};
+
+struct flow_cache {
+	struct flow_costs costs[FLOW_CACHE_SIZE];
+	struct flow_shared flows[FLOW_CACHE_SIZE];
+	uint32_t clock;
+};
+
+/**
+ * Work out the signature of a monster
+ */
+void flow_sig_get(struct monster *mon, struct flow_sig *sig)
+{
+	size_t i;
+
+	sig->moves = 0;
+	for (i = 0; i < N_ELEMENTS(flow_sig_flags); i++) {
+		if (rf_has(mon->race->flags, flow_sig_flags[i])) {
+			sig->moves |= 1 << i;
+		}
+	}
+	sig->alert = mon->alertness >= ALERTNESS_ALERT;
+	sig->will = sig->alert ? monster_skill(mon, SKILL_WILL) : 0;
+	sig->perception = rf_has(mon->race->flags, RF_OPEN_DOOR) &&
+		rf_has(mon->race->flags, RF_UNLOCK_DOOR) ?
+		monster_skill(mon, SKILL_PERCEPTION) : 0;
+	sig->strength = rf_has(mon->race->flags, RF_BASH_DOOR) ?
+		monster_stat(mon, STAT_STR) : 0;
+}
+
+/**
+ * Check whether two monsters with these signatures move alike
+ */
+bool flow_sig_eq(const struct flow_sig *sig1, const struct flow_sig *sig2)
+{
+	return (sig1->moves == sig2->moves) && (sig1->alert == sig2->alert) &&
+		(sig1->will == sig2->will) && (sig1->perception == sig2->perception) &&
+		(sig1->strength == sig2->strength);
+}
+
+/**
+ * Free the shared flows and costs of a chunk
+ */
+void flow_cache_free(struct chunk *c)
+{
+	int i;
+
+	if (!c->flow_cache) return;
+	for (i = 0; i < FLOW_CACHE_SIZE; i++) {
+		mem_free(c->flow_cache->costs[i].cost);
+		mem_free(c->flow_cache->flows[i].grids);
+		mem_free(c->flow_cache->flows[i].touched);
+		mem_free(c->flow_cache->flows[i].occupants);
+	}
+	mem_free(c->flow_cache);
+	c->flow_cache = NULL;
+}
+
+/**
+ * Get the cost layer for a signature, making it if need be; the costs are
+ * forgotten whenever the terrain changes
+ */
+static struct flow_costs *flow_costs_get(struct chunk *c,
+										 const struct flow_sig *sig)
+{
+	struct flow_cache *cache = c->flow_cache;
+	struct flow_costs *layer = &cache->costs[0];
+	int i;
+
+	for (i = 0; i < FLOW_CACHE_SIZE; i++) {
+		struct flow_costs *costs = &cache->costs[i];
+		if (costs->cost && flow_sig_eq(&costs->sig, sig)) {
+			layer = costs;
+			break;
+		}
+		if (!costs->cost || (layer->cost && (costs->used < layer->used))) {
+			layer = costs;
+		}
+	}
+	if (!layer->cost) {
+		layer->cost = mem_alloc(c->height * c->width);
+		layer->terrain = c->terrain_stamp + 1;
+	}
+	if (!flow_sig_eq(&layer->sig, sig) ||
+		(layer->terrain != c->terrain_stamp)) {
+		layer->sig = *sig;
+		layer->terrain = c->terrain_stamp;
+		memset(layer->cost, FLOW_COST_UNKNOWN, c->height * c->width);
+	}
+	layer->used = ++cache->clock;
+	return layer;
+}
+
+/**
+ * Get the cost to a monster of a grid if it were empty, from its cost layer
+ */
+static int flow_layer_cost(struct chunk *c, struct loc grid,
+						   struct monster *mon, struct flow_costs *layer)
+{
+	int i = grid_to_i(grid, c->width);
+
+	if (layer->cost[i] == FLOW_COST_UNKNOWN) {
+		bool bash = false;
+		int chance = monster_terrain_chance(c, mon, grid, &bash);
+		layer->cost[i] = monster_flow_cost(c, grid, mon, chance, bash);
+	}
+	return layer->cost[i];
+}
+
+/**
+ * Get the cost of a grid to a monster, using the cost layer if the grid is
+ * empty and the monster has one
+ */
+static int flow_grid_cost(struct chunk *c, struct loc grid,
+						  struct monster *mon, struct flow_costs *layer)
+{
+	if (!layer || square(c, grid)->mon) {
+		return square_flow_cost(c, grid, mon);
+	}
+	return flow_layer_cost(c, grid, mon, layer);
+}
+
+/**
+ * Get the shared flow for a signature and centre, or the one to replace
+ * with it
+ */
+static struct flow_shared *flow_shared_get(struct chunk *c,
+										   const struct flow_sig *sig,
+										   struct loc centre)
+{
+	struct flow_cache *cache = c->flow_cache;
+	struct flow_shared *shared = &cache->flows[0];
+	int i;
+
+	for (i = 0; i < FLOW_CACHE_SIZE; i++) {
+		struct flow_shared *flow = &cache->flows[i];
+		if (flow->grids && flow_sig_eq(&flow->sig, sig) &&
+			loc_eq(flow->centre, centre)) {
+			shared = flow;
+			break;
+		}
+		if (!flow->grids || (shared->grids && (flow->used < shared->used))) {
+			shared = flow;
+		}
+	}
+	if (!shared->grids) {
+		shared->grids = mem_alloc(c->height * c->width * sizeof(uint16_t));
+		shared->touched = mem_alloc(c->height * c->width);
+		shared->centre = loc(0, 0);
+	}
+	shared->used = ++cache->clock;
+	return shared;
+}
+
+/**
+ * Note that the cost of a grid was used in calculating a shared flow
+ */
+static void flow_shared_touch(struct chunk *c, struct flow_shared *shared,
+							  struct loc grid, int cost)
+{
+	int i = grid_to_i(grid, c->width);
+	struct flow_occupant *occupant;
+
+	if (shared->touched[i]) return;
+	shared->touched[i] = 1;
+	if (!square(c, grid)->mon) return;
+	if (shared->num_occupants == shared->max_occupants) {
+		shared->max_occupants += 16;
+		shared->occupants = mem_realloc(shared->occupants,
+			shared->max_occupants * sizeof(*shared->occupants));
+	}
+	occupant = &shared->occupants[shared->num_occupants++];
+	occupant->grid = i;
+	occupant->cost = cost;
+}
+
+/**
+ * Check whether an occupied grid has a different cost to a monster from the
+ * one used in calculating a shared flow
+ */
+static bool flow_shared_changed(struct chunk *c, struct flow_shared *shared,
+								struct monster *mon, struct flow_costs *layer,
+								struct loc grid)
+{
+	int i = grid_to_i(grid, c->width), j;
+
+	/* Grids the flow never reached don't matter */
+	if (!shared->touched[i]) return false;
+
+	/* Compare with the grid's occupant at the time, if any */
+	for (j = 0; j < shared->num_occupants; j++) {
+		if (shared->occupants[j].grid == i) {
+			return square_flow_cost(c, grid, mon) != shared->occupants[j].cost;
+		}
+	}
+	return square_flow_cost(c, grid, mon) != flow_layer_cost(c, grid, mon,
+															 layer);
+}
+
+/**
+ * Check whether a shared flow is right for a monster with its signature,
+ * which it is if no grid whose cost was used has changed cost since; only
+ * occupied grids can have, as the terrain hasn't changed
+ */
+static bool flow_shared_valid(struct chunk *c, struct flow_shared *shared,
+							  struct monster *mon, struct flow_costs *layer)
+{
+	int i;
+
+	/* Grids which have been vacated */
+	for (i = 0; i < shared->num_occupants; i++) {
+		struct flow_occupant *occupant = &shared->occupants[i];
+		struct loc grid;
+
+		i_to_grid(occupant->grid, c->width, &grid);
+		if (square(c, grid)->mon) continue;
+		if (flow_layer_cost(c, grid, mon, layer) != occupant->cost) {
+			return false;
+		}
+	}
+
+	/* Grids which are occupied now */
+	if (square_in_bounds(c, player->grid) &&
+		(square(c, player->grid)->mon < 0) &&
+		flow_shared_changed(c, shared, mon, layer, player->grid)) {
+		return false;
+	}
+	for (i = 1; i < mon_max; i++) {
+		struct monster *grid_mon = monster(i);
+		if (!grid_mon->race) continue;
+		if (square(c, grid_mon->grid)->mon != i) continue;
+		if (flow_shared_changed(c, shared, mon, layer, grid_mon->grid)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Give a monster a shared flow, resetting the targets of monsters the flow
+ * reaches just as calculating it would
+ */
+static void flow_shared_use(struct chunk *c, struct flow_shared *shared,
+							struct flow *flow, struct monster *mon,
+							struct flow_costs *layer)
+{
+	int i;
+
+	memcpy(flow->grids[0], shared->grids,
+		   c->height * c->width * sizeof(uint16_t));
+	for (i = 1; i < mon_max; i++) {
+		struct monster *grid_mon = monster(i);
+		struct loc grid = grid_mon->grid;
+
+		if (!grid_mon->race) continue;
+		if (square(c, grid)->mon != i) continue;
+		if (!shared->touched[grid_to_i(grid, c->width)]) continue;
+		if (flow_grid_cost(c, grid, mon, layer) < 0) continue;
+		grid_mon->target.grid = loc(0, 0);
+	}
+}
+
 /**
  * Sil needs various 'flows', which are arrays of the same size as the map,
  * with a number for each map square.
@@ -586,13 +1268,74 @@ static void i_to_grid(int i, int w, struct loc *grid)
  *
  * Note that the noise is generated around the centre.
  * This is often the player, but can be a monster (for FLOW_MONSTER_NOISE)
+ *
+ * The flow spreads out from the centre one value at a time.  A grid reached
+ * while expanding value v is given v plus its extra cost, and expands in turn
+ * at v plus the larger of its extra cost and 1; grids waiting to expand are
+ * kept in buckets by that value.  Noise flows depend only on the centre and
+ * the terrain, so if neither has changed since the last calculation the
+ * values are kept, and only the monsters in range are told to re-consider
+ * their targets.
+ *
+ * Monster flows are kept per chunk by the monster's signature (its movement
+ * abilities, alertness and relevant skills).  The cost of empty grids to a
+ * signature is only worked out once for each state of the terrain, and a
+ * flow is handed on to another monster with the same signature and centre
+ * as long as no occupied grid it depends on has changed its cost.
  */
 void update_flow(struct chunk *c, struct flow *flow, struct monster *mon)
 {
 	struct loc next = flow->centre;
-	int y, x, d;
-	int value = 0;
-	struct queue *queue = q_new(c->height * c->width);
+	struct flow_costs *layer = NULL;
+	struct flow_shared *shared = NULL;
+	int y, x, d, i;
+	int value;
+	int *head, *bucket_next;
+
+	if (loc_eq(next, loc(0, 0))) {
+		quit("Flow has no centre!");
+	}
+
+	/* Reuse an unchanged noise flow */
+	if (!mon && loc_eq(next, flow->last_centre) &&
+		(flow->terrain == c->terrain_stamp)) {
+		for (i = 1; i < mon_max; i++) {
+			struct monster *grid_mon = monster(i);
+			if (!grid_mon->race) continue;
+			if (square_monster(c, grid_mon->grid) != grid_mon) continue;
+			if (flow_reached(c, flow, grid_mon->grid)) {
+				grid_mon->target.grid = loc(0, 0);
+			}
+		}
+		return;
+	}
+	flow->last_centre = mon ? loc(0, 0) : next;
+	flow->terrain = c->terrain_stamp;
+
+	/* Use or replace a flow shared by monsters which move alike */
+	if (mon) {
+		struct flow_sig sig;
+
+		if (!c->flow_cache) {
+			c->flow_cache = mem_zalloc(sizeof(*c->flow_cache));
+		}
+		flow_sig_get(mon, &sig);
+		layer = flow_costs_get(c, &sig);
+		shared = flow_shared_get(c, &sig, next);
+		if (loc_eq(shared->centre, next) &&
+			(shared->terrain == c->terrain_stamp) &&
+			flow_shared_valid(c, shared, mon, layer)) {
+			flow_shared_use(c, shared, flow, mon, layer);
+			flow_cache_stats.shared++;
+			return;
+		}
+		shared->sig = sig;
+		shared->centre = next;
+		shared->terrain = c->terrain_stamp;
+		shared->num_occupants = 0;
+		memset(shared->touched, 0, c->height * c->width);
+		flow_cache_stats.calculated++;
+	}
 
 	/* Set all the grids to maximum */
 	for (y = 1; y < c->height - 1; y++) {
@@ -601,36 +1344,30 @@ void update_flow(struct chunk *c, struct flow *flow, struct monster *mon)
 		}
 	}
 
-	if (loc_eq(next, loc(0, 0))) {
-		quit("Flow has no centre!");
+	/* Empty the buckets */
+	flow_queue_reserve(c->height * c->width, z_info->flow_max + 1);
+	head = flow_queue.head;
+	bucket_next = flow_queue.next;
+	for (i = 0; i <= z_info->flow_max; i++) {
+		head[i] = -1;
 	}
 
-	/* Set the centre value to zero, push it onto the queue */
+	/* Set the centre value to zero, and expand it first */
 	flow->grids[next.y][next.x] = 0;
-	q_push_int(queue, grid_to_i(next, c->width));
-	value++;
+	head[1] = grid_to_i(next, c->width);
+	bucket_next[head[1]] = -1;
 
 	/* Propagate outwards */
-	while ((q_len(queue) > 0) && (value < z_info->flow_max)) {
-		/* Process only the grids currently on the queue */
-		int count = q_len(queue);
-		while (count) {
-			/* Get the next grid, count it */
-			i_to_grid(q_pop_int(queue), c->width, &next);
-			count--;
-
-			/* If it costs more the current value, put it back on the queue */
-			if (flow->grids[next.y][next.x] > value) {
-				q_push_int(queue, grid_to_i(next, c->width));
-				continue;
-			}
+	for (value = 1; value < z_info->flow_max; value++) {
+		for (i = head[value]; i >= 0; i = bucket_next[i]) {
+			i_to_grid(i, c->width, &next);
 
 			/* Iterate over the current grid's children */
 			for (d = 0; d < 8; d++)	{
 				/* Child location */
 				struct loc grid = loc_sum(next, ddgrid_ddd[d]);
 				struct monster *grid_mon;
-				int cost;
+				int cost, expand;
 
 				/* Legal grids only */
 				if (!square_in_bounds(c, grid)) continue;
@@ -639,7 +1376,10 @@ void update_flow(struct chunk *c, struct flow *flow, struct monster *mon)
 				if (flow->grids[grid.y][grid.x] < z_info->flow_max) continue;
 
 				/* Extra cost of the grid */
-				cost = square_flow_cost(c, grid, mon);
+				cost = flow_grid_cost(c, grid, mon, layer);
+				if (shared) {
+					flow_shared_touch(c, shared, grid, cost);
+				}
 
 				/* Ignore features that block flow */
 				if (cost < 0) continue;
@@ -647,8 +1387,13 @@ void update_flow(struct chunk *c, struct flow *flow, struct monster *mon)
 				/* Save the flow value */
 				flow->grids[grid.y][grid.x] = value + cost;
 
-				/* Enqueue that child */
-				q_push_int(queue, grid_to_i(grid, c->width));
+				/* Put the child in the bucket for when it expands */
+				expand = value + MAX(cost, 1);
+				if (expand < z_info->flow_max) {
+					int child = grid_to_i(grid, c->width);
+					bucket_next[child] = head[expand];
+					head[expand] = child;
+				}
 
 				/* Monster on this grid */
 				grid_mon = square_monster(c, grid);
@@ -659,10 +1404,13 @@ void update_flow(struct chunk *c, struct flow *flow, struct monster *mon)
 				}
 			}
 		}
-		value++;
 	}
 
-	q_free(queue);
+	/* Keep the flow for sharing */
+	if (shared) {
+		memcpy(shared->grids, flow->grids[0],
+			   c->height * c->width * sizeof(uint16_t));
+	}
 }
 
 /**
@@ -854,6 +1602,11 @@ void process_world(struct chunk *c)
 
 	/* Process light */
 	player_update_light(player);
+
+	/* Get the way ahead ready in case the player crosses into it */
+	if (outside() && !in_tutorial()) {
+		chunk_pregenerate(player);
+	}
 }
 
 
@@ -1061,23 +1814,23 @@ static void process_player_post_energy_use_cleanup(void)
 	/*** Check the Food, and Regenerate ***/
 
 	/* Digest */
-	player_digest(player);
+	player_digest(player, 1);
 	if (player->is_dead) {
 		return;
 	}
 
 	/* Regenerate Hit Points if needed */
 	if (player->chp < player->mhp) {
-		player_regen_hp(player);
+		player_regen_hp(player, 1);
 	}
 
 	/* Regenerate voice if needed */
 	if (player->csp < player->msp) {
-		player_regen_mana(player);
+		player_regen_mana(player, 1);
 	}
 
 	/* Timeout various things */
-	decrease_timeouts();
+	decrease_timeouts(1);
 
 	/* Notice things after time */
 	if (!(turn % 100))
@@ -1264,6 +2017,235 @@ static void on_leave_level(void) {
 }
 
 
+/**
+ * Skip over game turns on which nothing would happen.
+ *
+ * Monsters are given their energy when they next need it, so a game turn
+ * with no monster due to move, no world processing and no move for the
+ * character does nothing but give the character energy.  Resting through
+ * such turns one at a time is most of the cost of a long rest.
+ */
+static void skip_idle_turns(void)
+{
+	int gain = turn_energy(player->state.speed);
+	int need = z_info->move_energy - player->energy;
+	int32_t skip;
+
+	/* Time is stopped one turn at a time */
+	if (!skip_idle || OPT(player, cheat_timestop) || (gain <= 0) ||
+		(need <= 0)) {
+		return;
+	}
+
+	/* Stop before the world is processed, or a monster or the player moves */
+	skip = (turn % 10) ? 10 - (turn % 10) : 0;
+	skip = MIN(skip, monster_next_turn() - turn);
+	skip = MIN(skip, (need - 1) / gain);
+	if (skip <= 0) return;
+
+	player->energy += skip * gain;
+	turn += skip;
+}
+
+/**
+ * The most player turns of resting passed over at once; interruptions are
+ * checked for between batches
+ */
+#define REST_BATCH_TURNS 100
+
+/**
+ * How many player turns a timed effect can go down by decr a turn without
+ * changing grade or running out
+ */
+static int timed_turns_in_grade(int idx, int decr)
+{
+	struct timed_grade *grade = timed_effects[idx].grade;
+	int lower = 1;
+
+	/* Effects without grades may say something on any turn */
+	if (!grade) return 0;
+	if (decr <= 0) return REST_BATCH_TURNS;
+	while ((player->timed[idx] > grade->max) && grade->next) {
+		lower = grade->max + 1;
+		grade = grade->next;
+	}
+	return (player->timed[idx] - lower) / decr;
+}
+
+/**
+ * How many player turns, up to limit, it takes regeneration of amount() a
+ * turn to bring cur up to max
+ */
+static int rest_turns_to_fill(int cur, int max,
+							  int (*amount)(struct player *p, int num),
+							  int limit)
+{
+	int low = 0, high = limit;
+
+	if (cur + amount(player, limit) < max) return limit;
+	while (low < high) {
+		int mid = (low + high) / 2;
+
+		if (cur + amount(player, mid) >= max) {
+			high = mid;
+		} else {
+			low = mid + 1;
+		}
+	}
+	return low;
+}
+
+/**
+ * Work out how many player turns of the current rest can be passed over at
+ * once, or 0 if anything might happen on the next one
+ */
+static int rest_batch_turns(void)
+{
+	struct command *cmd = cmdq_peek();
+	int16_t resting = player_resting_count(player);
+	int i, hp, sp, rate, num = REST_BATCH_TURNS;
+
+	/* Only resting until healed, after the first turn of it */
+	if (!skip_rest || OPT(player, cheat_timestop)) return 0;
+	if ((resting != REST_ALL_POINTS) && (resting != REST_SOME_POINTS) &&
+		(resting != REST_COMPLETE)) {
+		return 0;
+	}
+	if (!cmd || (cmd->code != CMD_REST) ||
+		(player->previous_action[0] != ACTION_STAND)) {
+		return 0;
+	}
+
+	/* Nothing the player is doing or suffering may change turn by turn */
+	if (player->song[SONG_MAIN] || player->wrath || player->mount ||
+		player->upkeep->smithing || player->upkeep->knocked_back ||
+		(player->stealth_mode == STEALTH_MODE_STOPPING) ||
+		player->attacked || player->been_attacked || (player->turn <= 1)) {
+		return 0;
+	}
+	if (player->timed[TMD_ENTRANCED] || player->timed[TMD_POISONED] ||
+		player->timed[TMD_CUT] ||
+		player_timed_grade_eq(player, TMD_STUN, "Knocked Out")) {
+		return 0;
+	}
+	if ((player->timed[TMD_FOOD] < PY_FOOD_STARVE) ||
+		(player->timed[TMD_FOOD] >= PY_FOOD_MAX)) {
+		return 0;
+	}
+	if (player->truce && (player->depth == z_info->angband_depth)) return 0;
+	if (player_check_terrain_damage(player, player->grid, false)) return 0;
+
+	/* Nothing nearby to be found or woken */
+	if (player_near_hidden(player)) return 0;
+	if (!monsters_undisturbed(player->stealth_score)) return 0;
+
+	/* Keep every timed effect, and food, within its current grade */
+	for (i = 0; i < TMD_MAX; i++) {
+		if (!player->timed[i] || (i == TMD_FOOD)) continue;
+		num = MIN(num, timed_turns_in_grade(i,
+			player_timed_decrement_amount(player, i)));
+	}
+	rate = (player->state.hunger > 0) ? int_exp(3, player->state.hunger) : 1;
+	num = MIN(num, timed_turns_in_grade(TMD_FOOD, rate));
+
+	/* Stop when the rest would be complete */
+	hp = rest_turns_to_fill(player->chp, player->mhp, player_regen_hp_amount,
+							num);
+	sp = rest_turns_to_fill(player->csp, player->msp,
+							player_regen_mana_amount, num);
+	if (resting == REST_ALL_POINTS) {
+		num = MAX(hp, sp);
+	} else if (resting == REST_SOME_POINTS) {
+		num = MIN(hp, sp);
+	} else {
+		num = hp;
+	}
+	return num;
+}
+
+/**
+ * Pass over as much of an undisturbed rest as possible at once.
+ *
+ * While the character rests with every monster asleep and nothing nearby to
+ * notice, a player turn does nothing but regenerate, digest and run down
+ * timed effects, and a sleeping monster's turn does nothing but recover, so
+ * these are worked out in closed form over a batch of turns.  The world is
+ * still processed every ten game turns, and the batch ends early if that
+ * brings a new monster or disturbs the rest.  Anything else falls back to
+ * taking turns one at a time, with skip_idle_turns() passing over the game
+ * turns between them.
+ *
+ * Returns whether any turns were passed over; if not, the player takes their
+ * turn as usual.
+ */
+static bool rest_fast_forward(void)
+{
+	int gain = turn_energy(player->state.speed);
+	int count = mon_cnt;
+	int i, num, moves = 0;
+	bool stop = false;
+
+	/* Check for interrupts, as process_player() does */
+	player_resting_complete_special(player);
+	event_signal(EVENT_CHECK_INTERRUPT);
+	if ((gain <= 0) || !player_is_resting(player)) return false;
+	num = rest_batch_turns();
+	if (num < 2) return false;
+
+	/* Take the player turns, processing the world between them */
+	while (!stop) {
+		player->energy -= z_info->move_energy;
+		if (!(turn % 100))
+			equip_learn_after_time(player);
+		if (++moves == num) break;
+
+		while (!stop && (player->energy < z_info->move_energy)) {
+			if (!(turn % 10)) {
+				process_world(cave);
+				stop = player->is_dead || !player->upkeep->playing ||
+					player->upkeep->generate_level ||
+					!player_is_resting(player) || (mon_cnt != count);
+			}
+			player->energy += gain;
+			turn++;
+		}
+	}
+
+	/* The player turns passed over, all at once */
+	player->total_energy += moves * z_info->move_energy;
+	player_digest(player, moves);
+	if (player->chp < player->mhp) {
+		player_regen_hp(player, moves);
+	}
+	if (player->csp < player->msp) {
+		player_regen_mana(player, moves);
+	}
+	decrease_timeouts(moves);
+	player->forge_drought += moves;
+	player_resting_skip_turns(player, moves);
+	for (i = 0; i < moves; i++) {
+		update_scent();
+		if (one_in_(500)) {
+			equip_learn_flag(player, OF_DANGER);
+		}
+	}
+	player->turn += moves;
+	player->upkeep->update |= (PU_BONUS);
+
+	/* The sleeping monsters' turns */
+	recover_sleeping_monsters();
+	return true;
+}
+
+/**
+ * Turn off skipping idle game turns or fast-forwarding rests, for testing
+ */
+void set_turn_skipping(bool idle, bool rest)
+{
+	skip_idle = idle;
+	skip_rest = rest;
+}
+
 /**
  * The main game loop.
  *
@@ -1295,12 +2277,12 @@ void run_game_loop(void)
 		if (player->is_dead || !player->upkeep->playing) {
 			return;
 		} else if (!player->upkeep->generate_level) {
+			/* Pass quickly over turns when nothing happens */
+			skip_idle_turns();
+
 			/* Process the rest of the monsters */
 			process_monsters(0);
 
-			/* Mark all monsters as ready to act when they have the energy */
-			reset_monsters();
-
 			/* Refresh */
 			notice_stuff(player);
 			handle_stuff(player);
@@ -1353,6 +2335,9 @@ void run_game_loop(void)
 				player->upkeep->generate_level)
 				break;
 
+			/* Pass quickly over an undisturbed rest */
+			if (rest_fast_forward()) continue;
+
 			/* Process the player until they use some energy */
 			while (player->upkeep->playing) {
 				pre_process_player();
@@ -20,6 +20,7 @@
 #define GAME_WORLD_H
 
 #include "cave.h"
+#include "z-file.h"
 
 enum {
 	HEALTH_DEAD,
@@ -31,7 +32,7 @@ enum {
 };
 
 /**
- * Size increment of the generated locations array
+ * Initial size of the generated locations array, which doubles as needed
  */
 #define GEN_LOC_INCR 128
 
@@ -175,7 +176,7 @@ struct river_mile {
 	struct river *river;			/**< The river we're a part of */
 	enum river_part part;			/**< Description of this river mile */
 	struct river_stretch *stretch;	/**< The stretch we're in */
-	struct square_mile *sq_mile;	/**< The square mile we're in */
+	struct loc sq_mile;				/**< Map grid of the square mile we're in */
 	struct river_mile *upstream;	/**< The river mile that flows into us */
 	struct river_mile *downstream;	/**< The river mile we flow into */
 	struct loc entry;				/**< The chunk we enter the square mile */
@@ -264,6 +265,9 @@ struct map_square {
  * A square mile contains 400 regular size chunks (20x20), and there are
  * 49x49 (= 2401) of them to a map square.  Each square mile is represented
  * as a single grid in region.txt.
+ *
+ * The square miles themselves are kept in compact form in game-world.c; this
+ * is a view of one, as given by square_mile().
  */
 struct square_mile {
 	enum biome_type biome;			/**< Biome of this square mile */
@@ -311,6 +315,7 @@ struct chunk_ref {
 	struct chunk *p_chunk;	/**< The player's knowledge of the chunk */
 	uint32_t gen_loc_idx;	/**< The chunk index in the generated locations list */
 	int adjacent[11];	/**< Adjacent chunks */
+	bool dirty;			/**< Stored chunks changed since the last full save */
 };
 
 /**
@@ -342,16 +347,37 @@ struct gen_loc {
     struct connector *join;	/**< Information for generating adjoining chunks */
 	struct river_piece *river_piece;	/**< Piece of river in the location */
 	struct road_edge *road_edge;	/**< Road edge crossing data */
+	bool dirty;			/**< Changed since the last full save */
+};
+
+/**
+ * Statistics for monster flows shared between monsters which move alike
+ */
+struct flow_cache_stats {
+	uint32_t shared;		/**< Flows taken from another monster */
+	uint32_t calculated;	/**< Flows which had to be calculated */
+};
+
+/**
+ * Everything about a monster that affects the cost to it of empty grids;
+ * see monster_terrain_chance() and monster_flow_cost()
+ */
+struct flow_sig {
+	int moves;			/**< Which of flow_sig_flags the monster has */
+	bool alert;			/**< Alert monsters break glyphs and tunnel */
+	int will;			/**< Will, for breaking glyphs */
+	int perception;		/**< Perception, for unlocking doors */
+	int strength;		/**< Strength, for bashing doors */
 };
 
 extern uint32_t seed_randart;
 extern uint32_t seed_flavor;
+extern uint32_t seed_world;
 extern int32_t turn;
 extern bool character_generated;
 extern bool character_dungeon;
 extern const uint8_t extract_energy[8];
 extern struct world_region *region_info;
-extern struct square_mile **square_miles;
 extern struct landmark *landmark_info;
 extern struct gen_loc *gen_loc_list;
 extern struct river *river_info;
@@ -361,12 +387,32 @@ extern struct chunk_ref *chunk_list;
 extern uint32_t gen_loc_max;
 extern uint32_t gen_loc_cnt;
 extern struct gen_loc *gen_loc_list;
+extern struct flow_cache_stats flow_cache_stats;
 
+void gen_loc_list_reserve(uint32_t count);
+void gen_loc_list_reindex(void);
 void gen_loc_list_init(void);
 void gen_loc_list_cleanup(void);
+struct terrain_change *terrain_change_new(void);
+struct river_grid *river_grid_new(void);
+void gen_loc_wipe(struct gen_loc *loc);
 bool gen_loc_find(int x_pos, int y_pos, int z_pos, int *below, int *above);
 void gen_loc_make(int x_pos, int y_pos, int z_pos, int idx);
-struct square_mile *square_mile(wchar_t letter, int number, int y, int x);
+void square_miles_init(void);
+void square_miles_cleanup(void);
+bool square_miles_write(ang_file *f);
+bool square_miles_read(ang_file *f);
+struct loc square_mile_grid(wchar_t letter, int number, int y, int x);
+struct square_mile square_mile(struct loc grid);
+enum biome_type square_mile_biome(struct loc grid);
+int square_mile_region(struct loc grid);
+void square_mile_set_terrain(struct loc grid, enum biome_type biome,
+							 int region);
+struct river_mile *square_mile_river_miles(struct loc grid);
+void square_mile_set_river_miles(struct loc grid,
+								 struct river_mile *river_miles);
+bool square_mile_is_mapped(struct loc grid);
+void square_mile_set_mapped(struct loc grid);
 int chunk_realm(int chunk_idx);
 int dungeon_depth(struct player *p);
 bool is_daytime(void);
@@ -375,14 +421,20 @@ bool is_daylight(void);
 bool is_night(void);
 int turn_energy(int speed);
 int regen_amount(int turn_number, int max, int period);
+int regen_amount_over(int from, int to, int max, int period);
 int health_level(int current, int max);
 void play_ambient_sound(void);
+void flow_queue_free(void);
+void flow_cache_free(struct chunk *c);
+void flow_sig_get(struct monster *mon, struct flow_sig *sig);
+bool flow_sig_eq(const struct flow_sig *sig1, const struct flow_sig *sig2);
 void update_flow(struct chunk *c, struct flow *flow, struct monster *mon);
 int flow_dist(struct flow flow, struct loc grid);
 int get_scent(struct chunk *c, struct loc grid);
 void process_world(struct chunk *c);
 void on_new_level(void);
 void process_player(void);
+void set_turn_skipping(bool idle, bool rest);
 void run_game_loop(void);
 
 #endif /* !GAME_WORLD_H */
@@ -137,8 +137,8 @@ static void flood_access(struct chunk *c, struct loc grid, bool **access,
  * \param grid1 is the start grid
  * \param grid2 is the finish grid
  */
-static void build_thread(struct chunk *c, int feat, struct loc grid1,
-						 struct loc grid2)
+static void build_thread(struct chunk *c, struct rng_ctx *rng, int feat,
+						 struct loc grid1, struct loc grid2)
 {
 	struct loc grid = grid1, offset;
 
@@ -148,8 +148,8 @@ static void build_thread(struct chunk *c, int feat, struct loc grid1,
 		offset.y = CMP(grid2.y, grid.y);
 
 		/* Favour cardinal directions slightly */
-		if (offset.x && offset.y && one_in_(3)) {
-			if (one_in_(2)) {
+		if (offset.x && offset.y && rng_one_in(rng, 3)) {
+			if (rng_one_in(rng, 2)) {
 				offset.x = 0;
 			} else {
 				offset.y = 0;
@@ -162,6 +162,23 @@ static void build_thread(struct chunk *c, int feat, struct loc grid1,
 	}
 }
 
+/**
+ * Find a room grid in the given range which is already marked as accessible
+ */
+static bool find_accessible_room(struct chunk *c, struct rng_ctx *rng,
+								 struct loc *grid, struct loc top_left,
+								 struct loc bottom_right, bool **access)
+{
+	int *state = cave_find_init(NULL, top_left, bottom_right);
+	bool found = false;
+
+	while (!found && cave_find_get_grid(rng, NULL, grid, state)) {
+		found = square_isroom(c, *grid) && access[grid->y][grid->x];
+	}
+	mem_free(state);
+	return found;
+}
+
 /**
  * Make sure that the level is sufficiently connected.
  *
@@ -169,7 +186,7 @@ static void build_thread(struct chunk *c, int feat, struct loc grid1,
  * as long as it's not happening too often.  Failure can now only happen from
  * the player not reaching the stairs due to rubble.
  */
-static bool ensure_connectivity(struct chunk *c)
+static bool ensure_connectivity(struct chunk *c, struct rng_ctx *rng)
 {
 	struct loc grid;
 	bool result = false;
@@ -198,17 +215,24 @@ static bool ensure_connectivity(struct chunk *c)
 		}
 		if (!fail) break;
 
-		/* Find a room to connect the fail grid to */
+		/* Find a room the player can reach to connect the fail grid to */
 		while (true) {
 			struct loc tl, br;
 			tl.x = MAX(grid.x - dist, 1);
 			br.x = MIN(grid.x + dist, c->width - 1);
 			tl.y = MAX(grid.y - dist, 1);
 			br.y = MIN(grid.y + dist, c->height - 1);
-			if (cave_find_in_range(c, &target, tl, br, square_isroom)) break;
+			if (find_accessible_room(c, rng, &target, tl, br, access)) break;
+
+			/* No such room anywhere, so go straight to the player */
+			if ((tl.x == 1) && (tl.y == 1) && (br.x == c->width - 1) &&
+				(br.y == c->height - 1)) {
+				target = player->grid;
+				break;
+			}
 			dist++;
 		}
-		build_thread(c, FEAT_FLOOR, grid, target);
+		build_thread(c, rng, FEAT_FLOOR, grid, target);
 	}
 
 	/* Reset the array used for checking connectivity */
@@ -244,13 +268,15 @@ CLEANUP:
  * \param c is the current chunk
  * \param feat is the base feature (currently only FEAT_QUARTZ)
  */
-static void build_streamer(struct chunk *c, int feat)
+static void build_streamer(struct chunk *c, struct rng_ctx *rng, int feat)
 {
 	/* Choose starting point */
-	struct loc grid = rand_loc(loc(c->width / 2, c->height / 2), 15, 10);
+	struct loc grid = loc(rng_range(rng, c->width / 2 - 15, c->width / 2 + 15),
+						  rng_range(rng, c->height / 2 - 10,
+									c->height / 2 + 10));
 
 	/* Choose a random direction */
-	int dir = ddd[randint0(8)];
+	int dir = ddd[rng_int0(rng, 8)];
 
 	/* Place streamer into dungeon */
 	while (true) {
@@ -262,7 +288,7 @@ static void build_streamer(struct chunk *c, int feat)
 			int d = dun->profile->str.rng;
 
 			/* Pick a nearby grid */
-			find_nearby_grid(c, &change, grid, d, d);
+			find_nearby_grid(c, rng, &change, grid, d, d);
 
 			/* Only convert walls */
 			if (square_isgranitewall(c, change)) {
@@ -284,7 +310,7 @@ static void build_streamer(struct chunk *c, int feat)
  *
  * \param c is the current chunk
  */
-static void build_chasm(struct chunk *c)
+static void build_chasm(struct chunk *c, struct rng_ctx *rng)
 {
 	bool chasm_ok = false;
 	struct loc grid1;
@@ -294,14 +320,14 @@ static void build_chasm(struct chunk *c)
 		int i;
 
         /* Choose starting point */
-        struct loc grid = loc(rand_range(10, c->width - 10),
-							  rand_range(10, c->height - 10));
+        struct loc grid = loc(rng_range(rng, 10, c->width - 10),
+							  rng_range(rng, 10, c->height - 10));
 
 		/* Choose a random cardinal direction for it to run in */
-		int main_dir = ddd[randint0(4)];
+		int main_dir = ddd[rng_int0(rng, 4)];
 
 		/* Choose a random length for it */
-        int length = damroll(4, 8);
+        int length = rng_damroll(rng, 4, 8);
 
 		/* Count floor squares that will be turned to chasm */
         int floor_to_chasm = 0;
@@ -309,9 +335,9 @@ static void build_chasm(struct chunk *c)
 		/* Determine its shape */
         for (i = 0; i < length; i++) {
             /* Go in a random direction half the time */
-            if (one_in_(2)) {
+            if (rng_one_in(rng, 2)) {
                 /* Choose the random cardinal direction */
-                grid = loc_sum(grid, ddgrid_ddd[randint0(4)]);
+                grid = loc_sum(grid, ddgrid_ddd[rng_int0(rng, 4)]);
             } else {
 				/* Go straight ahead the other half */
 				grid = loc_sum(grid, ddgrid[main_dir]);
@@ -417,7 +443,7 @@ static void build_chasm(struct chunk *c)
 /**
  * Places chasms through dungeon
  */
-static void build_chasms(struct chunk *c)
+static void build_chasms(struct chunk *c, struct rng_ctx *rng)
 {
     int i;
     int chasms = 0;
@@ -434,20 +460,20 @@ static void build_chasms(struct chunk *c)
 
     /* Determine whether to add chasms, and how many */
     if ((c->depth > 2) && (c->depth < dungeon_depth(player) - 1) &&
-		percent_chance(c->depth + 40)) {
+		(rng_int0(rng, 100) < c->depth + 40)) {
         /* Add some chasms */
-        chasms += damroll(1, blocks / 3);
+        chasms += rng_damroll(rng, 1, blocks / 3);
 
         /* Flip a coin, and if it is heads... */
-        while (one_in_(2)) {
+        while (rng_one_in(rng, 2)) {
             /* Add some more chasms and flip again... */
-            chasms += damroll(1, blocks / 3);
+            chasms += rng_damroll(rng, 1, blocks / 3);
         }
     }
 
     /* Build them */
     for (i = 0; i < chasms; i++) {
-        build_chasm(c);
+        build_chasm(c, rng);
     }
 
     if (OPT(player, cheat_room) && (chasms > 0)) {
@@ -509,8 +535,8 @@ static void reset_entrance_data(const struct chunk *c)
  * 3) For all m between zero and nexc - 1, ABS(x.x - exc[m].x) > 1 or
  * ABS(x.y - exc[m].y) > 1 or (x.x == exc[m].x and x.y == exc[m].y).
  */
-static struct loc choose_random_entrance(struct chunk *c, int ridx,
-	const struct loc *tgt, int bias, const struct loc *exc, int nexc)
+static struct loc choose_random_entrance(struct chunk *c, struct rng_ctx *rng,
+	int ridx, const struct loc *tgt, int bias, const struct loc *exc, int nexc)
 {
 	assert(ridx >= 0 && ridx < dun->cent_n);
 	if (dun->ent_n[ridx] > 0) {
@@ -576,7 +602,7 @@ static struct loc choose_random_entrance(struct chunk *c, int ridx,
 			}
 		}
 		if (nchoice > 0) {
-			int chosen = randint0(accum[dun->ent_n[ridx]]);
+			int chosen = rng_int0(rng, accum[dun->ent_n[ridx]]);
 			int low = 0, high = dun->ent_n[ridx];
 
 			/* Locate the selection by binary search. */
@@ -651,8 +677,8 @@ static void pierce_outer_wall(struct chunk *c, struct loc grid)
  * of tunnel iterations to wait before applying a bend.  At exit, *bend_intvl
  * is what that intverval should be for the next iteration of tunnel building.
  */
-static void handle_post_wall_step(struct chunk *c, struct loc *grid,
-	struct loc *dir, bool *door_flag, int *bend_intvl)
+static void handle_post_wall_step(struct chunk *c, struct rng_ctx *rng,
+	struct loc *grid, struct loc *dir, bool *door_flag, int *bend_intvl)
 {
 	if (dir->x != 0 && dir->y != 0) {
 		/*
@@ -686,7 +712,7 @@ static void handle_post_wall_step(struct chunk *c, struct loc *grid,
 		 * from what was used for the diagonal step, for the next step
 		 * since the tunnel iterations want a cardinal direction.
 		 */
-		if (randint0(32768) < 16384) {
+		if (rng_int0(rng, 32768) < 16384) {
 			dir->x = 0;
 		} else {
 			dir->y = 0;
@@ -713,8 +739,8 @@ static void handle_post_wall_step(struct chunk *c, struct loc *grid,
  * \return The returned value is the chosen direction.  It may be loc(0, 0)
  * if no feasible direction could be found.
  */
-static struct loc find_normal_to_wall(struct chunk *c, struct loc grid,
-	bool inner)
+static struct loc find_normal_to_wall(struct chunk *c, struct rng_ctx *rng,
+	struct loc grid, bool inner)
 {
 	int n = 0, ncardinal = 0, i;
 	struct loc choices[8];
@@ -742,7 +768,7 @@ static struct loc find_normal_to_wall(struct chunk *c, struct loc grid,
 	if (n > 1 && ncardinal > 0) {
 		n = ncardinal;
 	}
-	return (n == 0) ? loc(0, 0) : choices[randint0(n)];
+	return (n == 0) ? loc(0, 0) : choices[rng_int0(rng, n)];
 }
 
 
@@ -800,7 +826,8 @@ static bool allows_wall_piercing_door(struct chunk *c, struct loc grid)
  * The solid wall check prevents silly door placement and excessively wide
  * room entrances.
  */
-static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
+static void build_tunnel(struct chunk *c, struct rng_ctx *rng, struct loc grid1,
+						 struct loc grid2)
 {
 	int i;
 	int dstart = ABS(grid1.x - grid2.x) + ABS(grid1.y - grid2.y);
@@ -819,7 +846,7 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 	dun->wall_n = 0;
 
 	/* Start out in the correct direction */
-	correct_dir(&offset, grid1, grid2);
+	correct_dir(rng, &offset, grid1, grid2);
 
 	/* Keep going until done (or bored) */
 	while (!loc_eq(grid1, grid2)) {
@@ -828,13 +855,13 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 
 		/* Allow bends in the tunnel */
 		if (bend_intvl == 0) {
-			if (randint0(100) < dun->profile->tun.chg) {
+			if (rng_int0(rng, 100) < dun->profile->tun.chg) {
 				/* Get the correct direction */
-				correct_dir(&offset, grid1, grid2);
+				correct_dir(rng, &offset, grid1, grid2);
 
 				/* Random direction */
-				if (randint0(100) < dun->profile->tun.rnd)
-					rand_dir(&offset);
+				if (rng_int0(rng, 100) < dun->profile->tun.rnd)
+					rand_dir(rng, &offset);
 			}
 		} else {
 			assert(bend_intvl > 0);
@@ -846,11 +873,11 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 
 		while (!square_in_bounds(c, tmp_grid)) {
 			/* Get the correct direction */
-			correct_dir(&offset, grid1, grid2);
+			correct_dir(rng, &offset, grid1, grid2);
 
 			/* Random direction */
-			if (randint0(100) < dun->profile->tun.rnd)
-				rand_dir(&offset);
+			if (rng_int0(rng, 100) < dun->profile->tun.rnd)
+				rand_dir(rng, &offset);
 
 			/* Get the next location */
 			tmp_grid = loc_sum(grid1, offset);
@@ -896,7 +923,7 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 					 * room.  See if there's somewhere on
 					 * the outside to go.
 					 */
-					nxtdir = find_normal_to_wall(c,
+					nxtdir = find_normal_to_wall(c, rng,
 						tmp_grid, false);
 					if (nxtdir.x == 0 && nxtdir.y == 0) {
 						/* There isn't. */
@@ -938,15 +965,15 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 							break;
 						}
 						chk = choose_random_entrance(
-							c, iroom, &grid2, bias,
-							exc, 2);
+							c, rng, iroom, &grid2,
+							bias, exc, 2);
 						if (chk.x == 0 && chk.y == 0) {
 							/* No exits at all. */
 							ntry = mtry;
 							break;
 						}
 						nxtdir = find_normal_to_wall(
-							c, chk, false);
+							c, rng, chk, false);
 						if (nxtdir.x != 0 ||
 								nxtdir.y != 0) {
 							/*
@@ -976,13 +1003,13 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 					grid1 = chk;
 				}
 				offset = nxtdir;
-				handle_post_wall_step(c, &grid1, &offset,
+				handle_post_wall_step(c, rng, &grid1, &offset,
 					&door_flag, &bend_intvl);
 				continue;
 			}
 
 			/* Is there a feasible location after the wall? */
-			nxtdir = find_normal_to_wall(c, tmp_grid,
+			nxtdir = find_normal_to_wall(c, rng, tmp_grid,
 				!square_isroom(c, grid1));
 
 			if (nxtdir.x == 0 && nxtdir.y == 0) {
@@ -994,7 +1021,7 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 			grid1 = tmp_grid;
 			pierce_outer_wall(c, grid1);
 			offset = nxtdir;
-			handle_post_wall_step(c, &grid1, &offset, &door_flag,
+			handle_post_wall_step(c, rng, &grid1, &offset, &door_flag,
 				&bend_intvl);
 		} else if (square_isroom(c, tmp_grid)) {
 			/* Travel quickly through rooms */
@@ -1036,7 +1063,7 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 			}
 
 			/* Hack -- allow pre-emptive tunnel termination */
-			if (randint0(100) >= dun->profile->tun.con) {
+			if (rng_int0(rng, 100) >= dun->profile->tun.con) {
 				/* Offset between grid1 and start */
 				tmp_grid = loc_diff(grid1, start);
 
@@ -1062,9 +1089,9 @@ static void build_tunnel(struct chunk *c, struct loc grid1, struct loc grid2)
 		square_set_feat(c, dun->wall[i], FEAT_FLOOR);
 
 		/* Place a random door */
-		if (randint0(100) < dun->profile->tun.pen &&
+		if (rng_int0(rng, 100) < dun->profile->tun.pen &&
 				allows_wall_piercing_door(c, dun->wall[i]))
-			place_random_door(c, dun->wall[i]);
+			place_random_door(c, rng, dun->wall[i]);
 	}
 
 	event_signal_tunnel(EVENT_GEN_TUNNEL_FINISHED,
@@ -1132,7 +1159,7 @@ static bool possible_doorway(struct chunk *c, struct loc grid)
  * \param y are the co-ordinates
  * \param x are the co-ordinates
  */
-static void try_door(struct chunk *c, struct loc grid)
+static void try_door(struct chunk *c, struct rng_ctx *rng, struct loc grid)
 {
 	assert(square_in_bounds(c, grid));
 
@@ -1141,9 +1168,10 @@ static void try_door(struct chunk *c, struct loc grid)
 	if (square_isplayertrap(c, grid)) return;
 	if (square_isdoor(c, grid)) return;
 
-	if (randint0(100) < dun->profile->tun.jct && possible_doorway(c, grid))
-		place_random_door(c, grid);
-	else if (randint0(500) < dun->profile->tun.jct && possible_doorway(c, grid))
+	if (rng_int0(rng, 100) < dun->profile->tun.jct && possible_doorway(c, grid))
+		place_random_door(c, rng, grid);
+	else if (rng_int0(rng, 500) < dun->profile->tun.jct &&
+			 possible_doorway(c, grid))
 		place_trap(c, grid, -1, player->depth);
 }
 
@@ -1152,7 +1180,7 @@ static void try_door(struct chunk *c, struct loc grid)
  * Connect the rooms with tunnels in the traditional fashion.
  * \param c Is the chunk to use.
  */
-static void do_traditional_tunneling(struct chunk *c)
+static void do_traditional_tunneling(struct chunk *c, struct rng_ctx *rng)
 {
 	int *scrambled = mem_alloc(dun->cent_n * sizeof(*scrambled));
 	int i;
@@ -1166,8 +1194,8 @@ static void do_traditional_tunneling(struct chunk *c)
 		scrambled[i] = i;
 	}
 	for (i = 0; i < dun->cent_n; ++i) {
-		int pick1 = randint0(dun->cent_n);
-		int pick2 = randint0(dun->cent_n);
+		int pick1 = rng_int0(rng, dun->cent_n);
+		int pick2 = rng_int0(rng, dun->cent_n);
 		int tmp = scrambled[pick1];
 
 		scrambled[pick1] = scrambled[pick2];
@@ -1184,20 +1212,20 @@ static void do_traditional_tunneling(struct chunk *c)
 	 * typical screen width away, don't particularly care which entrance is
 	 * selected.
 	 */
-	grid = choose_random_entrance(c, scrambled[dun->cent_n - 1], NULL, 80,
+	grid = choose_random_entrance(c, rng, scrambled[dun->cent_n - 1], NULL, 80,
 		NULL, 0);
 	if (grid.x == 0 && grid.y == 0) {
 		/* Use the room's center. */
 		grid = dun->cent[scrambled[dun->cent_n - 1]];
 	}
 	for (i = 0; i < dun->cent_n; ++i) {
-		struct loc next_grid = choose_random_entrance(c, scrambled[i],
+		struct loc next_grid = choose_random_entrance(c, rng, scrambled[i],
 			&grid, 80, NULL, 0);
 
 		if (next_grid.x == 0 && next_grid.y == 0) {
 			next_grid = dun->cent[scrambled[i]];
 		}
-		build_tunnel(c, next_grid, grid);
+		build_tunnel(c, rng, next_grid, grid);
 
 		/* Remember the "previous" room. */
 		grid = next_grid;
@@ -1208,10 +1236,10 @@ static void do_traditional_tunneling(struct chunk *c)
 	/* Place intersection doors. */
 	for (i = 0; i < dun->door_n; ++i) {
 		/* Try placing doors. */
-		try_door(c, next_grid(dun->door[i], DIR_W));
-		try_door(c, next_grid(dun->door[i], DIR_E));
-		try_door(c, next_grid(dun->door[i], DIR_N));
-		try_door(c, next_grid(dun->door[i], DIR_S));
+		try_door(c, rng, next_grid(dun->door[i], DIR_W));
+		try_door(c, rng, next_grid(dun->door[i], DIR_E));
+		try_door(c, rng, next_grid(dun->door[i], DIR_N));
+		try_door(c, rng, next_grid(dun->door[i], DIR_S));
 	}
 }
 
@@ -1219,7 +1247,8 @@ static void do_traditional_tunneling(struct chunk *c)
 /**
  * Build the staircase rooms.
  */
-static void build_staircase_rooms(struct chunk *c, const char *label)
+static void build_staircase_rooms(struct chunk *c, struct rng_ctx *rng,
+								  const char *label)
 {
 	int num_rooms = dun->profile->n_room_profiles;
 	struct room_profile profile;
@@ -1239,7 +1268,7 @@ static void build_staircase_rooms(struct chunk *c, const char *label)
 
 		/* Build the staircase room; note that the argument join->grid in this
 		 * call (the room centre) is actually ignored by the room builder */
-		if (!room_build(c, join->grid, profile)) {
+		if (!room_build(c, rng, join->grid, profile)) {
 			dump_level_simple(NULL, format("%s:  Failed to Build "
 				"Staircase Room at Row=%d Column=%d in a "
 				"Cave with %d Rows and %d Columns", label,
@@ -1255,7 +1284,8 @@ static void build_staircase_rooms(struct chunk *c, const char *label)
 /**
  * Add stairs to a level, taking into account joins to other levels.
  */
-static void handle_level_stairs(struct chunk *c, struct player *p, int count)
+static void handle_level_stairs(struct chunk *c, struct rng_ctx *rng,
+								struct player *p, int count)
 {
 	/*
 	 * Require that the stairs be at least four grids apart (two for
@@ -1285,17 +1315,17 @@ static void handle_level_stairs(struct chunk *c, struct player *p, int count)
 
 	if (!one_below) {
 		assert(!two_below);
-		alloc_stairs(c, FEAT_MORE, count, minsep, true);
+		alloc_stairs(c, rng, FEAT_MORE, count, minsep, true);
 	} else if (!two_below) {
-		alloc_stairs(c, FEAT_MORE_SHAFT, count / 2, minsep, false);
+		alloc_stairs(c, rng, FEAT_MORE_SHAFT, count / 2, minsep, false);
 	}
 
 	if (!one_above) {
 		assert(two_above);
-		alloc_stairs(c, FEAT_MORE, count / 2 + 1, minsep, false);
+		alloc_stairs(c, rng, FEAT_MORE, count / 2 + 1, minsep, false);
 	} else if (!two_above) {
 		assert(one_above);
-		alloc_stairs(c, FEAT_MORE_SHAFT, count / 2, minsep, false);
+		alloc_stairs(c, rng, FEAT_MORE_SHAFT, count / 2, minsep, false);
 	}
 }
 
@@ -1310,8 +1340,8 @@ static void handle_level_stairs(struct chunk *c, struct player *p, int count)
  * \param forge if true forces a forge on this level
  * \return a pointer to the generated chunk
  */
-static struct chunk *angband_chunk(struct player *p, int depth, int height,
-								   int width, bool forge)
+static struct chunk *angband_chunk(struct player *p, struct rng_ctx *rng,
+								   int depth, int height, int width, bool forge)
 {
 	int i;
 	int key, rarity;
@@ -1350,7 +1380,7 @@ static struct chunk *angband_chunk(struct player *p, int depth, int height,
 	reset_entrance_data(c);
 
 	/* Build the special staircase rooms */
-	build_staircase_rooms(c, "Angband Generation");
+	build_staircase_rooms(c, rng, "Angband Generation");
 
 	/* Guarantee a forge if one hasn't been generated in a while */
 	if (forge) {
@@ -1359,7 +1389,7 @@ static struct chunk *angband_chunk(struct player *p, int depth, int height,
 		p->upkeep->force_forge = true;
 
 		/* Failure (not clear why this would happen) */
-		if (!room_build(c, loc(0, 0), profile)) {
+		if (!room_build(c, rng, loc(0, 0), profile)) {
 			p->upkeep->force_forge = false;
 			if (OPT(p, cheat_room)) msg("failed.");
 			uncreate_artifacts(c);
@@ -1403,7 +1433,7 @@ static struct chunk *angband_chunk(struct player *p, int depth, int height,
 		++n_attempt;
 
 		/* Roll for random key (to be compared against a profile's cutoff) */
-		key = randint0(100);
+		key = rng_int0(rng, 100);
 
 		/* We generate a rarity number to figure out how exotic to make
 		 * the room. This number has a (50+depth/2)/DUN_UNUSUAL chance
@@ -1412,7 +1442,7 @@ static struct chunk *angband_chunk(struct player *p, int depth, int height,
 		i = 0;
 		rarity = 0;
 		while (i == rarity && i < dun->profile->max_rarity) {
-			if (randint0(dun_unusual) < 50 + depth / 2) rarity++;
+			if (rng_int0(rng, dun_unusual) < 50 + depth / 2) rarity++;
 			i++;
 		}
 
@@ -1425,7 +1455,7 @@ static struct chunk *angband_chunk(struct player *p, int depth, int height,
 			struct room_profile profile = dun->profile->room_profiles[i];
 			if (profile.rarity > rarity) continue;
 			if (profile.cutoff <= key) continue;
-			if (room_build(c, loc(0, 0), profile)) break;
+			if (room_build(c, rng, loc(0, 0), profile)) break;
 		}
 	}
 
@@ -1434,7 +1464,7 @@ static struct chunk *angband_chunk(struct player *p, int depth, int height,
 	mem_free(dun->room_map);
 
 	/* Connect all the rooms together */
-	do_traditional_tunneling(c);
+	do_traditional_tunneling(c, rng);
 
 	/* Turn the outer permanent walls back to granite */
 	draw_rectangle(c, 0, 0, c->height - 1, c->width - 1,
@@ -1466,7 +1496,7 @@ static struct chunk *angband_chunk(struct player *p, int depth, int height,
  *   interesting rooms, as well as to make general monster restrictions in
  *   areas or the whole dungeon
  */
-struct chunk *angband_gen(struct player *p) {
+struct chunk *angband_gen(struct player *p, struct rng_ctx *rng) {
 	int i;
 	int y_size = ARENA_SIDE, x_size = ARENA_SIDE;
 	struct chunk *c;
@@ -1478,13 +1508,13 @@ struct chunk *angband_gen(struct player *p) {
 
 
 	/* Guarantee a forge if one hasn't been generated in a while */
-	if (p->forge_drought >= rand_range(2000, 5000)) forge = true;
+	if (p->forge_drought >= rng_range(rng, 2000, 5000)) forge = true;
 
 	/* Set the block height and width */
 	dun->block_hgt = dun->profile->block_size;
 	dun->block_wid = dun->profile->block_size;
 
-	c = angband_chunk(p, p->depth, MIN(z_info->dungeon_hgt, y_size),
+	c = angband_chunk(p, rng, p->depth, MIN(z_info->dungeon_hgt, y_size),
 					  MIN(z_info->dungeon_wid, x_size), forge);
 	if (!c) return NULL;
 
@@ -1494,20 +1524,21 @@ struct chunk *angband_gen(struct player *p) {
 
 	/* Add some quartz streamers */
 	for (i = 0; i < dun->profile->str.qua; i++)
-		build_streamer(c, FEAT_QUARTZ);
+		build_streamer(c, rng, FEAT_QUARTZ);
 
 	/* Place stairs near some walls as allowed by levels above and below */
-	handle_level_stairs(c, p, rand_range(3, 4));
+	handle_level_stairs(c, rng, p, rng_range(rng, 3, 4));
 
     /* Add any chasms if needed */
-    build_chasms(c);
+    build_chasms(c, rng);
 
 	/* Place some rubble, occasionally much more on deep levels */
-	rubble_gen = randint1(5);
-	if ((c->depth >= 5) && one_in_(10)) {
+	rubble_gen = rng_int1(rng, 5);
+	if ((c->depth >= 5) && rng_one_in(rng, 10)) {
 		rubble_gen += 30;
 	}
-	alloc_object(c, SET_BOTH, TYP_RUBBLE, rubble_gen, p->depth, ORIGIN_FLOOR);
+	alloc_object(c, rng, SET_BOTH, TYP_RUBBLE, rubble_gen, p->depth,
+				 ORIGIN_FLOOR);
 
 	/* Add join floors (the bottoms of chasms) */
 	for (join = dun->join; join; join = join->next) {
@@ -1520,7 +1551,7 @@ struct chunk *angband_gen(struct player *p) {
 	}
 
 	/* Check dungeon connectivity */
-	if (!ensure_connectivity(c)) {
+	if (!ensure_connectivity(c, rng)) {
 		if (OPT(p, cheat_room)) msg("Failed connectivity.");
 		uncreate_artifacts(c);
 		uncreate_greater_vaults(c, p);
@@ -1566,7 +1597,7 @@ struct chunk *angband_gen(struct player *p) {
 	/* Put some objects in rooms */
 	obj_room_gen = 3 * mon_gen / 4;
 	if (obj_room_gen > 0) {
-		alloc_object(c, SET_ROOM, TYP_OBJECT, obj_room_gen,
+		alloc_object(c, Rand_ctx, SET_ROOM, TYP_OBJECT, obj_room_gen,
 					 player_danger_level(p), ORIGIN_FLOOR);
 	}
 
@@ -1789,8 +1820,9 @@ static struct point_set *get_annulus(struct loc centre, int inner_rad,
 	return annulus;
 }
 
-static int build_room_circuit(struct chunk *c, struct loc start,
-							  struct loc *finish, int clearance)
+static int build_room_circuit(struct chunk *c, struct rng_ctx *rng,
+							  struct loc start, struct loc *finish,
+							  int clearance)
 {
 	int i, k;
 	int num_rooms = dun->profile->n_room_profiles;
@@ -1803,7 +1835,7 @@ static int build_room_circuit(struct chunk *c, struct loc start,
 	bool pierced_room = false;
 
 	/* Roll for random key (to be compared against a profile's cutoff) */
-	int key = randint0(100);
+	int key = rng_int0(rng, 100);
 
 	/* Once we have a key we iterate through our list of room profiles
 	 * looking for a match (whose cutoff > key). We try building the room,
@@ -1826,7 +1858,7 @@ static int build_room_circuit(struct chunk *c, struct loc start,
 
 		/* Build the first room */
 		dun->fix_room_parameters = true;
-		if (room_build(c, *finish, profile)) {
+		if (room_build(c, rng, *finish, profile)) {
 			dun->fix_room_parameters = false;
 			break;
 		} else {
@@ -1835,14 +1867,14 @@ static int build_room_circuit(struct chunk *c, struct loc start,
 	}
 
 	/* Now build the same room symmetrically about the centre of the level */
-	k = randint0(N_ELEMENTS(rota));
+	k = rng_int0(rng, N_ELEMENTS(rota));
 	for (i = 1; i < rota[k].nodes; i++) {
 		struct loc new = get_rotated_grid(*finish, rota[k].sin, rota[k].cos, i);
 		struct loc moved = loc(0, 0);
 		if (!find_nearest_point_set_grid(c, &moved, new, circle)) {
 			quit_fmt("Failed to centre room %s.", profile.name);
 		}
-		if (!room_build(c, moved, profile)) {
+		if (!room_build(c, rng, moved, profile)) {
 			quit_fmt("Failed to build room %s.", profile.name);
 		}
 	}
@@ -1897,11 +1929,11 @@ static int build_room_circuit(struct chunk *c, struct loc start,
 	return profile.width / 2;
 }
 
-static void lay_out_rooms(struct chunk *c)
+static void lay_out_rooms(struct chunk *c, struct rng_ctx *rng)
 {
 	struct loc centre = loc(ARENA_SIDE / 2, ARENA_SIDE / 2), first, second;
-	int clearance = build_room_circuit(c, centre, &first, 10);
-	(void) build_room_circuit(c, first, &second, clearance);
+	int clearance = build_room_circuit(c, rng, centre, &first, 10);
+	(void) build_room_circuit(c, rng, first, &second, clearance);
 }
 
 /**
@@ -1909,7 +1941,7 @@ static void lay_out_rooms(struct chunk *c)
  * TODO make this more than just a room, current plan is overlapping ellipses
  * and maybe some column rooms
  */
-struct chunk *elven_gen(struct player *p)
+struct chunk *elven_gen(struct player *p, struct rng_ctx *rng)
 {
 	int i;
 	struct chunk *c;
@@ -1957,7 +1989,7 @@ struct chunk *elven_gen(struct player *p)
 	dun->cent_n++;
 
 	/* Place rooms */
-	lay_out_rooms(c);
+	lay_out_rooms(c, rng);
 
 	/* Place staircases */
 	for (join = dun->join; join; join = join->next) {
@@ -2006,8 +2038,8 @@ struct chunk *elven_gen(struct player *p)
  * \param forge if true forces a forge on this level
  * \return a pointer to the generated chunk
  */
-static struct chunk *dwarven_chunk(struct player *p, int depth, int height,
-								   int width)
+static struct chunk *dwarven_chunk(struct player *p, struct rng_ctx *rng,
+								   int depth, int height, int width)
 {
 	int i;
 	int key, rarity;
@@ -2047,14 +2079,14 @@ static struct chunk *dwarven_chunk(struct player *p, int depth, int height,
 	reset_entrance_data(c);
 
 	/* Build the special staircase rooms */
-	build_staircase_rooms(c, "Dwarven Generation");
+	build_staircase_rooms(c, rng, "Dwarven Generation");
 
 	/* Guarantee a forge */
 	if (OPT(p, cheat_room)) msg("Trying to force a forge:");
 	p->upkeep->force_forge = true;
 
 	/* Failure (not clear why this would happen) */
-	if (!room_build(c, loc(0, 0), forge_profile)) {
+	if (!room_build(c, rng, loc(0, 0), forge_profile)) {
 		p->upkeep->force_forge = false;
 		if (OPT(p, cheat_room)) msg("failed.");
 		uncreate_artifacts(c);
@@ -2095,7 +2127,7 @@ static struct chunk *dwarven_chunk(struct player *p, int depth, int height,
 		++n_attempt;
 
 		/* Roll for random key (to be compared against a profile's cutoff) */
-		key = randint0(100);
+		key = rng_int0(rng, 100);
 
 		/* We generate a rarity number to figure out how exotic to make
 		 * the room. This number has a (50+depth/2)/DUN_UNUSUAL chance
@@ -2104,7 +2136,7 @@ static struct chunk *dwarven_chunk(struct player *p, int depth, int height,
 		i = 0;
 		rarity = 0;
 		while (i == rarity && i < dun->profile->max_rarity) {
-			if (randint0(dun_unusual) < 50 + depth / 2) rarity++;
+			if (rng_int0(rng, dun_unusual) < 50 + depth / 2) rarity++;
 			i++;
 		}
 
@@ -2117,7 +2149,7 @@ static struct chunk *dwarven_chunk(struct player *p, int depth, int height,
 			struct room_profile profile = dun->profile->room_profiles[i];
 			if (profile.rarity > rarity) continue;
 			if (profile.cutoff <= key) continue;
-			if (room_build(c, loc(0, 0), profile)) break;
+			if (room_build(c, rng, loc(0, 0), profile)) break;
 		}
 	}
 
@@ -2126,7 +2158,7 @@ static struct chunk *dwarven_chunk(struct player *p, int depth, int height,
 	mem_free(dun->room_map);
 
 	/* Connect all the rooms together */
-	do_traditional_tunneling(c);
+	do_traditional_tunneling(c, rng);
 
 	/* Turn the outer permanent walls back to granite */
 	draw_rectangle(c, 0, 0, c->height - 1, c->width - 1,
@@ -2158,7 +2190,7 @@ static struct chunk *dwarven_chunk(struct player *p, int depth, int height,
  *   interesting rooms, as well as to make general monster restrictions in
  *   areas or the whole dungeon
  */
-struct chunk *dwarven_gen(struct player *p) {
+struct chunk *dwarven_gen(struct player *p, struct rng_ctx *rng) {
 	int i;
 	int y_size = ARENA_SIDE, x_size = ARENA_SIDE;
 	struct chunk *c;
@@ -2171,7 +2203,7 @@ struct chunk *dwarven_gen(struct player *p) {
 	dun->block_hgt = dun->profile->block_size;
 	dun->block_wid = dun->profile->block_size;
 
-	c = dwarven_chunk(p, p->depth, MIN(z_info->dungeon_hgt, y_size),
+	c = dwarven_chunk(p, rng, p->depth, MIN(z_info->dungeon_hgt, y_size),
 					  MIN(z_info->dungeon_wid, x_size));
 	if (!c) return NULL;
 
@@ -2181,22 +2213,23 @@ struct chunk *dwarven_gen(struct player *p) {
 
 	/* Add some quartz streamers */
 	for (i = 0; i < dun->profile->str.qua; i++)
-		build_streamer(c, FEAT_QUARTZ);
+		build_streamer(c, rng, FEAT_QUARTZ);
 
 	/* Place stairs near some walls as allowed by levels above and below */
 	if (dungeon_depth(p) > p->depth) {
-		handle_level_stairs(c, p, rand_range(3, 4));
+		handle_level_stairs(c, rng, p, rng_range(rng, 3, 4));
 	}
 
     /* Add any chasms if needed */
-    build_chasms(c);
+    build_chasms(c, rng);
 
 	/* Place some rubble, occasionally much more on deep levels */
-	rubble_gen = randint1(5);
-	if ((c->depth >= 5) && one_in_(10)) {
+	rubble_gen = rng_int1(rng, 5);
+	if ((c->depth >= 5) && rng_one_in(rng, 10)) {
 		rubble_gen += 30;
 	}
-	alloc_object(c, SET_BOTH, TYP_RUBBLE, rubble_gen, p->depth, ORIGIN_FLOOR);
+	alloc_object(c, rng, SET_BOTH, TYP_RUBBLE, rubble_gen, p->depth,
+				 ORIGIN_FLOOR);
 
 	/* Add join floors (the bottoms of chasms) */
 	for (join = dun->join; join; join = join->next) {
@@ -2209,7 +2242,7 @@ struct chunk *dwarven_gen(struct player *p) {
 	}
 
 	/* Check dungeon connectivity - tolerate this for now NRM */
-	//if (!ensure_connectivity(c)) {
+	//if (!ensure_connectivity(c, rng)) {
 	//	if (OPT(p, cheat_room)) msg("Failed connectivity.");
 	//	uncreate_artifacts(c);
 	//	delete_temp_monsters();
@@ -2233,7 +2266,7 @@ struct chunk *dwarven_gen(struct player *p) {
 	/* Put some objects in rooms */
 	obj_room_gen = 3 * mon_gen / 4;
 	if (obj_room_gen > 0) {
-		alloc_object(c, SET_ROOM, TYP_OBJECT, obj_room_gen,
+		alloc_object(c, Rand_ctx, SET_ROOM, TYP_OBJECT, obj_room_gen,
 					 player_danger_level(p), ORIGIN_FLOOR);
 	}
 
@@ -2308,7 +2341,7 @@ struct chunk *dwarven_gen(struct player *p)
 /**
  * Create the level containing Morgoth's throne room
  */
-struct chunk *throne_gen(struct player *p)
+struct chunk *throne_gen(struct player *p, struct rng_ctx *rng)
 {
 	int y, x;
 	struct chunk *c;
@@ -2334,7 +2367,7 @@ struct chunk *throne_gen(struct player *p)
 				   true);
 
 	/* Build it */
-	room_build(c, loc(0, 0), profile);
+	room_build(c, rng, loc(0, 0), profile);
 
 	/* Find an up staircase */
 	for (y = 0; y < c->height; y++) {
@@ -2368,8 +2401,9 @@ struct chunk *throne_gen(struct player *p)
 /**
  * Load the appropriate bit of a landmark from the text file
  */
-bool build_landmark(struct chunk *c, struct landmark *landmark, int map_y,
-					int map_x, int y_coord, int x_coord)
+bool build_landmark(struct chunk *c, struct rng_ctx *rng,
+					struct landmark *landmark, int map_y, int map_x,
+					int y_coord, int x_coord)
 {
 	/* Where in the arena the chunk is going */
 	struct loc target = loc(x_coord * CHUNK_SIDE, y_coord * CHUNK_SIDE);
@@ -2389,7 +2423,7 @@ bool build_landmark(struct chunk *c, struct landmark *landmark, int map_y,
 	}
 
 	/* Place terrain features */
-	get_terrain(c, top_left, bottom_right, target, y_total, x_total,
+	get_terrain(c, rng, top_left, bottom_right, target, y_total, x_total,
 				0, false, NULL, true, landmark->text, true);
 
 	/* Success. */
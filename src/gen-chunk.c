@@ -37,7 +37,9 @@
 
 uint16_t chunk_max = 1;				/* Number of allocated chunks */
 uint16_t chunk_cnt = 0;				/* Number of live chunks */
+uint16_t chunk_list_max;			/* Size of chunk_list, MAX_CHUNKS */
 struct chunk_ref *chunk_list;     /**< list of pointers refs to saved chunks */
+struct chunk_cache_stats chunk_cache_stats;
 
 
 /**
@@ -83,6 +85,7 @@ void symmetry_transform(struct loc *grid, int y0, int x0, int height, int width,
 
 /**
  * Select a random symmetry transformation subject to certain constraints.
+ * \param rng Is the generator to use.
  * \param height Is the height of the piece to transform.
  * \param width Is the width of the piece to transform.
  * \param flags Is a bitwise-or of one or more of SYMTR_FLAG_NONE,
@@ -106,8 +109,8 @@ void symmetry_transform(struct loc *grid, int y0, int x0, int height, int width,
  * \param twidth If twidth is not NULL, *twidth is set to the width of the
  * piece after applying the transform.
  */
-void get_random_symmetry_transform(int height, int width, int flags,
-	int transpose_weight, int *rotate, bool *reflect,
+void get_random_symmetry_transform(struct rng_ctx *rng, int height,
+	int width, int flags, int transpose_weight, int *rotate, bool *reflect,
 	int *theight, int *twidth)
 {
 	/*
@@ -167,7 +170,7 @@ void get_random_symmetry_transform(int height, int width, int flags,
 	}
 	assert(weights[8] > 0);
 
-	draw = randint0(weights[8]);
+	draw = rng_int0(rng, weights[8]);
 
 	/* Find by a binary search. */
 	ilow = 0;
@@ -227,6 +230,8 @@ static void chunk_copy_grid(struct player *p, struct chunk *source,
 	struct loc grid, trans = loc_diff(dest_top_left, src_top_left);
 
 	/* Write the location stuff (terrain, objects, traps) */
+	dest->terrain_stamp++;
+	forget_view(dest);
 	for (grid.y = src_top_left.y; grid.y < src_top_left.y + height; grid.y++) {
 		for (grid.x = src_top_left.x; grid.x < src_top_left.x + width;
 			 grid.x++) {
@@ -239,6 +244,7 @@ static void chunk_copy_grid(struct player *p, struct chunk *source,
 			/* Terrain */
 			dest->squares[dest_grid.y][dest_grid.x].feat =
 				square(source, grid)->feat;
+			square_set_layers(dest, dest_grid);
 			sqinfo_copy(square(dest, dest_grid)->info,
 						square(source, grid)->info);
 
@@ -274,7 +280,7 @@ static void chunk_copy_grid(struct player *p, struct chunk *source,
 				dest->squares[dest_grid.y][dest_grid.x].mon = mon->midx;
 				source->squares[grid.y][grid.x].mon = 0;
 				mon->grid = dest_grid;
-				mon->place = idx;
+				monster_set_place(mon, idx);
 				flow_free(source, &mon->flow);
 				flow_new(dest, &mon->flow);
 			}
@@ -541,6 +547,80 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 	return true;
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Chunk cache bookkeeping
+ *
+ * Every allocated chunk_list entry is on a doubly linked list in order of
+ * last use, so the least recently used chunk can be evicted without a scan.
+ * Unused entries are kept on a stack, and the memory taken by stored chunks
+ * is tracked so the list can be held to the chunk-cache-kb budget.
+ * ------------------------------------------------------------------------ */
+struct chunk_cache_entry {
+	uint16_t prev;		/**< Next more recently used entry, or MAX_CHUNKS */
+	uint16_t next;		/**< Next less recently used entry, or MAX_CHUNKS */
+	size_t bytes;		/**< Memory used by the stored chunks */
+	bool staged;		/**< Generated ahead, still to be populated */
+	enum biome_type biome;	/**< Biome to populate a staged chunk from */
+};
+
+static struct chunk_cache_entry *chunk_cache;
+static uint16_t chunk_lru_head;		/**< Most recently used entry */
+static uint16_t chunk_lru_tail;		/**< Least recently used entry */
+static uint16_t *chunk_free;		/**< Stack of unused entries */
+static uint16_t chunk_free_num;		/**< Number of unused entries */
+
+/**
+ * Take a chunk_list entry off the list of used entries
+ */
+static void chunk_lru_remove(int idx)
+{
+	struct chunk_cache_entry *entry = &chunk_cache[idx];
+
+	if (entry->prev != MAX_CHUNKS) {
+		chunk_cache[entry->prev].next = entry->next;
+	} else if (chunk_lru_head == idx) {
+		chunk_lru_head = entry->next;
+	} else {
+		/* Not on the list */
+		return;
+	}
+	if (entry->next != MAX_CHUNKS) {
+		chunk_cache[entry->next].prev = entry->prev;
+	} else {
+		chunk_lru_tail = entry->prev;
+	}
+	entry->prev = MAX_CHUNKS;
+	entry->next = MAX_CHUNKS;
+}
+
+/**
+ * Mark a chunk_list entry as the most recently used
+ */
+static void chunk_lru_touch(int idx)
+{
+	struct chunk_cache_entry *entry = &chunk_cache[idx];
+
+	chunk_lru_remove(idx);
+	entry->next = chunk_lru_head;
+	if (chunk_lru_head != MAX_CHUNKS) {
+		chunk_cache[chunk_lru_head].prev = idx;
+	} else {
+		chunk_lru_tail = idx;
+	}
+	chunk_lru_head = idx;
+}
+
+/**
+ * Record the memory used by the stored chunks of a chunk_list entry
+ */
+static void chunk_cache_set_bytes(int idx, size_t bytes)
+{
+	chunk_cache_stats.bytes -= chunk_cache[idx].bytes;
+	chunk_cache[idx].bytes = bytes;
+	chunk_cache_stats.bytes += bytes;
+}
+
 /**
  * Read a chunk from the chunk list and put it back into the current playing
  * area
@@ -577,23 +657,37 @@ void chunk_read(struct player *p, int idx, int y_coord, int x_coord)
 	chunk_wipe(p_chunk);
 	chunk_list[idx].chunk = NULL;
 	chunk_list[idx].p_chunk = NULL;
+
+	/* Account for it in the cache */
+	chunk_cache_stats.hits++;
+	chunk_cache_set_bytes(idx, 0);
+	chunk_lru_touch(idx);
+
+	/* A chunk generated ahead of the player is now really arriving */
+	if (chunk_cache[idx].staged) {
+		chunk_cache[idx].staged = false;
+		chunk_cache_stats.pregen_used++;
+		surface_populate(cave, &chunk_list[idx], chunk_cache[idx].biome);
+	}
 }
 
 /**
- * Write a pair of chunks to memory and record pointers to them
+ * Write a pair of chunks to memory from a pair of arena-sized chunks, and
+ * record pointers to them
  */
 static void chunk_write(struct player *p, int idx, int y_coord, int x_coord,
+						struct chunk *source, struct chunk *p_source,
 						struct chunk **chunk, struct chunk **p_chunk)
 {
 	struct loc from = loc(x_coord * CHUNK_SIDE, y_coord * CHUNK_SIDE);
 	struct chunk *new = chunk_new(CHUNK_SIDE, CHUNK_SIDE);
 	struct chunk *p_new = chunk_new(CHUNK_SIDE, CHUNK_SIDE);
 
-	chunk_copy_grid(p, cave, new, CHUNK_SIDE, CHUNK_SIDE,
+	chunk_copy_grid(p, source, new, CHUNK_SIDE, CHUNK_SIDE,
 					from, loc(0, 0), idx, 0, false, false);
-	chunk_copy_grid(p, p->cave, p_new, CHUNK_SIDE, CHUNK_SIDE,
+	chunk_copy_grid(p, p_source, p_new, CHUNK_SIDE, CHUNK_SIDE,
 					from, loc(0, 0), idx, 0, false, false);
-	chunk_copy_objects_split(p, cave, p->cave, new, p_new, CHUNK_SIDE,
+	chunk_copy_objects_split(p, source, p_source, new, p_new, CHUNK_SIDE,
 							 CHUNK_SIDE, loc(0, 0));
 	chunk_validate_objects(new);
 	chunk_validate_objects(p_new);
@@ -601,6 +695,7 @@ static void chunk_write(struct player *p, int idx, int y_coord, int x_coord,
 
 	*chunk = new;
 	*p_chunk = p_new;
+	chunk_list[idx].dirty = true;
 }
 
 /**
@@ -727,32 +822,8 @@ static int chunk_get_idx(struct player *p, int y_coord, int x_coord)
  */
 int find_region(int y_pos, int x_pos)
 {
-	int i;
-
-	for (i = 1; i < z_info->region_max; i++) {
-		struct world_region *region = &region_info[i];
-		size_t entry;
-
-		if ((y_pos / CPM < region->y_offset) ||
-			(y_pos / CPM >= region->y_offset + region->height)) {
-			continue;
-		}
-
-		if ((x_pos / CPM < region->x_offset) ||
-			(x_pos / CPM >= region->x_offset + region->width)) {
-			continue;
-		}
-
-		entry =	region->width * ((y_pos / CPM) - region->y_offset) +
-			(x_pos / CPM) - region->x_offset;
-		if ((entry >= strlen(region->text)) || (region->text[entry] == ' ')) {
-			continue;
-		}
-
-		break;
-	}
-
-	return i;
+	int region = square_mile_region(loc(x_pos / CPM, y_pos / CPM));
+	return region ? region : z_info->region_max;
 }
 
 /**
@@ -815,6 +886,17 @@ static void connector_add(struct connector **first, struct connector **latest,
 	(*latest)->next = NULL;
 }
 
+static struct mem_pool connector_pool =
+	MEM_POOL_INIT("connectors", struct connector);
+
+/**
+ * Allocate a connector.
+ */
+struct connector *connector_new(void)
+{
+	return mem_pool_alloc(&connector_pool);
+}
+
 /**
  * Free a linked list of connectiors.
  */
@@ -824,8 +906,235 @@ void connectors_free(struct connector *join)
 		struct connector *current = join;
 
 		join = current->next;
-		mem_free(current);
+		mem_pool_free(&connector_pool, current);
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Chunk list index
+ *
+ * Live chunk_list entries are indexed by position in an open addressing hash
+ * table, so finding a chunk by its coordinates does not need a scan of the
+ * whole list.  The adjacent[] entries of live chunks are kept consistent as
+ * entries are added and deleted, touching only the changed entry and its
+ * neighbours.
+ * ------------------------------------------------------------------------ */
+static uint16_t *chunk_hash;		/**< chunk_list indices, MAX_CHUNKS if empty */
+static uint32_t chunk_hash_size;	/**< Size of chunk_hash, a power of two */
+
+/**
+ * Hash a chunk position
+ */
+static uint32_t chunk_hash_key(int z_pos, int y_pos, int x_pos)
+{
+	uint32_t key = (uint32_t) x_pos * 73856093U;
+	key ^= (uint32_t) y_pos * 19349663U;
+	key ^= (uint32_t) z_pos * 83492791U;
+	return (key ^ (key >> 16)) & (chunk_hash_size - 1);
+}
+
+/**
+ * Find the hash table entry for a chunk position; this is either the entry
+ * holding the chunk_list index of the chunk, or the empty entry where it
+ * would go
+ */
+static uint32_t chunk_hash_entry(int z_pos, int y_pos, int x_pos)
+{
+	uint32_t entry = chunk_hash_key(z_pos, y_pos, x_pos);
+
+	while (chunk_hash[entry] != MAX_CHUNKS) {
+		struct chunk_ref *ref = &chunk_list[chunk_hash[entry]];
+		if ((ref->x_pos == x_pos) && (ref->y_pos == y_pos) &&
+			(ref->z_pos == z_pos)) {
+			break;
+		}
+		entry = (entry + 1) & (chunk_hash_size - 1);
+	}
+
+	return entry;
+}
+
+/**
+ * Add a chunk_list entry to the index
+ */
+static void chunk_hash_insert(int idx)
+{
+	struct chunk_ref *ref = &chunk_list[idx];
+	uint32_t entry = chunk_hash_entry(ref->z_pos, ref->y_pos, ref->x_pos);
+	chunk_hash[entry] = idx;
+}
+
+/**
+ * Remove a chunk_list entry from the index, shifting back any later entries
+ * in the same probe sequence so lookups never need tombstones
+ */
+static void chunk_hash_remove(int idx)
+{
+	struct chunk_ref *ref = &chunk_list[idx];
+	uint32_t mask = chunk_hash_size - 1;
+	uint32_t hole = chunk_hash_entry(ref->z_pos, ref->y_pos, ref->x_pos);
+	uint32_t entry = hole;
+
+	if (chunk_hash[hole] != idx) return;
+	chunk_hash[hole] = MAX_CHUNKS;
+	while (true) {
+		struct chunk_ref *next;
+		uint32_t home;
+
+		entry = (entry + 1) & mask;
+		if (chunk_hash[entry] == MAX_CHUNKS) break;
+
+		/* Move the entry into the hole if its home is not between them */
+		next = &chunk_list[chunk_hash[entry]];
+		home = chunk_hash_key(next->z_pos, next->y_pos, next->x_pos);
+		if (((entry - home) & mask) >= ((entry - hole) & mask)) {
+			chunk_hash[hole] = chunk_hash[entry];
+			chunk_hash[entry] = MAX_CHUNKS;
+			hole = entry;
+		}
+	}
+}
+
+/**
+ * Get the position of the chunk adjacent to a chunk_ref in a given direction.
+ * \return false if that position is off the map
+ */
+static bool chunk_adjacent_pos(struct chunk_ref *ref, int n, int *z_pos,
+							   int *y_pos, int *x_pos)
+{
+	int z_off, y_off, x_off;
+
+	chunk_adjacent_to_offset(n, &z_off, &y_off, &x_off);
+	if (((ref->y_pos == 0) && (y_off < 0)) ||
+		((ref->y_pos >= CPM * MAX_Y_REGION - 1) && (y_off > 0)) ||
+		((ref->x_pos == 0) && (x_off < 0)) ||
+		((ref->x_pos >= CPM * MAX_X_REGION - 1) && (x_off > 0))) {
+		return false;
+	}
+	*z_pos = ref->z_pos + z_off;
+	*y_pos = ref->y_pos + y_off;
+	*x_pos = ref->x_pos + x_off;
+	return true;
+}
+
+/**
+ * Set the adjacencies of a chunk_list entry, and the reverse adjacencies of
+ * its neighbours
+ */
+static void chunk_link(int idx)
+{
+	struct chunk_ref *ref = &chunk_list[idx];
+	int n;
+
+	for (n = 0; n < DIR_MAX; n++) {
+		int z_pos, y_pos, x_pos;
+		uint32_t entry;
+
+		/* Self-reference (not strictly necessary) */
+		if (n == DIR_NONE) {
+			ref->adjacent[n] = idx;
+			continue;
+		}
+
+		/* Set to the default */
+		ref->adjacent[n] = MAX_CHUNKS;
+		if (!chunk_adjacent_pos(ref, n, &z_pos, &y_pos, &x_pos)) continue;
+
+		/* Link up with an existing chunk */
+		entry = chunk_hash_entry(z_pos, y_pos, x_pos);
+		if (chunk_hash[entry] != MAX_CHUNKS) {
+			ref->adjacent[n] = chunk_hash[entry];
+			chunk_list[chunk_hash[entry]].adjacent[opposite_dir(n)] = idx;
+		}
+	}
+}
+
+/**
+ * Clear the reverse adjacencies of a chunk_list entry's neighbours
+ */
+static void chunk_unlink(int idx)
+{
+	struct chunk_ref *ref = &chunk_list[idx];
+	int n;
+
+	for (n = 0; n < DIR_MAX; n++) {
+		int adj = ref->adjacent[n];
+		if ((n == DIR_NONE) || (adj < 0) || (adj >= MAX_CHUNKS)) continue;
+		if (chunk_list[adj].adjacent[opposite_dir(n)] == idx) {
+			chunk_list[adj].adjacent[opposite_dir(n)] = MAX_CHUNKS;
+		}
+	}
+}
+
+/**
+ * Order chunk_list entries by the turn they were last used
+ */
+static int cmp_chunk_turn(const void *a, const void *b)
+{
+	int idx_a = *(const uint16_t *) a, idx_b = *(const uint16_t *) b;
+
+	if (chunk_list[idx_a].turn != chunk_list[idx_b].turn) {
+		return (chunk_list[idx_a].turn < chunk_list[idx_b].turn) ? -1 : 1;
+	}
+	return idx_a - idx_b;
+}
+
+/**
+ * Rebuild the chunk_list index, all adjacencies and the cache bookkeeping
+ * from scratch; needed when chunk_list entries have been set directly (on
+ * birth or savefile load)
+ */
+void chunk_list_reindex(void)
+{
+	int i, num = 0;
+	uint16_t *order = mem_alloc(MAX_CHUNKS * sizeof(uint16_t));
+
+	for (i = 0; i < (int) chunk_hash_size; i++) {
+		chunk_hash[i] = MAX_CHUNKS;
+	}
+	chunk_lru_head = MAX_CHUNKS;
+	chunk_lru_tail = MAX_CHUNKS;
+	chunk_free_num = 0;
+	chunk_cnt = 0;
+	chunk_cache_stats.bytes = 0;
+	for (i = MAX_CHUNKS - 1; i >= 0; i--) {
+		struct chunk_ref *ref = &chunk_list[i];
+		int n;
+
+		ref->place = i;
+		for (n = 0; n < DIR_MAX; n++) {
+			ref->adjacent[n] = MAX_CHUNKS;
+		}
+		chunk_cache[i].prev = MAX_CHUNKS;
+		chunk_cache[i].next = MAX_CHUNKS;
+		chunk_cache[i].bytes = 0;
+		chunk_cache[i].staged = false;
+
+		/* Unused entries go on the free stack, lowest index on top */
+		if (!ref->region) {
+			chunk_free[chunk_free_num++] = i;
+			continue;
+		}
+		chunk_hash_insert(i);
+		order[num++] = i;
+		chunk_cnt++;
+		if (i >= chunk_max) chunk_max = i + 1;
 	}
+
+	/* Used entries go on the LRU list, oldest at the tail */
+	qsort(order, num, sizeof(uint16_t), cmp_chunk_turn);
+	for (i = 0; i < num; i++) {
+		struct chunk_ref *ref = &chunk_list[order[i]];
+
+		chunk_link(order[i]);
+		chunk_lru_touch(order[i]);
+		if (ref->chunk) {
+			chunk_cache_set_bytes(order[i], chunk_memory(ref->chunk)
+								  + chunk_memory(ref->p_chunk));
+		}
+	}
+	mem_free(order);
 }
 
 /**
@@ -833,11 +1142,48 @@ void connectors_free(struct connector *join)
  * Chunk list operations
  * ------------------------------------------------------------------------ */
 /**
- * Allocate the chunk list
+ * Allocate the chunk list and its index for a given number of entries
+ */
+static void chunk_list_alloc(int size)
+{
+	int old_size = chunk_list ? MAX_CHUNKS : 0;
+
+	chunk_list_max = size;
+	chunk_list = mem_realloc(chunk_list, size * sizeof(struct chunk_ref));
+	memset(chunk_list + old_size, 0,
+		   (size - old_size) * sizeof(struct chunk_ref));
+	chunk_cache = mem_realloc(chunk_cache,
+							  size * sizeof(struct chunk_cache_entry));
+	chunk_free = mem_realloc(chunk_free, size * sizeof(uint16_t));
+
+	/* Keep the index at most half full */
+	chunk_hash_size = 1;
+	while (chunk_hash_size < 2 * (uint32_t) size) {
+		chunk_hash_size <<= 1;
+	}
+	chunk_hash = mem_realloc(chunk_hash, chunk_hash_size * sizeof(uint16_t));
+}
+
+/**
+ * Allocate the chunk list; it is never smaller than saving and reloading the
+ * arena needs, even if constants.txt doesn't give a size
  */
 void chunk_list_init(void)
 {
-	chunk_list = mem_zalloc(MAX_CHUNKS * sizeof(struct chunk_ref));
+	memset(&chunk_cache_stats, 0, sizeof(chunk_cache_stats));
+	chunk_list_alloc(MAX(z_info->chunk_cache, MIN_CHUNKS));
+	chunk_list_reindex();
+}
+
+/**
+ * Make sure the chunk list has room for at least size entries; used when a
+ * savefile was made with a bigger chunk list than the current one
+ */
+void chunk_list_reserve(int size)
+{
+	if (size <= MAX_CHUNKS) return;
+	chunk_list_alloc(size);
+	chunk_list_reindex();
 }
 
 /**
@@ -857,6 +1203,34 @@ void chunk_list_cleanup(void)
 	}
 	mem_free(chunk_list);
 	chunk_list = NULL;
+	mem_free(chunk_cache);
+	chunk_cache = NULL;
+	mem_free(chunk_free);
+	chunk_free = NULL;
+	mem_free(chunk_hash);
+	chunk_hash = NULL;
+	chunk_hash_size = 0;
+
+	/* The locations holding connectors are freed first */
+	mem_pool_release(&connector_pool);
+}
+
+/**
+ * Get an unused entry in the chunk list
+ */
+static int chunk_new_slot(void)
+{
+	int idx;
+
+	assert(chunk_free_num);
+	idx = chunk_free[--chunk_free_num];
+
+	/* Increment the counter, and the maximum if necessary */
+	chunk_cnt++;
+	if (idx >= chunk_max)
+		chunk_max = idx + 1;
+
+	return idx;
 }
 
 /**
@@ -864,9 +1238,15 @@ void chunk_list_cleanup(void)
  */
 static void chunk_delete(int idx)
 {
-	int i, j;
+	int i;
 	struct chunk_ref *ref = &chunk_list[idx];
 
+	/* Remove from the index and repair adjacencies */
+	if (ref->region) {
+		chunk_hash_remove(idx);
+		chunk_unlink(idx);
+	}
+
 	ref->turn = 0;
 	ref->region = 0;
 	ref->z_pos = 0;
@@ -885,114 +1265,95 @@ static void chunk_delete(int idx)
 		ref->adjacent[i] = MAX_CHUNKS;
 	}
 
-	/* Repair chunks */
-	for (i = 0; i < chunk_max; i++) {
-		/* Get the chunk */
-		struct chunk_ref *chunk = &chunk_list[i];
-
-		/* Skip dead chunks */
-		if (!chunk->region) continue;
-
-		/* Repair adjacencies */
-		for (j = 0; j < DIR_MAX; j++) {
-			if (chunk->adjacent[j] == idx) {
-				chunk->adjacent[j] = MAX_CHUNKS;
-			}
-		}
-	}
+	/* Return the entry to the free stack */
+	chunk_lru_remove(idx);
+	chunk_cache_set_bytes(idx, 0);
+	chunk_cache[idx].staged = false;
+	chunk_free[chunk_free_num++] = idx;
+	chunk_cnt--;
 }
 
 /**
- * Delete all the same age dungeon chunks (wiping out all of a level
- * if some goes)
+ * Delete a stored dungeon chunk and all the same age chunks connected to it
+ * on its level (wiping out all of a level if some goes)
  */
-static void chunk_delete_level(int age)
+static void chunk_delete_level(int idx)
 {
-	int i;
+	struct chunk_ref *ref = &chunk_list[idx];
+	int z_pos = ref->z_pos, age = ref->turn;
+	int adjacent[DIR_MAX];
+	int n;
 
-	for (i = 0; i < MAX_CHUNKS; i++) {
-		if (chunk_list[i].turn == turn) {
-			chunk_delete(i);
+	memcpy(adjacent, ref->adjacent, sizeof(adjacent));
+	chunk_delete(idx);
+	for (n = 0; n < DIR_MAX; n++) {
+		struct chunk_ref *adj;
 
-			/* Decrement the counter, and the maximum if necessary */
-			chunk_cnt--;
-			if (i == chunk_max) {
-				chunk_max--;
-			}
+		if ((n == DIR_NONE) || (adjacent[n] == MAX_CHUNKS)) continue;
+		adj = &chunk_list[adjacent[n]];
+		if (adj->region && adj->chunk && (adj->z_pos == z_pos) &&
+			(adj->turn == age)) {
+			chunk_delete_level(adjacent[n]);
 		}
 	}
 }
 
 /**
- * Find a chunk_ref in chunk_list
+ * Evict the least recently used stored chunk from the chunk list, along with
+ * the rest of its level if it is from the dungeon.  Chunks stored this turn
+ * are kept so levels being stored are never split up.
+ * \param need_slot if true and there is no stored chunk to evict, evict the
+ * least recently used entry of any kind so the slot can be reused
+ * \return whether anything was evicted
  */
-int chunk_find(struct chunk_ref ref)
+static bool chunk_evict(bool need_slot)
 {
-	int i;
+	int idx;
 
-	/* Search the list */
-	for (i = 0; i < MAX_CHUNKS; i++) {
-		/* Reject wrong values */
-		//if (ref.region != chunk_list[i].region) continue;
-		if (ref.x_pos != chunk_list[i].x_pos) continue;
-		if (ref.y_pos != chunk_list[i].y_pos) continue;
-		if (ref.z_pos != chunk_list[i].z_pos) continue;
-
-		break;
+	for (idx = chunk_lru_tail; idx != MAX_CHUNKS; idx = chunk_cache[idx].prev) {
+		if (chunk_list[idx].chunk && (chunk_list[idx].turn != turn)) break;
+	}
+	if ((idx == MAX_CHUNKS) && need_slot) {
+		idx = chunk_lru_tail;
 	}
+	if (idx == MAX_CHUNKS) return false;
 
-	return i;
+	/* Delete whole levels at once */
+	if ((chunk_list[idx].z_pos > 0) && chunk_list[idx].chunk) {
+		chunk_delete_level(idx);
+	} else {
+		chunk_delete(idx);
+	}
+	chunk_cache_stats.evictions++;
+	return true;
 }
 
 /**
- * Check and repair all the entries in the chunk_list
+ * Evict stored chunks until they are within the memory budget
  */
-static void chunk_fix_all(void)
+static void chunk_cache_trim(void)
 {
-	int n, z_off, y_off, x_off, idx;
-
-	for (idx = 0; idx < MAX_CHUNKS; idx++) {
-		/* Get the chunk ref */
-		struct chunk_ref *ref = &chunk_list[idx];
-
-		/* Remove dead chunks */
-		if (!ref->region) {//B need something better, as this is Belegaer
-			chunk_delete(idx);
-			continue;
-		}
-
-		/* Set the index */
-		ref->place = idx;
-
-		/* Set adjacencies */
-		for (n = 0; n < DIR_MAX; n++) {
-			struct chunk_ref ref1 = { 0 };
-			int chunk_idx;
+	size_t budget = (size_t) z_info->chunk_cache_kb * 1024;
 
-			/* Self-reference (not strictly necessary) */
-			if (n == DIR_NONE) {
-				ref->adjacent[n] = idx;
-				continue;
-			}
+	while (budget && (chunk_cache_stats.bytes > budget) && chunk_evict(false))
+		;
+}
 
-			/* Set to the default */
-			ref->adjacent[n] = MAX_CHUNKS;
+/**
+ * Say whether a chunk_list entry holds a chunk generated ahead of the player
+ * which has not yet been read into the arena
+ */
+bool chunk_is_staged(int idx)
+{
+	return chunk_cache[idx].staged;
+}
 
-			/* Get the reference data for the adjacent chunk */
-			chunk_adjacent_to_offset(n, &z_off, &y_off, &x_off);
-			ref1.z_pos = ref->z_pos;
-			ref1.y_pos = ref->y_pos;
-			ref1.x_pos = ref->x_pos;
-			ref1.region = ref->region;
-			chunk_offset_data(&ref1, z_off, y_off, x_off);
-
-			/* Deal with existing chunks */
-			chunk_idx = chunk_find(ref1);
-			if (chunk_idx < MAX_CHUNKS) {
-				ref->adjacent[n] = chunk_idx;
-			}
-		}
-	}
+/**
+ * Find a chunk_ref in chunk_list
+ */
+int chunk_find(struct chunk_ref ref)
+{
+	return chunk_hash[chunk_hash_entry(ref.z_pos, ref.y_pos, ref.x_pos)];
 }
 
 /**
@@ -1002,8 +1363,8 @@ int chunk_store(int y_coord, int x_coord, uint16_t region, uint16_t z_pos,
 				uint16_t y_pos, uint16_t x_pos, uint32_t gen_loc_idx,
 				bool write)
 {
-	int i;
-	int max = turn, idx = 0;
+	int idx;
+	bool new_slot;
 
 	struct chunk_ref ref = { 0 };
 
@@ -1015,43 +1376,13 @@ int chunk_store(int y_coord, int x_coord, uint16_t region, uint16_t z_pos,
 
 	idx = chunk_find(ref);
 
-	/* We need a new slot */
-	if (idx == MAX_CHUNKS) {
-		/* Too many chunks */
-		if (chunk_cnt >= MAX_CHUNKS - 1) {
-			/* Find and delete the oldest chunk */
-			idx = 0;
-			for (i = 0; i < MAX_CHUNKS; i++) {
-				if (chunk_list[i].turn < max) {
-					max = chunk_list[i].turn;
-					idx = i;
-				}
-			}
-			chunk_delete(idx);
-
-			/* Delete whole levels at once */
-			if (chunk_list[idx].z_pos > 0) {
-				chunk_delete_level(max);
-			} else {
-				/* Decrement the counter, and the maximum if necessary */
-				chunk_cnt--;
-				if (idx == chunk_max)
-					chunk_max--;
-			}
-		} else {
-			/* Find the next free slot */
-			for (idx = 0; idx < chunk_max; idx++) {
-				if (!chunk_list[idx].region) {
-					break;
-				}
-			}
+	/* We need a new slot, so make room if there are too many chunks */
+	new_slot = (idx == MAX_CHUNKS);
+	if (new_slot) {
+		if (!chunk_free_num && !chunk_evict(true)) {
+			quit("Chunk list full!");
 		}
-
-		/* Increment the counter, and the maximum if necessary */
-		chunk_cnt++;
-		assert(chunk_max <= MAX_CHUNKS);
-		if (idx == chunk_max)
-			chunk_max++;
+		idx = chunk_new_slot();
 	}
 
 	/* Set all the values */
@@ -1064,16 +1395,29 @@ int chunk_store(int y_coord, int x_coord, uint16_t region, uint16_t z_pos,
 	chunk_list[idx].x_pos = x_pos;
 	chunk_list[idx].z_pos = z_pos;
 	chunk_list[idx].gen_loc_idx = gen_loc_idx;
-	chunk_list[idx].adjacent[5] = idx;
+
+	/* Index a new chunk and link it to its neighbours */
+	if (new_slot && region) {
+		chunk_hash_insert(idx);
+		chunk_link(idx);
+	}
+	chunk_lru_touch(idx);
 
 	/* Write the chunks */
 	if (write) {
-		chunk_write(player, idx, y_coord, x_coord, &chunk_list[idx].chunk,
-					&chunk_list[idx].p_chunk);
+		chunk_write(player, idx, y_coord, x_coord, cave, player->cave,
+					&chunk_list[idx].chunk, &chunk_list[idx].p_chunk);
+		chunk_cache_set_bytes(idx, chunk_memory(chunk_list[idx].chunk)
+							  + chunk_memory(chunk_list[idx].p_chunk));
 	}
 
-	/* Repair the list */
-	chunk_fix_all();
+	/* Remove dead chunks */
+	if (!region) {//B need something better, as this is Belegaer
+		chunk_delete(idx);
+	}
+
+	/* Keep to the memory budget */
+	chunk_cache_trim();
 
 	return idx;
 }
@@ -1082,43 +1426,77 @@ int chunk_store(int y_coord, int x_coord, uint16_t region, uint16_t z_pos,
  * ------------------------------------------------------------------------
  * Handling of player going from one chunk to the next
  * ------------------------------------------------------------------------ */
+/**
+ * Seed a generator for one place in the world from the world seed, so what is
+ * made there doesn't depend on when it is made or take anything from the
+ * game's generator
+ * \param rng is the generator
+ * \param kind keeps different uses of the same place apart
+ * \param y
+ * \param x are the place, in chunk or square mile coordinates
+ */
+static void world_rng_init(struct rng_ctx *rng, uint32_t kind, int y, int x)
+{
+	uint32_t seed = seed_world;
+
+	seed = (seed ^ kind) * 0x9E3779B1U;
+	seed = (seed ^ (uint32_t) y) * 0x85EBCA6BU;
+	seed = (seed ^ (uint32_t) x) * 0xC2B2AE35U;
+	rng_state_init(rng, seed ^ (seed >> 16));
+}
+
 /**
  * Generate a chunk
+ * \return whether it is ordinary surface, which needs monsters from the biome
+ * put in *biome
  */
-static void chunk_generate(struct chunk *c, struct gen_loc *loc,
+static bool chunk_generate(struct chunk *c, struct gen_loc *loc,
 						   struct chunk_ref *ref, int y_coord, int x_coord,
-						   struct connector *first)
+						   struct connector *first, enum biome_type *biome)
 {
 	int y_pos = ref->y_pos, x_pos = ref->x_pos;
 	struct landmark *landmark = find_landmark(x_pos, y_pos, 0);
+	struct rng_ctx rng;
 
-	/* Build the landmark... */
-	if (landmark) {
-		build_landmark(c, landmark, y_pos, x_pos, y_coord, x_coord);
-	} else {
-		/* or set the RNG to give reproducible results... */
+	/* Seed a generator to give reproducible results... */
+	if (!loc->seed) {
+		world_rng_init(&rng, 0, y_pos, x_pos);
 		while (!loc->seed) {
-			loc->seed = randint0(0x10000000);
+			loc->seed = rng_int0(&rng, 0x10000000);
 		}
-		Rand_quick = true;
-		Rand_value = loc->seed;
 
-		/* ...and generate the chunk */
-		surface_gen(c, ref, y_coord, x_coord, first);
+		/* The seed must be saved, even if the location was made (by
+		 * river mapping, say) before the last full save */
+		loc->dirty = true;
 	}
+	rng_quick_init(&rng, loc->seed);
+
+	/* ...and build the landmark... */
+	if (landmark) {
+		build_landmark(c, &rng, landmark, y_pos, x_pos, y_coord, x_coord);
+		return false;
+	}
+
+	/* ...or generate the chunk */
+	*biome = surface_gen(c, ref, y_coord, x_coord, first, &rng);
+	return true;
 }
 
 /**
- * Generate a chunk on the surface
+ * Generate the terrain of a chunk on the surface, and record it as generated
+ * \param populate is set to whether monsters still need adding
+ * \param biome is set to the biome for those monsters
  */
-int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
+static int chunk_fill_terrain(struct chunk *c, struct chunk_ref *ref,
+							  int y_coord, int x_coord, bool *populate,
+							  enum biome_type *biome)
 {
 	int n, z_off, y_off, x_off, idx;
 	int z_pos = ref->z_pos, y_pos = ref->y_pos, x_pos = ref->x_pos;
 	int lower, upper, region;
 	bool reload;
 	struct gen_loc *location;
-	struct square_mile *mile = &square_miles[y_pos / CPM][x_pos / CPM];
+	struct loc mile = loc(x_pos / CPM, y_pos / CPM);
 	struct connector east[CHUNK_SIDE] = {{{0}, 0, {0}, 0, 0}};
 	struct connector west[CHUNK_SIDE] = {{{0}, 0, {0}, 0, 0}};
 	struct connector north[CHUNK_SIDE] = {{{0}, 0, {0}, 0, 0}};
@@ -1128,11 +1506,16 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 	struct connector *latest = NULL;
 
 	/* If underground, return */
+	*populate = false;
 	if (z_pos) return MAX_CHUNKS;
 
 	/* See if we've been generated before */
 	reload = gen_loc_find(x_pos, y_pos, z_pos, &lower, &upper);
 
+	/* Not in the chunk list, so count a cache miss */
+	chunk_cache_stats.misses++;
+	if (reload) chunk_cache_stats.regenerations++;
+
 	/* Access the old place in the gen_loc_list, or make the new one */
 	if (reload) {
 		location = &gen_loc_list[upper];
@@ -1142,10 +1525,13 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 	}
 
 	/* Check for new square miles and do river mapping */
-	if (!mile->mapped) {
-		map_river_miles(mile);
+	if (!square_mile_is_mapped(mile)) {
+		struct rng_ctx rng;
+
+		world_rng_init(&rng, 1, mile.y, mile.x);
+		map_river_miles(mile, &rng);
 
-		/* Get the location again in case it's moved */
+		/* Get the location again in case the list has been reallocated */
 		reload = gen_loc_find(x_pos, y_pos, z_pos, &lower, &upper);
 		assert(reload);
 		location = &gen_loc_list[upper];
@@ -1265,7 +1651,8 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 	}
 
 	/* Place chunk */
-	chunk_generate(c, location, ref, y_coord, x_coord, first);
+	*populate = chunk_generate(c, location, ref, y_coord, x_coord, first,
+							   biome);
 
 	/* Do terrain changes */
 	if (reload) {
@@ -1288,11 +1675,13 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 		int y0 = CHUNK_SIDE * y_coord;
 		int x0 = CHUNK_SIDE * x_coord;
 
+		location->dirty = true;
+
 		/* South, north and vertical */
 		for (x = 0; x < CHUNK_SIDE; x++) {
 			if (south[x].feat == 0) {
 				struct loc grid = loc(x0 + x, y0 + CHUNK_SIDE - 1);
-				struct connector *new = mem_zalloc(sizeof *new);
+				struct connector *new = connector_new();
 				new->grid.y = CHUNK_SIDE - 1;
 				new->grid.x = x;
 				new->feat = square(c, grid)->feat;
@@ -1303,7 +1692,7 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 			}
 			if (north[x].feat == 0) {
 				struct loc grid = loc(x0 + x, y0);
-				struct connector *new = mem_zalloc(sizeof *new);
+				struct connector *new = connector_new();
 				new->grid.y = 0;
 				new->grid.x = x;
 				new->feat = square(c, grid)->feat;
@@ -1318,7 +1707,7 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 				if (feat == 0) {
 					if (feat_is_stair(square(c, grid)->feat) ||
 						feat_is_chasm(square(c, grid)->feat)) {
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = y;
 						new->grid.x = x;
 						new->feat = square(c, grid)->feat;
@@ -1335,7 +1724,7 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 		for (y = 0; y < CHUNK_SIDE; y++) {
 			if (west[y].feat == 0) {
 				struct loc grid = loc(x0, y0 + y);
-				struct connector *new = mem_zalloc(sizeof *new);
+				struct connector *new = connector_new();
 				new->grid.y = y;
 				new->grid.x = 0;
 				new->feat = square(c, grid)->feat;
@@ -1346,7 +1735,7 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 			}
 			if (east[y].feat == 0) {
 				struct loc grid = loc(x0 + CHUNK_SIDE - 1, y0 + y);
-				struct connector *new = mem_zalloc(sizeof *new);
+				struct connector *new = connector_new();
 				new->grid.y = y;
 				new->grid.x = CHUNK_SIDE - 1;
 				new->feat = square(c, grid)->feat;
@@ -1360,6 +1749,19 @@ int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
 	return idx;
 }
 
+/**
+ * Generate a chunk on the surface
+ */
+int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord, int x_coord)
+{
+	bool populate;
+	enum biome_type biome;
+	int idx = chunk_fill_terrain(c, ref, y_coord, x_coord, &populate, &biome);
+
+	if (populate) surface_populate(c, ref, biome);
+	return idx;
+}
+
 /**
  * Deal with re-aligning the playing arena on the same z-level
  *
@@ -1457,6 +1859,7 @@ static void arena_realign(struct player *p, int y_offset, int x_offset)
 
 	chunk_wipe(cave);
 	chunk_wipe(p->cave);
+	chunk_set_live(new);
 	cave = new;
 	p->cave = p_new;
 
@@ -1495,38 +1898,206 @@ static void arena_realign(struct player *p, int y_offset, int x_offset)
 }
 
 /**
- * Get the centre chunk from the playing arena
- * This is necessary in dungeons because the player is not kept central
+ * Give an arena the terrain around a chunk that arena_realign() will have put
+ * there by the time it generates the chunk, which is that of all the chunks
+ * it keeps and of those it reads in or generates first.  Generation looks past
+ * the edges of the chunk, for deep water and for the extent of starburst
+ * areas, so all of the neighbouring chunks are copied.
+ * \param p is the player
+ * \param c is the arena
+ * \param y_coord
+ * \param x_coord are where the chunk will go in the arena
+ * \param y_offset
+ * \param x_offset are the direction the arena will move in
  */
-int chunk_get_centre(void)
+static void chunk_stage_surround(struct player *p, struct chunk *c,
+								 int y_coord, int x_coord, int y_offset,
+								 int x_offset)
 {
-	int idx = -1;
-	int max_y = 0, max_x = 0;
-	int min_y = CPM * MAX_Y_REGION, min_x = CPM * MAX_X_REGION;
-
-	/* Find the min x and y positions */
-	for (idx = 0; idx < MAX_CHUNKS; idx++) {
-		struct chunk_ref ref = chunk_list[idx];
-		if (!ref.chunk) {
-			if (ref.y_pos > max_y) max_y = ref.y_pos;
-			if (ref.x_pos > max_x) max_x = ref.x_pos;
-			if (ref.y_pos < min_y) min_y = ref.y_pos;
-			if (ref.x_pos < min_x) min_x = ref.x_pos;
-			if ((max_y - min_y == ARENA_CHUNKS - 1) &&
-				(max_x - min_x == ARENA_CHUNKS - 1)) break;
+	struct chunk_ref *centre = &chunk_list[p->place];
+	struct loc top_left = loc(x_coord * CHUNK_SIDE, y_coord * CHUNK_SIDE);
+	struct loc grid;
+
+	for (grid.y = top_left.y - CHUNK_SIDE;
+		 grid.y < top_left.y + 2 * CHUNK_SIDE; grid.y++) {
+		for (grid.x = top_left.x - CHUNK_SIDE;
+			 grid.x < top_left.x + 2 * CHUNK_SIDE; grid.x++) {
+			int y = grid.y / CHUNK_SIDE, x = grid.x / CHUNK_SIDE;
+			int old_y = y + y_offset, old_x = x + x_offset;
+			struct chunk *source;
+			struct loc src;
+
+			/* Only the neighbouring chunks, inside the arena */
+			if (!square_in_bounds(c, grid)) continue;
+			if ((y == y_coord) && (x == x_coord)) continue;
+
+			if ((old_y >= 0) && (old_y < ARENA_CHUNKS) &&
+				(old_x >= 0) && (old_x < ARENA_CHUNKS)) {
+				/* Kept from the current arena */
+				source = cave;
+				src = loc(old_x * CHUNK_SIDE + grid.x % CHUNK_SIDE,
+						  old_y * CHUNK_SIDE + grid.y % CHUNK_SIDE);
+			} else {
+				/* Read in from the chunk list */
+				struct chunk_ref ref = { 0 };
+				int idx;
+
+				/* Chunks after this one aren't there yet */
+				if (y * ARENA_CHUNKS + x > y_coord * ARENA_CHUNKS + x_coord) {
+					continue;
+				}
+
+				ref.y_pos = centre->y_pos + old_y - ARENA_CHUNKS / 2;
+				ref.x_pos = centre->x_pos + old_x - ARENA_CHUNKS / 2;
+				idx = chunk_find(ref);
+				if ((idx == MAX_CHUNKS) || !chunk_list[idx].chunk) continue;
+				source = chunk_list[idx].chunk;
+				src = loc(grid.x % CHUNK_SIDE, grid.y % CHUNK_SIDE);
+			}
+
+			/* Just the feature, which isn't kept with the chunk */
+			c->squares[grid.y][grid.x].feat = square(source, src)->feat;
 		}
 	}
+}
 
-	/* Find the centre */
-	for (idx = 0; idx < MAX_CHUNKS; idx++) {
-		struct chunk_ref ref = chunk_list[idx];
-		if (!ref.chunk && (ref.y_pos == min_y + ARENA_CHUNKS / 2) &&
-			(ref.x_pos == min_x + ARENA_CHUNKS / 2))
-			return idx;
+/**
+ * Generate a chunk ahead of the player and keep it in the chunk list until it
+ * is read into the arena, which is when it gets its monsters
+ * \param p is the player
+ * \param ref has the position of the chunk
+ * \param y_coord
+ * \param x_coord are where the chunk will go in the arena
+ * \param y_offset
+ * \param x_offset are the direction the arena will move in
+ * \return whether the chunk was generated
+ */
+static bool chunk_stage(struct player *p, struct chunk_ref *ref, int y_coord,
+						int x_coord, int y_offset, int x_offset)
+{
+	struct chunk *c, *p_c;
+	struct chunk_ref *stored;
+	bool populate;
+	enum biome_type biome;
+	int i, idx;
+
+	/* Landmarks and places outside any region are left until needed */
+	if ((find_region(ref->y_pos, ref->x_pos) >= z_info->region_max) ||
+		find_landmark(ref->x_pos, ref->y_pos, 0)) {
+		return false;
 	}
 
+	/* Generate it in an arena of its own, in the place it will go and with
+	 * what will be around it, so it comes out just as it would in the real
+	 * one */
+	c = chunk_new(ARENA_SIDE, ARENA_SIDE);
+	p_c = chunk_new(ARENA_SIDE, ARENA_SIDE);
+	chunk_stage_surround(p, c, y_coord, x_coord, y_offset, x_offset);
+	idx = chunk_fill_terrain(c, ref, y_coord, x_coord, &populate, &biome);
+	assert(populate);
+
+	/* Store it, with the feature counts generating it in the arena would
+	 * have added */
+	stored = &chunk_list[idx];
+	chunk_write(p, idx, y_coord, x_coord, c, p_c, &stored->chunk,
+				&stored->p_chunk);
+	for (i = 0; i < FEAT_MAX + 1; i++) {
+		stored->chunk->feat_count[i] = c->feat_count[i];
+	}
+	chunk_wipe(c);
+	chunk_wipe(p_c);
+	chunk_cache_set_bytes(idx, chunk_memory(stored->chunk)
+						  + chunk_memory(stored->p_chunk));
+	chunk_cache[idx].staged = true;
+	chunk_cache[idx].biome = biome;
+	chunk_cache_stats.pregenerated++;
+	chunk_cache_trim();
+	return true;
+}
+
+/**
+ * Generate a chunk the player is likely to need soon.
+ *
+ * The player is taken to be heading for the nearest edge of the centre chunk.
+ * The chunks that crossing it would bring into the arena are generated one
+ * per call, in the order arena_realign() would generate them, so that the
+ * crossing only has to read them in from the chunk list.
+ *
+ * This is done on the main thread, between player turns, as generation adds
+ * to the location and chunk lists and looks at the terrain of the arena.
+ */
+void chunk_pregenerate(struct player *p)
+{
+	struct chunk_ref *centre = &chunk_list[p->place];
+	int py = p->grid.y - (ARENA_CHUNKS / 2) * CHUNK_SIDE;
+	int px = p->grid.x - (ARENA_CHUNKS / 2) * CHUNK_SIDE;
+	int y_offset = 0, x_offset = 0;
+	int y, x;
+
+	/* Only on the surface, with the player in the centre chunk */
+	if (p->depth || p->upkeep->generate_level) return;
+	if ((cave->height != ARENA_SIDE) || (cave->width != ARENA_SIDE)) return;
+	if ((py < 0) || (py >= CHUNK_SIDE) || (px < 0) || (px >= CHUNK_SIDE)) {
+		return;
+	}
+
+	/* Pick the nearest edge */
+	if (MIN(py, CHUNK_SIDE - 1 - py) < MIN(px, CHUNK_SIDE - 1 - px)) {
+		y_offset = (py < CHUNK_SIDE / 2) ? -1 : 1;
+	} else {
+		x_offset = (px < CHUNK_SIDE / 2) ? -1 : 1;
+	}
+
+	/* Find the first chunk crossing that edge would need generated */
+	for (y = 0; y < ARENA_CHUNKS; y++) {
+		for (x = 0; x < ARENA_CHUNKS; x++) {
+			struct chunk_ref ref = { 0 };
+			int old_y = y + y_offset, old_x = x + x_offset;
+			int y_pos = centre->y_pos + old_y - ARENA_CHUNKS / 2;
+			int x_pos = centre->x_pos + old_x - ARENA_CHUNKS / 2;
+			int idx;
+
+			/* Already in the arena */
+			if ((old_y >= 0) && (old_y < ARENA_CHUNKS) &&
+				(old_x >= 0) && (old_x < ARENA_CHUNKS)) {
+				continue;
+			}
+
+			/* Off the map */
+			if ((y_pos < 0) || (y_pos >= CPM * MAX_Y_REGION) ||
+				(x_pos < 0) || (x_pos >= CPM * MAX_X_REGION)) {
+				return;
+			}
+
+			/* Already stored, so it will just be read in */
+			ref.y_pos = y_pos;
+			ref.x_pos = x_pos;
+			idx = chunk_find(ref);
+			if ((idx != MAX_CHUNKS) && chunk_list[idx].chunk) continue;
+
+			/* Generate it, or leave the rest if it can't be done yet */
+			(void) chunk_stage(p, &ref, y, x, y_offset, x_offset);
+			return;
+		}
+	}
+}
+
+/**
+ * Get the centre chunk from the playing arena, from the chunk the player is
+ * in and where in the arena that is
+ * This is necessary in dungeons because the player is not kept central
+ */
+int chunk_get_centre(void)
+{
+	struct chunk_ref ref = chunk_list[player->place];
+	int idx;
+
+	ref.y_pos += ARENA_CHUNKS / 2 - player->grid.y / CHUNK_SIDE;
+	ref.x_pos += ARENA_CHUNKS / 2 - player->grid.x / CHUNK_SIDE;
+	idx = chunk_find(ref);
+
 	/* Fail */
-	idx = -1;
+	if ((idx == MAX_CHUNKS) || !chunk_list[idx].region) return -1;
 
 	return idx;
 }
@@ -34,9 +34,10 @@
  * \param finish the finishing grid
  * \param course a square array with all entries zero
  * \param side the dimensions of the array
+ * \param rng the random number generator to use
  */
 static int map_point_to_point(struct loc start, struct loc finish,
-							  uint16_t **course, int side)
+							  uint16_t **course, int side, struct rng_ctx *rng)
 {
 	struct loc grid = start;
 	enum direction dir = DIR_NONE;
@@ -64,11 +65,11 @@ static int map_point_to_point(struct loc start, struct loc finish,
 		must_adjust = (course[grid.y + ddy[dir]][grid.x + ddx[dir]] != 0);
 
 		/* Smallish chance of deviating, none if on the edge */
-		if ((one_in_(6) || must_adjust) &&
+		if ((rng_one_in(rng, 6) || must_adjust) &&
 			(grid.x > 0) && (grid.x < side - 1) &&
 			(grid.y > 0) && (grid.y < side - 1)) {
 			enum direction new_dir = DIR_NONE;
-			if (one_in_(2)) {
+			if (rng_one_in(rng, 2)) {
 				new_dir = cycle[chome[dir] + 1];
 				/* Didn't work, try the other one */
 				if (course[grid.y + ddy[new_dir]][grid.x + ddx[new_dir]] != 0) {
@@ -110,7 +111,7 @@ static int map_point_to_point(struct loc start, struct loc finish,
 				grid = next_grid(grid, cycle[chome[dir] - 1]);
 				assert(course[grid.y][grid.x] == 0);
 				course[grid.y][grid.x] = ++count;
-			} else if (one_in_(2)) {
+			} else if (rng_one_in(rng, 2)) {
 				/* Randomly clockwise first */
 				grid = next_grid(grid, cycle[chome[dir] - 1]);
 				assert(course[grid.y][grid.x] == 0);
@@ -201,7 +202,7 @@ static void find_river_chunk(struct square_mile *sq_mile, struct loc *int_chunk,
 	size_t i;
 	bool vertical = (dir == DIR_N) || (dir == DIR_S);
 
-	/* Coordinates of this square mile in the square_miles array */
+	/* Coordinates of this square mile in the map */
 	int x = sq_mile->map_grid.x, y = sq_mile->map_grid.y;
 
 	/* Coordinates of the chunk in the top left corner */
@@ -307,17 +308,18 @@ static void square_mile_river_borders(struct square_mile *sq_mile,
  * \param finish_dir is the direction where the course finishes
  * \param finish is the finishing point outside the finish side, if known
  * \param course is an array showing which grids are included
+ * \param rng is the random number generator to use
  */
 static int map_course(size_t side, enum direction start_dir, struct loc *start,
 					   enum direction finish_dir, struct loc *finish,
-					   uint16_t **course)
+					   uint16_t **course, struct rng_ctx *rng)
 {
 	int num = 0;
 
 	/* Choose a start point where necessary */
 	if (start->x < 0) {
 		/* Pick a random point along the border (not needed for diagonals) */
-		int start_point = randint0(side);
+		int start_point = rng_int0(rng, side);
 
 		/* Record start */
 		switch (start_dir) {
@@ -336,7 +338,7 @@ static int map_course(size_t side, enum direction start_dir, struct loc *start,
 	/* Choose a finish point where necessary */
 	if (finish->x < 0) {
 		/* Pick a random point along the border (not needed for diagonals) */
-		int finish_point = randint0(side);
+		int finish_point = rng_int0(rng, side);
 
 		/* Record finish */
 		switch (finish_dir) {
@@ -353,7 +355,7 @@ static int map_course(size_t side, enum direction start_dir, struct loc *start,
 	}
 
 	/* Do the actual course */
-	num = map_point_to_point(*start, *finish, course, side);
+	num = map_point_to_point(*start, *finish, course, side, rng);
 
 	return num;
 }
@@ -574,7 +576,7 @@ static void write_river_piece(uint16_t **course, struct gen_loc *location)
 	for (y = 0; y < CHUNK_SIDE; y++) {
 		for (x = 0; x < CHUNK_SIDE; x++) {
 			if (course[y][x]) {
-				struct river_grid *rgrid = mem_zalloc(sizeof(*rgrid));
+				struct river_grid *rgrid = river_grid_new();
 				rgrid->next = location->river_piece->grids;
 				rgrid->grid = loc(x, y);
 				location->river_piece->grids = rgrid;
@@ -598,7 +600,8 @@ static void write_river_pieces(struct square_mile *sq_mile,
 							   enum direction start_dir, struct loc start,
 							   struct loc start_adj, enum direction finish_dir,
 							   struct loc finish, struct loc finish_adj,
-							   uint16_t **course, int num)
+							   uint16_t **course, int num,
+							   struct rng_ctx *rng)
 {
 	int k;
 
@@ -626,20 +629,20 @@ static void write_river_pieces(struct square_mile *sq_mile,
 	if (width > 1) {
 		/* Always choose as perpendicular a direction as possible */
 		bool right = (finish.x > start.x) ||
-			((finish.x == start.x) && one_in_(2));
+			((finish.x == start.x) && rng_one_in(rng, 2));
 		bool down = (finish.y > start.y) ||
-			((finish.y == start.y) && one_in_(2));
+			((finish.y == start.y) && rng_one_in(rng, 2));
 		if (right) {
 			if (down) {
-				widen_dir = one_in_(2) ? DIR_SW : DIR_NE;
+				widen_dir = rng_one_in(rng, 2) ? DIR_SW : DIR_NE;
 			} else {
-				widen_dir = one_in_(2) ? DIR_SE : DIR_NW;
+				widen_dir = rng_one_in(rng, 2) ? DIR_SE : DIR_NW;
 			}
 		} else {
 			if (down) {
-				widen_dir = one_in_(2) ? DIR_NW : DIR_SE;
+				widen_dir = rng_one_in(rng, 2) ? DIR_NW : DIR_SE;
 			} else {
-				widen_dir = one_in_(2) ? DIR_NE : DIR_SW;
+				widen_dir = rng_one_in(rng, 2) ? DIR_NE : DIR_SW;
 			}
 		}
 	}
@@ -655,8 +658,8 @@ static void write_river_pieces(struct square_mile *sq_mile,
 		} else {
 			/* Make external river and remember where we come in */
 			int y;
-			int start_point = randint0(CHUNK_SIDE);
-			int finish_point = randint0(CHUNK_SIDE);
+			int start_point = rng_int0(rng, CHUNK_SIDE);
+			int finish_point = rng_int0(rng, CHUNK_SIDE);
 			int lower, upper;
 			bool reload;
 			struct gen_loc *location = NULL;
@@ -728,7 +731,7 @@ static void write_river_pieces(struct square_mile *sq_mile,
 
 			/* Map a course across the chunk */
 			(void) map_course(CHUNK_SIDE, in_dir, &in_grid, out_dir,
-							  &out_grid, course1);
+							  &out_grid, course1, rng);
 
 			/* Set entry_grid for initial chunk */
 			if (out_dir == DIR_N) {
@@ -764,8 +767,8 @@ static void write_river_pieces(struct square_mile *sq_mile,
 			mem_free(course1);
 		}
 	} else if (start_dir == DIR_NONE) {
-		in_grid = loc(randint0(CHUNK_SIDE / 2) + randint0(CHUNK_SIDE / 2 + 1),
-					  randint0(CHUNK_SIDE / 2) + randint0(CHUNK_SIDE / 2 + 1));
+		in_grid = loc(rng_int0(rng, CHUNK_SIDE / 2) + rng_int0(rng, CHUNK_SIDE / 2 + 1),
+					  rng_int0(rng, CHUNK_SIDE / 2) + rng_int0(rng, CHUNK_SIDE / 2 + 1));
 	} else {
 		in_dir = start_dir;
 	}
@@ -781,8 +784,8 @@ static void write_river_pieces(struct square_mile *sq_mile,
 		} else {
 			/* Make external river and remember where we leave */
 			int y;
-			int start_point = randint0(CHUNK_SIDE);
-			int finish_point = randint0(CHUNK_SIDE);
+			int start_point = rng_int0(rng, CHUNK_SIDE);
+			int finish_point = rng_int0(rng, CHUNK_SIDE);
 			int lower, upper;
 			bool reload;
 			struct gen_loc *location = NULL;
@@ -854,7 +857,7 @@ static void write_river_pieces(struct square_mile *sq_mile,
 
 			/* Map a course across the chunk */
 			(void) map_course(CHUNK_SIDE, in_dir, &in_grid, out_dir,
-							  &out_grid, course1);
+							  &out_grid, course1, rng);
 
 			/* Set exit_grid for final chunk */
 			if (in_dir == DIR_N) {
@@ -920,10 +923,10 @@ static void write_river_pieces(struct square_mile *sq_mile,
 			out_dir1 = grid_direction(next_chunk, current_chunk, CPM);
 			out_grid = loc(-1, -1);
 		} else if (finish_dir == DIR_NONE) {
-			out_grid = loc(randint0(CHUNK_SIDE / 2) +
-						   randint0(CHUNK_SIDE / 2 + 1),
-						   randint0(CHUNK_SIDE / 2) +
-						   randint0(CHUNK_SIDE / 2 + 1));
+			out_grid = loc(rng_int0(rng, CHUNK_SIDE / 2) +
+						   rng_int0(rng, CHUNK_SIDE / 2 + 1),
+						   rng_int0(rng, CHUNK_SIDE / 2) +
+						   rng_int0(rng, CHUNK_SIDE / 2 + 1));
 		} else {
 			out_grid = exit_grid;
 			out_dir1 = finish_dir;
@@ -931,7 +934,7 @@ static void write_river_pieces(struct square_mile *sq_mile,
 
 		/* Map a course across the chunk */
 		(void) map_course(CHUNK_SIDE, in_dir, &in_grid, out_dir1, &out_grid,
-						  course1);
+						  course1, rng);
 
 		/* Write new in_grid adjacent to out_grid in out_dir1 */
 		in_grid = loc_sum(out_grid, ddgrid[out_dir1]);
@@ -972,8 +975,10 @@ static void write_river_pieces(struct square_mile *sq_mile,
  * writes river edges into all the locations that it deems any river to pass
  * through, creating these locations first.
  */
-void map_river_miles(struct square_mile *sq_mile)
+void map_river_miles(struct loc grid, struct rng_ctx *rng)
 {
+	struct square_mile mile = square_mile(grid);
+	struct square_mile *sq_mile = &mile;
 	struct river_mile *r_mile;
 	bool two_up = false;
 	bool two_down = false;
@@ -998,8 +1003,8 @@ void map_river_miles(struct square_mile *sq_mile)
 		struct loc start_local = loc(-1, -1), finish_local = loc(-1, -1);
 
 		/* Rough centre in case it's needed for start and stop purposes */
-		struct loc centre = loc(randint0(CPM / 2) + randint0(CPM / 2 + 1),
-								randint0(CPM / 2) + randint0(CPM / 2 + 1));
+		struct loc centre = loc(rng_int0(rng, CPM / 2) + rng_int0(rng, CPM / 2 + 1),
+								rng_int0(rng, CPM / 2) + rng_int0(rng, CPM / 2 + 1));
 
 		/* Adjacent river miles upstream and downstream */
 		struct river_mile *upstream = next_river_mile(r_mile, true, two_up),
@@ -1024,12 +1029,12 @@ void map_river_miles(struct square_mile *sq_mile)
 
 		/* Find the incoming and outgoing directions if any */
 		if (upstream) {
-			start_dir = grid_direction(upstream->sq_mile->map_grid,
+			start_dir = grid_direction(upstream->sq_mile,
 									   sq_mile->map_grid, MPS);
 			two_up = true;
 		}
 		if (downstream) {
-			finish_dir = grid_direction(downstream->sq_mile->map_grid,
+			finish_dir = grid_direction(downstream->sq_mile,
 										sq_mile->map_grid, MPS);
 			two_down = true;
 		}
@@ -1078,7 +1083,7 @@ void map_river_miles(struct square_mile *sq_mile)
 
 		/* Map the chunks the river crosses */
 		num = map_course(CPM, start_dir, &start_local, finish_dir,
-						 &finish_local, course);
+						 &finish_local, course, rng);
 
 		/* Update start and finish chunks */
 		assert(grid_in_square(CPM, start_local) &&
@@ -1096,7 +1101,7 @@ void map_river_miles(struct square_mile *sq_mile)
 
 		/* Pick chunks to add river to for ungenerated diagonals */
 		if ((start_adj.x < 0) && (start_dir % 2) && (start_dir != DIR_NONE)) {
-			bool clockwise = one_in_(2);
+			bool clockwise = rng_one_in(rng, 2);
 			switch (start_dir) {
 				case DIR_NE: {
 					start_adj = clockwise ?
@@ -1123,7 +1128,7 @@ void map_river_miles(struct square_mile *sq_mile)
 			}
 		}
 		if ((finish_adj.x < 0) && (finish_dir % 2) && (finish_dir != DIR_NONE)){
-			bool clockwise = one_in_(2);
+			bool clockwise = rng_one_in(rng, 2);
 			switch (finish_dir) {
 				case DIR_NE: {
 					finish_adj = clockwise ? loc(finish.x + 1, finish.y)
@@ -1152,12 +1157,12 @@ void map_river_miles(struct square_mile *sq_mile)
 
 		/* Write the pieces of river */
 		write_river_pieces(sq_mile, r_mile, start_dir, start, start_adj,
-						   finish_dir, finish, finish_adj, course, num);
+						   finish_dir, finish, finish_adj, course, num, rng);
 
 		/* Set a joining point if necessary */
 		if (r_mile->next && (r_mile->next->part == RIVER_JOIN)) {
 			/* Get a random point to join, biased toward the middle */
-			int index = randint1(num / 2) + randint1(num / 2);
+			int index = rng_int1(rng, num / 2) + rng_int1(rng, num / 2);
 			join = find_course_index(CPM, index, course);
 			assert((join.x != -1) && (join.y != -1));
 		}
@@ -1170,7 +1175,7 @@ void map_river_miles(struct square_mile *sq_mile)
 	}
 
 	/* Mark as mapped */
-	sq_mile->mapped = true;
+	square_mile_set_mapped(grid);
 }
 
 
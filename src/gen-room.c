@@ -22,10 +22,11 @@
  * generate.c).
  *
  * The room builders all take as arguments the chunk they are being generated
- * in, and the co-ordinates of the room centre in that chunk.  Each room
- * builder is also able to find space for itself in the chunk using the 
- * find_space() function; the chunk generating functions can ask it to do that
- * by passing too large centre co-ordinates.
+ * in, the generator to take its terrain from, and the co-ordinates of the room
+ * centre in that chunk.  Monsters and objects come from the game's generator.
+ * Each room builder is also able to find space for itself in the chunk using
+ * the find_space() function; the chunk generating functions can ask it to do
+ * that by passing too large centre co-ordinates.
  */
 
 #include "angband.h"
@@ -54,12 +55,14 @@
  * ------------------------------------------------------------------------ */
 /**
  * Chooses a vault of a particular kind at random.
+ * \param rng the generator to use
  * \param depth the current depth, for vault bound checking
  * \param typ vault type
  * \param forge whether we are forcing a forge
  * \return a pointer to the vault template
  */
-struct vault *random_vault(int depth, const char *typ, bool forge)
+struct vault *random_vault(struct rng_ctx *rng, int depth, const char *typ,
+						   bool forge)
 {
 	struct vault *v = vaults;
 	struct vault *r = NULL;
@@ -79,7 +82,7 @@ struct vault *random_vault(int depth, const char *typ, bool forge)
 
 			if (valid) {
 				rarity_sum += v->rarity;
-				if (Rand_div(rarity_sum) < v->rarity) r = v;
+				if (rng_div(rng, rarity_sum) < v->rarity) r = v;
 			}
 		}
 		v = v->next;
@@ -108,6 +111,9 @@ static void generate_room(struct chunk *c, struct point_set *room, bool light)
 		if (light)
 			sqinfo_on(square(c, grid)->info, SQUARE_GLOW);
 	}
+
+	/* Room marks decide where monsters wander, so count as terrain */
+	c->terrain_stamp++;
 }
 
 /**
@@ -123,6 +129,7 @@ void generate_mark(struct chunk *c, struct point_set *grids, int flag)
 		struct loc grid = grids->pts[i];
 		sqinfo_on(square(c, grid)->info, flag);
 	}
+	c->terrain_stamp++;
 }
 
 /**
@@ -348,6 +355,8 @@ void set_bordering_walls(struct chunk *c, int y1, int x1, int y2, int x2)
  * Make a starburst room. -LM-
  *
  * \param c the current chunk
+ * \param rng the generator to use
+ * \param set if not NULL, the grids the starburst must stay within
  * \param y1 boundaries which will contain the starburst
  * \param x1 boundaries which will contain the starburst
  * \param y2 boundaries which will contain the starburst
@@ -384,9 +393,10 @@ void set_bordering_walls(struct chunk *c, int y1, int x1, int y2, int x2)
  *   this code does works well for lakes, etc.
  *
  */
-extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
-									int y1, int x1, int y2, int x2,
-									bool light, int feat, bool special_ok)
+extern bool generate_starburst_room(struct chunk *c, struct rng_ctx *rng,
+									struct point_set *set, int y1, int x1,
+									int y2, int x2, bool light, int feat,
+									bool special_ok)
 {
 	int y0, x0, y, x, ny, nx;
 	int i, d;
@@ -431,8 +441,8 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 			tmp_ax = x1 + 2 * width / 3;
 
 		/* Make the first room. */
-		(void) generate_starburst_room(c, set, y1, x1, tmp_ay, tmp_ax, light,
-									   feat, false);
+		(void) generate_starburst_room(c, rng, set, y1, x1, tmp_ay, tmp_ax,
+									   light, feat, false);
 
 
 		/* Get top_right borders of the second room. */
@@ -444,8 +454,8 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 			tmp_bx = x1 + 1 * width / 3;
 
 		/* Make the second room. */
-		(void) generate_starburst_room(c, set, tmp_by, tmp_bx, y2, x2, light,
-									   feat, false);
+		(void) generate_starburst_room(c, rng, set, tmp_by, tmp_bx, y2, x2,
+									   light, feat, false);
 
 
 		/* If floor, extend a "corridor" between room centers, to ensure 
@@ -474,8 +484,9 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 			}
 
 			/* Make the third room. */
-			(void) generate_starburst_room(c, set, tmp_cy1, tmp_cx1, tmp_cy2,
-										   tmp_cx2, light, feat, false);
+			(void) generate_starburst_room(c, rng, set, tmp_cy1, tmp_cx1,
+										   tmp_cy2, tmp_cx2, light, feat,
+										   false);
 		}
 
 		/* Return. */
@@ -494,7 +505,7 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 
 
 	/* Make a cloverleaf room sometimes. */
-	if ((special_ok) && (height > 10) && (randint0(20) == 0)) {
+	if ((special_ok) && (height > 10) && (rng_int0(rng, 20) == 0)) {
 		arc_num = 12;
 		make_cloverleaf = true;
 	}
@@ -503,7 +514,7 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 	else {
 		/* Ask for a reasonable number of arcs. */
 		arc_num = 8 + (height * width / 80);
-		arc_num = arc_num + 3 - randint0(7);
+		arc_num = arc_num + 3 - rng_int0(rng, 7);
 		if (arc_num < 8)
 			arc_num = 8;
 		if (arc_num > 45)
@@ -525,7 +536,7 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 		arc[i][0] = degree_first;
 
 		/* Get a slightly randomized start degree for the next arc. */
-		degree_first += (180 + randint0(arc_num)) / arc_num;
+		degree_first += (180 + rng_int0(rng, arc_num)) / arc_num;
 		if (degree_first < 180 * (i + 1) / arc_num)
 			degree_first = 180 * (i + 1) / arc_num;
 		if (degree_first > (180 + arc_num) * (i + 1) / arc_num)
@@ -538,13 +549,13 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 		/* Calculate a reasonable distance to expand vertically. */
 		if (((center_of_arc > 45) && (center_of_arc < 135))
 			|| ((center_of_arc > 225) && (center_of_arc < 315))) {
-			arc[i][1] = height / 4 + randint0((height + 3) / 4);
+			arc[i][1] = height / 4 + rng_int0(rng, (height + 3) / 4);
 		}
 
 		/* Calculate a reasonable distance to expand horizontally. */
 		else if (((center_of_arc < 45) || (center_of_arc > 315))
 				 || ((center_of_arc < 225) && (center_of_arc > 135))) {
-			arc[i][1] = width / 4 + randint0((width + 3) / 4);
+			arc[i][1] = width / 4 + rng_int0(rng, (width + 3) / 4);
 		}
 
 		/* Handle arcs that count as neither vertical nor horizontal */
@@ -552,7 +563,7 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 			if (make_cloverleaf)
 				arc[i][1] = 0;
 			else
-				arc[i][1] = arc[i - 1][1] + 3 - randint0(7);
+				arc[i][1] = arc[i - 1][1] + 3 - rng_int0(rng, 7);
 		}
 
 
@@ -577,9 +588,9 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 		/* Neaten up final arc of circle by comparing it to the first. */
 		if ((i == arc_num - 1) && (ABS(arc[i][1] - arc[0][1]) > 3)) {
 			if (arc[i][1] > arc[0][1])
-				arc[i][1] -= randint0(arc[i][1] - arc[0][1]);
+				arc[i][1] -= rng_int0(rng, arc[i][1] - arc[0][1]);
 			else if (arc[i][1] < arc[0][1])
-				arc[i][1] += randint0(arc[0][1] - arc[i][1]);
+				arc[i][1] += rng_int0(rng, arc[0][1] - arc[i][1]);
 		}
 	}
 
@@ -653,7 +664,7 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 							} else {
 								/* Make denser in the middle. */
 								if (square_isfloor(c, grid) &&
-									(randint1(max_dist + 5) >= dist + 5))
+									(rng_int1(rng, max_dist + 5) >= dist + 5))
 									square_set_feat(c, grid, feat);
 							}
 
@@ -703,6 +714,7 @@ extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
 				}
 			}
 		}
+		c->terrain_stamp++;
 	}
 
 	/* Success */
@@ -756,6 +768,7 @@ static void reserve_blocks(int by1, int bx1, int by2, int bx2)
 /**
  * Find a good spot for the next room.
  *
+ * \param rng the generator to use
  * \param centre centre of the room
  * \param height dimensions of the room
  * \param width dimensions of the room
@@ -775,7 +788,8 @@ static void reserve_blocks(int by1, int bx1, int by2, int bx2)
  * Return true and values for the center of the room if all went well.
  * Otherwise, return false.
  */
-static bool find_space(struct loc *centre, int height, int width)
+static bool find_space(struct rng_ctx *rng, struct loc *centre, int height,
+					   int width)
 {
 	int i;
 	int by1, bx1, by2, bx2;
@@ -789,8 +803,8 @@ static bool find_space(struct loc *centre, int height, int width)
 		/* We'll allow twenty-five guesses. */
 		for (i = 0; i < 25; i++) {
 			/* Pick a top left block at random */
-			by1 = randint0(dun->row_blocks);
-			bx1 = randint0(dun->col_blocks);
+			by1 = rng_int0(rng, dun->row_blocks);
+			bx1 = rng_int0(rng, dun->col_blocks);
 
 			/* Extract bottom right corner block */
 			by2 = by1 + blocks_high - 1;
@@ -831,14 +845,15 @@ static bool find_space(struct loc *centre, int height, int width)
 /**
  * Build a vault from its string representation.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre; out of chunk centre invokes find_space()
  * \param v pointer to the vault template
  * \param flip whether or not to diagonally flip (interchange x and y) the
  * vault template
  * \return success
  */
-bool build_vault(struct chunk *c, struct loc *centre, bool *rotated,
-				 struct vault *v)
+bool build_vault(struct chunk *c, struct rng_ctx *rng, struct loc *centre,
+				 bool *rotated, struct vault *v)
 {
 	const char *data = v->text;
 	int y1, x1, y2, x2;
@@ -854,12 +869,13 @@ bool build_vault(struct chunk *c, struct loc *centre, bool *rotated,
 	/* Find and reserve some space in the dungeon.  Get center of room. */
 	event_signal_string(EVENT_GEN_ROOM_CHOOSE_SUBTYPE, v->name);
 	if (transform) {
-		get_random_symmetry_transform(v->hgt, v->wid, SYMTR_FLAG_NONE,
+		get_random_symmetry_transform(rng, v->hgt, v->wid,
+									  SYMTR_FLAG_NONE,
 									  calc_default_transpose_weight(v->hgt, v->wid),
 									  &rotate, &reflect, &thgt, &twid);
 		if (rotate % 2) *rotated = true;
 		event_signal_size(EVENT_GEN_ROOM_CHOOSE_SIZE, thgt + 2, twid + 2);
-		if (!find_space(centre, thgt + 2, twid + 2))
+		if (!find_space(rng, centre, thgt + 2, twid + 2))
 			return false;
 	}
 
@@ -890,18 +906,12 @@ bool build_vault(struct chunk *c, struct loc *centre, bool *rotated,
 	x2 = x1 + twid - 1;
 
 	/* Place dungeon features and objects */
-	get_terrain(c, loc(0, 0), loc(v->wid, v->hgt), *centre, v->hgt, v->wid,
-				rotate, reflect, v->flags, floor, data, false);
+	get_terrain(c, rng, loc(0, 0), loc(v->wid, v->hgt), *centre, v->hgt,
+				v->wid, rotate, reflect, v->flags, floor, data, false);
 
 	/* Finished if it's been generated before */
 	if (!dun->first_time) return true;
 
-	/* Switch random number generator so terrain always generates the same */
-	Rand_quick = false;
-
-	/* Save the current seed value */
-	dun->seed = Rand_value;
-
 	/* Place regular dungeon monsters and objects */
 	for (t = data, y = 0; y < v->hgt && *t; y++) {
 		for (x = 0; x < v->wid && *t; x++, t++) {
@@ -1268,10 +1278,6 @@ bool build_vault(struct chunk *c, struct loc *centre, bool *rotated,
 		}
 	}
 
-	/* Revert to the quick RNG, restore the seed */
-	Rand_value = dun->seed;
-	Rand_quick = true;
-
 	return true;
 }
 
@@ -1293,16 +1299,17 @@ void unset_room_parameters(void)
 /**
  * Helper function for building vaults.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre; out of chunk centre invokes find_space()
  * \param typ the vault type
  * \param forge whether we are forcing a forge
  * \return success
  */
-static bool build_vault_type(struct chunk *c, const char *typ,
-							 struct loc centre, bool forge)
+static bool build_vault_type(struct chunk *c, struct rng_ctx *rng,
+							 const char *typ, struct loc centre, bool forge)
 {
 	bool rotated = false;
-	struct vault *v = random_vault(c->depth, typ, forge);
+	struct vault *v = random_vault(rng, c->depth, typ, forge);
 	if (v == NULL) {
 		return false;
 	}
@@ -1317,7 +1324,7 @@ static bool build_vault_type(struct chunk *c, const char *typ,
 	}
 
 	/* Build the vault */
-	if (!build_vault(c, &centre, &rotated, v)) {
+	if (!build_vault(c, rng, &centre, &rotated, v)) {
 		return false;
 	}
 
@@ -1362,7 +1369,7 @@ static bool build_vault_type(struct chunk *c, const char *typ,
  * Build a staircase to connect with a previous staircase on the level one up
  * or (occasionally) one down
  */
-bool build_staircase(struct chunk *c, struct loc centre)
+bool build_staircase(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
 	struct connector *join = dun->curr_join;
 	struct loc tl, br;
@@ -1402,7 +1409,7 @@ bool build_staircase(struct chunk *c, struct loc centre)
 	if (dun->block_hgt > 1 || dun->block_wid > 1) {
 		struct loc rg;
 
-		if (cave_find_in_range(c, &rg, tl, br, square_isroom))
+		if (cave_find_in_range(c, rng, &rg, tl, br, square_isroom))
 			return false;
 	} else if (!check_for_unreserved_blocks(by1, bx1, by2, bx2)) {
 		return false;
@@ -1434,16 +1441,17 @@ bool build_staircase(struct chunk *c, struct loc centre)
 /**
  * Build a circular room (interior radius 4-7).
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre; out of chunk centre invokes find_space()
  * \return success
  */
-bool build_circular(struct chunk *c, struct loc centre)
+bool build_circular(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
 	/* Pick a room size */
-	int radius = 2 + randint1(2) + randint1(3);
+	int radius = 2 + rng_int1(rng, 2) + rng_int1(rng, 3);
 
 	/* Occasional light */
-	bool light = player->depth <= randint1(8) ? true : false;
+	bool light = player->depth <= rng_int1(rng, 8) ? true : false;
 
 	/* Fix room parameters if requested... */
 	if (dun->fix_room_parameters) {
@@ -1457,7 +1465,7 @@ bool build_circular(struct chunk *c, struct loc centre)
 	/* Find and reserve lots of space in the dungeon.  Get center of room. */
 	event_signal_size(EVENT_GEN_ROOM_CHOOSE_SIZE,
 		2 * radius + 10, 2 * radius + 10);
-	if (!find_space(&centre, 2 * radius + 10, 2 * radius + 10))
+	if (!find_space(rng, &centre, 2 * radius + 10, 2 * radius + 10))
 		return (false);
 
 	/* Mark as a room. */
@@ -1469,18 +1477,18 @@ bool build_circular(struct chunk *c, struct loc centre)
 						centre.y + radius + 2, centre.x + radius + 2);
 
 	/* Especially large circular rooms will have a middle chamber */
-	if (radius - 4 > 0 && randint0(4) < radius - 4) {
+	if (radius - 4 > 0 && rng_int0(rng, 4) < radius - 4) {
 		struct loc offset;
 
 		event_signal_string(EVENT_GEN_ROOM_CHOOSE_SUBTYPE, "middle chamber");
 
 		/* choose a random direction */
-		rand_dir(&offset);
+		rand_dir(rng, &offset);
 
 		/* draw a room with a closed door on a random side */
 		draw_rectangle(c, centre.y - 2, centre.x - 2, centre.y + 2,
 					   centre.x + 2, FEAT_GRANITE, SQUARE_WALL_INNER, false);
-		place_closed_door(c, loc(centre.x + offset.x * 2,
+		place_closed_door(c, rng, loc(centre.x + offset.x * 2,
 								 centre.y + offset.y * 2));
 	}
 
@@ -1490,17 +1498,18 @@ bool build_circular(struct chunk *c, struct loc centre)
 /**
  * Build an elliptical room (interior radius 4-7).
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre; out of chunk centre invokes find_space()
  * \return success
  */
-bool build_elliptical(struct chunk *c, struct loc centre)
+bool build_elliptical(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
 	/* Pick a room size */
-	int y_radius = 2 + randint1(2) + randint1(5);
-	int x_radius = 2 + randint1(2) + randint1(5);
+	int y_radius = 2 + rng_int1(rng, 2) + rng_int1(rng, 5);
+	int x_radius = 2 + rng_int1(rng, 2) + rng_int1(rng, 5);
 
 	/* Occasional light */
-	bool light = player->depth <= randint1(8) ? true : false;
+	bool light = player->depth <= rng_int1(rng, 8) ? true : false;
 
 	/* Fix room parameters if requested... */
 	if (dun->fix_room_parameters) {
@@ -1516,7 +1525,7 @@ bool build_elliptical(struct chunk *c, struct loc centre)
 	/* Find and reserve lots of space in the dungeon.  Get center of room. */
 	event_signal_size(EVENT_GEN_ROOM_CHOOSE_SIZE,
 		2 * y_radius + 10, 2 * x_radius + 10);
-	if (!find_space(&centre, 2 * y_radius + 10, 2 * x_radius + 10))
+	if (!find_space(rng, &centre, 2 * y_radius + 10, 2 * x_radius + 10))
 		return (false);
 
 	/* Mark as a room. */
@@ -1529,18 +1538,18 @@ bool build_elliptical(struct chunk *c, struct loc centre)
 
 	/* Especially large elliptical rooms will have pillars at the foci */
 	//TODO actually do this
-	if (y_radius - 5 > 0 && randint0(4) < x_radius - 4) {//WRONG
+	if (y_radius - 5 > 0 && rng_int0(rng, 4) < x_radius - 4) {//WRONG
 		struct loc offset;
 
 		event_signal_string(EVENT_GEN_ROOM_CHOOSE_SUBTYPE, "middle chamber");
 
 		/* choose a random direction */
-		rand_dir(&offset);
+		rand_dir(rng, &offset);
 
 		/* draw a room with a closed door on a random side */
 		draw_rectangle(c, centre.y - 2, centre.x - 2, centre.y + 2,
 			centre.x + 2, FEAT_GRANITE, SQUARE_WALL_INNER, false);
-		place_closed_door(c, loc(centre.x + offset.x * 2,
+		place_closed_door(c, rng, loc(centre.x + offset.x * 2,
 								 centre.y + offset.y * 2));
 	}
 
@@ -1550,17 +1559,18 @@ bool build_elliptical(struct chunk *c, struct loc centre)
 /**
  * Builds a normal rectangular room.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre
  * \return success
  */
-bool build_simple(struct chunk *c, struct loc centre)
+bool build_simple(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
 	int y, x, y1, x1, y2, x2;
 	bool light = false;
 
 	/* Pick a room size */
-	int height = 1 + randint1(6) + randint1(5);
-	int width = 1 + randint1(6) + randint1(5);
+	int height = 1 + rng_int1(rng, 6) + rng_int1(rng, 5);
+	int width = 1 + rng_int1(rng, 6) + rng_int1(rng, 5);
 	struct point_set *rectangle;
 
 	/* Fix room parameters if requested... */
@@ -1576,14 +1586,14 @@ bool build_simple(struct chunk *c, struct loc centre)
 
 	/* Find and reserve some space in the dungeon.  Get center of room. */
 	event_signal_size(EVENT_GEN_ROOM_CHOOSE_SIZE, height + 2, width + 2);
-	if (!find_space(&centre, height + 2, width + 2))
+	if (!find_space(rng, &centre, height + 2, width + 2))
 		return false;
 
 	/* Occasional light - chance of darkness starts very small and
 	 * increases quadratically until always dark at 450 ft */
 	//TODO work out a general lighting scheme, this is really for Angband
-	if ((c->depth < randint1(z_info->angband_depth - 1)) ||
-		(c->depth < randint1(z_info->angband_depth - 1))) {
+	if ((c->depth < rng_int1(rng, z_info->angband_depth - 1)) ||
+		(c->depth < rng_int1(rng, z_info->angband_depth - 1))) {
 		light = true;
 	}
 
@@ -1601,7 +1611,7 @@ bool build_simple(struct chunk *c, struct loc centre)
 	point_set_dispose(rectangle);
 
 	/* Sometimes make a pillar room */
-	if (one_in_(20) && ((x2 - x1) % 2 == 0) && ((y2 - y1) % 2 == 0)) {
+	if (rng_one_in(rng, 20) && ((x2 - x1) % 2 == 0) && ((y2 - y1) % 2 == 0)) {
 		event_signal_string(EVENT_GEN_ROOM_CHOOSE_SUBTYPE, "pillared");
 
 		for (y = y1 + 1; y <= y2; y += 2) {
@@ -1609,7 +1619,8 @@ bool build_simple(struct chunk *c, struct loc centre)
 				set_marked_granite(c, loc(x, y), SQUARE_WALL_INNER);
 			}
 		}
-	} else if (one_in_(10) && ((x2 - x1) % 2 == 0) && ((y2 - y1) % 2 == 0)) {
+	} else if (rng_one_in(rng, 10) && ((x2 - x1) % 2 == 0) &&
+			   ((y2 - y1) % 2 == 0)) {
 		/* Sometimes make a pillar-lined room */
 		event_signal_string(EVENT_GEN_ROOM_CHOOSE_SUBTYPE, "ragged");
 
@@ -1630,12 +1641,13 @@ bool build_simple(struct chunk *c, struct loc centre)
 /**
  * Builds a cross-shaped room.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre
  * \return success
  *
  * Room "v" runs north/south, and Room "h" runs east/west 
  */
-bool build_crossed(struct chunk *c, struct loc centre)
+bool build_crossed(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
 	int y, x;
 	int height, width;
@@ -1649,14 +1661,14 @@ bool build_crossed(struct chunk *c, struct loc centre)
 	struct point_set *room_h, *room_v;
 
 	/* Occasional light - always at level 1 down to never at Morgoth's level */
-	if (c->depth <= randint1(z_info->angband_depth - 1)) light = true;
+	if (c->depth <= rng_int1(rng, z_info->angband_depth - 1)) light = true;
 
 	/* Pick a room size */
 	h_hgt = 1;                /* 3 */
-	h_wid = rand_range(5, 7); /* 11, 13, 15 */
+	h_wid = rng_range(rng, 5, 7); /* 11, 13, 15 */
 
-	v_hgt = rand_range(3, 6); /* 7, 9, 11, 13 */
-	v_wid = rand_range(1, 2); /* 3, 5 */
+	v_hgt = rng_range(rng, 3, 6); /* 7, 9, 11, 13 */
+	v_wid = rng_range(rng, 1, 2); /* 3, 5 */
 
 	/* Fix room parameters if requested... */
 	if (dun->fix_room_parameters) {
@@ -1679,7 +1691,7 @@ bool build_crossed(struct chunk *c, struct loc centre)
 
 	/* Find and reserve some space in the dungeon.  Get center of room. */
 	event_signal_size(EVENT_GEN_ROOM_CHOOSE_SIZE, height + 2, width + 2);
-	if (!find_space(&centre, height + 2, width + 2))
+	if (!find_space(rng, &centre, height + 2, width + 2))
 		return (false);
 
 	/* Get the room boundaries */
@@ -1703,7 +1715,7 @@ bool build_crossed(struct chunk *c, struct loc centre)
 	point_set_dispose(room_h);
 
 	/* Special features */
-	switch (randint1(7)) {
+	switch (rng_int1(rng, 7)) {
 		case 1: {
 			event_signal_string(EVENT_GEN_ROOM_CHOOSE_SUBTYPE, "chest");
 			if ((v_wid == 2) && (v_hgt == 6)) {
@@ -1770,12 +1782,13 @@ bool build_crossed(struct chunk *c, struct loc centre)
 /**
  * Build an interesting room.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre
  * \return success
  */
-bool build_interesting(struct chunk *c, struct loc centre)
+bool build_interesting(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
-	return build_vault_type(c, "Interesting room", centre,
+	return build_vault_type(c, rng, "Interesting room", centre,
 							player->upkeep->force_forge);
 }
 
@@ -1783,43 +1796,47 @@ bool build_interesting(struct chunk *c, struct loc centre)
 /**
  * Build a lesser vault.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre
  * \return success
  */
-bool build_lesser_vault(struct chunk *c, struct loc centre)
+bool build_lesser_vault(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
-	return build_vault_type(c, "Lesser vault", centre, false);
+	return build_vault_type(c, rng, "Lesser vault", centre, false);
 }
 
 
 /**
  * Build a greater vault.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre
  * \return success
  */
 
-bool build_greater_vault(struct chunk *c, struct loc centre)
+bool build_greater_vault(struct chunk *c, struct rng_ctx *rng,
+						 struct loc centre)
 {
 	/* Can only have one greater vault per level */
 	if (c->vault_name) {
 		return false;
 	}
-	return build_vault_type(c, "Greater vault", centre, false);
+	return build_vault_type(c, rng, "Greater vault", centre, false);
 }
 
 
 /**
  * Build Morgoth's throne room.
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre
  * \return success
  */
-bool build_throne(struct chunk *c, struct loc centre)
+bool build_throne(struct chunk *c, struct rng_ctx *rng, struct loc centre)
 {
 	int y1, x1, y2, x2;
 	bool dummy = false;
-	struct vault *v = random_vault(c->depth, "Throne room", false);
+	struct vault *v = random_vault(rng, c->depth, "Throne room", false);
 	struct point_set *grids;
 	if (v == NULL) {
 		return false;
@@ -1833,7 +1850,7 @@ bool build_throne(struct chunk *c, struct loc centre)
 	x2 = x1 + v->wid - 1;
 
 	/* Build the vault */
-	if (!build_vault(c, &centre, &dummy, v)) {
+	if (!build_vault(c, rng, &centre, &dummy, v)) {
 		return false;
 	}
 
@@ -1851,6 +1868,7 @@ bool build_throne(struct chunk *c, struct loc centre)
  * Attempt to build a room of the given type at the given block
  *
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param profile the profile of the rooom we're trying to build
  * \return success
  *
@@ -1858,7 +1876,8 @@ bool build_throne(struct chunk *c, struct loc centre)
  * possible grid sizes, and then allocates a number of blocks that will always
  * contain them.
  */
-bool room_build(struct chunk *c, struct loc centre, struct room_profile profile)
+bool room_build(struct chunk *c, struct rng_ctx *rng, struct loc centre,
+				struct room_profile profile)
 {
 	event_signal_string(EVENT_GEN_ROOM_START, profile.name);
 
@@ -1869,7 +1888,7 @@ bool room_build(struct chunk *c, struct loc centre, struct room_profile profile)
 	}
 
 	/* Try to build a room */
-	if (!profile.builder(c, centre)) {
+	if (!profile.builder(c, rng, centre)) {
 		event_signal_flag(EVENT_GEN_ROOM_END, false);
 		return false;
 	}
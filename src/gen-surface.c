@@ -61,15 +61,15 @@ static struct point_set *make_chunk_point_set(struct chunk *c,
  *
  * This border can be applied either to a straight edge or a diagonal
  */
-static void make_biome_border(int edge[])
+static void make_biome_border(struct rng_ctx *rng, int edge[])
 {
 	int i;
 
 	/* Start within CHUNK_SIDE / 10 of straight */
-	edge[0] = CHUNK_SIDE / 10 - randint0(CHUNK_SIDE / 5);
+	edge[0] = CHUNK_SIDE / 10 - rng_int0(rng, CHUNK_SIDE / 5);
 	for (i = 1; i < CHUNK_SIDE; i++) {
 		/* Move maximum of 1 in either direction */
-		edge[i] = edge[i - 1] + 1 - randint0(3);
+		edge[i] = edge[i - 1] + 1 - rng_int0(rng, 3);
 	}
 }
 
@@ -77,6 +77,7 @@ static void make_biome_border(int edge[])
  * Make a point set at the given direction corner of a 22x22 chunk
  */
 static struct point_set *make_corner_point_set(struct chunk *c,
+											   struct rng_ctx *rng,
 											   struct loc top_left, int dir)
 {
 	int y, x;
@@ -86,7 +87,7 @@ static struct point_set *make_corner_point_set(struct chunk *c,
 	assert(dir == DIR_NE || dir == DIR_SE || dir == DIR_SW || dir == DIR_NW);
 
 	/* Get border deviations */
-	make_biome_border(edge);
+	make_biome_border(rng, edge);
 
 	/* Allocate points */
 	if (dir == DIR_NE) {
@@ -126,6 +127,7 @@ static struct point_set *make_corner_point_set(struct chunk *c,
  * Make a point set at the given direction edge of a 22x22 chunk
  */
 static struct point_set *make_edge_point_set(struct chunk *c,
+											 struct rng_ctx *rng,
 											 struct loc top_left, int dir)
 {
 	int y, x;
@@ -135,7 +137,7 @@ static struct point_set *make_edge_point_set(struct chunk *c,
 	assert(dir == DIR_E || dir == DIR_S || dir == DIR_W || dir == DIR_N);
 
 	/* Get border deviations */
-	make_biome_border(edge);
+	make_biome_border(rng, edge);
 
 	/* Allocate points */
 	if (dir == DIR_E) {
@@ -176,6 +178,7 @@ static struct point_set *make_edge_point_set(struct chunk *c,
  * existing one on the adjacent edge
  */
 static struct point_set *match_edge_point_set(struct chunk *c,
+											  struct rng_ctx *rng,
 											  struct loc top_left,
 											  int gen_loc_idx, int dir)
 {
@@ -198,7 +201,7 @@ static struct point_set *match_edge_point_set(struct chunk *c,
 					if (count) {
 						int half = count / 2, mid = count % 2, i, j, len = 0;
 						for (i = y - 1; i > y - 1 - half; i--) {
-							if (!one_in_(3)) len++;
+							if (!rng_one_in(rng, 3)) len++;
 							for (j = CHUNK_SIDE - 2; j > CHUNK_SIDE - 2 - len;
 								 j--) {
 								add_to_point_set(new, loc(j, i));
@@ -232,7 +235,7 @@ static struct point_set *match_edge_point_set(struct chunk *c,
 					if (count) {
 						int half = count / 2, mid = count % 2, i, j, len = 0;
 						for (i = x - 1; i > x - 1 - half; i--) {
-							if (!one_in_(3)) len++;
+							if (!rng_one_in(rng, 3)) len++;
 							for (j = CHUNK_SIDE - 2; j > CHUNK_SIDE - 2 - len;
 								 j--) {
 								add_to_point_set(new, loc(i, j));
@@ -266,7 +269,7 @@ static struct point_set *match_edge_point_set(struct chunk *c,
 					if (count) {
 						int half = count / 2, mid = count % 2, i, j, len = 0;
 						for (i = y - 1; i > y - 1 - half; i--) {
-							if (!one_in_(3)) len++;
+							if (!rng_one_in(rng, 3)) len++;
 							for (j = 1; j < 1 + len; j++) {
 								add_to_point_set(new, loc(j, i));
 								add_to_point_set(new, loc(j, i - count + 1));
@@ -298,7 +301,7 @@ static struct point_set *match_edge_point_set(struct chunk *c,
 					if (count) {
 						int half = count / 2, mid = count % 2, i, j, len = 0;
 						for (i = x - 1; i > x - 1 - half; i--) {
-							if (!one_in_(3)) len++;
+							if (!rng_one_in(rng, 3)) len++;
 							for (j = 1; j > 1 + len; j--) {
 								add_to_point_set(new, loc(i, j));
 								add_to_point_set(new, loc(i - count + 1, j));
@@ -327,6 +330,7 @@ static struct point_set *match_edge_point_set(struct chunk *c,
  * Make a randomish point_set of grids contained in a given point_set.
  */
 static struct point_set *make_random_point_set(struct chunk *c,
+											   struct rng_ctx *rng,
 											   struct point_set *big, int size,
 											   struct loc grid, char *base_feat,
 											   int num_base_feats)
@@ -337,7 +341,7 @@ static struct point_set *make_random_point_set(struct chunk *c,
 	size--;
 	while (size && tries) {
 		/* Choose a random step */
-		int i, step = randint1(8);
+		int i, step = rng_int1(rng, 8);
 		if (step > DIR_NONE) step++;
 		grid = loc_sum(grid, ddgrid[step]);
 
@@ -370,16 +374,17 @@ static struct point_set *make_random_point_set(struct chunk *c,
 /**
  * Make a formation - a randomish group of terrain squares. -NRM-
  */
-static int make_formation(struct chunk *c, struct point_set *big,
+static int make_formation(struct chunk *c, struct rng_ctx *rng,
+						  struct point_set *big,
 						  char base_feat[], int num_base_feats,
 						  char form_feat[], int num_form_feats, int size)
 {
-	struct loc grid = point_set_random(big);
-	struct point_set *form = make_random_point_set(c, big, size, grid,
+	struct loc grid = point_set_random(rng, big);
+	struct point_set *form = make_random_point_set(c, rng, big, size, grid,
 												   base_feat, num_base_feats);
 	int i, num = point_set_size(form);
 	for (i = 0; i < num; i++) {
-		square_set_feat(c, form->pts[i], form_feat[randint0(num_form_feats)]);
+		square_set_feat(c, form->pts[i], form_feat[rng_int0(rng, num_form_feats)]);
 	}
 	point_set_dispose(form);
 	return num;
@@ -414,11 +419,11 @@ static bool get_biome_tweaks(int y_pos, int x_pos, struct biome_tweak *tweak)
 	if (!right && !bottom && !left && !top) return false;
 
 	/* Get the biome for the square mile the chunk is in and its neighbours */
-	standard = square_miles[y_pos / CPM][x_pos / CPM].biome;
-	east = square_miles[y_pos / CPM][x_pos / CPM + 1].biome;
-	south = square_miles[y_pos / CPM + 1][x_pos / CPM].biome;
-	west = square_miles[y_pos / CPM][x_pos / CPM - 1].biome;
-	north = square_miles[y_pos / CPM - 1][x_pos / CPM].biome;
+	standard = square_mile_biome(loc(x_pos / CPM, y_pos / CPM));
+	east = square_mile_biome(loc(x_pos / CPM + 1, y_pos / CPM));
+	south = square_mile_biome(loc(x_pos / CPM, y_pos / CPM + 1));
+	west = square_mile_biome(loc(x_pos / CPM - 1, y_pos / CPM));
+	north = square_mile_biome(loc(x_pos / CPM, y_pos / CPM - 1));
 
 	/* Check each edge and set the other biomes if needed */
 	if (right) {
@@ -567,7 +572,7 @@ static bool get_biome_tweaks(int y_pos, int x_pos, struct biome_tweak *tweak)
  * \param flag settlement flag it must have
  * \return a pointer to the settlement template
  */
-static struct settlement *random_settlement(int flag)
+static struct settlement *random_settlement(struct rng_ctx *rng, int flag)
 {
 	struct settlement *s = settlements;
 	struct settlement *r = NULL;
@@ -575,7 +580,7 @@ static struct settlement *random_settlement(int flag)
 	do {
 		if (settf_has(s->flags, flag)) {
 			sum++;
-			if (!Rand_div(sum)) r = s;
+			if (!rng_div(rng, sum)) r = s;
 		}
 		s = s->next;
 	} while(s);
@@ -585,14 +590,16 @@ static struct settlement *random_settlement(int flag)
 /**
  * Build a settlement from its string representation (like build_vault()).
  * \param c the chunk the room is being built in
+ * \param rng the generator to use
  * \param centre the room centre; out of chunk centre invokes find_space()
  * \param v pointer to the vault template
  * \param flip whether or not to diagonally flip (interchange x and y) the
  * vault template
  * \return success
  */
-static bool build_settlement(struct chunk *c, struct point_set *piece,
-					  struct loc *centre, struct settlement *s)
+static bool build_settlement(struct chunk *c, struct rng_ctx *rng,
+							 struct point_set *piece, struct loc *centre,
+							 struct settlement *s)
 {
 	const char *data = s->text;
 	int y1, x1, y2, x2;
@@ -604,7 +611,7 @@ static bool build_settlement(struct chunk *c, struct point_set *piece,
 	assert(c);
 
 	/* Find and reserve some space in the dungeon.  Get center of room. */
-	get_random_symmetry_transform(s->hgt, s->wid, SYMTR_FLAG_NONE,
+	get_random_symmetry_transform(rng, s->hgt, s->wid, SYMTR_FLAG_NONE,
 								  calc_default_transpose_weight(s->hgt, s->wid),
 								  &rotate, &reflect, &thgt, &twid);
 
@@ -636,8 +643,8 @@ static bool build_settlement(struct chunk *c, struct point_set *piece,
 	}
 
 	/* Place dungeon features and objects */
-	get_terrain(c, loc(0, 0), loc(s->wid, s->hgt), *centre, s->hgt, s->wid,
-				rotate, reflect, s->flags, true, data, false);
+	get_terrain(c, rng, loc(0, 0), loc(s->wid, s->hgt), *centre, s->hgt,
+				s->wid, rotate, reflect, s->flags, true, data, false);
 
 	/* Lighting */
 	for (t = data, y = 0; y < s->hgt && *t; y++) {
@@ -664,8 +671,9 @@ static bool build_settlement(struct chunk *c, struct point_set *piece,
  * ------------------------------------------------------------------------
  * Surface generation
  * ------------------------------------------------------------------------ */
-static void make_piece(struct chunk *c, enum biome_type terrain,
-					   struct point_set *piece, struct loc top_left)
+static void make_piece(struct chunk *c, struct rng_ctx *rng,
+					   enum biome_type terrain, struct point_set *piece,
+					   struct loc top_left)
 {
 	int i, form_grids, size = point_set_size(piece);
 	struct surface_profile *s;
@@ -681,7 +689,7 @@ static void make_piece(struct chunk *c, enum biome_type terrain,
 
 	/* Basic terrain */
 	for (i = 0; i < size; i++) {
-		int feat = s->base_feats[randint0(s->num_base_feats)];
+		int feat = s->base_feats[rng_int0(rng, s->num_base_feats)];
 		square_set_feat(c, piece->pts[i], feat);
 	}
 
@@ -690,19 +698,19 @@ static void make_piece(struct chunk *c, enum biome_type terrain,
 	while (area) {
 		int areas = 0;
 		for (i = 0; i < area->attempts; i++) {
-			if (one_in_(size / area->frequency)) areas++;
+			if (rng_one_in(rng, size / area->frequency)) areas++;
 		}
 
 		/* Try fairly hard */
 		for (i = 0; i < 50 && areas; i++) {
-			int a = randcalc(area->size, 0, RANDOMISE);
-			int b = randcalc(area->size, 0, RANDOMISE);
+			int a = rng_randcalc(rng, area->size, 0, RANDOMISE);
+			int b = rng_randcalc(rng, area->size, 0, RANDOMISE);
 			struct loc grid;
 			bool made_area = false;
 
 			/* Try for an area */
-			grid = point_set_random(piece);
-			made_area = generate_starburst_room(c, piece, grid.y - b,
+			grid = point_set_random(rng, piece);
+			made_area = generate_starburst_room(c, rng, piece, grid.y - b,
 												grid.x - a, grid.y + b,
 												grid.x + a, false, area->feat,
 												true);
@@ -722,16 +730,17 @@ static void make_piece(struct chunk *c, enum biome_type terrain,
 			continue;
 		}
 		form_grids = (size * form->proportion) / 100;
-		if (one_in_(2)) {
-			form_grids -= randint0(form_grids / 4);
+		if (rng_one_in(rng, 2)) {
+			form_grids -= rng_int0(rng, form_grids / 4);
 		} else {
-			form_grids += randint0(form_grids / 4);
+			form_grids += rng_int0(rng, form_grids / 4);
 		}
 		while (form_grids > 0) {
-			form_grids -= make_formation(c, piece, s->base_feats,
+			form_grids -= make_formation(c, rng, piece, s->base_feats,
 										 s->num_base_feats, form->feats,
 										 form->num_feats,
-										 randcalc(form->size, 0, RANDOMISE));
+										 rng_randcalc(rng, form->size, 0,
+													  RANDOMISE));
 		}
 		form = form->next;
 	}
@@ -742,10 +751,10 @@ static void make_piece(struct chunk *c, enum biome_type terrain,
 		int j, space = 7;
 		for (i = space / 2; i < CHUNK_SIDE; i += space) {
 			for (j = space / 2; j < CHUNK_SIDE; j += space) {
-				struct settlement *sett = random_settlement(s->settlement_type);
-				struct loc grid = loc_sum(loc(randint0(3) + i, randint0(3) + j),
+				struct settlement *sett = random_settlement(rng, s->settlement_type);
+				struct loc grid = loc_sum(loc(rng_int0(rng, 3) + i, rng_int0(rng, 3) + j),
 										  top_left);
-				(void) build_settlement(c, piece, &grid, sett);
+				(void) build_settlement(c, rng, piece, &grid, sett);
 			}
 		}
 	}
@@ -780,34 +789,29 @@ static void make_river_piece(struct chunk *c, struct loc top_left,
 	}
 }
 
-void surface_gen(struct chunk *c, struct chunk_ref *ref, int y_coord,
-				 int x_coord, struct connector *first_conn)
+/**
+ * Generate the terrain of a surface chunk.
+ *
+ * This depends on the location's seed, the stored data for it and its
+ * neighbours, and (for deep water at the chunk's edges) the terrain already
+ * in the arena around it.  Everything random comes from rng, which is seeded
+ * from the location, so the current generator is neither used nor changed.
+ * \return the biome to draw the chunk's monsters from
+ */
+enum biome_type surface_gen(struct chunk *c, struct chunk_ref *ref,
+							int y_coord, int x_coord,
+							struct connector *first_conn, struct rng_ctx *rng)
 {
 	struct loc top_left = loc(x_coord * CHUNK_SIDE, y_coord * CHUNK_SIDE);
 	struct point_set *chunk = make_chunk_point_set(c, top_left);
-	struct world_region *region = &region_info[find_region(ref->y_pos,
-														   ref->x_pos)];
 	enum biome_type standard, mon_biome;
 	struct biome_tweak tweak = { DIR_NONE, 0, -1, DIR_NONE, 0, -1 };
 	struct gen_loc *location;
-	int lower, upper, i;
+	int lower, upper;
 	bool found;
 
-	/* Player now counts as having visited this region */
-	if (!player->region_visit[region->index]) {
-		char buf[120];
-		int new_exp = 200;
-		player->region_visit[region->index] = true;
-		if (turn != 1) {
-			player_exp_gain(player, new_exp);
-			player->explore_exp += new_exp;
-			strnfmt(buf, sizeof(buf), "Visited %s.", region->name);
-			history_add(player, buf, HIST_VISIT_REGION);
-		}
-	}
-
 	/* Get the standard biome based on region.txt */
-	standard = square_miles[ref->y_pos / CPM][ref->x_pos / CPM].biome;
+	standard = square_mile_biome(loc(ref->x_pos / CPM, ref->y_pos / CPM));
 	tweak.biome1 = standard;
 	tweak.biome2 = standard;
 	mon_biome = standard;
@@ -816,59 +820,56 @@ void surface_gen(struct chunk *c, struct chunk_ref *ref, int y_coord,
 	if (get_biome_tweaks(ref->y_pos, ref->x_pos, &tweak)) {
 		if (tweak.dir1 == DIR_NONE) {
 			/* Whole chunk is the tweaked biome */
-			make_piece(c, tweak.biome1, chunk, top_left);
+			make_piece(c, rng, tweak.biome1, chunk, top_left);
 			mon_biome = tweak.biome1;
 		} else if ((tweak.dir1 == DIR_NE) || (tweak.dir1 == DIR_SE) ||
 				   (tweak.dir1 == DIR_SW) || (tweak.dir1 == DIR_NW)) {
 			/* Corner effect */
-			struct point_set *tweaked = make_corner_point_set(c, top_left,
+			struct point_set *tweaked = make_corner_point_set(c, rng, top_left,
 															  tweak.dir1);
 			struct point_set *remainder = point_set_subtract(chunk, tweaked);
-			make_piece(c, tweak.biome1, tweaked, top_left);
-			make_piece(c, standard, remainder, top_left);
+			make_piece(c, rng, tweak.biome1, tweaked, top_left);
+			make_piece(c, rng, standard, remainder, top_left);
 			point_set_dispose(tweaked);
 			point_set_dispose(remainder);
 		} else {
 			/* An edge effect, or two separate edge effects */
 			struct point_set *first, *remainder1;
 			if (tweak.idx1 >= 0) {
-				first = match_edge_point_set(c, top_left, tweak.idx1,
+				first = match_edge_point_set(c, rng, top_left, tweak.idx1,
 											 tweak.dir1);
 			} else {
-				first = make_edge_point_set(c, top_left, tweak.dir1);
+				first = make_edge_point_set(c, rng, top_left, tweak.dir1);
 			}
 			remainder1 = point_set_subtract(chunk, first);
-			make_piece(c, tweak.biome1, first, top_left);
+			make_piece(c, rng, tweak.biome1, first, top_left);
 
 			if (tweak.dir2 != DIR_NONE) {
 				struct point_set *second, *remainder2;
 				if (tweak.idx2 >= 0) {
-					second = match_edge_point_set(c, top_left, tweak.idx2,
+					second = match_edge_point_set(c, rng, top_left, tweak.idx2,
 												  tweak.dir2);
 				} else {
-					second = make_edge_point_set(c, top_left, tweak.dir2);
+					second = make_edge_point_set(c, rng, top_left, tweak.dir2);
 				}
 				remainder2 = point_set_subtract(remainder1, first);
 
 				/* Possibly this will overlap first, which I think is OK */
-				make_piece(c, tweak.biome2, second, top_left);
-				make_piece(c, standard, remainder2, top_left);
+				make_piece(c, rng, tweak.biome2, second, top_left);
+				make_piece(c, rng, standard, remainder2, top_left);
 				point_set_dispose(second);
 				point_set_dispose(remainder2);
 			} else {
-				make_piece(c, standard, remainder1, top_left);
+				make_piece(c, rng, standard, remainder1, top_left);
 			}
 			point_set_dispose(first);
 			point_set_dispose(remainder1);
 		}
 	} else {
-		make_piece(c, standard, chunk, top_left);
+		make_piece(c, rng, standard, chunk, top_left);
 	}
 	point_set_dispose(chunk);
 
-	/* Re-activate the complex RNG now terrain generation is done */
-	Rand_quick = false;
-
 	/* Place river if any */
 	found = gen_loc_find(ref->x_pos, ref->y_pos, 0, &lower, &upper);
 	assert(found);
@@ -877,9 +878,35 @@ void surface_gen(struct chunk *c, struct chunk_ref *ref, int y_coord,
 		make_river_piece(c, top_left, location->river_piece);
 	}
 
+	return mon_biome;
+}
+
+/**
+ * Do what happens when a new surface chunk joins the playing arena
+ */
+void surface_populate(struct chunk *c, struct chunk_ref *ref,
+					  enum biome_type biome)
+{
+	struct world_region *region = &region_info[find_region(ref->y_pos,
+														   ref->x_pos)];
+	int i;
+
+	/* Player now counts as having visited this region */
+	if (!player->region_visit[region->index]) {
+		char buf[120];
+		int new_exp = 200;
+		player->region_visit[region->index] = true;
+		if (turn != 1) {
+			player_exp_gain(player, new_exp);
+			player->explore_exp += new_exp;
+			strnfmt(buf, sizeof(buf), "Visited %s.", region->name);
+			history_add(player, buf, HIST_VISIT_REGION);
+		}
+	}
+
 	//TODO generate monsters, perhaps objects
 	for (i = randint1(2); i > 0; i--) {
-		pick_and_place_distant_monster(c, player, mon_biome, region->realm,
+		pick_and_place_distant_monster(c, player, biome, region->realm,
 									   true, region->danger);
 	}
 }
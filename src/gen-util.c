@@ -299,13 +299,15 @@ void cave_find_reset(int *state)
 /**
  * Get the next grid for a search created by cave_find_init().
  *
+ * \param rng is the generator to use.
  * \param grid is dereferenced and set to the grid to check.
  * \param state is the search state created by cave_find_init().
  * \return true if grid was dereferenced and set to the next grid to be
  * searched; otherwise return false to indicate that there are no more grids
  * available.
  */
-bool cave_find_get_grid(int *index, struct loc *grid, int *state)
+bool cave_find_get_grid(struct rng_ctx *rng, int *index, struct loc *grid,
+						int *state)
 {
 	int j, k;
 
@@ -316,7 +318,7 @@ bool cave_find_get_grid(int *index, struct loc *grid, int *state)
 	 * Choose one of the remaining ones at random.  Swap it with the one
 	 * that's next in order.
 	 */
-	j = randint0(state[0] - state[4]) + state[4];
+	j = rng_int0(rng, state[0] - state[4]) + state[4];
 	k = state[5 + j];
 	state[5 + j] = state[5 + state[4]];
 	state[5 + state[4]] = k;
@@ -343,20 +345,21 @@ bool cave_find_get_grid(int *index, struct loc *grid, int *state)
  * Locate a square in a rectangle which satisfies the given predicate.
  *
  * \param c current chunk
+ * \param rng generator to use
  * \param grid found grid
  * \param top_left top left grid of rectangle
  * \param bottom_right bottom right grid of rectangle
  * \param pred square_predicate specifying what we're looking for
  * \return success
  */
-bool cave_find_in_range(struct chunk *c, struct loc *grid,
+bool cave_find_in_range(struct chunk *c, struct rng_ctx *rng, struct loc *grid,
 		struct loc top_left, struct loc bottom_right,
 		square_predicate pred)
 {
 	int *state = cave_find_init(NULL, top_left, bottom_right);
 	bool found = false;
 
-	while (!found && cave_find_get_grid(NULL, grid, state)) {
+	while (!found && cave_find_get_grid(rng, NULL, grid, state)) {
 		found = pred(c, *grid);
 	}
 	mem_free(state);
@@ -377,7 +380,7 @@ bool cave_find_in_point_set(struct chunk *c, struct loc *grid,
 	int *state = cave_find_init(points, loc(0, 0), loc(0, 0)), *index = NULL;
 	bool found = false;
 
-	while (!found && cave_find_get_grid(index, NULL, state)) {
+	while (!found && cave_find_get_grid(Rand_ctx, index, NULL, state)) {
 		assert((*index >= 0) && (*index < point_set_size(points)));
 		*grid = points->pts[*index];
 		found = pred(c, *grid);
@@ -398,7 +401,8 @@ bool cave_find(struct chunk *c, struct loc *grid, square_predicate pred)
 {
 	struct loc top_left = loc(0, 0);
 	struct loc bottom_right = loc(c->width - 1, c->height - 1);
-	return cave_find_in_range(c, grid, top_left, bottom_right, pred);
+	return cave_find_in_range(c, Rand_ctx, grid, top_left, bottom_right,
+							  pred);
 }
 
 
@@ -425,7 +429,7 @@ bool find_empty(struct chunk *c, struct loc *grid)
 bool find_empty_range(struct chunk *c, struct loc *grid, struct loc top_left,
 	struct loc bottom_right)
 {
-	return cave_find_in_range(c, grid, top_left, bottom_right,
+	return cave_find_in_range(c, Rand_ctx, grid, top_left, bottom_right,
 		square_isempty);
 }
 
@@ -433,18 +437,19 @@ bool find_empty_range(struct chunk *c, struct loc *grid, struct loc top_left,
 /**
  * Locate a grid within +/- yd, xd of a centre.
  * \param c current chunk
+ * \param rng generator to use
  * \param grid found grid
  * \param centre starting grid
  * \param yd y-range
  * \param xd x-range
  * \return success
  */
-bool find_nearby_grid(struct chunk *c, struct loc *grid, struct loc centre,
-	int yd, int xd)
+bool find_nearby_grid(struct chunk *c, struct rng_ctx *rng, struct loc *grid,
+	struct loc centre, int yd, int xd)
 {
 	struct loc top_left = loc(centre.x - xd, centre.y - yd);
 	struct loc bottom_right = loc(centre.x + xd, centre.y + yd);
-	return cave_find_in_range(c, grid, top_left, bottom_right,
+	return cave_find_in_range(c, rng, grid, top_left, bottom_right,
 		square_in_bounds_fully);
 }
 
@@ -476,11 +481,13 @@ bool find_nearest_point_set_grid(struct chunk *c, struct loc *grid,
 
 /**
  * Given two points, pick a valid cardinal direction from one to the other.
+ * \param rng generator to use
  * \param offset found offset direction from grid 1 to grid2
  * \param grid1 starting grid
  * \param grid2 target grid
  */
-void correct_dir(struct loc *offset, struct loc grid1, struct loc grid2)
+void correct_dir(struct rng_ctx *rng, struct loc *offset, struct loc grid1,
+				 struct loc grid2)
 {
 	/* Extract horizontal and vertical directions */
 	offset->x = CMP(grid2.x, grid1.x);
@@ -490,7 +497,7 @@ void correct_dir(struct loc *offset, struct loc grid1, struct loc grid2)
 	if (!offset->x || !offset->y) return;
 
 	/* If we need to go diagonally, then choose a random direction */
-	if (randint0(100) < 50)
+	if (rng_int0(rng, 100) < 50)
 		offset->y = 0;
 	else
 		offset->x = 0;
@@ -501,7 +508,8 @@ void correct_dir(struct loc *offset, struct loc grid1, struct loc grid2)
  * Go in a semi-random direction from current location to target location.  
  * Do not actually head away from the target grid.  Always make a turn.
  */
-void adjust_dir(struct loc *offset, struct loc grid1, struct loc grid2)
+void adjust_dir(struct rng_ctx *rng, struct loc *offset, struct loc grid1,
+				struct loc grid2)
 {
 	/* Always turn 90 degrees. */
 	if ((*offset).y == 0) {
@@ -509,7 +517,7 @@ void adjust_dir(struct loc *offset, struct loc grid1, struct loc grid2)
 
 		/* On the y-axis of target - freely choose a side to turn to. */
 		if (grid1.y == grid2.y) {
-			(*offset).y = ((one_in_(2) == 0) ? -1 : 1);
+			(*offset).y = ((rng_one_in(rng, 2) == 0) ? -1 : 1);
 		} else {
 			/* Never turn away from target. */
 			(*offset).y = ((grid1.y < grid2.y) ? 1 : -1);
@@ -519,7 +527,7 @@ void adjust_dir(struct loc *offset, struct loc grid1, struct loc grid2)
 
 		/* On the x-axis of target - freely choose a side to turn to. */
 		if (grid1.x == grid2.x) {
-			(*offset).x = ((one_in_(2) == 0) ? -1 : 1);
+			(*offset).x = ((rng_one_in(rng, 2) == 0) ? -1 : 1);
 		} else {
 			/* Never turn away from target. */
 			(*offset).x = ((grid1.x < grid2.x) ? 1 : -1);
@@ -530,12 +538,13 @@ void adjust_dir(struct loc *offset, struct loc grid1, struct loc grid2)
 
 /**
  * Pick a random cardinal direction.
+ * \param rng generator to use
  * \param offset direction offset
  */
-void rand_dir(struct loc *offset)
+void rand_dir(struct rng_ctx *rng, struct loc *offset)
 {
 	/* Pick a random direction and extract the dy/dx components */
-	int i = randint0(4);
+	int i = rng_int0(rng, 4);
 	*offset = ddgrid_ddd[i];
 }
 
@@ -567,10 +576,10 @@ static void place_rubble(struct chunk *c, struct loc grid)
 /**
  * Choose either an ordinary up staircase or an up shaft.
  */
-static int choose_up_stairs(struct chunk *c)
+static int choose_up_stairs(struct chunk *c, struct rng_ctx *rng)
 {
 	if (c->depth >= 2) {
-		if (one_in_(2)) return FEAT_LESS_SHAFT;
+		if (rng_one_in(rng, 2)) return FEAT_LESS_SHAFT;
 	}
 	return FEAT_LESS;
 }
@@ -578,10 +587,10 @@ static int choose_up_stairs(struct chunk *c)
 /**
  * Choose either an ordinary down staircase or an down shaft.
  */
-static int choose_down_stairs(struct chunk *c)
+static int choose_down_stairs(struct chunk *c, struct rng_ctx *rng)
 {
 	if (c->depth < dungeon_depth(player) - 2) {
-		if (one_in_(2)) return FEAT_MORE_SHAFT;
+		if (rng_one_in(rng, 2)) return FEAT_MORE_SHAFT;
 	}
 	return FEAT_MORE;
 }
@@ -590,19 +599,20 @@ static int choose_down_stairs(struct chunk *c)
  * Place stairs (of the requested type 'feat' if allowed) at a given location.
  *
  * \param c current chunk
+ * \param rng generator to use
  * \param grid location
  * \param first is whether or not this is the first stair on the level.
  * \param feat stair terrain type
  */
-static void place_stairs(struct chunk *c, struct loc grid, bool first, int feat,
-						 bool any)
+static void place_stairs(struct chunk *c, struct rng_ctx *rng, struct loc grid,
+						 bool first, int feat, bool any)
 {
 	/* Allow shafts, but guarantee the first one is an ordinary stair */
 	if (!first) {
 		if (any && (feat == FEAT_LESS)) {
-			feat = choose_up_stairs(c);
+			feat = choose_up_stairs(c, rng);
 		} else if (any && (feat == FEAT_MORE)) {
-			feat = choose_down_stairs(c);
+			feat = choose_down_stairs(c, rng);
 		}
 	}
 	square_set_feat(c, grid, feat);
@@ -662,14 +672,15 @@ void place_secret_door(struct chunk *c, struct loc grid)
 /**
  * Place a closed (and possibly locked or jammed) door at a given location.
  * \param c current chunk
+ * \param rng generator to use
  * \param grid location
  */
-void place_closed_door(struct chunk *c, struct loc grid)
+void place_closed_door(struct chunk *c, struct rng_ctx *rng, struct loc grid)
 {
-	int value = randint0(100);
+	int value = rng_int0(rng, 100);
 	square_set_feat(c, grid, FEAT_CLOSED);
 	if (square_isvault(c, grid)) {
-		int power = (20 + c->depth + randint1(15)) / 5;
+		int power = (20 + c->depth + rng_int1(rng, 15)) / 5;
 		power = MIN(7, power);
 		if (value < 4) {
 			/* Locked doors (8%) */
@@ -679,7 +690,7 @@ void place_closed_door(struct chunk *c, struct loc grid)
 			square_set_door_jam(c, grid, power);
 		}
 	} else {
-		int power = (10 + c->depth + randint1(15)) / 5;
+		int power = (10 + c->depth + rng_int1(rng, 15)) / 5;
 		power = MIN(7, power);
 		if (value < 24) {
 			/* Locked doors (24%) */
@@ -694,18 +705,19 @@ void place_closed_door(struct chunk *c, struct loc grid)
 /**
  * Place a random door at a given location.
  * \param c current chunk
+ * \param rng generator to use
  * \param grid location
  *
  * The door generated could be closed (and possibly locked), open, or secret.
  */
-void place_random_door(struct chunk *c, struct loc grid)
+void place_random_door(struct chunk *c, struct rng_ctx *rng, struct loc grid)
 {
-	int tmp = randint0(70 + c->depth);
+	int tmp = rng_int0(rng, 70 + c->depth);
 
 	if (tmp < 20) {
 		square_set_feat(c, grid, FEAT_OPEN);
 	} else if (tmp < 60) {
-		place_closed_door(c, grid);
+		place_closed_door(c, rng, grid);
 	} else {
 		place_secret_door(c, grid);
 	}
@@ -714,14 +726,15 @@ void place_random_door(struct chunk *c, struct loc grid)
 /**
  * Place a forge at a given location.
  * \param c current chunk
+ * \param rng generator to use
  * \param grid location
  */
-void place_forge(struct chunk *c, struct loc grid)
+void place_forge(struct chunk *c, struct rng_ctx *rng, struct loc grid)
 {
 	int i;
 	int effective_depth = c->depth + 10;
 	int power = 1;
-	int uses = damroll(2, 2);
+	int uses = rng_damroll(rng, 2, 2);
 
 	if (square_isgreatervault(c, grid)) {
 		effective_depth *= 2;
@@ -729,7 +742,7 @@ void place_forge(struct chunk *c, struct loc grid)
 
 	/* Roll once per level of depth and keep the best roll */
 	for (i = 0; i < effective_depth; i++) {
-		int p = randint1(1000);
+		int p = rng_int1(rng, 1000);
 		power = MAX(power, p);
 	}
 
@@ -763,6 +776,7 @@ void place_forge(struct chunk *c, struct loc grid)
 /**
  * Place some staircases near walls.
  * \param c the current chunk
+ * \param rng generator to use
  * \param feat the stair terrain type
  * \param num number of staircases to place
  * \param minsep If greater than zero, the stairs must be more than minsep
@@ -771,7 +785,8 @@ void place_forge(struct chunk *c, struct loc grid)
  * \param any If true, any type of staircase in the given  direction is valid.
  *  Otherwise, only staircases of the exact type of feat are.
  */
-void alloc_stairs(struct chunk *c, int feat, int num, int minsep, bool any)
+void alloc_stairs(struct chunk *c, struct rng_ctx *rng, int feat, int num,
+				  int minsep, bool any)
 {
 	int i, navalloc, nav, walls;
 	struct loc *av;
@@ -824,7 +839,7 @@ void alloc_stairs(struct chunk *c, int feat, int num, int minsep, bool any)
 		bool first = (i == 0);
 
 		/* Try to find; then decrease "walls" */
-		while (i < num && cave_find_get_grid(NULL, &grid, state)) {
+		while (i < num && cave_find_get_grid(rng, NULL, &grid, state)) {
 			if (!square_isempty(c, grid)
 				|| square_num_walls_adjacent(c, grid) != walls) {
 				continue;
@@ -853,7 +868,7 @@ void alloc_stairs(struct chunk *c, int feat, int num, int minsep, bool any)
 				av[nav++] = grid;
 			}
 
-			place_stairs(c, grid, first, feat, any);
+			place_stairs(c, rng, grid, first, feat, any);
 			assert(square_isstairs(c, grid) || square_isshaft(c, grid));
 			++i;
 		}
@@ -938,6 +953,7 @@ void place_traps(struct chunk *c)
 /**
  * Allocates zero or more random objects in the dungeon.
  * \param c the current chunk
+ * \param rng the generator for where they go
  * \param set where the entity is placed (corridor, room or either)
  * \param typ what is placed (rubble, trap, gold, item)
  * \param num is the number of objects to allocate
@@ -948,15 +964,15 @@ void place_traps(struct chunk *c)
  * 'set' controls where the object is placed (corridor, room, either).
  * 'typ' conrols the kind of object (rubble, trap, gold, item).
  */
-int alloc_object(struct chunk *c, int set, int typ, int num, int depth,
-						 uint8_t origin)
+int alloc_object(struct chunk *c, struct rng_ctx *rng, int set, int typ,
+				 int num, int depth, uint8_t origin)
 {
 	int nrem = num;
 	int *state = cave_find_init(NULL, loc(1, 1),
 								loc(c->width - 2, c->height - 2));
 	struct loc grid;
 
-	while (nrem > 0 && cave_find_get_grid(NULL, &grid, state)) {
+	while (nrem > 0 && cave_find_get_grid(rng, NULL, &grid, state)) {
 		/*
 		 * If we're ok with a corridor and we're in one, we're done.
 		 * If we are ok with a room and we're in one, we're done
@@ -1044,13 +1060,14 @@ void uncreate_greater_vaults(struct chunk *c, struct player *p)
  * Read terrain from a text file.  Allow for picking a smaller rectangle out of
  * a large rectangle.
  *
- * Used for vaults and landmarks.  Note that some vault codes are repurposed
- * here to allow more terrain for landmarks
+ * Used for vaults, settlements and landmarks.  Note that some vault codes are
+ * repurposed here to allow more terrain for landmarks.  Random terrain comes
+ * from rng; traps still use the current generator.
  */
-void get_terrain(struct chunk *c, struct loc top_left, struct loc bottom_right,
-				 struct loc place, int height, int width, int rotate,
-				 bool reflect, bitflag *flags, bool floor, const char *data,
-				 bool landmark)
+void get_terrain(struct chunk *c, struct rng_ctx *rng, struct loc top_left,
+				 struct loc bottom_right, struct loc place, int height,
+				 int width, int rotate, bool reflect, bitflag *flags,
+				 bool floor, const char *data, bool landmark)
 {
 	int x, y;
 	const char *t;
@@ -1103,30 +1120,30 @@ void get_terrain(struct chunk *c, struct loc top_left, struct loc bottom_right,
 				/* Glyph of warding */
 			case '8': square_add_glyph(c, grid, GLYPH_WARDING); break;
 				/* Visible door */
-			case '+': place_closed_door(c, grid); break;
+			case '+': place_closed_door(c, rng, grid); break;
 				/* Secret door */
 			case 's': place_secret_door(c, grid); break;
 				/* Trap */
-			case '^': if (one_in_(2)) square_add_trap(c, grid); break;
+			case '^': if (rng_one_in(rng, 2)) square_add_trap(c, grid); break;
 				/* Forge */
-			case '0': place_forge(c, grid); break;
+			case '0': place_forge(c, rng, grid); break;
 				/* Chasm */
 			case '7': square_set_feat(c, grid, FEAT_CHASM); break;
 				/* Permanent wall */
 			case '@': square_set_feat(c, grid, FEAT_PERM); break;
 				/* Rubble */
 			case ':': {
-				square_set_feat(c, grid, one_in_(2) ? FEAT_PASS_RUBBLE :
-								FEAT_RUBBLE);
+				square_set_feat(c, grid, rng_one_in(rng, 2) ?
+								FEAT_PASS_RUBBLE : FEAT_RUBBLE);
 				break;
 			}
 				/* Stairs */
 			case '<': {
-				place_stairs(c, grid, false, FEAT_LESS, false);
+				place_stairs(c, rng, grid, false, FEAT_LESS, false);
 				break;
 			}
 			case '>': {
-				place_stairs(c, grid, false, FEAT_MORE, false);
+				place_stairs(c, rng, grid, false, FEAT_MORE, false);
 				break;
 			}
 				/* Lava */
@@ -1135,7 +1152,7 @@ void get_terrain(struct chunk *c, struct loc top_left, struct loc bottom_right,
 			case '/': square_set_feat(c, grid, FEAT_S_WATER); break;
 				/* Trees */
 			case ';': {
-				if (one_in_(2))
+				if (rng_one_in(rng, 2))
 					square_set_feat(c, grid, FEAT_L_TREE);
 				else
 					square_set_feat(c, grid, FEAT_H_TREE);
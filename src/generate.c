@@ -1073,7 +1073,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 				while (join) {
 					if (join->feat == FEAT_MORE_SHAFT) {
 						/* Join must be an up shaft */
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_LESS_SHAFT;
@@ -1102,7 +1102,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 						}
 
 						/* Join must be a floor */
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_FLOOR;
@@ -1116,7 +1116,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 						 * safely placed.  We do this by just setting the
 						 * feature to be a wall.
 						 */
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_GRANITE;
@@ -1135,7 +1135,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 				join = location->join;
 				while (join) {
 					if (join->feat == FEAT_MORE) {
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_LESS;
@@ -1144,7 +1144,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 					} else if (join->feat == FEAT_CHASM) {
 						/* Two up level chasm case is already dealt with */
 						if (!exists_up2) {
-							struct connector *new = mem_zalloc(sizeof *new);
+							struct connector *new = connector_new();
 							/* If on second bottom level, put a floor */
 							bool floor = (p->depth == dungeon_depth(p) - 1);
 
@@ -1163,7 +1163,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 						 * if the two-up level is ever generated.  We do this
 						 * by just setting the feature to be a wall.
 						 */
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_GRANITE;
@@ -1183,7 +1183,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 				join = location->join;
 				while (join) {
 					if (join->feat == FEAT_LESS) {
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_MORE;
@@ -1191,7 +1191,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 						dd->join = new;
 					} else if (feat_is_downstair(join->feat)) {
 						/* Prevent anything that might conflict */
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_GRANITE;
@@ -1209,7 +1209,7 @@ static void get_join_info(struct player *p, struct dun_data *dd)
 				join = location->join;
 				while (join) {
 					if (join->feat == FEAT_LESS_SHAFT) {
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = join->grid.y + y * CHUNK_SIDE;
 						new->grid.x = join->grid.x + x * CHUNK_SIDE;
 						new->feat = FEAT_MORE_SHAFT;
@@ -1263,6 +1263,7 @@ static struct chunk *cave_generate(struct player *p, uint32_t seed)
 	struct chunk *chunk = NULL;
 	struct connector *dun_join = NULL;
 	struct loc centre = p->grid;
+	struct rng_ctx level_rng;
 
 	/* Generate */
 	for (tries = 0; tries < 100 && error; tries++) {
@@ -1293,19 +1294,20 @@ static struct chunk *cave_generate(struct player *p, uint32_t seed)
 		/* Get connector info */
 		get_join_info(p, dun);
 
-		/* Set the RNG to give reproducible results.  Note that only terrain
-		 * is generated with the simple RNG, as objects, traps and monsters
-		 * are generated differently each time for any location. */
+		/* Seed a generator to give reproducible results.  Note that only
+		 * terrain is generated with it, as objects, traps and monsters are
+		 * generated differently each time for any location; as for surface
+		 * chunks, the cave profiles and their room builders are passed it
+		 * and draw the rest from the game's generator. */
 		while (!dun->seed) {
 			dun->seed = randint0(0x10000000);
 		}
-		Rand_quick = true;
-		Rand_value = dun->seed;
+		rng_quick_init(&level_rng, dun->seed);
 
 		/* Choose a profile and build the level */
 		dun->profile = choose_profile(p);
 		event_signal_string(EVENT_GEN_LEVEL_START, dun->profile->name);
-		chunk = dun->profile->builder(p);
+		chunk = dun->profile->builder(p, &level_rng);
 		if (!chunk) {
 			error = "Failed to build level";
 			cleanup_dun_data(dun);
@@ -1316,8 +1318,6 @@ static struct chunk *cave_generate(struct player *p, uint32_t seed)
 			continue;
 		}
 
-		Rand_quick = false;
-
 		/* Regenerate levels that overflow their maxima */
 		if (mon_max >= z_info->monster_max) {
 			if (!dun->first_time) {
@@ -1390,6 +1390,7 @@ static struct chunk *cave_generate(struct player *p, uint32_t seed)
 
 			/* Write the seed */
 			location->seed = dun->seed;
+			location->dirty = true;
 
 			/* Now write the connectors */
 			for (grid.y = y * CHUNK_SIDE; grid.y < (y + 1) * CHUNK_SIDE;
@@ -1400,7 +1401,7 @@ static struct chunk *cave_generate(struct player *p, uint32_t seed)
 					if (feat_is_stair(feat)	|| feat_is_shaft(feat)
 						|| feat_is_chasm(feat)) {
 						/* Write the join */
-						struct connector *new = mem_zalloc(sizeof *new);
+						struct connector *new = connector_new();
 						new->grid.y = grid.y - y * CHUNK_SIDE;
 						new->grid.x = grid.x - x * CHUNK_SIDE;
 						new->feat = feat;
@@ -1436,6 +1437,7 @@ void prepare_next_level(struct player *p)
 	if (turn == 1) {
 		/* Make an arena to build into */
 		cave = chunk_new(ARENA_SIDE, ARENA_SIDE);
+		chunk_set_live(cave);
 
 		for (y = - ARENA_CHUNKS / 2; y <= ARENA_CHUNKS / 2; y++) {
 			for (x = - ARENA_CHUNKS / 2; x <= ARENA_CHUNKS / 2; x++) {
@@ -1494,6 +1496,10 @@ void prepare_next_level(struct player *p)
 					reload = gen_loc_find(ref.x_pos, ref.y_pos, ref.z_pos,
 										  &lower, &upper);
 
+					/* Not in the chunk list, so count a cache miss */
+					chunk_cache_stats.misses++;
+					if (reload) chunk_cache_stats.regenerations++;
+
 					/* New gen_loc, or seed loading and checking */
 					if (!reload) {
 						gen_loc_make(ref.x_pos, ref.y_pos, ref.z_pos, upper);
@@ -1545,6 +1551,7 @@ void prepare_next_level(struct player *p)
 			/* Silly games */
 			chunk_wipe(cave);
 			chunk = chunk_new(ARENA_SIDE, ARENA_SIDE);
+			chunk_set_live(chunk);
 			cave = chunk;
 			chunk_wipe(p->cave);
 			p_chunk = chunk_new(ARENA_SIDE, ARENA_SIDE);
@@ -1579,6 +1586,7 @@ void prepare_next_level(struct player *p)
 			}
 			player_place(chunk, p, p->grid);
 		}
+		chunk_set_live(chunk);
 		cave = chunk;
 	}
 
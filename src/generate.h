@@ -19,12 +19,13 @@
 /**
  * Constants for generation.  Note that MAX_CHUNKS needs to be at least three
  * times ARENA_CHUNKS squared to allow proper saving off and reloading of
- * chunks from the chunk_list.
+ * chunks from the chunk_list; it is set from the chunk-cache constant.
  */
 #define ARENA_CHUNKS 3
 #define ARENA_SIDE (CHUNK_SIDE * ARENA_CHUNKS)
 #define WIDEN_RATIO 25			/* River miles length per extra grid width */
-#define MAX_CHUNKS 256
+#define MAX_CHUNKS chunk_list_max
+#define MIN_CHUNKS (3 * ARENA_CHUNKS * ARENA_CHUNKS)
 #define CHUNK_TEMP -2
 #define CHUNK_CUR -1
 
@@ -236,7 +237,7 @@ struct streamer_profile {
 /*
  * cave_builder is a function pointer which builds a level.
  */
-typedef struct chunk * (*cave_builder) (struct player *p);
+typedef struct chunk * (*cave_builder) (struct player *p, struct rng_ctx *rng);
 
 
 struct cave_profile {
@@ -259,9 +260,10 @@ struct cave_profile {
 
 /**
  * room_builder is a function pointer which builds rooms in the cave given
- * anchor coordinates.
+ * anchor coordinates, taking their terrain from the given generator.
  */
-typedef bool (*room_builder) (struct chunk *c, struct loc centre);
+typedef bool (*room_builder) (struct chunk *c, struct rng_ctx *rng,
+							  struct loc centre);
 
 
 /**
@@ -298,6 +300,18 @@ struct vault {
     bool forge;					/*!< Is there a forge in it? */
 };
 
+/**
+ * Statistics for the chunk list as a cache of stored chunks
+ */
+struct chunk_cache_stats {
+	uint32_t hits;			/**< Chunks reloaded from the chunk list */
+	uint32_t misses;		/**< Chunks which had to be generated */
+	uint32_t regenerations;	/**< Misses for chunks generated before */
+	uint32_t evictions;		/**< Entries evicted to make room */
+	uint32_t pregenerated;	/**< Chunks generated ahead of the player */
+	uint32_t pregen_used;	/**< Of those, chunks read into the arena */
+	size_t bytes;			/**< Memory used by stored chunks */
+};
 /*
  * Information about settlement generation
  */
@@ -331,6 +345,8 @@ extern struct dun_data *dun;
 extern struct vault *vaults;
 extern struct settlement *settlements;
 extern struct room_template *room_templates;
+extern uint16_t chunk_list_max;
+extern struct chunk_cache_stats chunk_cache_stats;
 
 /* generate.c */
 void prepare_next_level(struct player *p);
@@ -341,25 +357,29 @@ int get_level_profile_index_from_name(const char *name);
 const char *get_level_profile_name_from_index(int i);
 
 /* gen-cave.c */
-struct chunk *angband_gen(struct player *p);
-struct chunk *elven_gen(struct player *p);
-struct chunk *dwarven_gen(struct player *p);
-struct chunk *throne_gen(struct player *p);
-bool build_landmark(struct chunk *c, struct landmark *landmark, int map_y,
-					int map_x, int y_coord, int x_coord);
+struct chunk *angband_gen(struct player *p, struct rng_ctx *rng);
+struct chunk *elven_gen(struct player *p, struct rng_ctx *rng);
+struct chunk *dwarven_gen(struct player *p, struct rng_ctx *rng);
+struct chunk *throne_gen(struct player *p, struct rng_ctx *rng);
+bool build_landmark(struct chunk *c, struct rng_ctx *rng,
+					struct landmark *landmark, int map_y, int map_x,
+					int y_coord, int x_coord);
 
 /* gen-river.c */
-void map_river_miles(struct square_mile *sq_mile);
+void map_river_miles(struct loc grid, struct rng_ctx *rng);
 
 /* gen-surface.c */
-void surface_gen(struct chunk *c, struct chunk_ref *ref, int y_coord,
-				 int x_coord, struct connector *first);
+enum biome_type surface_gen(struct chunk *c, struct chunk_ref *ref,
+							int y_coord, int x_coord, struct connector *first,
+							struct rng_ctx *rng);
+void surface_populate(struct chunk *c, struct chunk_ref *ref,
+					  enum biome_type biome);
 
 /* gen-chunk.c */
 void symmetry_transform(struct loc *grid, int y0, int x0, int height, int width,
 	int rotate, bool reflect);
-void get_random_symmetry_transform(int height, int width, int flags,
-	int transpose_weight, int *rotate, bool *reflect,
+void get_random_symmetry_transform(struct rng_ctx *rng, int height,
+	int width, int flags, int transpose_weight, int *rotate, bool *reflect,
 	int *theight, int *twidth);
 int calc_default_transpose_weight(int height, int width);
 bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
@@ -370,9 +390,13 @@ int chunk_offset_to_adjacent(int z_offset, int y_offset, int x_offset);
 int find_region(int y_pos, int x_pos);
 void chunk_offset_data(struct chunk_ref *ref, int z_offset, int y_offset,
 						 int x_offset);
+struct connector *connector_new(void);
 void connectors_free(struct connector *join);
+void chunk_list_reindex(void);
 void chunk_list_init(void);
+void chunk_list_reserve(int size);
 void chunk_list_cleanup(void);
+bool chunk_is_staged(int idx);
 int chunk_find(struct chunk_ref ref);
 int chunk_store(int y_coord, int x_coord, uint16_t region, uint16_t z_pos,
 				uint16_t y_pos, uint16_t x_pos, uint32_t gen_loc_idx,
@@ -380,11 +404,13 @@ int chunk_store(int y_coord, int x_coord, uint16_t region, uint16_t z_pos,
 int chunk_fill(struct chunk *c, struct chunk_ref *ref, int y_coord,
 			   int x_coord);
 int chunk_get_centre(void);
+void chunk_pregenerate(struct player *p);
 void chunk_change(struct player *p, int z_offset, int y_offset, int x_offset);
 
 
 /* gen-room.c */
-struct vault *random_vault(int depth, const char *typ, bool forge);
+struct vault *random_vault(struct rng_ctx *rng, int depth, const char *typ,
+						   bool forge);
 void generate_mark(struct chunk *c, struct point_set *grids, int flag);
 void fill_point_set(struct chunk *c, struct point_set *grids, int feat,
 					int flag);
@@ -396,25 +422,29 @@ void fill_ellipse(struct chunk *c, int y0, int x0, int y_radius, int x_radius,
 				  int feat, int flag, bool light);
 void set_marked_granite(struct chunk *c, struct loc grid, int flag);
 void set_bordering_walls(struct chunk *c, int y1, int x1, int y2, int x2);
-extern bool generate_starburst_room(struct chunk *c, struct point_set *set,
-									int y1, int x1, int y2, int x2,
-									bool light, int feat, bool special_ok);
-bool build_vault(struct chunk *c, struct loc *centre, bool *rotated,
-				 struct vault *v);
+extern bool generate_starburst_room(struct chunk *c, struct rng_ctx *rng,
+									struct point_set *set, int y1, int x1,
+									int y2, int x2, bool light, int feat,
+									bool special_ok);
+bool build_vault(struct chunk *c, struct rng_ctx *rng, struct loc *centre,
+				 bool *rotated, struct vault *v);
 void unset_room_parameters(void);
-bool build_staircase(struct chunk *c, struct loc centre);
-bool build_simple(struct chunk *c, struct loc centre);
-bool build_circular(struct chunk *c, struct loc centre);
-bool build_elliptical(struct chunk *c, struct loc centre);
-bool build_overlap(struct chunk *c, struct loc centre);
-bool build_crossed(struct chunk *c, struct loc centre);
-bool build_room_of_chambers(struct chunk *c, struct loc centre);
-bool build_interesting(struct chunk *c, struct loc centre);
-bool build_lesser_vault(struct chunk *c, struct loc centre);
-bool build_greater_vault(struct chunk *c, struct loc centre);
-bool build_throne(struct chunk *c, struct loc centre);
-bool build_gates(struct chunk *c, struct loc centre);
-bool room_build(struct chunk *c, struct loc centre,
+bool build_staircase(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_simple(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_circular(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_elliptical(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_overlap(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_crossed(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_room_of_chambers(struct chunk *c, struct rng_ctx *rng,
+							struct loc centre);
+bool build_interesting(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_lesser_vault(struct chunk *c, struct rng_ctx *rng,
+						struct loc centre);
+bool build_greater_vault(struct chunk *c, struct rng_ctx *rng,
+						 struct loc centre);
+bool build_throne(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool build_gates(struct chunk *c, struct rng_ctx *rng, struct loc centre);
+bool room_build(struct chunk *c, struct rng_ctx *rng, struct loc centre,
 				struct room_profile profile);
 
 
@@ -427,43 +457,47 @@ struct loc get_rotated_grid(struct loc start, int sin, int cos, int mult);
 int *cave_find_init(struct point_set *points, struct loc top_left,
 					struct loc bottom_right);
 void cave_find_reset(int *state);
-bool cave_find_get_grid(int *index, struct loc *grid, int *state);
+bool cave_find_get_grid(struct rng_ctx *rng, int *index, struct loc *grid,
+						int *state);
 
-bool cave_find_in_range(struct chunk *c, struct loc *grid, struct loc top_left,
-	struct loc bottom_right, square_predicate pred);
+bool cave_find_in_range(struct chunk *c, struct rng_ctx *rng, struct loc *grid,
+	struct loc top_left, struct loc bottom_right, square_predicate pred);
 bool cave_find_in_point_set(struct chunk *c, struct loc *grid,
 							struct point_set *points, square_predicate pred);
 bool cave_find(struct chunk *c, struct loc *grid, square_predicate pred);
 bool find_empty(struct chunk *c, struct loc *grid);
 bool find_empty_range(struct chunk *c, struct loc *grid, struct loc top_left,
 					  struct loc bottom_right);
-bool find_nearby_grid(struct chunk *c, struct loc *grid, struct loc centre,
-					  int yd, int xd);
+bool find_nearby_grid(struct chunk *c, struct rng_ctx *rng, struct loc *grid,
+					  struct loc centre, int yd, int xd);
 bool find_nearest_point_set_grid(struct chunk *c, struct loc *grid,
 								 struct loc centre, struct point_set *points);
-void correct_dir(struct loc *offset, struct loc grid1, struct loc grid2);
-void adjust_dir(struct loc *offset, struct loc grid1, struct loc grid2);
-void rand_dir(struct loc *offset);
+void correct_dir(struct rng_ctx *rng, struct loc *offset, struct loc grid1,
+				 struct loc grid2);
+void adjust_dir(struct rng_ctx *rng, struct loc *offset, struct loc grid1,
+				struct loc grid2);
+void rand_dir(struct rng_ctx *rng, struct loc *offset);
 enum direction opposite_dir(enum direction dir);
 int trap_placement_chance(struct chunk *c, struct loc grid);
 void place_traps(struct chunk *c);
 void place_object(struct chunk *c, struct loc grid, int level, bool good,
 	bool great, uint8_t origin, struct drop *drop);
 void place_secret_door(struct chunk *c, struct loc grid);
-void place_closed_door(struct chunk *c, struct loc grid);
-void place_random_door(struct chunk *c, struct loc grid);
-void place_forge(struct chunk *c, struct loc grid);
-void alloc_stairs(struct chunk *c, int feat, int num, int minsep, bool any);
-int alloc_object(struct chunk *c, int set, int typ, int num, int depth,
-	uint8_t origin);
+void place_closed_door(struct chunk *c, struct rng_ctx *rng, struct loc grid);
+void place_random_door(struct chunk *c, struct rng_ctx *rng, struct loc grid);
+void place_forge(struct chunk *c, struct rng_ctx *rng, struct loc grid);
+void alloc_stairs(struct chunk *c, struct rng_ctx *rng, int feat, int num,
+				  int minsep, bool any);
+int alloc_object(struct chunk *c, struct rng_ctx *rng, int set, int typ,
+				 int num, int depth, uint8_t origin);
 struct room_profile lookup_room_profile(const char *name);
 void uncreate_artifacts(struct chunk *c);
 void uncreate_greater_vaults(struct chunk *c, struct player *p);
 void chunk_validate_objects(struct chunk *c);
-void get_terrain(struct chunk *c, struct loc top_left, struct loc bottom_right,
-				 struct loc place, int height, int width, int rotate,
-				 bool reflect, bitflag *flags, bool floor, const char *data,
-				 bool landmark);
+void get_terrain(struct chunk *c, struct rng_ctx *rng, struct loc top_left,
+				 struct loc bottom_right, struct loc place, int height,
+				 int width, int rotate, bool reflect, bitflag *flags,
+				 bool floor, const char *data, bool landmark);
 struct landmark *find_landmark(int x_pos, int y_pos, int tolerance);
 void dump_level_simple(const char *basefilename, const char *title,
 	struct chunk *c);
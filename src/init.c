@@ -63,6 +63,7 @@
 #include "songs.h"
 #include "trap.h"
 #include "ui-visuals.h"
+#include "world-cache.h"
 
 bool play_again = false;
 
@@ -198,8 +199,8 @@ errr grab_effect_data(struct parser *p, struct effect *effect)
 
 static void record_square_mile_river_data(struct river_mile *r_mile)
 {
-	struct square_mile *sq_mile = r_mile->sq_mile;
-	struct river_mile *check = sq_mile->river_miles;
+	struct square_mile sq_mile = square_mile(r_mile->sq_mile);
+	struct river_mile *check = sq_mile.river_miles;
 	int count = 0;
 
 	/* Ensure no repeats, not too many river miles per square mile */
@@ -210,21 +211,21 @@ static void record_square_mile_river_data(struct river_mile *r_mile)
 	}
 	if (count > 2) {
 		quit_fmt("Too many river miles in %c%d (%d,%d)",
-				 sq_mile->map_square.letter, sq_mile->map_square.number,
-				 sq_mile->map_square_grid.x, sq_mile->map_square_grid.y);
+				 sq_mile.map_square.letter, sq_mile.map_square.number,
+				 sq_mile.map_square_grid.x, sq_mile.map_square_grid.y);
 	}
 
 	/* If there's an existing one that isn't a join, put the new one second */
-	if (sq_mile->river_miles && (sq_mile->river_miles->part != RIVER_JOIN)) {
+	if (sq_mile.river_miles && (sq_mile.river_miles->part != RIVER_JOIN)) {
 		/* Existing one isn't a join, so the current one should be */
 		assert(r_mile->part == RIVER_JOIN);
-		sq_mile->river_miles->next = r_mile;
+		sq_mile.river_miles->next = r_mile;
 		return;
 	}
 
 	/* If there is an existing one, it's a join and needs to go second */
-	r_mile->next = sq_mile->river_miles;
-	sq_mile->river_miles = r_mile;
+	r_mile->next = sq_mile.river_miles;
+	square_mile_set_river_miles(r_mile->sq_mile, r_mile);
 }
 
 /**
@@ -507,6 +508,10 @@ static enum parser_error parse_constants_world(struct parser *p) {
 		z->move_energy = value;
 	else if (streq(label, "flow-max"))
 		z->flow_max = value;
+	else if (streq(label, "chunk-cache"))
+		z->chunk_cache = MIN(MAX(value, MIN_CHUNKS), UINT16_MAX - 1);
+	else if (streq(label, "chunk-cache-kb"))
+		z->chunk_cache_kb = value;
 	else
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 
@@ -806,22 +811,7 @@ static errr finish_parse_region(struct parser *p)
 		region = n;
 	}
 
-	square_miles = mem_zalloc(MAX_Y_REGION * sizeof(struct square_mile*));
-	for (y = 0; y < MAX_Y_REGION; y++) {
-		char letter = 'A' + y / MPS;
-		if (letter > 'I') letter++;
-		square_miles[y] = mem_zalloc(MAX_X_REGION * sizeof(struct square_mile));
-		for (x = 0; x < MAX_X_REGION; x++) {
-			square_miles[y][x].biome = '~';
-			square_miles[y][x].map_square.letter = letter;
-			square_miles[y][x].map_square.number = x / MPS + 1;
-			square_miles[y][x].map_square_grid.y = y % MPS;
-			square_miles[y][x].map_square_grid.x = x % MPS;
-			square_miles[y][x].map_grid.y = y;
-			square_miles[y][x].map_grid.x = x;
-		}
-	}
-
+	square_miles_init();
 	for (i = 1; i < z_info->region_max; i++) {
 		struct world_region *reg = &region_info[i];
 		int y_start = reg->y_offset;
@@ -834,29 +824,32 @@ static errr finish_parse_region(struct parser *p)
 
 				/* Space means terrain that's part of another region */
 				if (terrain != ' ') {
-					square_miles[y + y_start][x + x_start].biome = terrain;
-					square_miles[y + y_start][x + x_start].region = reg;
+					square_mile_set_terrain(loc(x + x_start, y + y_start),
+											terrain, i);
 				}
 			}
 		}
 	}
 
+	/* The map text isn't needed now the square miles have it */
+	for (i = 1; i < z_info->region_max; i++) {
+		mem_free(region_info[i].text);
+		region_info[i].text = NULL;
+	}
+
 	parser_destroy(p);
 	return 0;
 }
 
 static void cleanup_region(void)
 {
-	int idx, y;
+	int idx;
 	for (idx = 0; idx < z_info->region_max; idx++) {
 		mem_free(region_info[idx].name);
 		mem_free(region_info[idx].text);
 	}
 	mem_free(region_info);
-	for (y = 0; y < MAX_Y_REGION; y++) {
-		mem_free(square_miles[y]);
-	}
-	mem_free(square_miles);
+	square_miles_cleanup();
 }
 
 static struct file_parser region_parser = {
@@ -921,7 +914,7 @@ static enum parser_error parse_river_source(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	stretch->miles->sq_mile = square_mile(letter, number, y, x);
+	stretch->miles->sq_mile = square_mile_grid(letter, number, y, x);
 	record_square_mile_river_data(stretch->miles);
 	return PARSE_ERROR_NONE;
 }
@@ -959,7 +952,7 @@ static enum parser_error parse_river_stretch(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	new->sq_mile = square_mile(letter, number, y, x);
+	new->sq_mile = square_mile_grid(letter, number, y, x);
 	record_square_mile_river_data(new);
 	mile->downstream = new;
 	new->upstream = mile;
@@ -975,7 +968,7 @@ static enum parser_error parse_river_split(struct parser *p)
 	struct river_stretch *current = river->stretch;
 	int number, y, x, index = parser_getint(p, "index");
 	wchar_t letter;
-	struct square_mile *sq_mile;
+	struct loc sq_mile;
 
 	if (!river)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
@@ -1011,7 +1004,7 @@ static enum parser_error parse_river_split(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	sq_mile = square_mile(letter, number, y, x);
+	sq_mile = square_mile_grid(letter, number, y, x);
 	stretch1->miles->sq_mile = sq_mile;
 	stretch2->miles->sq_mile = sq_mile;
 	record_square_mile_river_data(stretch1->miles);
@@ -1058,7 +1051,7 @@ static enum parser_error parse_river_join(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	new->sq_mile = square_mile(letter, number, y, x);
+	new->sq_mile = square_mile_grid(letter, number, y, x);
 	record_square_mile_river_data(new);
 	mile->downstream = new;
 	new->upstream = mile;
@@ -1154,7 +1147,7 @@ static enum parser_error parse_river_underground(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	new->sq_mile = square_mile(letter, number, y, x);
+	new->sq_mile = square_mile_grid(letter, number, y, x);
 	record_square_mile_river_data(new);
 
 	return PARSE_ERROR_NONE;
@@ -1191,7 +1184,7 @@ static enum parser_error parse_river_emerge(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	stretch->miles->sq_mile = square_mile(letter, number, y, x);
+	stretch->miles->sq_mile = square_mile_grid(letter, number, y, x);
 	record_square_mile_river_data(stretch->miles);
 	return PARSE_ERROR_NONE;
 }
@@ -1229,7 +1222,7 @@ static enum parser_error parse_river_lake(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	new->sq_mile = square_mile(letter, number, y, x);
+	new->sq_mile = square_mile_grid(letter, number, y, x);
 	record_square_mile_river_data(new);
 	mile->downstream = new;
 	new->upstream = mile;
@@ -1270,7 +1263,7 @@ static enum parser_error parse_river_sea(struct parser *p)
 	number = parser_getint(p, "number");
 	y = parser_getint(p, "y");
 	x = parser_getint(p, "x");
-	new->sq_mile = square_mile(letter, number, y, x);
+	new->sq_mile = square_mile_grid(letter, number, y, x);
 	record_square_mile_river_data(new);
 	mile->downstream = new;
 	new->upstream = mile;
@@ -2864,13 +2857,27 @@ void init_arrays(void)
 {
 	unsigned int i;
 
+	/* The world map is read from its cache if that is up to date */
+	bool cached = world_cache_load();
+
 	for (i = 0; i < N_ELEMENTS(pl); i++) {
-		char *msg = string_make(format("Initializing %s...", pl[i].name));
+		char *msg;
+
+		if (cached && ((pl[i].parser == &region_parser) ||
+					   (pl[i].parser == &river_parser))) {
+			continue;
+		}
+		msg = string_make(format("Initializing %s...", pl[i].name));
 		event_signal_message(EVENT_INITSTATUS, 0, msg);
 		string_free(msg);
 		if (run_parser(pl[i].parser))
 			quit_fmt("Cannot initialize %s.", pl[i].name);
 	}
+
+	/* Keep the parsed world map for next time */
+	if (!cached) {
+		(void) world_cache_save();
+	}
 }
 
 /**
@@ -2894,6 +2901,7 @@ static struct init_module arrays_module = {
 
 
 extern struct init_module z_quark_module;
+extern struct init_module z_type_module;
 extern struct init_module generate_module;
 extern struct init_module rune_module;
 extern struct init_module obj_make_module;
@@ -2908,6 +2916,7 @@ extern struct init_module tutorial_module;
 
 static struct init_module *modules[] = {
 	&z_quark_module,
+	&z_type_module,
 	&messages_module,
 	&arrays_module,
 	&generate_module,
@@ -2992,8 +3001,11 @@ void cleanup_angband(void)
 		cave = NULL;
 	}
 
-	chunk_list_cleanup();
 	gen_loc_list_cleanup();
+	chunk_list_cleanup();
+	object_pool_cleanup();
+	flow_queue_free();
+	view_free();
 
 	monster_list_finalize();
 	object_list_finalize();
@@ -90,6 +90,8 @@ struct angband_constants
 	uint16_t dungeon_wid;	/**< Maximum number of horizontical grids on a level */
 	uint16_t move_energy;	/**< Energy the player or monster needs to move */
 	uint16_t flow_max;		/**< Maximum distance measured in a flow */
+	uint16_t chunk_cache;	/**< Maximum number of chunks in the chunk list */
+	uint32_t chunk_cache_kb;/**< Memory budget for stored chunks, 0 for none */
 
 	/* Carrying capacity constants, read from constants.txt */
 	uint16_t pack_size;		/**< Maximum number of pack slots */
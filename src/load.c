@@ -377,13 +377,13 @@ int rd_randomizer(void)
 	uint32_t noop;
 
 	/* current value for the simple RNG */
-	rd_u32b(&Rand_value);
+	rd_u32b(&Rand_game.value);
 
 	/* state index */
-	rd_u32b(&state_i);
+	rd_u32b(&Rand_game.state_i);
 
 	/* for safety, make sure state_i < RAND_DEG */
-	state_i = state_i % RAND_DEG;
+	Rand_game.state_i = Rand_game.state_i % RAND_DEG;
     
 	/* NULL padding for compatibility with previous versions */
 	rd_u32b(&noop);
@@ -392,13 +392,13 @@ int rd_randomizer(void)
     
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		rd_u32b(&STATE[i]);
+		rd_u32b(&Rand_game.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
 		rd_u32b(&noop);
 
-	Rand_quick = false;
+	Rand_game.quick = false;
 
 	return 0;
 }
@@ -736,6 +736,7 @@ int rd_player(void)
 			instance->active = true;
 		}
 	}
+	player_update_abilities(player);
 
 	/* Read the action list */
 	for (i = 0; i < MAX_ACTION; i++) {
@@ -983,7 +984,7 @@ int rd_ignore(void)
 }
 
 
-int rd_misc(void)
+static int rd_misc_aux(bool world)
 {
 	size_t i;
 	uint8_t tmp8u;
@@ -995,6 +996,13 @@ int rd_misc(void)
 	rd_u32b(&seed_flavor);
 	flavor_init();
 
+	/* Read the world seed; older savefiles take the flavors one */
+	if (world) {
+		rd_u32b(&seed_world);
+	} else {
+		seed_world = seed_flavor;
+	}
+
 	/* Special stuff */
 	rd_u16b(&player->noscore);
 
@@ -1050,6 +1058,19 @@ int rd_misc(void)
 	return 0;
 }
 
+/**
+ * Read the misc block, before the world seed was added
+ */
+int rd_misc_1(void)
+{
+	return rd_misc_aux(false);
+}
+
+int rd_misc(void)
+{
+	return rd_misc_aux(true);
+}
+
 int rd_artifacts(void)
 {
 	int i;
@@ -1412,6 +1433,7 @@ int rd_dungeon(void)
 
 	if (rd_dungeon_aux(&cave))
 		return 1;
+	chunk_set_live(cave);
 
 	/* Ignore illegal dungeons */
 	if ((px >= cave->width) || (py >= cave->height)) {
@@ -1464,6 +1486,100 @@ int rd_traps(void)
 	return 0;
 }
 
+/**
+ * Read the details of a chunk_list entry
+ */
+static void rd_chunk_ref(struct chunk_ref *ref)
+{
+	int i;
+	uint16_t tmp16u;
+
+	rd_s32b(&ref->turn);
+	rd_u16b(&ref->region);
+	rd_s16b(&ref->z_pos);
+	rd_u16b(&ref->y_pos);
+	rd_u16b(&ref->x_pos);
+	rd_u32b(&ref->gen_loc_idx);
+	for (i = 0; i < 11; i++) {
+		rd_u16b(&tmp16u);
+		ref->adjacent[i] = tmp16u;
+	}
+}
+
+/**
+ * Read the stored chunks of a chunk_list entry
+ */
+static int rd_chunk_data(struct chunk_ref *ref)
+{
+	struct chunk *c, *p_c;
+	int i;
+	uint16_t tmp16u;
+
+	/* Read the dungeon */
+	if (rd_dungeon_aux(&c))
+		return -1;
+	if (rd_dungeon_aux(&p_c))
+		return -1;
+
+	/* Read the objects */
+	if (rd_objects_aux(c))
+		return -1;
+	if (rd_objects_aux(p_c))
+		return -1;
+
+#if OBJ_RECOVER
+	p_c->objects = mem_zalloc((c->obj_max + 1) * sizeof(struct object*));
+	p_c->obj_max = c->obj_max;
+	for (i = 0; i <= c->obj_max; i++) {
+		struct object *obj = c->objects[i], *known_obj;
+		if (!obj) continue;
+		known_obj = object_new();
+		obj->known = known_obj;
+		object_copy(known_obj, obj);
+		p_c->objects[i] = known_obj;
+	}
+#else
+	/* Associate known objects */
+	for (i = 0; i < player->cave->obj_max; i++) {
+		if (c->objects[i] && p_c->objects[i]) {
+			c->objects[i]->known = p_c->objects[i];
+		}
+	}
+#endif
+
+	/* Read traps */
+	if (rd_traps_aux(c))
+		return -1;
+	if (rd_traps_aux(p_c))
+		return -1;
+
+
+	/* Read other chunk info */
+	rd_u16b(&tmp16u);
+	c->height = tmp16u;
+	rd_u16b(&tmp16u);
+	c->width = tmp16u;
+	for (i = 0; i < FEAT_MAX + 1; i++) {
+		rd_u16b(&tmp16u);
+		c->feat_count[i] = tmp16u;
+	}
+	ref->chunk = c;
+	ref->p_chunk = p_c;
+
+	return 0;
+}
+
+/**
+ * Free the stored chunks of a chunk_list entry
+ */
+static void chunk_ref_wipe(struct chunk_ref *ref)
+{
+	if (ref->chunk) chunk_wipe(ref->chunk);
+	ref->chunk = NULL;
+	if (ref->p_chunk) chunk_wipe(ref->p_chunk);
+	ref->p_chunk = NULL;
+}
+
 /**
  * Read the chunk list
  */
@@ -1476,82 +1592,80 @@ int rd_chunks(void)
 
 	rd_u16b(&chunk_max);
 	rd_u16b(&chunk_cnt);
+	chunk_list_reserve(chunk_max);
 	for (j = 0; j < chunk_max; j++) {
 		struct chunk_ref *ref = &chunk_list[j];
-		struct chunk *c, *p_c;
-		int i;
-		uint16_t tmp16u;
 		uint8_t tmp8u;
 
 		ref->place = j;
-		rd_s32b(&ref->turn);
-		rd_u16b(&ref->region);
-		rd_s16b(&ref->z_pos);
-		rd_u16b(&ref->y_pos);
-		rd_u16b(&ref->x_pos);
-		rd_u32b(&ref->gen_loc_idx);
-		for (i = 0; i < 11; i++) {
-			rd_u16b(&tmp16u);
-			ref->adjacent[i] = tmp16u;
-		}
+		rd_chunk_ref(ref);
+		ref->dirty = false;
 
 		rd_byte(&tmp8u);
 		if (!tmp8u) {
 			continue;
 		}
 
-		/* Read the dungeon */
-		if (rd_dungeon_aux(&c))
-			return -1;
-		if (rd_dungeon_aux(&p_c))
+		if (rd_chunk_data(ref))
 			return -1;
+	}
 
-		/* Read the objects */
-		if (rd_objects_aux(c))
-			return -1;
-		if (rd_objects_aux(p_c))
-			return -1;
+	/* Index the chunk list */
+	chunk_list_reindex();
 
-#if OBJ_RECOVER
-		p_c->objects = mem_zalloc((c->obj_max + 1) * sizeof(struct object*));
-		p_c->obj_max = c->obj_max;
-		for (i = 0; i <= c->obj_max; i++) {
-			struct object *obj = c->objects[i], *known_obj;
-			if (!obj) continue;
-			known_obj = object_new();
-			obj->known = known_obj;
-			object_copy(known_obj, obj);
-			p_c->objects[i] = known_obj;
+	return 0;
+}
+
+/**
+ * Read the chunk list from a savefile journal, on top of the one read from
+ * the full savefile it was made after
+ */
+int rd_chunk_changes(void)
+{
+	int j;
+
+	if (player->is_dead)
+		return 0;
+
+	rd_u16b(&chunk_max);
+	rd_u16b(&chunk_cnt);
+	chunk_list_reserve(chunk_max);
+	for (j = 0; j < MAX_CHUNKS; j++) {
+		struct chunk_ref *ref = &chunk_list[j];
+		uint8_t tmp8u = 0;
+
+		/* Entries past the end of the list are unused */
+		if (j >= chunk_max) {
+			chunk_ref_wipe(ref);
+			memset(ref, 0, sizeof(*ref));
+			continue;
 		}
-#else
-		/* Associate known objects */
-		for (i = 0; i < player->cave->obj_max; i++) {
-			if (c->objects[i] && p_c->objects[i]) {
-				c->objects[i]->known = p_c->objects[i];
+
+		ref->place = j;
+		rd_chunk_ref(ref);
+		rd_byte(&tmp8u);
+
+		/* Stored chunks the same as in the full savefile are kept */
+		if (tmp8u == 2) {
+			if (!ref->chunk) {
+				note("Savefile journal has a chunk its savefile lacks!");
+				return -1;
 			}
+			continue;
+		}
+		chunk_ref_wipe(ref);
+		ref->dirty = (tmp8u == 1);
+		if (!tmp8u) {
+			continue;
 		}
-#endif
 
-		/* Read traps */
-		if (rd_traps_aux(c))
-			return -1;
-		if (rd_traps_aux(p_c))
+		if (rd_chunk_data(ref))
 			return -1;
-
-
-		/* Read other chunk info */
-		rd_u16b(&tmp16u);
-		c->height = tmp16u;
-		rd_u16b(&tmp16u);
-		c->width = tmp16u;
-		for (i = 0; i < FEAT_MAX + 1; i++) {
-			rd_u16b(&tmp16u);
-			c->feat_count[i] = tmp16u;
-		}
-		ref->chunk = c;
-		ref->p_chunk = p_c;
 	}
 
+	/* Index the chunk list */
+	chunk_list_reindex();
+
 	return 0;
 }
 
@@ -1589,17 +1703,91 @@ int rd_monsters(void)
 
 	/* Associate ridden monster */
 	if (ridden_monster) {
-		player->mount = monster(ridden_monster);
+		player_set_mount(player, monster(ridden_monster));
 		assert(player->mount->race);
 	}
 
 	return 0;
 }
 
+/**
+ * Read a generated location
+ */
+static void rd_location(struct gen_loc *loc)
+{
+	size_t j;
+	uint8_t tmp8u;
+	uint16_t tmp16u;
+	uint32_t tmp32u;
+	uint16_t num_changes = 0, num_joins = 0;
+
+	rd_u16b(&tmp16u);
+	loc->x_pos = tmp16u;
+	rd_u16b(&tmp16u);
+	loc->y_pos = tmp16u;
+	rd_u16b(&tmp16u);
+	loc->z_pos = tmp16u;
+	rd_u32b(&tmp32u);
+	loc->seed = tmp32u;
+
+	/* If on the surface, mark this location's square mile as mapped */
+	if (!loc->z_pos) {
+		struct loc mile = { loc->x_pos / CPM, loc->y_pos / CPM };
+		square_mile_set_mapped(mile);
+	}
+
+	/* Read the terrain changes */
+	rd_u16b(&num_changes);
+	for (j = 0; j < num_changes; j++) {
+		struct terrain_change *change = terrain_change_new();
+		uint8_t bytes[3];
+		rd_bytes(bytes, 3);
+		change->grid.y = bytes[0];
+		change->grid.x = bytes[1];
+		change->feat = bytes[2];
+		change->next = loc->change;
+		loc->change = change;
+	}
+
+	/* Read the joins */
+	rd_u16b(&num_joins);
+	for (j = 0; j < num_joins; j++) {
+		struct connector *join = connector_new();
+		rd_byte(&tmp8u);
+		join->grid.y = tmp8u;
+		rd_byte(&tmp8u);
+		join->grid.x = tmp8u;
+		rd_byte(&tmp8u);
+		join->feat = tmp8u;
+		rd_bytes(join->info, square_size);
+		join->next = loc->join;
+		loc->join = join;
+	}
+
+	/* Read the river piece */
+	rd_u16b(&tmp16u);
+	if (tmp16u) {
+		loc->river_piece = mem_zalloc(sizeof(struct river_piece));
+		loc->river_piece->num_grids = tmp16u;
+		for (j = 0; j < tmp16u; j++) {
+			struct river_grid *rgrid = river_grid_new();
+			uint8_t bytes[2];
+			rd_bytes(bytes, 2);
+			rgrid->grid.y = bytes[0];
+			rgrid->grid.x = bytes[1];
+			rgrid->next = loc->river_piece->grids;
+			loc->river_piece->grids = rgrid;
+		}
+		rd_byte(&tmp8u);
+		loc->river_piece->dir = tmp8u;
+	}
+}
+
+
 int rd_locations(void)
 {
 
-	size_t i, j, k;
+	size_t i;
 	//u16b square_size;
 
 	/* Only if the player's alive */
@@ -1608,89 +1796,57 @@ int rd_locations(void)
 
 	rd_byte(&square_size);
 	rd_u32b(&gen_loc_cnt);
+	gen_loc_list_reserve(gen_loc_cnt);
 
 	for (i = 0; i < gen_loc_cnt; i++) {
-		uint8_t tmp8u;
-		uint16_t tmp16u;
-		uint32_t tmp32u;
-		struct gen_loc *loc = NULL;
-		uint16_t num_changes = 0, num_joins = 0;
-
-		/* Increase the array size if necessary */
-		if (((i % GEN_LOC_INCR) == 0) && (i > 0)) {
-			gen_loc_max += GEN_LOC_INCR;
-			gen_loc_list =
-				mem_realloc(gen_loc_list, gen_loc_max * sizeof(struct gen_loc));
-			for (j = gen_loc_max - GEN_LOC_INCR; j < gen_loc_max; j++) {
-				memset(&gen_loc_list[j], 0, sizeof(struct gen_loc));
-			}
-		}
-		loc = &gen_loc_list[i];
+		rd_location(&gen_loc_list[i]);
+		gen_loc_list[i].dirty = false;
+	}
 
-		rd_u16b(&tmp16u);
-		loc->x_pos = tmp16u;
-		rd_u16b(&tmp16u);
-		loc->y_pos = tmp16u;
-		rd_u16b(&tmp16u);
-		loc->z_pos = tmp16u;
-		rd_u32b(&tmp32u);
-		loc->seed = tmp32u;
+	/* Index the locations by position */
+	gen_loc_list_reindex();
+	return 0;
+}
 
-		/* If on the surface, mark this location's square mile as mapped */
-		if (!loc->z_pos) {
-			square_miles[loc->y_pos / CPM][loc->x_pos / CPM].mapped = true;
-		}
+/**
+ * Read the generated locations list from a savefile journal, on top of the
+ * one read from the full savefile it was made after
+ */
+int rd_location_changes(void)
+{
+	uint32_t i, count, num_dirty;
 
-		/* Read the terrain changes */
-		rd_u16b(&num_changes);
-		for (j = 0; j < num_changes; j++) {
-			struct terrain_change *change = mem_zalloc(sizeof(*change));
-			rd_byte(&tmp8u);
-			change->grid.y = tmp8u;
-			rd_byte(&tmp8u);
-			change->grid.x = tmp8u;
-			rd_byte(&tmp8u);
-			change->feat = tmp8u;
-			change->next = loc->change;
-			loc->change = change;
-		}
+	/* Only if the player's alive */
+	if (player->is_dead)
+		return 0;
 
-		/* Read the joins */
-		rd_u16b(&num_joins);
-		for (j = 0; j < num_joins; j++) {
-			struct connector *join = mem_zalloc(sizeof(*join));
-			rd_byte(&tmp8u);
-			join->grid.y = tmp8u;
-			rd_byte(&tmp8u);
-			join->grid.x = tmp8u;
-			rd_byte(&tmp8u);
-			join->feat = tmp8u;
-			for (k = 0; k < square_size; k++) {
-				rd_byte(&tmp8u);
-				join->info[k] = tmp8u;
-			}
-			join->next = loc->join;
-			loc->join = join;
-		}
+	rd_byte(&square_size);
+	rd_u32b(&count);
+	if (count < gen_loc_cnt) {
+		note("Savefile journal has fewer locations than its savefile!");
+		return -1;
+	}
+	gen_loc_list_reserve(count);
+	gen_loc_cnt = count;
 
-		/* Read the river piece */
-		rd_u16b(&tmp16u);
-		if (tmp16u) {
-			loc->river_piece = mem_zalloc(sizeof(struct river_piece));
-			loc->river_piece->num_grids = tmp16u;
-			for (j = 0; j < tmp16u; j++) {
-				struct river_grid *rgrid = mem_zalloc(sizeof(*rgrid));
-				rd_byte(&tmp8u);
-				rgrid->grid.y = tmp8u;
-				rd_byte(&tmp8u);
-				rgrid->grid.x = tmp8u;
-				rgrid->next = loc->river_piece->grids;
-				loc->river_piece->grids = rgrid;
-			}
-			rd_byte(&tmp8u);
-			loc->river_piece->dir = tmp8u;
+	rd_u32b(&num_dirty);
+	for (i = 0; i < num_dirty; i++) {
+		uint32_t idx;
+		struct gen_loc *loc;
+
+		rd_u32b(&idx);
+		if (idx >= gen_loc_cnt) {
+			note(format("Savefile journal location %u out of range!", idx));
+			return -1;
 		}
+		loc = &gen_loc_list[idx];
+		gen_loc_wipe(loc);
+		rd_location(loc);
+		loc->dirty = true;
 	}
+
+	/* Index the locations by position */
+	gen_loc_list_reindex();
 	return 0;
 }
 
@@ -1764,9 +1920,9 @@ int rd_monster_groups(void)
 	while (tmp16u) {
 		group = monster_groups[tmp16u];
 		rd_byte(&tmp8u);
-		group->flow.centre.x = tmp8u;
+		group->centre.x = tmp8u;
 		rd_byte(&tmp8u);
-		group->flow.centre.y = tmp8u;
+		group->centre.y = tmp8u;
 		rd_s16b(&tmp16s);
 		group->wandering_pause = tmp16s;
 		rd_u16b(&tmp16u);
@@ -218,7 +218,7 @@ static void initialize_character(void)
 	}
 
 	seed = (time(NULL));
-	Rand_quick = false;
+	Rand_game.quick = false;
 	Rand_state_init(seed);
 
 	player_init(player);
@@ -226,6 +226,7 @@ static void initialize_character(void)
 
 	seed_flavor = randint0(0x10000000);
 	seed_randart = randint0(0x10000000);
+	seed_world = randint0(0x10000000);
 
 	flavor_init();
 	player->upkeep->playing = true;
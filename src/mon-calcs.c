@@ -71,15 +71,9 @@ static int morale_from_friends(struct monster *mon)
 	int morale_penalty = 0;
 
 	/* Scan monsters */
-	for (i = 1; i < mon_max; i++) {
+	for (i = live_monster_after(0); i; i = live_monster_after(i)) {
 		struct monster *mon1 = monster(i);
 
-		/* Skip dead monsters */
-		if (!mon1->race) continue;
-
-		/* Skip stored monsters */
-		if (monster_is_stored(mon1)) continue;
-
 		/* Skip self! */
 		if (mon == mon1) continue;
 
@@ -228,12 +222,12 @@ void calc_morale(struct monster *mon)
 	/* Reduce morale for the Majesty ability */
     difference = MAX(player->state.skill_use[SKILL_WILL]
 					 - monster_skill(mon, SKILL_WILL), 0);
-	if (player_active_ability(player, "Majesty")) {
+	if (player_active_ability(player, PA_MAJESTY)) {
 		morale -= difference / 2 * 10;
 	}
 
 	/* Reduce morale for the Bane ability */
-	if (player_active_ability(player, "Bane")) {
+	if (player_active_ability(player, PA_BANE)) {
 		morale -= player_bane_bonus(player, mon) * 10;
 	}
 
@@ -597,7 +591,7 @@ static void listen(struct chunk *c, struct player *p, struct monster *mon)
 	mon->noise = 0;
 
 	/* Must have the listen skill */
-	if (!player_active_ability(p, "Listen")) return;
+	if (!player_active_ability(p, PA_LISTEN)) return;
 
 	/* Must not be visible */
 	if (monster_is_visible(mon)) return;
@@ -801,7 +795,7 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 					do_invisible = true;
 
 					/* Keen senses */
-					if (player_active_ability(player, "Keen Senses")) {
+					if (player_active_ability(player, PA_KEEN_SENSES)) {
 						/* Makes things a bit easier */
 						difficulty -= 5;
 					}
@@ -946,13 +940,9 @@ void update_monsters(bool full)
 {
 	int i;
 
-	/* Update each (live) monster */
-	for (i = 1; i < mon_max; i++) {
-		struct monster *mon = monster(i);
-
-		/* Update the monster if alive */
-		if (mon->race && !monster_is_stored(mon))
-			update_mon(mon, cave, full);
+	/* Update each monster in the arena */
+	for (i = live_monster_after(0); i; i = live_monster_after(i)) {
+		update_mon(monster(i), cave, full);
 	}
 }
 
@@ -1073,8 +1063,10 @@ void calc_monster_speed(struct monster *mon)
 
 	if (speed < 1) speed = 1;
 
-	/* Set the speed and return */
+	/* Set the speed, giving any energy owed at the old speed first */
+	monster_energy_sync(mon);
 	mon->mspeed = speed;
+	monster_reschedule(mon);
 
 	return;
 }
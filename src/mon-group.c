@@ -27,14 +27,75 @@
 #include "monster.h"
 #include "tutorial.h"
 
+/**
+ * A flow to a wandering destination, shared by all the groups heading there
+ * whose leaders move alike
+ */
+struct group_flow {
+	struct flow flow;		/* Flow centred on the destination */
+	struct flow_sig sig;	/* Signature of the monsters it is for */
+	int refs;				/* Number of groups using it */
+	bool stale;				/* Calculate it again before it is next used */
+	struct group_flow *next;
+};
+
+static struct group_flow *group_flows;
+
+/**
+ * Get the shared flow to a destination for monsters with a signature,
+ * making a new one to be calculated when first used if there is none
+ */
+static struct group_flow *group_flow_get(const struct flow_sig *sig,
+										 struct loc centre)
+{
+	struct group_flow *shared;
+
+	for (shared = group_flows; shared; shared = shared->next) {
+		if (loc_eq(shared->flow.centre, centre) &&
+			flow_sig_eq(&shared->sig, sig)) {
+			break;
+		}
+	}
+	if (!shared) {
+		shared = mem_zalloc(sizeof(*shared));
+		flow_new(cave, &shared->flow);
+		shared->flow.centre = centre;
+		shared->sig = *sig;
+		shared->stale = true;
+		shared->next = group_flows;
+		group_flows = shared;
+	} else if (shared->flow.terrain != cave->terrain_stamp) {
+		shared->stale = true;
+	}
+	shared->refs++;
+	return shared;
+}
+
+/**
+ * Stop a group using its shared flow, freeing the flow if no other group
+ * uses it
+ */
+static void group_flow_release(struct monster_group *group)
+{
+	struct group_flow *shared = group->flow, **link = &group_flows;
+
+	if (!shared) return;
+	group->flow = NULL;
+	if (--shared->refs) return;
+	while (*link != shared) {
+		link = &(*link)->next;
+	}
+	*link = shared->next;
+	flow_free(cave, &shared->flow);
+	mem_free(shared);
+}
+
 /**
  * Allocate a new monster group
  */
 static struct monster_group *monster_group_new(void)
 {
-	struct monster_group *group = mem_zalloc(sizeof(struct monster_group));
-	flow_new(cave, &group->flow);
-	return group;
+	return mem_zalloc(sizeof(struct monster_group));
 }
 
 /**
@@ -49,7 +110,7 @@ void monster_group_free(struct monster_group *group)
 		group->member_list = next;
 	}
 
-	flow_free(cave, &group->flow);
+	group_flow_release(group);
 	mem_free(group);
 }
 
@@ -296,11 +357,105 @@ struct monster *monster_group_leader(struct monster *mon)
 }
 
 /**
- * Set the centre of a new flow for a monster group, and update the flow
+ * Get the grids wandering monsters may choose as destinations, which are
+ * room floors outside vaults; the list is kept until the terrain changes
+ */
+struct loc *wandering_destinations(struct chunk *c, int *num)
+{
+	struct loc grid;
+	int n = 0;
+
+	/* The terrain stamp also changes with the room marks, so the list is
+	 * built once for each stage of generation, not once for each group */
+	if (c->wander_grids && (c->wander_terrain == c->terrain_stamp)) {
+		*num = c->wander_num;
+		return c->wander_grids;
+	}
+
+	/* Count the grids, then list them */
+	for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
+		for (grid.x = 1; grid.x < c->width - 1; grid.x++) {
+			if (square_isfloor(c, grid) && square_isroom(c, grid) &&
+				!square_isvault(c, grid)) {
+				n++;
+			}
+		}
+	}
+	mem_free(c->wander_grids);
+	c->wander_grids = mem_alloc(MAX(n, 1) * sizeof(struct loc));
+	c->wander_num = 0;
+	c->wander_terrain = c->terrain_stamp;
+	for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
+		for (grid.x = 1; grid.x < c->width - 1; grid.x++) {
+			if (square_isfloor(c, grid) && square_isroom(c, grid) &&
+				!square_isvault(c, grid)) {
+				c->wander_grids[c->wander_num++] = grid;
+			}
+		}
+	}
+	*num = c->wander_num;
+	return c->wander_grids;
+}
+
+/**
+ * Get the flow to a group's wandering destination, or NULL if it has none.
+ *
+ * Groups heading to the same place whose leaders move alike share a flow,
+ * and it is only calculated when a member actually needs it.
+ */
+struct flow *monster_group_flow(struct monster_group *group,
+								struct monster *mon)
+{
+	struct monster *leader = monster(group->leader);
+	struct flow_sig sig;
+
+	if (loc_is_zero(group->centre)) return NULL;
+	if (!leader || !leader->race) leader = mon;
+
+	/* The leader may have changed, or woken up, since the flow was got */
+	flow_sig_get(leader, &sig);
+	if (group->flow && !flow_sig_eq(&sig, &group->flow->sig)) {
+		group_flow_release(group);
+	}
+	if (!group->flow) {
+		group->flow = group_flow_get(&sig, group->centre);
+	}
+	if (group->flow->stale) {
+		update_flow(cave, &group->flow->flow, leader);
+		group->flow->stale = false;
+	}
+	return &group->flow->flow;
+}
+
+/**
+ * Have a group's flow calculated again when it is next used, to take account
+ * of changes in the dungeon
+ */
+void monster_group_refresh_flow(struct monster_group *group)
+{
+	if (group->flow) group->flow->stale = true;
+}
+
+/**
+ * Set a monster group's wandering destination
+ */
+static void monster_group_set_centre(struct monster_group *group,
+									 struct loc grid)
+{
+	if (!loc_eq(grid, group->centre)) {
+		group_flow_release(group);
+		group->centre = grid;
+	} else if (group->flow &&
+			   (group->flow->flow.terrain != cave->terrain_stamp)) {
+		group->flow->stale = true;
+	}
+}
+
+/**
+ * Choose a new wandering destination for a monster group
  */
 void monster_group_new_wandering_flow(struct monster *mon, struct loc tgrid)
 {	
-	int i;
 	struct monster_group *group = monster_group_by_index(mon->group_info.index);
 	struct monster *leader = monster(group->leader);
 	struct monster_race *race = !!leader ? leader->race : NULL;
@@ -315,13 +470,11 @@ void monster_group_new_wandering_flow(struct monster *mon, struct loc tgrid)
 		/* They only pick a new location on creation.  Detect this using the
 		 * fact that speed hasn't been determined yet on creation */
 		if (mon->mspeed == 0) {
-			group->flow.centre = leader->grid;
-			update_flow(cave, &group->flow, leader);
+			monster_group_set_centre(group, leader->grid);
 		}
 	} else if (square_in_bounds_fully(cave, tgrid)) {
 		/* If a location was requested, use that */
-		group->flow.centre = tgrid;
-		update_flow(cave, &group->flow, leader);
+		monster_group_set_centre(group, tgrid);
 	} else {
 		/* Otherwise choose a location */
 		if (rf_has(race->flags, RF_SMART) &&
@@ -331,22 +484,15 @@ void monster_group_new_wandering_flow(struct monster *mon, struct loc tgrid)
 			!square_isplayer(cave, grid) && !square_isvault(cave, grid)) {
 			/* Sometimes intelligent monsters want to pick a staircase and leave
 			 * the level */
-			group->flow.centre = grid;
-			update_flow(cave, &group->flow, leader);
+			monster_group_set_centre(group, grid);
 		} else {
 			/* Otherwise pick a random location (on a floor, in a room, and not
 			 * in a vault) */
-			for (i = 0; i < 100; i++) {
-				grid.y = randint0(cave->height);
-				grid.x = randint0(cave->width);
-				if (square_in_bounds_fully(cave, grid) &&
-					square_isfloor(cave, grid) && 
-					square_isroom(cave, grid) &&
-					!square_isvault(cave, grid)) {
-					group->flow.centre = grid;
-					update_flow(cave, &group->flow, leader);
-					break;
-				}
+			int num;
+			struct loc *grids = wandering_destinations(cave, &num);
+
+			if (num) {
+				monster_group_set_centre(group, grids[randint0(num)]);
 			}
 		}
 	}
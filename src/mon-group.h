@@ -25,10 +25,13 @@ struct mon_group_list_entry {
 	struct mon_group_list_entry *next;
 };
 
+struct group_flow;
+
 struct monster_group {
 	int index;				/* Index of this group */
 	int leader;				/* Group leader index */
-	struct flow flow;		/* Group flow */
+	struct loc centre;		/* Wandering destination, (0, 0) if none */
+	struct group_flow *flow;	/* Shared flow to the destination, if found */
 	int wandering_pause;	/* Length of pause from wandering */
 	int size;				/* Number of members */
 	int dist;				/* Distance from destination */
@@ -49,6 +52,10 @@ bool monster_group_change_index(int new, int old);
 int monster_group_size(const struct monster *mon);
 int monster_group_leader_idx(struct monster_group *group);
 struct monster *monster_group_leader(struct monster *mon);
+struct loc *wandering_destinations(struct chunk *c, int *num);
+struct flow *monster_group_flow(struct monster_group *group,
+								struct monster *mon);
+void monster_group_refresh_flow(struct monster_group *group);
 void monster_group_new_wandering_flow(struct monster *mon, struct loc tgrid);
 void monster_groups_verify(void);
 
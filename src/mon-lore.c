@@ -1108,7 +1108,7 @@ void lore_append_skills(textblock *tb, const struct monster_race *race,
 		const char *aware = lore_describe_awareness(race->sleep);
 		textblock_append(tb, "%s has %d Will,",
 						 lore_pronoun_nominative(msex, true), race->wil);
-		if (player_active_ability(player, "Listen")) {
+		if (player_active_ability(player, PA_LISTEN)) {
 			textblock_append(tb, " %d Stealth,", race->stl);
 		}
 		textblock_append(tb, " %d Perception", race->per);
@@ -51,6 +51,22 @@ uint16_t mon_cnt = 0;
 int mon_current = -1;
 int num_repro = 0;
 
+/**
+ * Monster place lists.  Monsters in the current playing arena are kept in a
+ * dense array sorted by index, so the per-turn monster loops only visit them.
+ * Monsters placed temporarily or stored in the chunk list are kept on a
+ * linked list for their place, and the unused slots below mon_max are kept
+ * on a stack for mon_pop().
+ */
+static uint16_t *mon_live;
+static uint16_t mon_live_num;
+static uint16_t *mon_place_next;
+static uint16_t *mon_place_prev;
+static uint16_t *mon_place_head;
+static int mon_place_heads;
+static uint16_t *mon_free;
+static uint16_t mon_free_num;
+
 /**
  * ------------------------------------------------------------------------
  * Monster race allocation
@@ -370,6 +386,172 @@ void monsters_init(void)
 	monsters = mem_zalloc(z_info->monster_max *sizeof(struct monster));
 	monster_groups = mem_zalloc(z_info->monster_max *
 								sizeof(struct monster_group*));
+	mon_live = mem_zalloc(z_info->monster_max * sizeof(uint16_t));
+	mon_place_next = mem_zalloc(z_info->monster_max * sizeof(uint16_t));
+	mon_place_prev = mem_zalloc(z_info->monster_max * sizeof(uint16_t));
+	mon_free = mem_zalloc(z_info->monster_max * sizeof(uint16_t));
+	mon_live_num = 0;
+	mon_free_num = 0;
+	monster_turns_init();
+}
+
+/**
+ * Get the head of the list of monsters at a place other than the current
+ * playing arena, making room for it if necessary
+ */
+static uint16_t *place_head(int place)
+{
+	int n = (place == CHUNK_TEMP) ? 0 : place + 1;
+
+	assert(place != CHUNK_CUR);
+	if (n >= mon_place_heads) {
+		int size = MAX(n + 1, 2 * mon_place_heads);
+		mon_place_head = mem_realloc(mon_place_head, size * sizeof(uint16_t));
+		memset(mon_place_head + mon_place_heads, 0,
+			   (size - mon_place_heads) * sizeof(uint16_t));
+		mon_place_heads = size;
+	}
+	return &mon_place_head[n];
+}
+
+/**
+ * Find the position in the live array of the first monster with index at
+ * least m_idx
+ */
+static int live_position(int m_idx)
+{
+	int lo = 0, hi = mon_live_num;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (mon_live[mid] < m_idx) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/**
+ * Add a monster index to the list for a place; monsters in the arena are
+ * also scheduled, starting afresh if they are arriving rather than moving
+ * index
+ */
+static void monster_place_link(int m_idx, int place, bool arriving)
+{
+	if (place == CHUNK_CUR) {
+		int pos = live_position(m_idx);
+		memmove(mon_live + pos + 1, mon_live + pos,
+				(mon_live_num - pos) * sizeof(uint16_t));
+		mon_live[pos] = m_idx;
+		mon_live_num++;
+		schedule_monster(m_idx, arriving);
+	} else {
+		uint16_t *head = place_head(place);
+		mon_place_prev[m_idx] = 0;
+		mon_place_next[m_idx] = *head;
+		if (*head) mon_place_prev[*head] = m_idx;
+		*head = m_idx;
+	}
+}
+
+/**
+ * Remove a monster index from the list for a place; monsters leaving the
+ * arena are also taken out of the schedule
+ */
+static void monster_place_unlink(int m_idx, int place)
+{
+	if (place == CHUNK_CUR) {
+		int pos = live_position(m_idx);
+		assert((pos < mon_live_num) && (mon_live[pos] == m_idx));
+		unschedule_monster(m_idx);
+		mon_live_num--;
+		memmove(mon_live + pos, mon_live + pos + 1,
+				(mon_live_num - pos) * sizeof(uint16_t));
+	} else {
+		uint16_t prev = mon_place_prev[m_idx], next = mon_place_next[m_idx];
+		if (prev) {
+			mon_place_next[prev] = next;
+		} else {
+			*place_head(place) = next;
+		}
+		if (next) mon_place_prev[next] = prev;
+		mon_place_next[m_idx] = 0;
+		mon_place_prev[m_idx] = 0;
+	}
+}
+
+/**
+ * Move a monster to a new place (the current playing arena, a temporary
+ * placement or a chunk_list entry), keeping the place lists up to date.
+ * This is the only way an existing monster's place should be changed.
+ */
+void monster_set_place(struct monster *mon, int place)
+{
+	if (mon->place == place) return;
+	monster_place_unlink(mon->midx, mon->place);
+	mon->place = place;
+	monster_place_link(mon->midx, place, true);
+}
+
+/**
+ * Get the lowest index of a monster in the current playing arena which is
+ * greater than m_idx, or 0 if there is none; safe to use while monsters are
+ * being added or deleted
+ */
+int live_monster_after(int m_idx)
+{
+	int pos = live_position(m_idx + 1);
+	return (pos < mon_live_num) ? mon_live[pos] : 0;
+}
+
+/**
+ * Get the highest index of a monster in the current playing arena which is
+ * less than m_idx, or 0 if there is none; safe to use while monsters are
+ * being added or deleted
+ */
+int live_monster_before(int m_idx)
+{
+	int pos = live_position(m_idx);
+	return pos ? mon_live[pos - 1] : 0;
+}
+
+static int cmp_mon_idx(const void *a, const void *b)
+{
+	return (int) *(const uint16_t *) a - (int) *(const uint16_t *) b;
+}
+
+/**
+ * Get the indices of all the monsters at a place in increasing order.
+ * \param place is the place, as stored in the monster's place field
+ * \param num is set to the number of monsters
+ * \return an array of monster indices, which the caller should free, or NULL
+ * if there are none
+ */
+uint16_t *monsters_at_place(int place, int *num)
+{
+	uint16_t *list;
+	int n = 0, m_idx;
+
+	if (place == CHUNK_CUR) {
+		*num = mon_live_num;
+		list = mem_alloc(mon_live_num * sizeof(uint16_t));
+		if (list) memcpy(list, mon_live, mon_live_num * sizeof(uint16_t));
+		return list;
+	}
+
+	for (m_idx = *place_head(place); m_idx; m_idx = mon_place_next[m_idx]) {
+		n++;
+	}
+	*num = n;
+	list = mem_alloc(n * sizeof(uint16_t));
+	n = 0;
+	for (m_idx = *place_head(place); m_idx; m_idx = mon_place_next[m_idx]) {
+		list[n++] = m_idx;
+	}
+	if (n) qsort(list, n, sizeof(uint16_t), cmp_mon_idx);
+	return list;
 }
 
 /**
@@ -415,6 +597,7 @@ void delete_monster_idx(int m_idx)
 
 	/* Monster is gone from square and group */
 	square_set_mon(c, grid, 0);
+	if (mon->place >= 0) chunk_list[mon->place].dirty = true;
 	monster_remove_from_group(mon);
 
 	/* Delete objects */
@@ -437,6 +620,10 @@ void delete_monster_idx(int m_idx)
 	/* Free flow */
 	flow_free(c, &mon->flow);
 
+	/* Take the monster off its place list and free up the slot */
+	monster_place_unlink(m_idx, mon->place);
+	mon_free[mon_free_num++] = m_idx;
+
 	/* Wipe the Monster */
 	memset(mon, 0, sizeof(struct monster));
 
@@ -483,6 +670,7 @@ void monster_index_move(int i1, int i2)
 	/* Set and update the chunk */
 	c = mon->place < 0 ? cave : chunk_list[mon->place].chunk;
 	square_set_mon(c, mon->grid, i2);
+	if (mon->place >= 0) chunk_list[mon->place].dirty = true;
 
 	/* Update midx */
 	mon->midx = i2;
@@ -506,7 +694,9 @@ void monster_index_move(int i1, int i2)
 		player->upkeep->health_who = monster(i2);
 
 	/* Move monster */
+	monster_place_unlink(i1, mon->place);
 	memcpy(monster(i2),	monster(i1), sizeof(struct monster));
+	monster_place_link(i2, monster(i2)->place, false);
 
 	/* Wipe hole */
 	memset(monster(i1), 0, sizeof(struct monster));
@@ -593,6 +783,9 @@ void compact_monsters(int num_to_compact)
 		/* Compress "mon_max" */
 		mon_max--;
 	}
+
+	/* There are no holes left */
+	mon_free_num = 0;
 }
 
 /**
@@ -604,15 +797,13 @@ void compact_monsters(int num_to_compact)
  */
 void delete_temp_monsters(void)
 {
-	int i;
+	int i, num;
+	uint16_t *temp = monsters_at_place(CHUNK_TEMP, &num);
 
-	for (i = 1; i < mon_max; i++) {
-		struct monster *mon = monster(i);
-		if (!mon) continue;
-		if (mon->place == CHUNK_TEMP) {
-			delete_monster_idx(i);
-		}
+	for (i = 0; i < num; i++) {
+		delete_monster_idx(temp[i]);
 	}
+	mem_free(temp);
 }
 
 /**
@@ -643,6 +834,22 @@ void wipe_mon_list(void)
 	/* Reset "mon_cnt" */
 	mon_cnt = 0;
 
+	/* Reset the place lists and the turn schedule */
+	monster_turns_free();
+	mem_free(mon_live);
+	mem_free(mon_place_next);
+	mem_free(mon_place_prev);
+	mem_free(mon_place_head);
+	mem_free(mon_free);
+	mon_live = NULL;
+	mon_place_next = NULL;
+	mon_place_prev = NULL;
+	mon_place_head = NULL;
+	mon_free = NULL;
+	mon_live_num = 0;
+	mon_place_heads = 0;
+	mon_free_num = 0;
+
 	/* No more target */
 	target_set_monster(0);
 
@@ -685,17 +892,12 @@ static int16_t mon_pop(void)
 	}
 
 	/* Recycle dead monsters if we've run out of room */
-	for (m_idx = 1; m_idx < mon_max; m_idx++) {
-		struct monster *mon = monster(m_idx);
-
-		/* Skip live monsters */
-		if (!mon->race) {
-			/* Count monsters */
-			mon_cnt++;
+	if (mon_free_num) {
+		/* Count monsters */
+		mon_cnt++;
 
-			/* Use this monster */
-			return m_idx;
-		}
+		/* Use the most recently freed slot */
+		return mon_free[--mon_free_num];
 	}
 
 	/* Warn the player if no index is available */
@@ -753,15 +955,13 @@ static void new_wandering_destination(struct chunk *c, struct monster *mon)
  */
 void set_monster_place_current(void)
 {
-	int i;
+	int i, num;
+	uint16_t *temp = monsters_at_place(CHUNK_TEMP, &num);
 
-	for (i = 1; i < mon_max; i++) {
-		struct monster *mon = monster(i);
-		if (!mon) continue;
-		if (mon->place == CHUNK_TEMP) {
-			mon->place = CHUNK_CUR;
-		}
+	for (i = 0; i < num; i++) {
+		monster_set_place(monster(temp[i]), CHUNK_CUR);
 	}
+	mem_free(temp);
 }
 
 /**
@@ -855,8 +1055,9 @@ int16_t place_monster(struct chunk *c, struct loc grid, struct monster *mon,
 	new_mon = monster(m_idx);
 	memcpy(new_mon, mon, sizeof(struct monster));
 
-	/* Set the ID */
+	/* Set the ID, and put the monster on its place list */
 	new_mon->midx = m_idx;
+	monster_place_link(m_idx, new_mon->place, true);
 
 	/* Set the location and origin */
 	square_set_mon(c, grid, new_mon->midx);
@@ -34,6 +34,10 @@ struct monster *monster(int idx);
 void delete_monster_idx(int m_idx);
 void delete_monster(struct loc grid);
 void monster_index_move(int i1, int i2);
+void monster_set_place(struct monster *mon, int place);
+int live_monster_after(int m_idx);
+int live_monster_before(int m_idx);
+uint16_t *monsters_at_place(int place, int *num);
 void compact_monsters(int num_to_compact);
 void delete_temp_monsters(void);
 void wipe_mon_list(void);
@@ -180,23 +180,17 @@ static int success_chance(int sides, int skill, int difficulty)
 }
 
 /**
- * Can the monster enter this grid?  How easy is it for them to do so?
- *
- * Returns the percentage chance of success.
- *
- * The code that uses this function sometimes assumes that it will never
- * return a value greater than 100.
+ * Can the monster enter this grid if nothing else is in it?  How easy is it
+ * for them to do so?
  *
- * The usage of level to determine whether one monster can push past
- * another is a tad iffy, but ensures that orc soldiers can always
- * push past other orc soldiers.
+ * Returns the percentage chance of success.  This depends only on the
+ * terrain and on the monster's movement abilities, alertness and skills, so
+ * monsters which share all of those get the same answer.
  */
-int monster_entry_chance(struct chunk *c, struct monster *mon, struct loc grid,
-						 bool *bash)
+int monster_terrain_chance(struct chunk *c, struct monster *mon,
+						   struct loc grid, bool *bash)
 {
-	struct monster *mon1 = square_monster(c, grid);
-
-	/* Assume nothing in the grid other than the terrain hinders movement */
+	/* Assume nothing other than the terrain hinders movement */
 	int move_chance = 100;
 
 	/* Check Bounds */
@@ -205,42 +199,6 @@ int monster_entry_chance(struct chunk *c, struct monster *mon, struct loc grid,
 	/* Permanent walls are never passable */
 	if (square_isperm(c, grid)) return 0;
 
-	/* The grid is occupied by the player or a monster. */
-	if (square_isplayer(c, grid)) {
-		return 100;
-	} else if (mon1) {
-		/* All monsters can attempt to push past monsters that can move */
-		if (!rf_has(mon1->race->flags, RF_NEVER_MOVE) &&
-			!rf_has(mon1->race->flags, RF_HIDDEN_MOVE)) {
-			/* It is easy to push past unwary or sleeping monsters */
-			if ((mon1->alertness < ALERTNESS_ALERT) &&
-				(monster_group_leader(mon) != monster_group_leader(mon1))) {
-				move_chance = 80;
-			} else if ((mon1->stance == STANCE_FLEEING) &&
-					   (mon->stance != STANCE_FLEEING)) {
-				/* Easy for non-fleeing monsters to push past fleeing ones */
-				move_chance = 80;
-			} else if ((mon1->stance != STANCE_FLEEING) &&
-					   (mon->stance == STANCE_FLEEING)) {
-				/* Easy for fleeing monsters to push past non-fleeing ones */
-				move_chance = 80;
-			} else if (mon->race->level > mon1->race->level) {
-				/* It is easy to push past weaker monsters */
-				move_chance = 80;
-			} else if (mon->race->level == mon1->race->level) {
-				/* It is quite hard to push past monsters of equal strength */
-				move_chance = 20;
-			} else {
-				/* It is very difficult to move past alert, unafraid,
-				 * stronger monsters */
-				move_chance = 10;
-			}
-		} else {
-			/* Cannot do anything to clear away the other monster */
-			return 0;
-		}
-	}
-
 	/* Glyphs */
 	if (square_iswarded(c, grid)) {
 		/* A simulated Will check */
@@ -362,6 +320,72 @@ int monster_entry_chance(struct chunk *c, struct monster *mon, struct loc grid,
 
 }
 
+/**
+ * Can the monster enter this grid?  How easy is it for them to do so?
+ *
+ * Returns the percentage chance of success.
+ *
+ * The code that uses this function sometimes assumes that it will never
+ * return a value greater than 100.
+ *
+ * The usage of level to determine whether one monster can push past
+ * another is a tad iffy, but ensures that orc soldiers can always
+ * push past other orc soldiers.
+ */
+int monster_entry_chance(struct chunk *c, struct monster *mon, struct loc grid,
+						 bool *bash)
+{
+	struct monster *mon1 = square_monster(c, grid);
+
+	/* Assume nothing in the grid other than the terrain hinders movement */
+	int move_chance = 100;
+
+	/* Check Bounds */
+	if (!square_in_bounds(c, grid)) return 0;
+
+	/* Permanent walls are never passable */
+	if (square_isperm(c, grid)) return 0;
+
+	/* The grid is occupied by the player or a monster. */
+	if (square_isplayer(c, grid)) {
+		return 100;
+	} else if (mon1) {
+		/* All monsters can attempt to push past monsters that can move */
+		if (!rf_has(mon1->race->flags, RF_NEVER_MOVE) &&
+			!rf_has(mon1->race->flags, RF_HIDDEN_MOVE)) {
+			/* It is easy to push past unwary or sleeping monsters */
+			if ((mon1->alertness < ALERTNESS_ALERT) &&
+				(monster_group_leader(mon) != monster_group_leader(mon1))) {
+				move_chance = 80;
+			} else if ((mon1->stance == STANCE_FLEEING) &&
+					   (mon->stance != STANCE_FLEEING)) {
+				/* Easy for non-fleeing monsters to push past fleeing ones */
+				move_chance = 80;
+			} else if ((mon1->stance != STANCE_FLEEING) &&
+					   (mon->stance == STANCE_FLEEING)) {
+				/* Easy for fleeing monsters to push past non-fleeing ones */
+				move_chance = 80;
+			} else if (mon->race->level > mon1->race->level) {
+				/* It is easy to push past weaker monsters */
+				move_chance = 80;
+			} else if (mon->race->level == mon1->race->level) {
+				/* It is quite hard to push past monsters of equal strength */
+				move_chance = 20;
+			} else {
+				/* It is very difficult to move past alert, unafraid,
+				 * stronger monsters */
+				move_chance = 10;
+			}
+		} else {
+			/* Cannot do anything to clear away the other monster */
+			return 0;
+		}
+	}
+
+	/* The terrain may make it harder still */
+	return MIN(move_chance, monster_terrain_chance(c, mon, grid, bash));
+}
+
 /**
  * Counts the number of monsters adjacent to a given square
  */
@@ -517,6 +541,7 @@ static bool get_move_wander(struct monster *mon, struct loc *tgrid)
 	struct loc grid1 = mon->grid, grid;
 	struct monster_group *group = monster_group_by_index(mon->group_info.index);
 	struct monster_race *race = mon->race;
+	struct flow *flow = monster_group_flow(group, mon);
 	bool random_move = false;
 	bool no_move = false;
 	int d;
@@ -524,7 +549,7 @@ static bool get_move_wander(struct monster *mon, struct loc *tgrid)
 	int closest = z_info->flow_max - 1;
 					
 	/* Deal with monsters that don't have a destination */
-	if (loc_eq(group->flow.centre, loc(0, 0))) {
+	if (!flow) {
 		/* Some monsters cannot move at all */
 		if (rf_has(race->flags, RF_NEVER_MOVE)) {
 			return false;
@@ -547,7 +572,7 @@ static bool get_move_wander(struct monster *mon, struct loc *tgrid)
 		bool hoarder = false;
 
         /* How far is the monster from its wandering destination? */
-        dist = flow_dist(group->flow, grid1);
+        dist = flow_dist(*flow, grid1);
 
 		/* Check out monsters in the same group */
 		while (list_entry) {
@@ -621,7 +646,7 @@ static bool get_move_wander(struct monster *mon, struct loc *tgrid)
 		/* Unwary monsters won't wander off while others are sleeping */
 		if ((mon->alertness < ALERTNESS_ALERT) && (group_sleepers > 0)) {
 			/* Only set the new flow if needed */
-			if (!loc_eq(group->flow.centre, sleeper_grid)) {
+			if (!loc_eq(group->centre, sleeper_grid)) {
 				monster_group_new_wandering_flow(mon, sleeper_grid);
 			}
 			if (one_in_(2)) random_move = true;
@@ -681,6 +706,7 @@ static bool get_move_wander(struct monster *mon, struct loc *tgrid)
 		}
 
 		/* Using flow information, check nearby grids, diagonals first. */
+		flow = monster_group_flow(group, mon);
 		for (d = 7; d >= 0; d--) {
 			/* Get the location */
 			grid = loc_sum(grid1, ddgrid_ddd[d]);
@@ -688,7 +714,7 @@ static bool get_move_wander(struct monster *mon, struct loc *tgrid)
 			/* Check Bounds */
 			if (!square_in_bounds(cave, grid)) continue;
 
-			dist = flow_dist(group->flow, grid);
+			dist = flow_dist(*flow, grid);
 
 			/* Ignore grids that are further than the current favourite */
 			if (closest < dist) continue;
@@ -3044,8 +3070,8 @@ static void monster_turn_wander(struct monster *mon)
 
     /* Occasionally update the flow to take account of changes in the dungeon
 	 * (new glyphs of warding, doors closed etc) */
-    if (one_in_(10) && !loc_eq(group->flow.centre, loc(0, 0))) {
-		update_flow(cave, &group->flow, mon);
+    if (one_in_(10)) {
+		monster_group_refresh_flow(group);
      }
 
 	/* Choose a target grid, or cancel the move. */
@@ -3553,22 +3579,23 @@ static void monster_turn(struct monster *mon)
  * gets a turn, and/or to decide whether it gets a turn
  * ------------------------------------------------------------------------ */
 /**
- * Monster regeneration of HPs.
+ * Monster regeneration of HPs, for the regeneration turns (one every ten
+ * game turns, numbered by turn / 10) from 'from' up to but not including 'to'.
  */
-static void regen_monster(struct monster *mon, int num)
+static void regen_monster(struct monster *mon, int from, int to)
 {
 	int regen_period = z_info->mon_regen_hp_period;
 
 	/* Regenerate (if needed) */
 	if (mon->hp < mon->maxhp) {
+		int hp;
+
 		/* Some monsters regenerate quickly */
 		if (rf_has(mon->race->flags, RF_REGENERATE)) regen_period /= 5;
 
-		/* Regenerate */
-		mon->hp += regen_amount(turn / 10, mon->maxhp, regen_period);
-
-		/* Do not over-regenerate */
-		if (mon->hp > mon->maxhp) mon->hp = mon->maxhp;
+		/* Regenerate, but do not over-regenerate */
+		hp = mon->hp + regen_amount_over(from, to, mon->maxhp, regen_period);
+		mon->hp = MIN(hp, mon->maxhp);
 			
 		/* Fully healed -> flag minimum range for recalculation */
 		if (mon->hp == mon->maxhp) mon->min_range = 0;
@@ -3582,11 +3609,11 @@ static void regen_monster(struct monster *mon, int num)
 	if (mon->mana != z_info->mana_max) {
 		/* Can only regenerate mana if not singing */
 		if (!mon->song) {
-			mon->mana += regen_amount(turn / 10, z_info->mana_max,
-									  z_info->mon_regen_sp_period);
+			int mana = mon->mana + regen_amount_over(from, to,
+				z_info->mana_max, z_info->mon_regen_sp_period);
 
 			/* Do not over-regenerate */
-			if (mon->mana > z_info->mana_max) mon->mana = z_info->mana_max;
+			mon->mana = MIN(mana, z_info->mana_max);
 
 			/* Fully healed -> flag minimum range for recalculation */
 			if (mon->mana == z_info->mana_max) mon->min_range = 0;
@@ -3648,7 +3675,7 @@ static void process_monster_recover(struct monster *mon)
 	if (!los(cave, mon->grid, player->grid) &&
 		(mon->alertness >= ALERTNESS_ALERT) && 
 	    (mon->stance != STANCE_FLEEING) && (mon->race->sleep > 0)) {
-		int bonus = player_active_ability(player, "Vanish") ? 15 : 25;
+		int bonus = player_active_ability(player, PA_VANISH) ? 15 : 25;
 		int result = skill_check(source_monster(mon->midx), 
 		                         monster_skill(mon, SKILL_PERCEPTION) + bonus,
 		                         player->state.skill_use[SKILL_STEALTH] +
@@ -3664,74 +3691,347 @@ static void process_monster_recover(struct monster *mon)
 	calc_morale(mon);
 	calc_stance(mon);
 }
-
-
 /**
  * ------------------------------------------------------------------------
- * Monster processing routines to be called by the main game loop
- * ------------------------------------------------------------------------ */
-/**
- * Process all the "live" monsters, once per game turn.
+ * Monster turn scheduling
  *
- * During each game turn, we scan through the list of all the "live" monsters,
- * (backwards, so we can excise any "freshly dead" monsters), energizing each
- * monster, and allowing fully energized monsters to move, attack, pass, etc.
+ * Monsters in the arena gain energy every game turn, and move on the turns
+ * when they have enough of it.  Rather than visiting every monster on every
+ * game turn, each monster's energy is only brought up to date when it is
+ * needed, and the monsters are kept in a heap ordered by the game turn on
+ * which they will next have enough energy to move, and then by decreasing
+ * index, which is the order in which they have always been processed.
  *
- * This function and its children are responsible for a considerable fraction
- * of the processor time in normal situations, greater if the character is
- * resting.
+ * A monster's energy includes what it gains on game turns before its
+ * energy_turn.  During the final sweep of a game turn (see process_monsters())
+ * the monsters above sweep_idx have also gained their energy for that turn.
+ * ------------------------------------------------------------------------ */
+static uint16_t *sched_heap;
+static uint16_t *sched_pos;
+static int32_t *sched_due;
+static int sched_num;
+static uint16_t *sched_list;
+static int32_t sweep_turn = -1;
+static int sweep_idx;
+
+/**
+ * Allocate the monster turn schedule
  */
-void process_monsters(int minimum_energy)
+void monster_turns_init(void)
 {
-	int i;
+	sched_heap = mem_zalloc(z_info->monster_max * sizeof(uint16_t));
+	sched_pos = mem_zalloc(z_info->monster_max * sizeof(uint16_t));
+	sched_due = mem_zalloc(z_info->monster_max * sizeof(int32_t));
+	sched_list = mem_zalloc(z_info->monster_max * sizeof(uint16_t));
+	sched_num = 0;
+	sweep_turn = -1;
+}
 
-	/* Only process some things every so often */
-	bool regen = false;
+/**
+ * Free the monster turn schedule
+ */
+void monster_turns_free(void)
+{
+	mem_free(sched_heap);
+	mem_free(sched_pos);
+	mem_free(sched_due);
+	mem_free(sched_list);
+	sched_heap = NULL;
+	sched_pos = NULL;
+	sched_due = NULL;
+	sched_list = NULL;
+	sched_num = 0;
+}
 
-	/* If time is stopped, no monsters can move */
-	if (OPT(player, cheat_timestop)) return;
+/**
+ * Whether monster index a comes before monster index b in the schedule
+ */
+static bool sched_before(int a, int b)
+{
+	if (sched_due[a] != sched_due[b]) return sched_due[a] < sched_due[b];
+	return a > b;
+}
 
-	/* Regenerate hitpoints and mana every 100 game turns */
-	if (turn % 10 == 0)
-		regen = true;
+static void sched_set(int pos, int m_idx)
+{
+	sched_heap[pos] = m_idx;
+	sched_pos[m_idx] = pos + 1;
+}
 
-	/* Process the monsters (backwards) */
-	for (i = mon_max - 1; i >= 1; i--) {
-		struct monster *mon;
-		bool moving;
+static void sched_up(int pos)
+{
+	int m_idx = sched_heap[pos];
 
-		/* Handle "leaving" */
-		if (player->is_dead || player->upkeep->generate_level) break;
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+		if (!sched_before(m_idx, sched_heap[parent])) break;
+		sched_set(pos, sched_heap[parent]);
+		pos = parent;
+	}
+	sched_set(pos, m_idx);
+}
 
-		/* Get a 'live' monster */
-		mon = monster(i);
-		if (!mon->race || monster_is_stored(mon)) continue;
+static void sched_down(int pos)
+{
+	int m_idx = sched_heap[pos];
+
+	while (true) {
+		int child = 2 * pos + 1;
+		if (child >= sched_num) break;
+		if ((child + 1 < sched_num) &&
+			sched_before(sched_heap[child + 1], sched_heap[child])) {
+			child++;
+		}
+		if (!sched_before(sched_heap[child], m_idx)) break;
+		sched_set(pos, sched_heap[child]);
+		pos = child;
+	}
+	sched_set(pos, m_idx);
+}
 
-		/* Ignore monster if the player is riding it */
-		if (mon == player->mount) continue;
+/**
+ * Whether a monster is in the schedule (that is, alive in the arena)
+ */
+static bool monster_is_scheduled(const struct monster *mon)
+{
+	return sched_pos && (mon->midx > 0) && sched_pos[mon->midx] &&
+		(monster(mon->midx) == mon);
+}
 
-		/* Ignore monsters that have already been handled */
-		if (mflag_has(mon->mflag, MFLAG_HANDLED)) continue;
+/**
+ * Energy a monster gains each game turn; a ridden monster gains none
+ */
+static int monster_energy_gain(const struct monster *mon)
+{
+	if (player && (player->mount == mon)) return 0;
+	return turn_energy(mon->mspeed);
+}
+
+/**
+ * The game turn before which a monster in the arena should have been given
+ * its energy
+ */
+static int32_t energy_credit_turn(int m_idx)
+{
+	if ((turn == sweep_turn) && (m_idx > sweep_idx)) return turn + 1;
+	return turn;
+}
+
+/**
+ * Bring the energy of the monster with the given index up to date, along with
+ * the regeneration it gets every ten game turns while it is gaining energy
+ */
+static void energy_sync(int m_idx)
+{
+	struct monster *mon = monster(m_idx);
+	int32_t until = energy_credit_turn(m_idx);
+
+	if (until > mon->energy_turn) {
+		int gain = monster_energy_gain(mon);
+
+		mon->energy += (until - mon->energy_turn) * gain;
+		if (gain) {
+			regen_monster(mon, (mon->energy_turn + 9) / 10, (until + 9) / 10);
+		}
+		mon->energy_turn = until;
+	}
+}
+
+/**
+ * Work out the game turn on which a monster next has enough energy to move
+ */
+static int32_t monster_due_turn(const struct monster *mon)
+{
+	int need = z_info->move_energy - mon->energy;
+	int gain = monster_energy_gain(mon);
+
+	if (!gain) return INT32_MAX;
+	if (need <= 0) return mon->energy_turn;
+	return mon->energy_turn + (need + gain - 1) / gain;
+}
+
+/**
+ * Get the current energy of a monster
+ */
+int monster_energy(const struct monster *mon)
+{
+	int32_t until;
+
+	if (!monster_is_scheduled(mon)) return mon->energy;
+	until = energy_credit_turn(mon->midx);
+	if (until <= mon->energy_turn) return mon->energy;
+	return mon->energy + (until - mon->energy_turn) * monster_energy_gain(mon);
+}
+
+/**
+ * Whether a monster in the arena has already been processed this game turn
+ */
+bool monster_handled(const struct monster *mon)
+{
+	if (!monster_is_scheduled(mon)) return false;
+	return (mon->energy_turn > turn) || (energy_credit_turn(mon->midx) > turn);
+}
+
+/**
+ * Bring a monster's energy up to date; this must be done before anything
+ * which changes how much energy it gains per turn
+ */
+void monster_energy_sync(struct monster *mon)
+{
+	if (monster_is_scheduled(mon)) energy_sync(mon->midx);
+}
+
+/**
+ * Put a monster back in the right place in the schedule after its energy
+ * or speed has changed
+ */
+void monster_reschedule(struct monster *mon)
+{
+	int pos;
+
+	if (!monster_is_scheduled(mon)) return;
+	pos = sched_pos[mon->midx] - 1;
+	sched_due[mon->midx] = monster_due_turn(mon);
+	sched_up(pos);
+	sched_down(sched_pos[mon->midx] - 1);
+}
+
+/**
+ * Add a monster to the schedule.
+ * \param m_idx is the monster's index
+ * \param arriving is whether it has just come into the arena, rather than
+ * just changed index
+ */
+void schedule_monster(int m_idx, bool arriving)
+{
+	struct monster *mon = monster(m_idx);
+
+	if (!sched_pos || sched_pos[m_idx]) return;
+	if (arriving) {
+		/* Savefiles mark monsters which have been processed this turn */
+		if (mflag_has(mon->mflag, MFLAG_HANDLED)) {
+			mon->energy_turn = turn + 1;
+			mflag_off(mon->mflag, MFLAG_HANDLED);
+		} else {
+			mon->energy_turn = energy_credit_turn(m_idx);
+		}
+	}
+	sched_due[m_idx] = monster_due_turn(mon);
+	sched_set(sched_num++, m_idx);
+	sched_up(sched_num - 1);
+}
 
-		/* Not enough energy to move yet */
-		if (mon->energy < minimum_energy) continue;
+/**
+ * Take a monster out of the schedule, bringing its energy up to date
+ */
+void unschedule_monster(int m_idx)
+{
+	int pos, last;
+
+	if (!sched_pos || !sched_pos[m_idx]) return;
+	energy_sync(m_idx);
+	pos = sched_pos[m_idx] - 1;
+	sched_pos[m_idx] = 0;
+	last = sched_heap[--sched_num];
+	if (pos < sched_num) {
+		sched_set(pos, last);
+		sched_up(pos);
+		sched_down(sched_pos[last] - 1);
+	}
+}
 
-		/* Does this monster have enough energy to move? */
-		moving = mon->energy >= z_info->move_energy ? true : false;
+/**
+ * Get the first game turn on which any monster in the arena is due to move
+ */
+int32_t monster_next_turn(void)
+{
+	if (!sched_num) return INT32_MAX;
+	return sched_due[sched_heap[0]];
+}
 
-		/* Prevent reprocessing */
-		mflag_on(mon->mflag, MFLAG_HANDLED);
+static int cmp_mon_idx_desc(const void *a, const void *b)
+{
+	return (int) *(const uint16_t *) b - (int) *(const uint16_t *) a;
+}
 
-		/* Handle monster regeneration if requested */
-		if (regen)
-			regen_monster(mon, 1);
+/**
+ * Get the monsters due to move this game turn, in decreasing index order
+ * \param list is filled with their indices
+ * \return the number of monsters
+ */
+static int monsters_due(uint16_t *list)
+{
+	int i, k, num = 0;
+
+	/* Collect the heap positions at the top of the heap which are due */
+	if (sched_num && (sched_due[sched_heap[0]] <= turn)) list[num++] = 0;
+	for (i = 0; i < num; i++) {
+		for (k = 2 * list[i] + 1; (k <= 2 * list[i] + 2) && (k < sched_num);
+			 k++) {
+			if (sched_due[sched_heap[k]] <= turn) list[num++] = k;
+		}
+	}
+	for (i = 0; i < num; i++) {
+		list[i] = sched_heap[list[i]];
+	}
+	qsort(list, num, sizeof(uint16_t), cmp_mon_idx_desc);
+	return num;
+}
 
-		/* Give this monster some energy */
-		mon->energy += turn_energy(mon->mspeed);
+/**
+ * Whether a monster in the schedule is still due to move this game turn
+ */
+static bool monster_is_due(const struct monster *mon)
+{
+	if (!monster_is_scheduled(mon)) return false;
+	if ((mon->energy_turn > turn) || !monster_energy_gain(mon)) return false;
+	return monster_energy(mon) >= z_info->move_energy;
+}
 
-		/* End the turn of monsters without enough energy to move */
-		if (!moving) continue;
+/**
+ * Hold every monster's energy where it is for a game turn
+ */
+static void delay_monster_turns(void)
+{
+	int i;
 
+	for (i = 0; i < sched_num; i++) {
+		struct monster *mon = monster(sched_heap[i]);
+		if (mon->energy_turn <= turn) mon->energy_turn++;
+		sched_due[sched_heap[i]] = monster_due_turn(mon);
+	}
+	for (i = sched_num / 2 - 1; i >= 0; i--) {
+		sched_down(i);
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Monster processing routines to be called by the main game loop
+ * ------------------------------------------------------------------------ */
+/**
+ * Give a monster its energy and regeneration for this game turn, and let it
+ * move if it had enough energy already
+ */
+static void process_monster(struct monster *mon)
+{
+	bool moving;
+	int m_idx = mon->midx;
+
+	/* Bring the monster's energy up to date */
+	energy_sync(m_idx);
+
+	/* Does this monster have enough energy to move? */
+	moving = mon->energy >= z_info->move_energy ? true : false;
+
+	/* Regenerate hitpoints and mana every 10 game turns */
+	if (turn % 10 == 0) regen_monster(mon, turn / 10, turn / 10 + 1);
+
+	/* Give this monster some energy, and prevent reprocessing */
+	mon->energy += turn_energy(mon->mspeed);
+	mon->energy_turn = turn + 1;
+
+	if (moving) {
 		/* Process timed effects and other every-turn things */
 		process_monster_recover(mon);
 
@@ -3739,28 +4039,129 @@ void process_monsters(int minimum_energy)
 		mon->energy -= z_info->move_energy;
 
 		/* Sleeping monsters don't get a move */
-		if (mon->alertness < ALERTNESS_UNWARY) continue;
-
-		/* Monsters who have just noticed you miss their turns (as do those
-		 * who have been knocked back...) */
-		if (mon->skip_next_turn) {
-            /* Reset its previous movement to stop it charging etc. */
+		if (mon->alertness < ALERTNESS_UNWARY) {
+			/* No move */
+		} else if (mon->skip_next_turn) {
+			/* Monsters who have just noticed you miss their turns (as do
+			 * those who have been knocked back...); reset their previous
+			 * movement to stop them charging etc. */
 			mon->previous_action[0] = ACTION_MISC;
 			mon->skip_next_turn = false;
-			continue;
+		} else {
+			/* Set this monster to be the current actor */
+			mon_current = m_idx;
+
+			/* The monster takes its turn */
+			monster_turn(mon);
+
+			/* Monster can take terrain damage after its turn. */
+			monster_take_terrain_damage(mon);
+
+			/* Monster is no longer current */
+			mon_current = -1;
 		}
+	}
 
-		/* Set this monster to be the current actor */
-		mon_current = i;
+	/* Work out when it next moves, if it is still here */
+	monster_reschedule(mon);
+}
+
+/**
+ * Process the "live" monsters for a game turn.
+ *
+ * Each monster in the arena gets energy once per game turn, and moves if it
+ * had enough.  The main game loop first calls this with minimum_energy set
+ * to just more than the player's energy, so monsters with more energy than
+ * the player move before the player does, and then with minimum_energy 0
+ * for the final sweep of the game turn, which handles the rest (backwards,
+ * so we can excise any "freshly dead" monsters).
+ *
+ * Only monsters due to move are visited, except that a first call with
+ * minimum_energy below the energy needed to move visits every monster with
+ * that much; the rest gain energy and regenerate implicitly, and are brought
+ * up to date when they are next visited or have their speed changed.
+ *
+ * This function and its children are responsible for a considerable fraction
+ * of the processor time in normal situations, greater if the character is
+ * resting.
+ */
+void process_monsters(int minimum_energy)
+{
+	int i, num;
+
+	/* If time is stopped, no monsters can move or gain energy */
+	if (OPT(player, cheat_timestop)) {
+		if (!minimum_energy) delay_monster_turns();
+		return;
+	}
 
-		/* The monster takes its turn */
-		monster_turn(mon);
+	if (minimum_energy >= z_info->move_energy) {
+		/* Only monsters due to move can have that much energy */
+		num = monsters_due(sched_list);
+		for (i = 0; i < num; i++) {
+			struct monster *mon = monster(sched_list[i]);
 
-		/* Monster can take terrain damage after its turn. */
-		monster_take_terrain_damage(mon);
+			/* Handle "leaving" */
+			if (player->is_dead || player->upkeep->generate_level) break;
+
+			/* Ignore monsters that have already been handled */
+			if (!monster_is_due(mon)) continue;
+
+			/* Not enough energy to move yet */
+			if (monster_energy(mon) < minimum_energy) continue;
+
+			process_monster(mon);
+		}
+		return;
+	} else if (minimum_energy) {
+		/* Monsters which can't move yet get their energy early too */
+		for (i = live_monster_before(mon_max); i; i = live_monster_before(i)) {
+			struct monster *mon = monster(i);
 
-		/* Monster is no longer current */
-		mon_current = -1;
+			/* Handle "leaving" */
+			if (player->is_dead || player->upkeep->generate_level) break;
+
+			/* Ignore monster if the player is riding it */
+			if (mon == player->mount) continue;
+
+			/* Ignore monsters that have already been handled */
+			if (mon->energy_turn > turn) continue;
+
+			/* Not enough energy yet */
+			if (monster_energy(mon) < minimum_energy) continue;
+
+			process_monster(mon);
+		}
+		return;
+	}
+
+	/* Final sweep, backwards; monsters passed have had their energy */
+	sweep_turn = turn;
+	sweep_idx = mon_max;
+	num = monsters_due(sched_list);
+	for (i = 0; i < num; i++) {
+		struct monster *mon = monster(sched_list[i]);
+
+		/* Handle "leaving" */
+		if (player->is_dead || player->upkeep->generate_level) break;
+		sweep_idx = sched_list[i];
+
+		/* Ignore monsters that have already been handled */
+		if (!monster_is_due(mon)) continue;
+
+		process_monster(mon);
+	}
+
+	if (player->is_dead || player->upkeep->generate_level) {
+		/* Give the monsters passed their energy, and end the sweep */
+		for (i = live_monster_before(mon_max); i > sweep_idx;
+			 i = live_monster_before(i)) {
+			energy_sync(i);
+		}
+		sweep_turn = -1;
+	} else {
+		/* All the monsters have had their energy */
+		sweep_idx = 0;
 	}
 
 	/* Update monster visibility after this */
@@ -3769,22 +4170,50 @@ void process_monsters(int minimum_energy)
 }
 
 /**
- * Clear 'moved' status from all monsters.
- *
- * Clear noise if appropriate.
+ * Bring the sleeping monsters in the arena up to date after game turns have
+ * been passed over without processing them.  A sleeping monster does nothing
+ * on its turns but recover, so the moves it would have had are worked out
+ * from its energy, and it recovers from all of them at once.
  */
-void reset_monsters(void)
+void recover_sleeping_monsters(void)
 {
-	int i;
-	struct monster *mon;
+	int i, j;
 
-	/* Process the monsters (backwards) */
-	for (i = mon_max - 1; i >= 1; i--) {
-		/* Access the monster */
-		mon = monster(i);
+	for (i = 0; i < sched_num; i++) {
+		int m_idx = sched_heap[i];
+		struct monster *mon = monster(m_idx);
+		int32_t turns = energy_credit_turn(m_idx) - mon->energy_turn;
+		int gain = monster_energy_gain(mon);
+		int moves, status;
 
-		/* Monster is ready to go again */
-		mflag_off(mon->mflag, MFLAG_HANDLED);
+		if ((turns <= 0) || !gain || (mon->alertness >= ALERTNESS_UNWARY)) {
+			continue;
+		}
+
+		/* Each game turn it moves if it has the energy, then gains more */
+		moves = (mon->energy + (turns - 1) * gain) / z_info->move_energy;
+		energy_sync(m_idx);
+		mon->energy -= moves * z_info->move_energy;
+		sched_due[m_idx] = monster_due_turn(mon);
+		if (!moves) continue;
+
+		/* Recover as process_monster_recover() does on each move */
+		for (status = 0; status < MON_TMD_MAX; status++) {
+			if (mon->m_timed[status]) {
+				mon_dec_timed(mon, status, moves, MON_TMD_FLG_NOTIFY);
+			}
+		}
+		for (j = 0; (j < moves) && mon->tmp_morale; j++) {
+			mon->tmp_morale *= 9;
+			mon->tmp_morale /= 10;
+		}
+		if (player->upkeep->health_who == mon)
+			player->upkeep->redraw |= (PR_HEALTH);
+		calc_morale(mon);
+		calc_stance(mon);
+	}
+	for (i = sched_num / 2 - 1; i >= 0; i--) {
+		sched_down(i);
 	}
 }
 
@@ -3793,21 +4222,19 @@ void reset_monsters(void)
  */
 void restore_monsters(int place, int num_turns)
 {
-	int i;
+	int i, num;
 	struct monster *mon;
+	uint16_t *stored = monsters_at_place(place, &num);
 
 	/* Process the monsters (backwards) */
-	for (i = mon_max - 1; i >= 1; i--) {
+	for (i = num - 1; i >= 0; i--) {
 		int status, status_red;
 
 		/* Access the monster */
-		mon = monster(i);
-
-		/* Check the place */
-		if (mon->place != place) continue;
+		mon = monster(stored[i]);
 
 		/* Regenerate */
-		regen_monster(mon, num_turns / 100);
+		regen_monster(mon, turn / 10, turn / 10 + 1);
 
 		/* Handle timed effects */
 		status_red = num_turns * turn_energy(mon->mspeed) / z_info->move_energy;
@@ -3819,4 +4246,5 @@ void restore_monsters(int place, int num_turns)
 			}
 		}
 	}
+	mem_free(stored);
 }
@@ -49,13 +49,24 @@ enum monster_stance {
 	STANCE_ALLIED = 5
 };
 
+int monster_terrain_chance(struct chunk *c, struct monster *mon,
+						   struct loc grid, bool *bash);
 int monster_entry_chance(struct chunk *c, struct monster *mon, struct loc grid,
 						 bool *bash);
 int adj_mon_count(struct loc grid);
 void tell_allies(struct monster *mon, int flag);
 bool multiply_monster(const struct monster *mon);
+void monster_turns_init(void);
+void monster_turns_free(void);
+int monster_energy(const struct monster *mon);
+bool monster_handled(const struct monster *mon);
+void monster_energy_sync(struct monster *mon);
+void monster_reschedule(struct monster *mon);
+void schedule_monster(int m_idx, bool arriving);
+void unschedule_monster(int m_idx);
+int32_t monster_next_turn(void);
 void process_monsters(int minimum_energy);
-void reset_monsters(void);
+void recover_sleeping_monsters(void);
 void restore_monsters(int place, int num_turns);
 
 #endif /* !MONSTER_MOVE_H */
@@ -416,7 +416,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 	square_light_spot(cave, grid2);
 
 	/* Deal with set polearm attacks */
-	if (player_active_ability(player, "Polearm Mastery") && m1_is_monster) {
+	if (player_active_ability(player, PA_POLEARM_MASTERY) && m1_is_monster) {
 		player_polearm_passive_attack(player, grid1, grid2);
 	}
 
@@ -535,13 +535,10 @@ void monsters_hear(bool player_centered, bool main_roll, int difficulty)
 	}
 
 	/* Process the monsters (backwards) */
-	for (i = mon_max - 1; i >= 1; i--) {
+	for (i = live_monster_before(mon_max); i; i = live_monster_before(i)) {
 		/* Access the monster */
 		struct monster *mon = monster(i);
 
-		/* Ignore dead and stored monsters */
-		if (!mon->race || monster_is_stored(mon)) continue;
-
 		/* Ignore if character is within detection range
 		 * (unlimited for most monsters, 2 for shortsighted ones) */		
 		if (rf_has(mon->race->flags, RF_SHORT_SIGHTED) && (mon->cdis > 2)) {
@@ -604,7 +601,7 @@ void monsters_hear(bool player_centered, bool main_roll, int difficulty)
 			}
 
 			/* Bonus reduced if the player has 'disguise' */
-			if (player_active_ability(player, "Disguise")) {
+			if (player_active_ability(player, PA_DISGUISE)) {
 				m_perception += (open_squares + combat_sight_bonus) / 2;
 			} else {
 				m_perception += open_squares + combat_sight_bonus;
@@ -643,6 +640,47 @@ void monsters_hear(bool player_centered, bool main_roll, int difficulty)
 	}
 }
 
+/**
+ * Whether every monster in the arena is asleep, and will stay asleep and
+ * keep its speed through any number of rolls of monsters_hear() for player
+ * noise of the given difficulty, with no combat bonus and no song of silence
+ */
+bool monsters_undisturbed(int difficulty)
+{
+	int i;
+
+	for (i = live_monster_before(mon_max); i; i = live_monster_before(i)) {
+		struct monster *mon = monster(i);
+		int m_perception;
+
+		/* Awake, fading or changing speed monsters are not undisturbed */
+		if ((mon->alertness >= ALERTNESS_UNWARY) ||
+			mflag_has(mon->mflag, MFLAG_SUMMONED) ||
+			mon->m_timed[MON_TMD_SLOW] || mon->m_timed[MON_TMD_FAST]) {
+			return false;
+		}
+
+		/* Shortsighted monsters can't hear from far off */
+		if (rf_has(mon->race->flags, RF_SHORT_SIGHTED) && (mon->cdis > 2)) {
+			continue;
+		}
+
+		/* Build up the monster's perception as monsters_hear() does */
+		m_perception = monster_skill(mon, SKILL_PERCEPTION) -
+			flow_dist(cave->player_noise, mon->grid);
+		m_perception -= player_bane_bonus(player, mon);
+		m_perception += monster_elf_bane_bonus(mon, player);
+		if (player->on_the_run &&
+			(chunk_realm(player->place) == REALM_MORGOTH)) {
+			m_perception += 5;
+		}
+
+		/* The best roll for the monster must lose to the worst for the noise */
+		if (m_perception + 10 > difficulty + 1) return false;
+	}
+	return true;
+}
+
 /**
  * ------------------------------------------------------------------------
  * Monster damage and death utilities
@@ -754,7 +792,7 @@ static int mon_create_drop(struct chunk *c, struct monster *mon,
 			/* Specified by tval or by kind */
 			if (drop->kind) {
 				/* Allocate by hand, prep */
-				obj = mem_zalloc(sizeof(*obj));
+				obj = object_new();
 				object_prep(obj, drop->kind, level, RANDOMISE);
 				obj->number = randcalc(drop->dice, 0, RANDOMISE);
 				/* Deathblades only */
@@ -769,7 +807,7 @@ static int mon_create_drop(struct chunk *c, struct monster *mon,
 				assert(drop->art);
 				art = drop->art;
 				kind = lookup_kind(art->tval, art->sval);
-				obj = mem_zalloc(sizeof(*obj));
+				obj = object_new();
 				object_prep(obj, kind, 100, RANDOMISE);
 				obj->artifact = art;
 				copy_artifact_data(obj, obj->artifact);
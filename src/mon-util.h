@@ -34,6 +34,7 @@ bool monster_can_see(struct chunk *c, struct monster *mon, struct loc grid);
 void update_smart_learn(struct monster *mon, struct player *p, int flag,
 						int pflag, int element);
 void monsters_hear(bool player_centered, bool main_roll, int difficulty);
+bool monsters_undisturbed(int difficulty);
 int32_t adjusted_mon_exp(const struct monster_race *race, bool kill);
 int mon_create_drop_count(const struct monster_race *race, bool maximize);
 void drop_loot(struct chunk *c, struct monster *mon, struct loc grid,
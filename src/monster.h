@@ -405,6 +405,7 @@ struct monster {
 
 	uint8_t mspeed;				/* Monster "speed" */
 	uint8_t energy;				/* Monster "energy" */
+	int32_t energy_turn;		/* Game turn from which energy is still owed */
 
 	uint8_t stance;		/* Fleeing, Timid, Cautious, Aggressive */
 	int16_t morale;		/* Overall morale */
@@ -618,7 +618,7 @@ bool handle_stickied_removal(struct player *p, struct object *obj)
 		return false;
 	}
 
-	if (player_active_ability(player, "Curse Breaking")) {
+	if (player_active_ability(player, PA_CURSE_BREAKING)) {
 		msg("With a great strength of will, you break the curse!");
 		uncurse_object(obj);
 		return false;
@@ -943,6 +943,7 @@ void inven_wield(struct object *obj, int slot)
 			activate_ability(&player->item_abilities, ability);
 		}
 	}
+	player_update_abilities(player);
 
 	/* See if we have to overflow the pack */
 	combine_pack(player);
@@ -1001,6 +1002,7 @@ void inven_takeoff(struct object *obj)
 	for (ability = obj->abilities; ability; ability = ability->next) {
 		remove_ability(&player->item_abilities, ability);
 	}
+	player_update_abilities(player);
 
 	player->upkeep->update |= (PU_BONUS | PU_INVEN | PU_UPDATE_VIEW);
 	player->upkeep->notice |= (PN_IGNORE);
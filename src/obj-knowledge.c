@@ -758,12 +758,12 @@ void player_know_object(struct player *p, struct object *obj)
 	}
 
 	/* Know flavored objects with Item Lore */
-	if (player_active_ability(p, "Item Lore")) {
+	if (player_active_ability(p, PA_ITEM_LORE)) {
 		object_flavor_aware(p, obj);
 	}
 
 	/* Know worn objects with Lore-Master */
-	if (player_active_ability(p, "Lore-Master")) {
+	if (player_active_ability(p, PA_LORE_MASTER)) {
 		while (!object_runes_known(obj)) {
 			object_learn_unknown_rune(p, obj);
 		}
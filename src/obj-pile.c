@@ -277,12 +277,22 @@ bool pile_contains(const struct object *top, const struct object *obj)
 	return false;
 }
 
+static struct mem_pool object_pool = MEM_POOL_INIT("objects", struct object);
+
 /**
  * Create a new object and return it
  */
 struct object *object_new(void)
 {
-	return mem_zalloc(sizeof(struct object));
+	return mem_pool_alloc(&object_pool);
+}
+
+/**
+ * Give back the memory kept for objects, once they have all been freed
+ */
+void object_pool_cleanup(void)
+{
+	mem_pool_release(&object_pool);
 }
 
 /**
@@ -295,7 +305,7 @@ void object_free(struct object *obj)
 	mem_free(obj->slays);
 	mem_free(obj->brands);
 	release_ability_list(obj->abilities);
-	mem_free(obj);
+	mem_pool_free(&object_pool, obj);
 }
 
 /**
@@ -48,6 +48,7 @@ typedef enum
 	OFLOOR_VISIBLE = 0x08, /* Visible items only */
 } object_floor_t;
 
+void object_pool_cleanup(void);
 struct object *object_new(void);
 void object_free(struct object *obj);
 void object_delete(struct chunk *c, struct chunk *p_c,
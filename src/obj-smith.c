@@ -84,7 +84,7 @@ int att_max(struct object *obj, bool assume_artistry)
 	struct ego_item *ego = obj->ego;
 	int att = kind->att;
 	bool artistry = assume_artistry ||
-		player_active_ability(player, "Artistry");
+		player_active_ability(player, PA_ARTISTRY);
 
 	if (artistry) att += base->smith_attack_artistry;
 	if (!tval_is_weapon(obj)) att = MIN(0, att);
@@ -142,7 +142,7 @@ int ds_max(struct object *obj, bool assume_artistry)
 	struct ego_item *ego = obj->ego;
 	int ds = kind->ds;
     bool artistry = assume_artistry ||
-		player_active_ability(player, "Artistry");
+		player_active_ability(player, PA_ARTISTRY);
 
 	if (artistry) ds += 1;
 	if (ego) ds += ego->ds;
@@ -199,7 +199,7 @@ int evn_max(struct object *obj, bool assume_artistry)
 	struct ego_item *ego = obj->ego;
 	int evn = kind->evn;
     bool artistry = assume_artistry ||
-		player_active_ability(player, "Artistry");
+		player_active_ability(player, PA_ARTISTRY);
 
 	if (tval_is_armor(obj) && artistry) evn += 1;
 	if (ego) evn += ego->evn;
@@ -270,7 +270,7 @@ int ps_max(struct object *obj, bool assume_artistry)
 	struct ego_item *ego = obj->ego;
 	int ps = kind->ps;
     bool artistry = assume_artistry ||
-		player_active_ability(player, "Artistry");
+		player_active_ability(player, PA_ARTISTRY);
 
 	if (artistry) ps += 1;
 
@@ -908,7 +908,7 @@ int object_difficulty(struct object *obj, struct smithing_cost *smithing_cost)
     if (tval_is_ammo(obj) && (obj->number == 1)) diff /= 2;
 
 	/* Deal with masterpiece */
-	if ((diff > drain) && player_active_ability(player, "Masterpiece")) {
+	if ((diff > drain) && player_active_ability(player, PA_MASTERPIECE)) {
 		smithing_cost->drain += diff - drain;
 	}
 
@@ -920,21 +920,21 @@ int object_difficulty(struct object *obj, struct smithing_cost *smithing_cost)
 	}
 
     if ((cat == SMITH_TYPE_WEAPON) &&
-		!player_active_ability(player, "Weaponsmith")) {
+		!player_active_ability(player, PA_WEAPONSMITH)) {
 		smithing_cost->weaponsmith = 1;
     }
     if ((cat == SMITH_TYPE_ARMOUR) &&
-		!player_active_ability(player, "Armoursmith")) {
+		!player_active_ability(player, PA_ARMOURSMITH)) {
 		smithing_cost->armoursmith = 1;
     }
     if ((cat == SMITH_TYPE_JEWELRY)
-		&& !player_active_ability(player, "Jeweller")) {
+		&& !player_active_ability(player, PA_JEWELLER)) {
 		smithing_cost->jeweller = 1;
     }
-    if (obj->artifact && !player_active_ability(player, "Artifice")) {
+    if (obj->artifact && !player_active_ability(player, PA_ARTIFICE)) {
 		smithing_cost->artifice = 1;
     }
-    if (obj->ego && !player_active_ability(player, "Enchantment")) {
+    if (obj->ego && !player_active_ability(player, PA_ENCHANTMENT)) {
 		smithing_cost->enchantment = 1;
     }
     if ((att_valid(obj) && (obj->att > att_max(obj, false))) ||
@@ -959,7 +959,7 @@ static int too_difficult(struct object *obj)
 	int ability = player->state.skill_use[SKILL_SMITHING] +
 		square_forge_bonus(cave, player->grid);
 
-	if (player_active_ability(player, "Masterpiece")) {
+	if (player_active_ability(player, PA_MASTERPIECE)) {
 		ability += player->skill_base[SKILL_SMITHING];
 	}
 
@@ -128,13 +128,12 @@ static void flavor_assign_random(uint8_t tval)
  */
 void flavor_init(void)
 {
+	struct rng_ctx flavor_rng;
 	int i;
 
-	/* Use the "simple" RNG */
-	Rand_quick = true;
-
-	/* Induce consistent flavors */
-	Rand_value = seed_flavor;
+	/* Use the "simple" RNG, with a seed to induce consistent flavors */
+	rng_quick_init(&flavor_rng, seed_flavor);
+	rng_use(&flavor_rng);
 
 	/* Scrub all flavors and re-parse for new players */
 	if (turn == 1) {
@@ -160,7 +159,7 @@ void flavor_init(void)
 	flavor_assign_random(TV_POTION);
 
 	/* Use the "complex" RNG */
-	Rand_quick = false;
+	rng_use_game();
 
 	/* Analyze every object */
 	for (i = 0; i < z_info->k_max; i++) {
@@ -599,7 +598,7 @@ bool obj_can_refuel(const struct object *obj)
 bool obj_can_takeoff(const struct object *obj)
 {
 	return !obj_has_flag(obj, OF_CURSED)
-		|| player_active_ability(player, "Curse Breaking");
+		|| player_active_ability(player, PA_CURSE_BREAKING);
 }
 
 /*
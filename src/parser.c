@@ -33,6 +33,12 @@
  * Each hook has a list of specs, which are essentially named formal parameters;
  * when we run a particular hook across a line, each spec in the hook is
  * assigned a value.
+ *
+ * Hooks are found by directive through an open hash table, and each line is
+ * tokenized in place in a line buffer the parser keeps from line to line.
+ * Values for the line go in an array that is likewise reused, and string
+ * values point into the line buffer, so parsing a line allocates nothing once
+ * the buffers are big enough.  Values last until the next line is parsed.
  */
 
 enum {
@@ -53,7 +59,7 @@ struct parser_spec {
 };
 
 struct parser_value {
-	struct parser_spec spec;
+	const struct parser_spec *spec;
 	union {
 		wchar_t cval;
 		int ival;
@@ -77,8 +83,14 @@ struct parser {
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	struct parser_hook **table;
+	size_t table_size;
+	size_t num_hooks;
+	char *line;
+	size_t line_size;
+	struct parser_value *values;
+	size_t num_values;
+	size_t max_values;
 	void *priv;
 };
 
@@ -90,26 +102,83 @@ struct parser *parser_new(void) {
 	return p;
 }
 
-static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (streq(h->dir, dir))
-			break;
-		h = h->next;
+static uint32_t hook_hash(const char *dir) {
+	uint32_t h = 2166136261U;
+	while (*dir) {
+		h ^= (unsigned char)*dir++;
+		h *= 16777619U;
 	}
 	return h;
 }
 
-static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+/**
+ * Find the table slot for a directive; it holds either the hook for that
+ * directive or NULL.
+ */
+static struct parser_hook **hook_slot(struct parser *p, const char *dir) {
+	size_t i = hook_hash(dir) & (p->table_size - 1);
+	while (p->table[i] && !streq(p->table[i]->dir, dir))
+		i = (i + 1) & (p->table_size - 1);
+	return &p->table[i];
+}
+
+static struct parser_hook *findhook(struct parser *p, const char *dir) {
+	if (!p->table_size)
+		return NULL;
+	return *hook_slot(p, dir);
+}
+
+/**
+ * Put a hook in the hash table, replacing any with the same directive.
+ */
+static void addhook(struct parser *p, struct parser_hook *h) {
+	struct parser_hook **slot;
+
+	/* Keep the table at most half full */
+	if ((p->num_hooks + 1) * 2 > p->table_size) {
+		struct parser_hook **old = p->table;
+		size_t i, old_size = p->table_size;
+
+		p->table_size = old_size ? old_size * 2 : 32;
+		p->table = mem_zalloc(p->table_size * sizeof(*p->table));
+		for (i = 0; i < old_size; i++) {
+			if (old[i])
+				*hook_slot(p, old[i]->dir) = old[i];
+		}
+		mem_free(old);
 	}
+
+	slot = hook_slot(p, h->dir);
+	if (!*slot)
+		p->num_hooks++;
+	*slot = h;
+}
+
+/**
+ * Return the next token from the line and move the cursor past it.  Tokens
+ * which are delimited end at the next ':', and skip any leading ones; others
+ * take the rest of the line.  There is no token if nothing is left.
+ */
+static char *next_token(char **cursor, bool delimited) {
+	char *tok = *cursor, *end;
+
+	if (delimited) {
+		while (*tok == ':')
+			tok++;
+	}
+	if (!*tok) {
+		*cursor = tok;
+		return NULL;
+	}
+
+	end = delimited ? strchr(tok, ':') : NULL;
+	if (end) {
+		*end = '\0';
+		*cursor = end + 1;
+	} else {
+		*cursor = tok + strlen(tok);
+	}
+	return tok;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -208,22 +277,19 @@ static bool parse_random(const char *str, random_value *bonus) {
  * This runs the first parser hook registered with `p` that matches `line`.
  */
 enum parser_error parser_parse(struct parser *p, const char *line) {
-	char *cline;
+	char *cursor;
 	char *tok;
 	struct parser_hook *h;
 	struct parser_spec *s;
 	struct parser_value *v;
-	char *sp = NULL;
+	size_t len;
 
 	assert(p);
 	assert(line);
 
-	parser_freeold(p);
-
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
+	p->num_values = 0;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace((unsigned char)*line)))
@@ -231,11 +297,18 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Copy the line to the line buffer, which is tokenized in place */
+	len = strlen(line) + 1;
+	if (len > p->line_size) {
+		while (len > p->line_size)
+			p->line_size = p->line_size ? p->line_size * 2 : 256;
+		p->line = mem_realloc(p->line, p->line_size);
+	}
+	memcpy(p->line, line, len);
+	cursor = p->line;
 
-	tok = strtok(cline, ":");
+	tok = next_token(&cursor, true);
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -244,7 +317,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
@@ -260,12 +332,11 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		 * at all (i.e., they consume the remainder of the line) */
 		if (t == PARSE_T_INT || t == PARSE_T_SYM || t == PARSE_T_RAND ||
 			t == PARSE_T_UINT) {
-			tok = strtok(sp, ":");
-			sp = NULL;
+			tok = next_token(&cursor, true);
 		} else if (t == PARSE_T_CHAR) {
-			tok = strtok(sp, "");
+			tok = next_token(&cursor, false);
 			if (tok) {
-				sp = utf8_fskip(tok, 1, NULL);
+				char *sp = utf8_fskip(tok, 1, NULL);
 				if (sp) {
 					if (*sp == ':') {
 						++sp;
@@ -273,38 +344,33 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 						my_strcpy(p->errmsg, s->name,
 							sizeof(p->errmsg));
 						p->error = PARSE_ERROR_FIELD_TOO_LONG;
-						mem_free(cline);
 						return PARSE_ERROR_FIELD_TOO_LONG;
 					}
+					cursor = sp;
 				}
 			}
 		} else {
-			tok = strtok(sp, "");
-			sp = NULL;
+			tok = next_token(&cursor, false);
 		}
 		if (!tok) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
-		v->spec.next = NULL;
-		v->spec.type = s->type;
-		v->spec.name = s->name;
+		/* Take the next value slot; there is one for every spec. */
+		assert(p->num_values < p->max_values);
+		v = &p->values[p->num_values];
+		v->spec = s;
 
 		/* Parse out its value. */
 		if (t == PARSE_T_INT) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -313,8 +379,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -322,27 +386,18 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		p->num_values++;
 	}
 
-	mem_free(cline);
-
 	p->error = h->func(p);
 	return p->error;
 }
@@ -400,7 +455,9 @@ static void clean_specs(struct parser_hook *h) {
  */
 void parser_destroy(struct parser *p) {
 	struct parser_hook *h;
-	parser_freeold(p);
+	mem_free(p->table);
+	mem_free(p->line);
+	mem_free(p->values);
 	while (p->hooks) {
 		h = p->hooks->next;
 		clean_specs(p->hooks);
@@ -487,6 +544,8 @@ errr parser_reg(struct parser *p, const char *fmt,
 	errr r;
 	char *cfmt;
 	struct parser_hook *h;
+	struct parser_spec *s;
+	size_t num_specs = 0;
 
 	assert(p);
 	assert(fmt);
@@ -505,7 +564,17 @@ errr parser_reg(struct parser *p, const char *fmt,
 	}
 
 	p->hooks = h;
+	addhook(p, h);
 	mem_free(cfmt);
+
+	/* Make sure there is room for a value for every spec */
+	for (s = h->fhead; s; s = s->next)
+		num_specs++;
+	if (num_specs > p->max_values) {
+		p->max_values = num_specs;
+		p->values = mem_realloc(p->values,
+			p->max_values * sizeof(*p->values));
+	}
 	return 0;
 }
 
@@ -522,19 +591,19 @@ enum parser_error ignored(struct parser *p) {
  * Used to test for presence of optional values.
  */
 bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (streq(v->spec.name, name))
+	size_t i;
+	for (i = 0; i < p->num_values; i++) {
+		if (streq(p->values[i].spec->name, name))
 			return true;
 	}
 	return false;
 }
 
 static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (streq(v->spec.name, name)) {
-			return v;
+	size_t i;
+	for (i = 0; i < p->num_values; i++) {
+		if (streq(p->values[i].spec->name, name)) {
+			return &p->values[i];
 		}
 	}
 	quit_fmt("parser_getval error: name is %s\n", name);
@@ -546,7 +615,7 @@ static struct parser_value *parser_getval(struct parser *p, const char *name) {
  */
 const char *parser_getsym(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_SYM);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_SYM);
 	return v->u.sval;
 }
 
@@ -555,7 +624,7 @@ const char *parser_getsym(struct parser *p, const char *name) {
  */
 int parser_getint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_INT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_INT);
 	return v->u.ival;
 }
 
@@ -564,7 +633,7 @@ int parser_getint(struct parser *p, const char *name) {
  */
 unsigned int parser_getuint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_UINT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_UINT);
 	return v->u.uval;
 }
 
@@ -573,7 +642,7 @@ unsigned int parser_getuint(struct parser *p, const char *name) {
  */
 const char *parser_getstr(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_STR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_STR);
 	return v->u.sval;
 }
 
@@ -582,7 +651,7 @@ const char *parser_getstr(struct parser *p, const char *name) {
  */
 struct random parser_getrand(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_RAND);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_RAND);
 	return v->u.rval;
 }
 
@@ -591,7 +660,7 @@ struct random parser_getrand(struct parser *p, const char *name) {
  */
 wchar_t parser_getchar(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_CHAR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_CHAR);
 	return v->u.cval;
 }
 
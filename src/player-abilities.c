@@ -29,6 +29,12 @@
 
 struct ability *abilities;
 
+static const char *ability_names[] = {
+	#define PA(a, b) b,
+	#include "list-abilities.h"
+	#undef PA
+};
+
 /**
  * ------------------------------------------------------------------------
  * Initialize abilities
@@ -66,6 +72,9 @@ static enum parser_error parse_ability_name(struct parser *p) {
 	parser_setpriv(p, a);
 	a->name = string_make(name);
 	a->skill = skill_index;
+	a->index = ability_index(name);
+	if (a->index == PA_NONE)
+		return PARSE_ERROR_INVALID_ABILITY;
 	return PARSE_ERROR_NONE;
 }
 
@@ -267,6 +276,18 @@ struct ability *lookup_ability(int skill, const char *name)
 	return NULL;
 }
 
+/**
+ * Find the PA_ index for an ability name, or PA_NONE if there is none.
+ */
+int ability_index(const char *name)
+{
+	int i;
+	for (i = 1; i < PA_MAX; i++) {
+		if (streq(ability_names[i], name)) return i;
+	}
+	return PA_NONE;
+}
+
 /**
  * Counts the abilities for a given skill in a set.
  * If the skill is SKILL_MAX, count all abilities.
@@ -284,46 +305,6 @@ static int count_abilities(struct ability *ability, int skill)
 	return count;
 }
 
-static bool ability_is_active(const struct ability *ability)
-{
-	return ability->active;
-}
-
-static int test_ability(const char *name, struct ability *test,
-						ability_predicate pred)
-{
-	int skill, count = 0;
-	bool found = false;
-
-	if (!test) return 0;
-
-	/* Look in every skill for an ability with the right name */
-	for (skill = 0; skill < SKILL_MAX; skill++) {
-		struct ability *ability = lookup_ability(skill, name);
-		if (ability) {
-			struct ability *thisa = test;
-
-			/* Note that we have found an ability of that name */
-			found = true;
-
-			/* See if the provided ability list contains the named one... */
-			while (thisa) {
-				if (streq(thisa->name, name) && (thisa->skill == skill)) {
-					/* ...and if so, if it satisfies any required condition */
-					if (!pred || (pred && pred(thisa))) {
-						count++;
-					}
-				}
-				thisa = thisa->next;
-			}
-		}
-	}
-	if (!found) {
-		assert(0);
-	}
-	return count;
-}
-
 /**
  * Does the given object type support the given ability type?
  */
@@ -337,7 +318,7 @@ bool applicable_ability(struct ability *ability, struct object *obj)
 
 	/* Throwing Mastery is OK for throwing items */
 	if (of_has(obj->flags, OF_THROWING) && (ability->skill == SKILL_MELEE) &&
-		streq(ability->name, "Throwing Mastery")) {
+		(ability->index == PA_THROWING_MASTERY)) {
 		return true;
 	}
 
@@ -429,12 +410,49 @@ bool player_has_ability(struct player *p, struct ability *ability)
 	return false;
 }
 
-int player_active_ability(struct player *p, const char *name)
+/**
+ * Recompute which abilities the player has active, from their innate and
+ * item abilities.  This needs calling whenever either list, or whether an
+ * ability in them is active, changes.
+ */
+void player_update_abilities(struct player *p)
+{
+	struct ability *ability;
+
+	pa_wipe(p->active_abilities);
+	for (ability = p->abilities; ability; ability = ability->next) {
+		if (ability->active) pa_on(p->active_abilities, ability->index);
+	}
+	for (ability = p->item_abilities; ability; ability = ability->next) {
+		if (ability->active) pa_on(p->active_abilities, ability->index);
+	}
+}
+
+/**
+ * Does the player have an active ability with the given PA_ index?
+ */
+bool player_active_ability(const struct player *p, int index)
 {
-	int count;
+	if (!p) return false;
+	return pa_has(p->active_abilities, index);
+}
+
+/**
+ * Count the player's active abilities with the given PA_ index, over all
+ * skills and both innate and item abilities.
+ */
+int player_ability_count(struct player *p, int index)
+{
+	struct ability *ability;
+	int count = 0;
+
 	if (!p) return 0;
-	count = test_ability(name, p->abilities, ability_is_active);
-	count += test_ability(name, p->item_abilities, ability_is_active);
+	for (ability = p->abilities; ability; ability = ability->next) {
+		if (ability->active && (ability->index == index)) count++;
+	}
+	for (ability = p->item_abilities; ability; ability = ability->next) {
+		if (ability->active && (ability->index == index)) count++;
+	}
 	return count;
 }
 
@@ -497,6 +515,7 @@ bool player_gain_ability(struct player *p, struct ability *ability)
 	add_ability(&p->abilities, ability);
 	new = locate_ability(p->abilities, ability);
 	new->active = true;
+	player_update_abilities(p);
 
 	/* Add languages (these persist even if the ability is turned off) */
 	if (ability->skill == SKILL_SPEECH) {
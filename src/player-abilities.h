@@ -29,6 +29,7 @@ struct ability {
 	char *desc;
 	uint8_t skill;
 	uint8_t level;
+	int index;			/* PA_ index of the name */
 	bool active;
 	bool last;
 	struct ability *prerequisites;
@@ -50,8 +51,11 @@ struct ability *locate_ability(struct ability *ability, struct ability *test);
 void add_ability(struct ability **set, struct ability *add);
 void activate_ability(struct ability **set, struct ability *activate);
 void remove_ability(struct ability **ability, struct ability *remove);
+int ability_index(const char *name);
 bool player_has_ability(struct player *p, struct ability *ability);
-int player_active_ability(struct player *p, const char *name);
+void player_update_abilities(struct player *p);
+bool player_active_ability(const struct player *p, int index);
+int player_ability_count(struct player *p, int index);
 bool player_has_prereq_abilities(struct player *p, struct ability *ability);
 int player_ability_cost(struct player *p, struct ability *ability);
 bool player_can_gain_ability(struct player *p, struct ability *ability);
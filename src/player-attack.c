@@ -67,7 +67,7 @@ static bool valid_charge(struct player *p, struct loc grid, int attack_type)
 	int delta_y = grid.y - p->grid.y;
 	int delta_x = grid.x - p->grid.x;
 	
-	if (player_active_ability(p, "Charge") && (p->state.speed > 1) &&
+	if (player_active_ability(p, PA_CHARGE) && (p->state.speed > 1) &&
 	    ((attack_type == ATT_MAIN) || (attack_type == ATT_FLANKING) ||
 		 (attack_type == ATT_CONTROLLED_RETREAT))) { 
 		/* Try all three directions */
@@ -94,7 +94,7 @@ static void possible_follow_through(struct player *p, struct loc grid,
 	int delta_y = grid.y - p->grid.y;
 	int delta_x = grid.x - p->grid.x;
 	
-	if (player_active_ability(p, "Follow-Through") && !p->timed[TMD_CONFUSED] &&
+	if (player_active_ability(p, PA_FOLLOW_THROUGH) && !p->timed[TMD_CONFUSED] &&
 		((attack_type == ATT_MAIN) || (attack_type == ATT_FLANKING) || 
 		 (attack_type == ATT_CONTROLLED_RETREAT) ||
 		 (attack_type == ATT_FOLLOW_THROUGH))) {
@@ -124,7 +124,7 @@ static void cruel_blow(int crit_bonus_dice, struct monster *mon)
 {
 	char m_name[80];
 
-	if (player_active_ability(player, "Cruel Blow")) {
+	if (player_active_ability(player, PA_CRUEL_BLOW)) {
 		/* Must be a damaging critical hit */
 		if (crit_bonus_dice <= 0) return;
 
@@ -212,7 +212,7 @@ static bool whirlwind_possible(struct player *p)
 
 	if (p->timed[TMD_RAGE]) return true;
 	
-	if (!player_active_ability(p, "Whirlwind Attack")) {
+	if (!player_active_ability(p, PA_WHIRLWIND_ATTACK)) {
 		return false;
 	}
 
@@ -384,7 +384,7 @@ void py_attack_real(struct player *p, struct loc grid, int attack_type)
 	p->attacked = true;
 		
 	/* Determine the number of attacks */
-	if (player_active_ability(p, "Rapid Attack")) {
+	if (player_active_ability(p, PA_RAPID_ATTACK)) {
 		blows++;
 		rapid_attack = true;
 	}
@@ -538,7 +538,7 @@ void py_attack_real(struct player *p, struct loc grid, int attack_type)
 			}
 
 			/* Check whether the effect triggers */
-			if (player_active_ability(p, "Knock Back") &&
+			if (player_active_ability(p, PA_KNOCK_BACK) &&
 				(attack_type != ATT_OPPORTUNIST) &&
 				!rf_has(race->flags, RF_NEVER_MOVE) &&
 			    (skill_check(source_player(), effective_strength * 2,
@@ -731,10 +731,10 @@ int breakage_chance(const struct object *obj, bool hit_wall) {
 			}
 		}
 	} else if (tval_is_ammo(obj)) {
-		if (player_active_ability(player, "Careful Shot")) perc /= 2;
-		if (player_active_ability(player, "Flaming Arrows")) perc = 100;
+		if (player_active_ability(player, PA_CAREFUL_SHOT)) perc /= 2;
+		if (player_active_ability(player, PA_FLAMING_ARROWS)) perc = 100;
 	} else if ((perc != 100) &&
-			   player_active_ability(player, "Throwing Mastery")) {
+			   player_active_ability(player, PA_THROWING_MASTERY)) {
 		perc = 0;
 	}
 
@@ -897,7 +897,7 @@ void attacks_of_opportunity(struct player *p, struct loc safe)
 
         /* 'Point blank archery' avoids attacks of opportunity from the monster
 		 * shot at */
-        if (player_active_ability(p, "Point Blank Archery") &&
+        if (player_active_ability(p, PA_POINT_BLANK_ARCHERY) &&
 			loc_eq(safe, grid)) {
 			continue;
         }
@@ -981,7 +981,7 @@ static struct attack_result make_ranged_shot(struct player *p,
 	slay_bonus_dice += slay_bonus(p, bow, mon, &bow_slay, &bow_brand);
 
 	/* Bonus for flaming arrows */
-	if (player_active_ability(p, "Flaming Arrows")) {
+	if (player_active_ability(p, PA_FLAMING_ARROWS)) {
 		struct monster_lore *lore = get_lore(race);
 
 		/* Notice immunity */
@@ -1079,7 +1079,7 @@ static struct attack_result make_ranged_throw(struct player *p,
 	attack_mod += polearm_bonus(p, obj);
 
 	/* Bonus for throwing proficiency ability */
-	if (player_active_ability(p, "Throwing Mastery")) attack_mod += 5;
+	if (player_active_ability(p, PA_THROWING_MASTERY)) attack_mod += 5;
 
 	/* Determine the player's attack score after all modifiers */
 	total_attack_mod = total_player_attack(p, mon, attack_mod);
@@ -1161,7 +1161,7 @@ static void ranged_helper(struct player *p,	struct object *obj, int dir,
 	bool none_left = false;
 	bool noticed_radiance = false;
 	bool targets_remaining = false;
-	bool rapid_fire = player_active_ability(p, "Rapid Fire");
+	bool rapid_fire = player_active_ability(p, PA_RAPID_FIRE);
 	bool hit_body = false;
 	bool is_potion;
 
@@ -1465,7 +1465,7 @@ static void ranged_helper(struct player *p,	struct object *obj, int dir,
 
 						/* Deal with crippling shot ability */
 						if (archery
-							&& player_active_ability(p, "Crippling Shot")
+							&& player_active_ability(p, PA_CRIPPLING_SHOT)
 							&& (result.crit_dice >= 1) && (result.dmg > 0)
 							&& !rf_has(mon->race->flags, RF_RES_CRIT)) {
 							if (skill_check(source_player(),
@@ -1540,7 +1540,7 @@ static void ranged_helper(struct player *p,	struct object *obj, int dir,
 
     /* Provoke attacks of opportunity */
 	if (archery) {
-		if (player_active_ability(p, "Point Blank Archery")) {
+		if (player_active_ability(p, PA_POINT_BLANK_ARCHERY)) {
 			attacks_of_opportunity(p, first);
 		} else {
 			attacks_of_opportunity(p, loc(0, 0));
@@ -340,7 +340,7 @@ void player_init(struct player *p)
 								  sizeof(struct object *));
 	p->timed = mem_zalloc(TMD_MAX * sizeof(int16_t));
 	p->vaults = mem_zalloc(z_info->v_max * sizeof(int16_t));
-	p->obj_k = mem_zalloc(sizeof(struct object));
+	p->obj_k = object_new();
 	p->obj_k->brands = mem_zalloc(z_info->brand_max * sizeof(bool));
 	p->obj_k->slays = mem_zalloc(z_info->slay_max * sizeof(bool));
 
@@ -916,7 +916,7 @@ void do_cmd_accept_character(struct command *cmd)
 			enum biome_type biome = BIOME_CAVE;
 			y_pos = randint0(MAX_Y_REGION * CPM);
 			x_pos = randint0(MAX_X_REGION * CPM);
-			biome = square_miles[y_pos / CPM][x_pos / CPM].biome;
+			biome = square_mile_biome(loc(x_pos / CPM, y_pos / CPM));
 			ok_start = (biome == BIOME_FOREST) || (biome == BIOME_MOOR) ||
 				(biome == BIOME_PLAIN) || (biome == BIOME_TOWN) ||
 				(biome == BIOME_MOUNTAIN);
@@ -932,9 +932,14 @@ void do_cmd_accept_character(struct command *cmd)
 	//chunk_list[0].y_pos = 4910;
 	//chunk_list[0].x_pos = 3230;
 	chunk_list[0].region = find_region(chunk_list[0].y_pos,chunk_list[0].x_pos);
+	chunk_list_reindex();
 
 	/* No locations generated yet */
 	gen_loc_cnt = 0;
+	gen_loc_list_reindex();
+
+	/* Nothing saved yet to build a savefile journal on */
+	savefile_journal_reset();
 
 	/* Clear old messages, add new starting message */
 	history_clear(player);
@@ -967,6 +972,9 @@ void do_cmd_accept_character(struct command *cmd)
 	seed_flavor = randint0(0x10000000);
 	flavor_init();
 
+	/* Seed for the surface world */
+	seed_world = randint0(0x10000000);
+
 	/* Outfit the player, if they can sell the stuff */
 	player_outfit(player);
 
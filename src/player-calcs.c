@@ -106,7 +106,7 @@ uint8_t total_mds(struct player *p, struct player_state *state,
 		}
 		
 		/* Apply the Momentum ability */
-		if (player_active_ability(p, "Momentum")) {
+		if (player_active_ability(p, PA_MOMENTUM)) {
 			divisor /= 2;
 		}
 
@@ -124,7 +124,7 @@ uint8_t total_mds(struct player *p, struct player_state *state,
 	int_mds += state->to_mds;
 
 	/* Bonus for users of 'mighty blows' ability */
-	if (player_active_ability(p, "Power")) {
+	if (player_active_ability(p, PA_POWER)) {
 		int_mds += 1;
 	}
 
@@ -191,7 +191,7 @@ int axe_bonus(struct player *p, const struct object *obj)
  */
 int polearm_bonus(struct player *p, const struct object *obj)
 {
-	if (player_active_ability(p, "Polearm Mastery") &&
+	if (player_active_ability(p, PA_POLEARM_MASTERY) &&
 		of_has(obj->kind->flags, OF_POLEARM)) {
 		return 1;
 	}
@@ -212,7 +212,7 @@ uint8_t total_ads(struct player *p, struct player_state *state,
 	
 	str_to_ads = state->stat_use[STAT_STR];
 
-	if (player_active_ability(p, "Rapid Fire") && !single_shot) {
+	if (player_active_ability(p, PA_RAPID_FIRE) && !single_shot) {
 		str_to_ads -= 3;
 	}
 
@@ -761,7 +761,7 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	struct song *song;
 
 	/* Remove off-hand weapons if you cannot wield them */
-	if (!player_active_ability(p, "Two Weapon Fighting") &&
+	if (!player_active_ability(p, PA_TWO_WEAPON_FIGHTING) &&
 		off && tval_is_weapon(off)) {
 		msg("You can no longer wield both weapons.");
 		inven_takeoff(off);
@@ -841,7 +841,7 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	}
 
 	/* Parrying grants extra bonus for weapon evasion */
-	if (weapon && player_active_ability(p, "Parry")) {
+	if (weapon && player_active_ability(p, PA_PARRY)) {
 		state->skill_equip_mod[SKILL_EVASION] += weapon->evn;
 	}
 
@@ -859,12 +859,12 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	}
 
 	/* Ability stat boosts */
-	state->stat_misc_mod[STAT_STR] += player_active_ability(p, "Strength");
-	state->stat_misc_mod[STAT_DEX] += player_active_ability(p, "Dexterity");
-	state->stat_misc_mod[STAT_CON] += player_active_ability(p, "Constitution");
-	state->stat_misc_mod[STAT_GRA] += player_active_ability(p, "Grace");
+	state->stat_misc_mod[STAT_STR] += player_ability_count(p, PA_STRENGTH);
+	state->stat_misc_mod[STAT_DEX] += player_ability_count(p, PA_DEXTERITY);
+	state->stat_misc_mod[STAT_CON] += player_ability_count(p, PA_CONSTITUTION);
+	state->stat_misc_mod[STAT_GRA] += player_ability_count(p, PA_GRACE);
 
-	if (player_active_ability(p, "Strength in Adversity")) {
+	if (player_active_ability(p, PA_STRENGTH_IN_ADVERSITY)) {
 		/* If <= 50% health, give a bonus to strength and grace */
 		if (health_level(p->chp, p->mhp) <= HEALTH_BADLY_WOUNDED) {
 			state->stat_misc_mod[STAT_STR]++;
@@ -879,13 +879,13 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	}
 
 	/* Ability skill modifications */
-	if (player_active_ability(p, "Rapid Attack")) {
+	if (player_active_ability(p, PA_RAPID_ATTACK)) {
 		state->skill_misc_mod[SKILL_MELEE] -= 3;
 	}
-	if (player_active_ability(p, "Rapid Fire")) {
+	if (player_active_ability(p, PA_RAPID_FIRE)) {
 		state->skill_misc_mod[SKILL_ARCHERY] -= 3;
 	}
-	if (player_active_ability(p, "Poison Resistance")) {
+	if (player_active_ability(p, PA_POISON_RESISTANCE)) {
 		state->el_info[ELEM_POIS].res_level += 1;
 	}
 
@@ -937,12 +937,12 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	}
 
 	/* Decrease food consumption with 'mind over body' ability */
-	if (player_active_ability(p, "Mind Over Body")) {
+	if (player_active_ability(p, PA_MIND_OVER_BODY)) {
 		state->flags[OF_HUNGER] -= 1;
 	}
 
 	/* Protect from confusion, stunning, hallucinaton with 'clarity' ability */
-	if (player_active_ability(p, "Clarity")) {
+	if (player_active_ability(p, PA_CLARITY)) {
 		state->flags[OF_PROT_CONF] += 1;
 		state->flags[OF_PROT_STUN] += 1;
 		state->flags[OF_PROT_HALLU] += 1;
@@ -1053,7 +1053,7 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	}
 
 	/* Deal with the 'Versatility' ability */
-	if (player_active_ability(p, "Versatility") &&
+	if (player_active_ability(p, PA_VERSATILITY) &&
 		(p->skill_base[SKILL_ARCHERY] > p->skill_base[SKILL_MELEE])) {
 		state->skill_misc_mod[SKILL_MELEE] +=
 			(p->skill_base[SKILL_ARCHERY] - p->skill_base[SKILL_MELEE]) / 2;
@@ -1062,10 +1062,10 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	/* Generate melee dice/sides from weapon, to_mdd, to_mds, strength */
 	state->mdd = total_mdd(p, weapon);
 	state->mds = total_mds(p, state, weapon,
-						   player_active_ability(p, "Rapid Attack") ? -3 : 0);
+						   player_active_ability(p, PA_RAPID_ATTACK) ? -3 : 0);
 
 	/* Determine the off-hand melee score, damage and sides */
-	if (player_active_ability(p, "Two Weapon Fighting") && 
+	if (player_active_ability(p, PA_TWO_WEAPON_FIGHTING) && 
 		off && tval_is_weapon(off)) {
 		/* Remove main-hand specific bonuses */
 		if (weapon) {
@@ -1074,7 +1074,7 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 				+ axe_bonus(p, weapon)
 				+ polearm_bonus(p, weapon);
 		}
-		if (player_active_ability(p, "Rapid Attack")) {
+		if (player_active_ability(p, PA_RAPID_ATTACK)) {
 			state->offhand_mel_mod += 3;
 		}
 
@@ -1123,6 +1123,7 @@ static void update_bonuses(struct player *p)
 	 * Calculate bonuses
 	 * ------------------------------------ */
 
+	player_update_abilities(p);
 	calc_bonuses(p, &state, false, true);
 	calc_bonuses(p, &known_state, true, true);
 
@@ -59,14 +59,14 @@ void drop_iron_crown(struct monster *mon, const char *message)
 		msg(message);
 
 		/* Choose a nearby location, but not his own square */
-		find_nearby_grid(cave, &grid, mon->grid, 1, 1);
+		find_nearby_grid(cave, Rand_ctx, &grid, mon->grid, 1, 1);
 		for (i = 0; i < 1000; i++) {
-			find_nearby_grid(cave, &grid, mon->grid, 1, 1);
+			find_nearby_grid(cave, Rand_ctx, &grid, mon->grid, 1, 1);
 			if (!loc_eq(grid, mon->grid) && square_isfloor(cave, grid)) break;
 		}
 
 		/* Allocate by hand, prep, apply magic */
-		obj = mem_zalloc(sizeof(*obj));
+		obj = object_new();
 		kind = lookup_kind(crown->tval, crown->sval);
 		object_prep(obj, kind, z_info->angband_depth, RANDOMISE);
 		obj->artifact = crown;
@@ -288,7 +288,7 @@ void prise_silmaril(struct player *p)
 	weapon = equipped_item_by_slot_name(p, "weapon");
 
 	/* Undo rapid attack penalties */
-	if (player_active_ability(p, "Rapid Attack")) {
+	if (player_active_ability(p, PA_RAPID_ATTACK)) {
 		/* Undo strength adjustment to the attack */
 		mds = total_mds(p, &p->state, weapon, 0);
 		
@@ -193,19 +193,19 @@ void death_knowledge(struct player *p)
 }
 
 /**
- * Regenerate one turn's worth of hit points
+ * How many hit points the player would regenerate over the next num turns,
+ * before capping at the maximum
  */
-void player_regen_hp(struct player *p)
+int player_regen_hp_amount(struct player *p, int num)
 {
-	int old_chp = p->chp;
 	int regen_multiplier = p->state.flags[OF_REGEN] + 1;
 	int regen_period = z_info->player_regen_period;
 	struct song *este = lookup_song("Este");
 
 	/* Various things interfere with physical healing */
-	if (p->timed[TMD_FOOD] < PY_FOOD_STARVE) return;
-	if (p->timed[TMD_POISONED]) return;
-	if (p->timed[TMD_CUT]) return;
+	if (p->timed[TMD_FOOD] < PY_FOOD_STARVE) return 0;
+	if (p->timed[TMD_POISONED]) return 0;
+	if (p->timed[TMD_CUT]) return 0;
 
 	/* Various things speed up regeneration */
 	if (player_is_singing(p, este)) {
@@ -216,11 +216,21 @@ void player_regen_hp(struct player *p)
 	if (regen_multiplier > 0) {
 		regen_period /= regen_multiplier;
 	} else {
-		return;
+		return 0;
 	}
 
+	return regen_amount_over(p->turn, p->turn + num, p->mhp, regen_period);
+}
+
+/**
+ * Regenerate num turns' worth of hit points
+ */
+void player_regen_hp(struct player *p, int num)
+{
+	int old_chp = p->chp;
+
 	/* Work out how much increase is due */
-	p->chp += regen_amount(p->turn, p->mhp, regen_period);
+	p->chp += player_regen_hp_amount(p, num);
 	p->chp = MIN(p->chp, p->mhp);
 
 	/* Notice changes */
@@ -232,27 +242,37 @@ void player_regen_hp(struct player *p)
 
 
 /**
- * Regenerate one turn's worth of voice
+ * How much voice the player would regenerate over the next num turns, before
+ * capping at the maximum
  */
-void player_regen_mana(struct player *p)
+int player_regen_mana_amount(struct player *p, int num)
 {
-	int old_csp = p->csp;
 	int regen_multiplier = p->state.flags[OF_REGEN] + 1;
 	int regen_period = z_info->player_regen_period;
 
 	/* Don't regenerate voice if singing */
-	if (p->song[SONG_MAIN]) return;
+	if (p->song[SONG_MAIN]) return 0;
 
 	/* Complete healing every z_info->player_regen_period player turns,
 	 * modified */
 	if (regen_multiplier > 0) {
 		regen_period /= regen_multiplier;
 	} else {
-		return;
+		return 0;
 	}
 
+	return regen_amount_over(p->turn, p->turn + num, p->msp, regen_period);
+}
+
+/**
+ * Regenerate num turns' worth of voice
+ */
+void player_regen_mana(struct player *p, int num)
+{
+	int old_csp = p->csp;
+
 	/* Work out how much increase is due */
-	p->csp += regen_amount(p->turn, p->msp, regen_period);
+	p->csp += player_regen_mana_amount(p, num);
 	p->csp = MIN(p->csp, p->msp);
 
 	/* Notice changes */
@@ -264,19 +284,23 @@ void player_regen_mana(struct player *p)
 
 
 /**
- * Digest food.
+ * Digest num turns' worth of food.
  *
  * Speed and regeneration are taken into account already in the hunger rate.
  */
-void player_digest(struct player *p)
+void player_digest(struct player *p, int num)
 {
 	/* Basic digestion rate */
-	int i = 1;
+	int i = num;
 
 	/* Slow hunger rates are done statistically */
 	if (p->state.hunger < 0) {
-		if (!one_in_(int_exp(3, -(p->state.hunger)))) {
-			i = 0;
+		int n;
+
+		for (n = 0, i = 0; n < num; n++) {
+			if (one_in_(int_exp(3, -(p->state.hunger)))) {
+				i++;
+			}
 		}
 	} else if (p->state.hunger > 0) {
 		i *= int_exp(3, p->state.hunger);
@@ -291,7 +315,7 @@ void player_digest(struct player *p)
 	/* Starve to death (slowly) */
 	if (p->timed[TMD_FOOD] < PY_FOOD_STARVE) {
 		/* Take damage */
-		take_hit(p, 1, "starvation");
+		take_hit(p, num, "starvation");
 	}
 }
 
@@ -385,7 +409,7 @@ int player_check_terrain_damage(struct player *p, struct loc grid, bool actual)
 		/* Fire damage */
 		dam_taken = adjust_dam(p, dd, ds, ELEM_FIRE);
 	} else if (square_isswim(cave, grid)) {
-		bool ok = player_active_ability(player, "Swimming") || !!player->boat;
+		bool ok = player_active_ability(player, PA_SWIMMING) || !!player->boat;
 		dam_taken = ok ? 0 : 3;
 	}
 
@@ -542,14 +566,14 @@ void player_flanking_or_retreat(struct player *p, struct loc grid)
 {
 	int d, start;
 	struct monster *mon = target_get_monster();
-	bool flanking = player_active_ability(p, "Flanking");
+	bool flanking = player_active_ability(p, PA_FLANKING);
 	bool controlled_retreat = false;
 
 	/* No attack if player is confused or afraid, or if the truce is in force */
 	if (p->timed[TMD_CONFUSED] || p->timed[TMD_AFRAID] || p->truce) return;
 	
 	/* Need to have the ability, and to have not moved last round */
-	if (player_active_ability(p, "Controlled Retreat") && 
+	if (player_active_ability(p, PA_CONTROLLED_RETREAT) && 
 	    ((p->previous_action[1] > 9) || (p->previous_action[1] == 5))) {
 		controlled_retreat = true;
 	}
@@ -620,8 +644,8 @@ void player_flanking_or_retreat(struct player *p, struct loc grid)
 void player_opportunist_or_zone(struct player *p, struct loc grid1,
 								struct loc grid2, bool opp_only)
 {
-	bool opp = player_active_ability(p, "Opportunist");
-	bool zone = player_active_ability(p, "Zone of Control") && !opp_only;
+	bool opp = player_active_ability(p, PA_OPPORTUNIST);
+	bool zone = player_active_ability(p, PA_ZONE_OF_CONTROL) && !opp_only;
 
 	/* Monster */
 	char m_name[80];
@@ -693,7 +717,7 @@ bool player_can_leap(struct player *p, struct loc grid, int dir)
 
 	if (p->timed[TMD_CONFUSED]) return false;
 	if (!square_isleapable(cave, grid)) return false;
-	if (!player_active_ability(p, "Leaping")) return false;
+	if (!player_active_ability(p, PA_LEAPING)) return false;
 
 	/* Test all three directions roughly towards the chasm/pit */
 	for (i = -1; i <= 1; i++) {
@@ -815,7 +839,7 @@ void player_dismount(struct player *p)
 	}
 
 	/* No longer riding */
-	p->mount = NULL;
+	player_set_mount(p, NULL);
 
 	/* Jump off */
 	monster_swap(p->grid, grid);
@@ -824,6 +848,21 @@ void player_dismount(struct player *p)
 	square_set_mon(cave, mon->grid, mon->midx);
 }
 
+/**
+ * Set the monster the player is riding, or none.  Ridden monsters gain no
+ * energy of their own, so the monsters' turns are rescheduled.
+ */
+void player_set_mount(struct player *p, struct monster *mon)
+{
+	struct monster *old = p->mount;
+
+	if (old) monster_energy_sync(old);
+	if (mon) monster_energy_sync(mon);
+	p->mount = mon;
+	if (old) monster_reschedule(old);
+	if (mon) monster_reschedule(mon);
+}
+
 /**
  * True if the player is riding a horse
  */
@@ -874,9 +913,9 @@ bool player_is_boating(struct player *p)
  */
 bool player_can_craft(struct player *p)
 {
-	bool wood = player_active_ability(p, "Woodcraft");
-	bool leather = player_active_ability(p, "Leatherwork");
-	bool boat = player_active_ability(p, "Boat Building");
+	bool wood = player_active_ability(p, PA_WOODCRAFT);
+	bool leather = player_active_ability(p, PA_LEATHERWORK);
+	bool boat = player_active_ability(p, PA_BOAT_BUILDING);
 	if (!(wood || leather || boat)) return false;
 	if (square_isdamaging(cave, p->grid)) return false;
 	if (player_is_riding(p)) return false;
@@ -890,7 +929,7 @@ bool player_can_craft(struct player *p)
 void player_catch_fish(struct player *p)
 {
 	/* Make a fish by hand */
-	struct object *obj = mem_zalloc(sizeof(*obj));
+	struct object *obj = object_new();
 	int sval = lookup_sval(TV_FOOD, "Raw Fish");
 	struct object_kind *kind = lookup_kind(TV_FOOD, sval);
 	object_prep(obj, kind, player_danger_level(p), RANDOMISE);
@@ -971,7 +1010,7 @@ bool player_leave_deep_water(struct player *p, struct loc grid)
 	int score = MAX(p->state.stat_use[STAT_STR] * 2, 0);
 
 	/* Swimmers or those in boats are fine */
-	if (player_active_ability(p, "Swimming")) return true;
+	if (player_active_ability(p, PA_SWIMMING)) return true;
 	if (player_is_boating(p)) return true;
 
 	/* Disturb the player */
@@ -1006,7 +1045,7 @@ bool player_leave_deep_water(struct player *p, struct loc grid)
 void player_blast_ceiling(struct player *p)
 {
 	int will = p->state.skill_use[SKILL_WILL];
-	if (player_active_ability(p, "Channeling")) {
+	if (player_active_ability(p, PA_CHANNELING)) {
 		will += 5;
 	}
 
@@ -1081,7 +1120,7 @@ bool player_can_fall_through_floor(struct player *p)
 void player_blast_floor(struct player *p)
 {
 	int will = p->state.skill_use[SKILL_WILL];
-	if (player_active_ability(p, "Channeling")) {
+	if (player_active_ability(p, PA_CHANNELING)) {
 		will += 5;
 	}
 
@@ -1146,7 +1185,7 @@ bool player_action_is_movement(struct player *p, int n)
  */
 int player_dodging_bonus(struct player *p)
 {
-	if (player_active_ability(p, "Dodging") && player_action_is_movement(p, 0)){
+	if (player_active_ability(p, PA_DODGING) && player_action_is_movement(p, 0)){
 		return 3;
 	} else {
 		return 0;
@@ -1161,7 +1200,7 @@ bool player_can_riposte(struct player *p, int hit_result)
 {
 	struct object *weapon = equipped_item_by_slot_name(p, "weapon");
 
-	return (weapon && player_active_ability(p, "Riposte") &&
+	return (weapon && player_active_ability(p, PA_RIPOSTE) &&
 			!p->upkeep->riposte &&
 			!p->timed[TMD_AFRAID] &&
 			!p->timed[TMD_CONFUSED] &&
@@ -1178,7 +1217,7 @@ bool player_is_sprinting(struct player *p)
 	int i;
 	int turns = 1;
 
-	if (player_active_ability(p, "Sprinting")) {
+	if (player_active_ability(p, PA_SPRINTING)) {
 		for (i = 1; i < 4; i++) {
 			if (player_action_is_movement(p, i) &&
 				player_action_is_movement(p, i + 1)) {
@@ -1588,6 +1627,27 @@ void player_resting_step_turn(struct player *p)
 	player_turns_rested++;
 }
 
+/**
+ * Do the bookkeeping of resting for a number of turns passed over at once,
+ * as for player_resting_step_turn() but without searching; only for
+ * conditional resting, which has no count to reduce.
+ */
+void player_resting_skip_turns(struct player *p, int num)
+{
+	int i;
+
+	/* Every action passed over was a rest */
+	for (i = MAX_ACTION - 1; i >= 0; i--) {
+		p->previous_action[i] = (i >= num) ? p->previous_action[i - num] :
+			ACTION_STAND;
+	}
+	p->focused = true;
+
+	/* Increment the resting counters */
+	p->resting_turn += num;
+	player_turns_rested += num;
+}
+
 /**
  * Handle the conditions for conditional resting (resting with the REST_
  * constants).
@@ -1705,7 +1765,7 @@ void player_handle_post_move(struct player *p, bool eval_trap,
 		assert(square_iswater(cave, p->grid));
 		if (p->mount) {
 			square_set_mon(cave, p->mount->grid, p->mount->midx);
-			p->mount = NULL;
+			player_set_mount(p, NULL);
 		}
 	}
 
@@ -1866,7 +1926,7 @@ static void search_square(struct player *p, struct loc grid, int dist,
 		if (searching) score += 5;
 
 		/* Eye for Detail ability */
-		if (player_active_ability(p, "Eye for Detail")) score += 5;
+		if (player_active_ability(p, PA_EYE_FOR_DETAIL)) score += 5;
 
 		/* Determine the base difficulty */
 		if (obj) {
@@ -1920,7 +1980,7 @@ static void search_square(struct player *p, struct loc grid, int dist,
 			/* Secret doors */
 			if (square_issecretdoor(cave, grid)) {
 				msg("You have found a secret door.");
-				place_closed_door(cave, grid);
+				place_closed_door(cave, Rand_ctx, grid);
 				disturb(p, false);
 			}
 
@@ -1954,6 +2014,27 @@ void search(struct player *p)
 	perceive(p);
 }
 
+/**
+ * Whether there is anything hidden near enough to the player to be noticed
+ * by searching
+ */
+bool player_near_hidden(struct player *p)
+{
+	struct loc grid;
+
+	for (grid.y = (p->grid.y - 4); grid.y <= (p->grid.y + 4); grid.y++) {
+		for (grid.x = (p->grid.x - 4); grid.x <= (p->grid.x + 4); grid.x++) {
+			if (!square_in_bounds(cave, grid)) continue;
+			if (chest_check(p, grid, CHEST_TRAPPED) ||
+				square_issecrettrap(cave, grid) ||
+				square_issecretdoor(cave, grid)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 /**
  * Maybe notice hidden things nearby
  */
@@ -75,10 +75,12 @@ uint8_t player_danger_level(struct player *p);
 void take_hit(struct player *p, int dam, const char *kb_str);
 void death_knowledge(struct player *p);
 int energy_per_move(struct player *p);
-void player_regen_hp(struct player *p);
-void player_regen_mana(struct player *p);
+int player_regen_hp_amount(struct player *p, int num);
+void player_regen_hp(struct player *p, int num);
+int player_regen_mana_amount(struct player *p, int num);
+void player_regen_mana(struct player *p, int num);
 void convert_mana_to_hp(struct player *p, int32_t sp);
-void player_digest(struct player *p);
+void player_digest(struct player *p, int num);
 void player_update_light(struct player *p);
 struct object *player_best_digger(struct player *p, bool forbid_stack);
 int player_check_terrain_damage(struct player *p, struct loc grid, bool actual);
@@ -95,6 +97,7 @@ void player_polearm_passive_attack(struct player *p, struct loc grid_from,
 bool player_can_leap(struct player *p, struct loc grid, int dir);
 void player_mount(struct player *p, struct monster *mon, int dir);
 void player_dismount(struct player *p);
+void player_set_mount(struct player *p, struct monster *mon);
 bool player_is_riding(struct player *p);
 void player_disembark(struct player *p);
 bool player_is_boating(struct player *p);
@@ -133,6 +136,7 @@ void player_resting_set_count(struct player *p, int16_t count);
 void player_resting_cancel(struct player *p, bool disturb);
 bool player_resting_can_regenerate(const struct player *p);
 void player_resting_step_turn(struct player *p);
+void player_resting_skip_turns(struct player *p, int num);
 void player_resting_complete_special(struct player *p);
 int player_get_resting_repeat_count(struct player *p);
 void player_set_resting_repeat_count(struct player *p, int16_t count);
@@ -142,6 +146,7 @@ void player_handle_post_move(struct player *p, bool eval_trap,
 							 bool is_involuntary);
 void disturb(struct player *p, bool stop_stealth);
 void search(struct player *p);
+bool player_near_hidden(struct player *p);
 void perceive(struct player *p);
 
 #endif /* !PLAYER_UTIL_H */
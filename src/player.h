@@ -96,6 +96,23 @@ enum
 #define pf_inter(f1, f2)       flag_inter(f1, f2, PF_SIZE)
 #define pf_diff(f1, f2)        flag_diff(f1, f2, PF_SIZE)
 
+/**
+ * Player abilities the game code refers to
+ */
+enum
+{
+	#define PA(a, b) PA_##a,
+	#include "list-abilities.h"
+	#undef PA
+	PA_MAX
+};
+
+#define PA_SIZE                FLAG_SIZE(PA_MAX)
+
+#define pa_has(f, flag)        flag_has_dbg(f, PA_SIZE, flag, #f, #flag)
+#define pa_on(f, flag)         flag_on_dbg(f, PA_SIZE, flag, #f, #flag)
+#define pa_wipe(f)             flag_wipe(f, PA_SIZE)
+
 /**
  * The range of possible indexes into tables based upon stats.
  * Currently things range from 3 to 18/220 = 40.
@@ -199,6 +216,7 @@ struct song {
 	char *msg;
 	struct alt_song_desc *alt_desc;
 	int index;
+	int ability;		/* PA_ index of the ability to sing it, if any */
 	int bonus_mult;
 	int bonus_div;
 	int bonus_min;
@@ -532,6 +550,7 @@ struct player {
 
 	struct ability *abilities;		/* Player innate abilities */
 	struct ability *item_abilities;	/* Player item abilities */
+	bitflag active_abilities[PA_SIZE];	/* Active innate or item abilities */
 
 	bitflag languages[LANGUAGE_SIZE];	/* Languages known */
 
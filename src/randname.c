@@ -195,7 +195,7 @@ int main(int argc, char *argv[])
 	int i;
 	char name[256];
 
-	Rand_value = time(NULL);
+	Rand_game.value = time(NULL);
 
 	for (i = 0; i < 20; i++) {
 		randname_make(RANDNAME_TOLKIEN, 5, 9, name, 256, name_sections);
@@ -19,10 +19,12 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-group.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "object.h"
 #include "obj-desc.h"
@@ -42,6 +44,10 @@
 #include "trap.h"
 #include "ui-term.h"
 
+/**
+ * Size of the buffer used to gather run length encoded data for writing
+ */
+#define RUN_BUFFER_SIZE 512
 
 /**
  * Write a description of the character
@@ -212,6 +218,7 @@ static void wr_monster(const struct monster *mon)
 	size_t j;
 	struct object *obj = mon->held_obj; 
 	struct object *dummy = object_new();
+	bitflag mflag[MFLAG_SIZE];
 
 	wr_u16b(mon->midx);
 	wr_string(mon->race->name);
@@ -229,7 +236,7 @@ static void wr_monster(const struct monster *mon)
 	wr_byte(mon->song ? mon->song->index : 0);
 	wr_s16b(mon->alertness);
 	wr_byte(mon->mspeed);
-	wr_byte(mon->energy);
+	wr_byte(monster_energy(mon));
 	wr_byte(mon->origin);
 	wr_byte(mon->stance);
 	wr_s16b(mon->morale);
@@ -241,8 +248,11 @@ static void wr_monster(const struct monster *mon)
 	for (j = 0; j < MON_TMD_MAX; j++)
 		wr_s16b(mon->m_timed[j]);
 
+	/* Mark monsters which have been processed this turn */
+	mflag_copy(mflag, mon->mflag);
+	if (monster_handled(mon)) mflag_on(mflag, MFLAG_HANDLED);
 	for (j = 0; j < MFLAG_SIZE; j++)
-		wr_byte(mon->mflag[j]);
+		wr_byte(mflag[j]);
 
 	for (j = 0; j < OF_SIZE; j++)
 		wr_s16b(mon->known_pstate.flags[j]);
@@ -306,10 +316,10 @@ void wr_randomizer(void)
 	int i;
 
 	/* current value for the simple RNG */
-	wr_u32b(Rand_value);
+	wr_u32b(Rand_game.value);
 
 	/* state index */
-	wr_u32b(state_i);
+	wr_u32b(Rand_game.state_i);
 
 	/* NULL padding for backwards compatibility with previous versions */
 	wr_u32b(0);
@@ -318,7 +328,7 @@ void wr_randomizer(void)
 
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
-		wr_u32b(STATE[i]);
+		wr_u32b(Rand_game.state[i]);
 
 	/* NULL padding */
 	for (i = 0; i < 59 - RAND_DEG; i++)
@@ -664,6 +674,9 @@ void wr_misc(void)
 	/* Write the "object seeds" */
 	wr_u32b(seed_flavor);
 
+	/* Write the world seed */
+	wr_u32b(seed_world);
+
 	/* Special stuff */
 	wr_u16b(player->noscore);
 
@@ -756,6 +769,20 @@ void wr_gear(void)
 
 
 
+/**
+ * Add a count and value pair to a buffer of runs, writing the buffer out when
+ * it is full
+ */
+static void wr_run(uint8_t *runs, size_t *len, uint8_t count, uint8_t value)
+{
+	runs[(*len)++] = count;
+	runs[(*len)++] = value;
+	if (*len == RUN_BUFFER_SIZE) {
+		wr_bytes(runs, *len);
+		*len = 0;
+	}
+}
+
 /**
  * Write the current dungeon terrain features and info flags
  *
@@ -771,6 +798,9 @@ static void wr_dungeon_aux(struct chunk *c)
 	uint8_t count;
 	uint8_t prev_char;
 
+	uint8_t runs[RUN_BUFFER_SIZE];
+	size_t len = 0;
+
 	/* Dungeon specific info follows */
 	wr_string(c->name ? c->name : "Blank");
 	wr_u16b(c->height);
@@ -795,8 +825,7 @@ static void wr_dungeon_aux(struct chunk *c)
 
 				/* If the run is broken, or too full, flush it */
 				if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-					wr_byte(count);
-					wr_byte(prev_char);
+					wr_run(runs, &len, count, prev_char);
 					prev_char = tmp8u;
 					count = 1;
 				} else /* Continue the run */
@@ -806,8 +835,7 @@ static void wr_dungeon_aux(struct chunk *c)
 
 		/* Flush the data (if any) */
 		if (count) {
-			wr_byte(count);
-			wr_byte(prev_char);
+			wr_run(runs, &len, count, prev_char);
 		}
 	}
 
@@ -823,8 +851,7 @@ static void wr_dungeon_aux(struct chunk *c)
 
 			/* If the run is broken, or too full, flush it */
 			if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
-				wr_byte(count);
-				wr_byte(prev_char);
+				wr_run(runs, &len, count, prev_char);
 				prev_char = tmp8u;
 				count = 1;
 			} else /* Continue the run */
@@ -834,9 +861,9 @@ static void wr_dungeon_aux(struct chunk *c)
 
 	/* Flush the data (if any) */
 	if (count) {
-		wr_byte(count);
-		wr_byte(prev_char);
+		wr_run(runs, &len, count, prev_char);
 	}
+	wr_bytes(runs, len);
 }
 
 /**
@@ -940,12 +967,85 @@ void wr_traps(void)
 	wr_traps_aux(player->cave);
 }
 
+/**
+ * Write the details of a chunk_list entry
+ */
+static void wr_chunk_ref(const struct chunk_ref *ref)
+{
+	int i;
+
+	wr_s32b(ref->turn);
+	wr_u16b(ref->region);
+	wr_s16b(ref->z_pos);
+	wr_u16b(ref->y_pos);
+	wr_u16b(ref->x_pos);
+	wr_u32b(ref->gen_loc_idx);
+	for (i = 0; i < 11; i++)
+		wr_u16b(ref->adjacent[i]);
+}
+
+/**
+ * Get the chunk_list entry to write to the savefile; chunks generated ahead
+ * of the player are left out, as unused entries, and will simply be generated
+ * again when needed
+ */
+static const struct chunk_ref *chunk_saved_ref(int idx)
+{
+	static const struct chunk_ref unused = { 0 };
+
+	return chunk_is_staged(idx) ? &unused : &chunk_list[idx];
+}
+
+/**
+ * Whether a chunk_list entry has stored chunks which go in the savefile
+ */
+static bool chunk_is_saved(int idx)
+{
+	const struct chunk_ref *ref = &chunk_list[idx];
+
+	if (ref->chunk && !chunk_is_staged(idx)) {
+		assert(ref->p_chunk);
+		return true;
+	}
+	assert(ref->chunk || (ref->p_chunk == NULL));
+	return false;
+}
+
+/**
+ * Write the stored chunks of a chunk_list entry
+ */
+static void wr_chunk_data(const struct chunk_ref *ref)
+{
+	struct chunk *c = ref->chunk;
+	struct chunk *p_c = ref->p_chunk;
+	int i;
+
+	/* Write the terrain and info */
+	wr_dungeon_aux(c);
+	wr_dungeon_aux(p_c);
+
+	/* Write the objects */
+	wr_objects_aux(c);
+	wr_objects_aux(p_c);
+
+	/* Write the traps */
+	wr_traps_aux(c);
+	wr_traps_aux(p_c);
+
+	/* Write other chunk info */
+	wr_u16b(c->height);
+	wr_u16b(c->width);
+	for (i = 0; i < FEAT_MAX + 1; i++) {
+		wr_u16b(c->feat_count[i]);
+	}
+}
+
 /*
  * Write the chunk list
  */
 void wr_chunks(void)
 {
-	int i, j;
+	int j;
 
 	if (player->is_dead)
 		return;
@@ -956,48 +1056,43 @@ void wr_chunks(void)
 	/* Now write each chunk */
 	for (j = 0; j < chunk_max; j++) {
 		struct chunk_ref *ref = &chunk_list[j];
-		struct chunk *c = ref->chunk;
-		struct chunk *p_c = ref->p_chunk;
-		uint8_t tmp8u;
-
-		wr_s32b(ref->turn);
-		wr_u16b(ref->region);
-		wr_s16b(ref->z_pos);
-		wr_u16b(ref->y_pos);
-		wr_u16b(ref->x_pos);
-		wr_u32b(ref->gen_loc_idx);
-		for (i = 0; i < 11; i++)
-			wr_u16b(ref->adjacent[i]);
-
-		/* Skip dead chunks */
-		if (c) {
-			assert(p_c);
-			tmp8u = 1;
-		} else {
-			assert(p_c == NULL);
-			tmp8u = 0;
-		}
+		bool saved = chunk_is_saved(j);
 
-		wr_byte(tmp8u);
-		if (!c)	continue;
+		wr_chunk_ref(chunk_saved_ref(j));
+		wr_byte(saved ? 1 : 0);
+
+		/* The savefile now has the stored chunks, unless they were skipped */
+		ref->dirty = ref->chunk && !saved;
+		if (saved) wr_chunk_data(ref);
+	}
+}
+
+/*
+ * Write the chunk list for a savefile journal; only stored chunks which have
+ * changed since the last full save are written, the rest being marked as
+ * the same as in that save
+ */
+void wr_chunk_changes(void)
+{
+	int j;
 
-		/* Write the terrain and info */
-		wr_dungeon_aux(c);
-		wr_dungeon_aux(p_c);
+	if (player->is_dead)
+		return;
 
-		/* Write the objects */
-		wr_objects_aux(c);
-		wr_objects_aux(p_c);
+	wr_u16b(chunk_max);
+	wr_u16b(chunk_cnt);
 
-		/* Write the traps */
-		wr_traps_aux(c);
-		wr_traps_aux(p_c);
+	for (j = 0; j < chunk_max; j++) {
+		struct chunk_ref *ref = &chunk_list[j];
 
-		/* Write other chunk info */
-		wr_u16b(c->height);
-		wr_u16b(c->width);
-		for (i = 0; i < FEAT_MAX + 1; i++) {
-			wr_u16b(c->feat_count[i]);
+		wr_chunk_ref(chunk_saved_ref(j));
+		if (!chunk_is_saved(j)) {
+			wr_byte(0);
+		} else if (ref->dirty) {
+			wr_byte(1);
+			wr_chunk_data(ref);
+		} else {
+			wr_byte(2);
 		}
 	}
 }
@@ -1012,15 +1107,72 @@ void wr_monsters(void)
 	/* Total monsters */
 	wr_u16b(mon_max);
 
-	/* Dump the monsters */
+	/* Dump the monsters, with the regeneration they are owed */
 	for (i = 1; i < mon_max; i++) {
+		monster_energy_sync(monster(i));
 		wr_monster(monster(i));
 	}
 }
 
+/**
+ * Write a generated location
+ */
+static void wr_location(const struct gen_loc *location)
+{
+	int num_changes = 0, num_joins = 0;
+	struct terrain_change *change;
+	struct connector *join;
+	struct river_piece *river = location->river_piece;
+	struct river_grid *rgrid;
+
+	wr_u16b(location->x_pos);
+	wr_u16b(location->y_pos);
+	wr_u16b(location->z_pos);
+	wr_u32b(location->seed);
+
+	/* Count the terrain changes */
+	for (change = location->change; change; change = change->next) {
+		num_changes++;
+	}
+
+	/* Write the terrain changes */
+	wr_u16b(num_changes);
+	for (change = location->change; change; change = change->next) {
+		uint8_t bytes[3] = { change->grid.y, change->grid.x, change->feat };
+		wr_bytes(bytes, 3);
+	}
+
+	/* Count the joins */
+	for (join = location->join; join; join = join->next) {
+		num_joins++;
+	}
+
+	/* Write the edge effects */
+	wr_u16b(num_joins);
+	for (join = location->join; join; join = join->next) {
+		wr_byte(join->grid.y);
+		wr_byte(join->grid.x);
+		wr_byte(join->feat);
+		wr_bytes(join->info, SQUARE_SIZE);
+	}
+
+	/* Count the river grids, if any */
+	if (river) {
+		/* Write the river grids and direction */
+		wr_u16b(river->num_grids);
+		for (rgrid = river->grids; rgrid; rgrid = rgrid->next) {
+			uint8_t bytes[2] = { rgrid->grid.y, rgrid->grid.x };
+			wr_bytes(bytes, 2);
+		}
+		wr_byte(river->dir);
+	} else {
+		wr_u16b(0);
+	}
+}
+
 void wr_locations(void)
 {
-	size_t i, j;
+	size_t i;
 
 	if (player->is_dead)
 		return;
@@ -1029,58 +1181,35 @@ void wr_locations(void)
 	wr_u32b(gen_loc_cnt);
 
 	for (i = 0; i < gen_loc_cnt; i++) {
-		struct gen_loc *location = &gen_loc_list[i];
-		int num_changes = 0, num_joins = 0;
-		struct terrain_change *change;
-		struct connector *join;
-		struct river_piece *river = location->river_piece;
-		struct river_grid *rgrid;
-
-		wr_u16b(location->x_pos);
-		wr_u16b(location->y_pos);
-		wr_u16b(location->z_pos);
-		wr_u32b(location->seed);
-
-		/* Count the terrain changes */
-		for (change = location->change; change; change = change->next) {
-			num_changes++;
-		}
+		wr_location(&gen_loc_list[i]);
+		gen_loc_list[i].dirty = false;
+	}
+}
 
-		/* Write the terrain changes */
-		wr_u16b(num_changes);
-		for (change = location->change; change; change = change->next) {
-			wr_byte(change->grid.y);
-			wr_byte(change->grid.x);
-			wr_byte(change->feat);
-		}
+/*
+ * Write the generated locations list for a savefile journal; only locations
+ * which are new or changed since the last full save are written, with their
+ * indices
+ */
+void wr_location_changes(void)
+{
+	size_t i;
+	uint32_t num_dirty = 0;
 
-		/* Count the joins */
-		for (join = location->join; join; join = join->next) {
-			num_joins++;
-		}
+	if (player->is_dead)
+		return;
 
-		/* Write the edge effects */
-		wr_u16b(num_joins);
-		for (join = location->join; join; join = join->next) {
-			wr_byte(join->grid.y);
-			wr_byte(join->grid.x);
-			wr_byte(join->feat);
-			for (j = 0; j < SQUARE_SIZE; j++)
-				wr_byte(join->info[j]);
-		}
+	wr_byte(SQUARE_SIZE);
+	wr_u32b(gen_loc_cnt);
 
-		/* Count the river grids, if any */
-		if (river) {
-			/* Write the river grids and direction */
-			wr_u16b(river->num_grids);
-			for (rgrid = river->grids; rgrid; rgrid = rgrid->next) {
-				wr_byte(rgrid->grid.y);
-				wr_byte(rgrid->grid.x);
-			}
-			wr_byte(river->dir);
-		} else {
-			wr_u16b(0);
-		}
+	for (i = 0; i < gen_loc_cnt; i++) {
+		if (gen_loc_list[i].dirty) num_dirty++;
+	}
+	wr_u32b(num_dirty);
+	for (i = 0; i < gen_loc_cnt; i++) {
+		if (!gen_loc_list[i].dirty) continue;
+		wr_u32b((uint32_t) i);
+		wr_location(&gen_loc_list[i]);
 	}
 }
 
@@ -1116,8 +1245,8 @@ void wr_monster_groups(void)
 		if (monster_groups[i]) {
 			struct monster_group *group = monster_groups[i];
 			wr_u16b(i);
-			wr_byte(group->flow.centre.x);
-			wr_byte(group->flow.centre.y);
+			wr_byte(group->centre.x);
+			wr_byte(group->centre.y);
 			wr_s16b(group->wandering_pause);
 		}
 	}
@@ -21,6 +21,16 @@
 #include "init.h"
 #include "savefile.h"
 #include "save-charoutput.h"
+#include "z-compress.h"
+
+/**
+ * Write autosaves on a thread of their own where there are threads.  Not when
+ * running setgid, as the permissions are for the whole process.
+ */
+#if defined(HAVE_PTHREAD) && !defined(SETGID)
+#define SAVE_IN_BACKGROUND
+#include <pthread.h>
+#endif
 
 /**
  * The savefile code.
@@ -37,6 +47,26 @@
  * ... data ...
  * padding so that block is a multiple of 4 bytes
  *
+ * Large blocks are compressed when that makes them smaller.  The top bit of
+ * the version is then set, the size is that of the compressed data, and the
+ * data is the 4-byte uncompressed size followed by the output of
+ * lz_compress(); the checksum is still that of the uncompressed data.
+ *
+ * Autosaves write a journal alongside the savefile rather than the whole
+ * savefile again.  The journal has the same layout, but in place of the
+ * chunk list and generated locations it has only those which have changed
+ * since the last full save, so loading it means reading those blocks from
+ * the savefile first.  Both files start with a "generation" block naming the
+ * full save, so a journal left over from an earlier one is ignored.  Every
+ * so often, and whenever the game is saved by hand, the full savefile is
+ * written again and the journal removed.
+ *
+ * Each block is written to a buffer of its own, so that once they are all
+ * written the file can be put together and written out on another thread
+ * while the game carries on.  The generation is worked out from the contents
+ * of the other blocks at that point, so the same game always gives the same
+ * savefile however it is written.
+ *
  * The savefile deosn't contain the version number of that game that saved it;
  * versioning is left at the individual block level.  The current code
  * keeps a list of savefile blocks to save in savers[] below, along with
@@ -87,6 +117,7 @@ struct blockheader {
 	char name[16];
 	uint32_t version;
 	uint32_t size;
+	bool compressed;
 };
 
 struct blockinfo {
@@ -95,15 +126,21 @@ struct blockinfo {
 	uint32_t version;
 };
 
-/**
- * Savefile saving functions
- */
-static const struct {
+struct blocksaver {
 	char name[16];
 	void (*save)(void);
 	uint32_t version;
-} savers[] = {
+};
+
+static void wr_generation(void);
+static int rd_generation(void);
+
+/**
+ * Savefile saving functions
+ */
+static const struct blocksaver savers[] = {
 	{ "description", wr_description, 1 },
+	{ "generation", wr_generation, 1 },
 	{ "rng", wr_randomizer, 1 },
 	{ "options", wr_options, 1 },
 	{ "messages", wr_messages, 1 },
@@ -111,7 +148,7 @@ static const struct {
 	{ "object memory", wr_object_memory, 1 },
 	{ "player", wr_player, 1 },
 	{ "ignore", wr_ignore, 1 },
-	{ "misc", wr_misc, 1 },
+	{ "misc", wr_misc, 2 },
 	{ "artifacts", wr_artifacts, 1 },
 	{ "gear", wr_gear, 1 },
 	{ "dungeon", wr_dungeon, 1 },
@@ -124,11 +161,39 @@ static const struct {
 	{ "monster groups", wr_monster_groups, 1 },
 };
 
+/**
+ * Savefile journal saving functions; these must line up with savers[], so
+ * that a block here with a different name holds the changes to that block
+ */
+static const struct blocksaver journal_savers[] = {
+	{ "description", wr_description, 1 },
+	{ "generation", wr_generation, 1 },
+	{ "rng", wr_randomizer, 1 },
+	{ "options", wr_options, 1 },
+	{ "messages", wr_messages, 1 },
+	{ "monster memory", wr_monster_memory, 1 },
+	{ "object memory", wr_object_memory, 1 },
+	{ "player", wr_player, 1 },
+	{ "ignore", wr_ignore, 1 },
+	{ "misc", wr_misc, 2 },
+	{ "artifacts", wr_artifacts, 1 },
+	{ "gear", wr_gear, 1 },
+	{ "dungeon", wr_dungeon, 1 },
+	{ "objects", wr_objects, 1 },
+	{ "traps", wr_traps, 1 },
+	{ "chunk deltas", wr_chunk_changes, 1 },
+	{ "monsters", wr_monsters, 1 },
+	{ "location deltas", wr_location_changes, 1 },
+	{ "history", wr_history, 1 },
+	{ "monster groups", wr_monster_groups, 1 },
+};
+
 /**
  * Savefile loading functions
  */
 static const struct blockinfo loaders[] = {
 	{ "description", rd_null, 1 },
+	{ "generation", rd_generation, 1 },
 	{ "rng", rd_randomizer, 1 },
 	{ "options", rd_options, 1 },
 	{ "messages", rd_messages, 1 },
@@ -136,17 +201,21 @@ static const struct blockinfo loaders[] = {
 	{ "object memory", rd_object_memory, 1 },
 	{ "player", rd_player, 1 },
 	{ "ignore", rd_ignore, 1 },
-	{ "misc", rd_misc, 1 },
+	{ "misc", rd_misc_1, 1 },
+	{ "misc", rd_misc, 2 },
 	{ "artifacts", rd_artifacts, 1 },
 	{ "gear", rd_gear, 1 },	
 	{ "dungeon", rd_dungeon, 1 },
 	{ "objects", rd_objects, 1 },	
 	{ "traps", rd_traps, 1 },
 	{ "chunks", rd_chunks, 1 },
+	{ "chunk deltas", rd_chunk_changes, 1 },
 	{ "monsters", rd_monsters, 1 },
 	{ "locations", rd_locations, 1 },
+	{ "location deltas", rd_location_changes, 1 },
 	{ "history", rd_history, 1 },
 	{ "monster groups", rd_monster_groups, 1 },
+	{ "", NULL, 0 }
 };
 
 
@@ -156,11 +225,43 @@ static uint32_t buffer_size;
 static uint32_t buffer_pos;
 static uint32_t buffer_check;
 
+/* Size of each block at the last save, used to size the buffer next time */
+static uint32_t block_size_hint[N_ELEMENTS(savers)];
+static uint32_t journal_size_hint[N_ELEMENTS(journal_savers)];
+
+/* The full savefile the journal is kept for; empty if there isn't one */
+static char journal_base[1024];
+
+/* The generation of that savefile, and the number of journals made since */
+static uint32_t journal_generation;
+static uint32_t journal_saves;
+
+/* Sizes of that savefile and the last journal */
+static size_t journal_base_bytes;
+static size_t journal_bytes;
+
 #define BUFFER_INITIAL_SIZE		1024
-#define BUFFER_BLOCK_INCREMENT	1024
+
+/**
+ * Blocks at least this big are compressed if that makes them smaller.  A
+ * compressed block has this bit set in its version, and its data starts with
+ * the uncompressed size.
+ */
+#define BLOCK_COMPRESS_MIN		4096
+#define BLOCK_COMPRESSED		0x80000000U
+
+/* No uncompressed block is allowed to claim to be bigger than this */
+#define BLOCK_MAX_SIZE			0x40000000U
 
 #define SAVEFILE_HEAD_SIZE		28
 
+/**
+ * The full savefile is written again once the journal has been written this
+ * many times, or is more than half its size
+ */
+#define JOURNAL_MAX_SAVES		20
+#define JOURNAL_MAX_FRACTION	2
+
 
 /**
  * ------------------------------------------------------------------------
@@ -182,16 +283,61 @@ void note(const char *message)
  * Base put/get
  * ------------------------------------------------------------------------ */
 
-static void sf_put(uint8_t v)
+/**
+ * Make sure there is room in the buffer for n more bytes, doubling its size
+ * as often as needed
+ */
+static void sf_reserve(uint32_t n)
 {
+	uint32_t size = buffer_size;
+
 	assert(buffer != NULL);
 	assert(buffer_size > 0);
 
-	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
+	while (size - buffer_pos < n) {
+		size *= 2;
+	}
+	if (size != buffer_size) {
+		buffer_size = size;
 		buffer = mem_realloc(buffer, buffer_size);
 	}
+}
+
+/**
+ * Add a run of bytes to the checksum.
+ *
+ * The bytes are summed eight at a time, in four 16-bit lanes of a 64-bit
+ * word; 128 words is as many as the lanes can hold before they are folded.
+ */
+static void sf_check(const uint8_t *bytes, size_t n)
+{
+	const uint64_t mask = 0x00FF00FF00FF00FFULL;
+
+	while (n >= 8) {
+		size_t words = MIN(n / 8, 128);
+		uint64_t lanes = 0;
+
+		n -= words * 8;
+		while (words--) {
+			uint64_t word;
+			memcpy(&word, bytes, 8);
+			lanes += (word & mask) + ((word >> 8) & mask);
+			bytes += 8;
+		}
+		lanes = (lanes & 0x0000FFFF0000FFFFULL) +
+			((lanes >> 16) & 0x0000FFFF0000FFFFULL);
+		buffer_check += (uint32_t) lanes + (uint32_t) (lanes >> 32);
+	}
+	while (n--) {
+		buffer_check += *bytes++;
+	}
+}
+
+static void sf_put(uint8_t v)
+{
+	if (buffer_size == buffer_pos) {
+		sf_reserve(1);
+	}
 
 	assert(buffer_pos < buffer_size);
 
@@ -222,8 +368,9 @@ void wr_byte(uint8_t v)
 
 void wr_u16b(uint16_t v)
 {
-	sf_put((uint8_t)(v & 0xFF));
-	sf_put((uint8_t)((v >> 8) & 0xFF));
+	uint8_t bytes[2] = { v & 0xFF, (v >> 8) & 0xFF };
+
+	wr_bytes(bytes, 2);
 }
 
 void wr_s16b(int16_t v)
@@ -233,10 +380,10 @@ void wr_s16b(int16_t v)
 
 void wr_u32b(uint32_t v)
 {
-	sf_put((uint8_t)(v & 0xFF));
-	sf_put((uint8_t)((v >> 8) & 0xFF));
-	sf_put((uint8_t)((v >> 16) & 0xFF));
-	sf_put((uint8_t)((v >> 24) & 0xFF));
+	uint8_t bytes[4] = { v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF,
+						 (v >> 24) & 0xFF };
+
+	wr_bytes(bytes, 4);
 }
 
 void wr_s32b(int32_t v)
@@ -246,12 +393,18 @@ void wr_s32b(int32_t v)
 
 void wr_string(const char *str)
 {
-	while (*str)
-	{
-		wr_byte(*str);
-		str++;
-	}
-	wr_byte(*str);
+	wr_bytes(str, strlen(str) + 1);
+}
+
+/**
+ * Write n bytes as they are
+ */
+void wr_bytes(const void *bytes, size_t n)
+{
+	sf_reserve(n);
+	memcpy(buffer + buffer_pos, bytes, n);
+	sf_check(buffer + buffer_pos, n);
+	buffer_pos += n;
 }
 
 
@@ -262,8 +415,11 @@ void rd_byte(uint8_t *ip)
 
 void rd_u16b(uint16_t *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((uint16_t)(sf_get()) << 8);
+	uint8_t bytes[2];
+
+	rd_bytes(bytes, 2);
+	(*ip) = bytes[0];
+	(*ip) |= ((uint16_t)(bytes[1]) << 8);
 }
 
 void rd_s16b(int16_t *ip)
@@ -273,10 +429,13 @@ void rd_s16b(int16_t *ip)
 
 void rd_u32b(uint32_t *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((uint32_t)(sf_get()) << 8);
-	(*ip) |= ((uint32_t)(sf_get()) << 16);
-	(*ip) |= ((uint32_t)(sf_get()) << 24);
+	uint8_t bytes[4];
+
+	rd_bytes(bytes, 4);
+	(*ip) = bytes[0];
+	(*ip) |= ((uint32_t)(bytes[1]) << 8);
+	(*ip) |= ((uint32_t)(bytes[2]) << 16);
+	(*ip) |= ((uint32_t)(bytes[3]) << 24);
 }
 
 void rd_s32b(int32_t *ip)
@@ -299,6 +458,20 @@ void rd_string(char *str, int max)
 	str[max - 1] = '\0';
 }
 
+/**
+ * Read n bytes as they are
+ */
+void rd_bytes(void *bytes, size_t n)
+{
+	if ((buffer == NULL) || (buffer_pos > buffer_size) ||
+		(n > buffer_size - buffer_pos))
+		quit("Broken savefile - probably from a development version");
+
+	memcpy(bytes, buffer + buffer_pos, n);
+	sf_check(buffer + buffer_pos, n);
+	buffer_pos += n;
+}
+
 void strip_bytes(int n)
 {
 	uint8_t tmp8u;
@@ -317,25 +490,235 @@ void pad_bytes(int n)
  * ------------------------------------------------------------------------ */
 
 
-static bool try_save(ang_file *file)
+/**
+ * A savefile block, serialised and waiting to be written out
+ */
+struct saved_block {
+	char name[16];
+	uint32_t version;
+	uint8_t *data;
+	uint32_t size;
+	uint32_t check;
+};
+
+/**
+ * A whole savefile, serialised and waiting to be written out.  Everything
+ * here belongs to whichever thread is writing it until it is finished.
+ */
+struct save_job {
+	char path[1024];		/**< File to write */
+	char new_path[1024];	/**< Name to write it under first */
+	char old_path[1024];	/**< Name to move the old file to meanwhile */
+	char journal[1024];		/**< Journal to delete afterwards, if any */
+	bool full;				/**< Whether this is a full savefile */
+	bool background;		/**< Whether the game carries on while it is written */
+	struct saved_block *blocks;
+	size_t num;
+	size_t generation_block;	/**< Index of the "generation" block */
+	uint32_t generation;	/**< Generation of a full savefile, once written */
+	size_t bytes;			/**< Bytes written */
+	bool success;
+};
+
+/**
+ * The savefile being written in the background, if any
+ */
+static struct save_job *save_pending;
+
+#ifdef SAVE_IN_BACKGROUND
+static pthread_t save_thread;
+static pthread_mutex_t save_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool save_thread_running;
+static bool save_thread_done;
+#endif
+
+/**
+ * Compress a block into packed, if that makes it worth it.
+ * \return the size of the compressed data, or 0 if the block should be
+ * written as it is
+ */
+static uint32_t compress_block(const struct saved_block *block,
+							   uint8_t **packed, uint32_t *packed_size)
 {
-	uint8_t savefile_head[SAVEFILE_HEAD_SIZE];
-	size_t i, pos;
-	bool success = true;
+	uint32_t need, len;
+
+	if (block->size < BLOCK_COMPRESS_MIN) return 0;
+
+	need = 4 + lz_compress_bound(block->size);
+	if (need > *packed_size) {
+		*packed = mem_realloc(*packed, need);
+		*packed_size = need;
+	}
+	len = lz_compress(block->data, block->size, *packed + 4,
+					  *packed_size - 4);
+	if (!len || (4 + len >= block->size)) return 0;
+
+	(*packed)[0] = block->size & 0xFF;
+	(*packed)[1] = (block->size >> 8) & 0xFF;
+	(*packed)[2] = (block->size >> 16) & 0xFF;
+	(*packed)[3] = (block->size >> 24) & 0xFF;
+	return 4 + len;
+}
 
-	/* Start off the buffer */
-	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
-	buffer_size = BUFFER_INITIAL_SIZE;
+/**
+ * Write the generation of the full savefile, which journal this is, and the
+ * size of the full savefile if this is a journal
+ */
+static void wr_generation(void)
+{
+	wr_u32b(journal_generation);
+	wr_u32b(journal_saves);
+	wr_u32b(journal_saves ? (uint32_t) journal_base_bytes : 0);
+}
 
-	for (i = 0; i < N_ELEMENTS(savers); i++) {
+/**
+ * Work out the generation of a full savefile from everything else in it, so
+ * that the same game always saves the same way, and a journal only goes with
+ * a savefile holding what it was made against
+ */
+static uint32_t save_job_generation(const struct save_job *job)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	size_t i, j;
+
+	for (i = 0; i < job->num; i++) {
+		const struct saved_block *block = &job->blocks[i];
+
+		if (i == job->generation_block) continue;
+		for (j = 0; j + 8 <= block->size; j += 8) {
+			uint64_t word;
+			memcpy(&word, block->data + j, 8);
+			hash = (hash ^ word) * 1099511628211ULL;
+			hash ^= hash >> 29;
+		}
+		for (; j < block->size; j++) {
+			hash = (hash ^ block->data[j]) * 1099511628211ULL;
+		}
+		hash = (hash ^ block->size) * 1099511628211ULL;
+	}
+	hash ^= hash >> 32;
+	return (uint32_t) hash ? (uint32_t) hash : 1;
+}
+
+/**
+ * Get the name of the journal kept alongside a savefile
+ */
+static void journal_name(char *buf, size_t len, const char *path)
+{
+	strnfmt(buf, len, "%s%s", path, SAVEFILE_JOURNAL_SUFFIX);
+}
+
+/**
+ * Serialise the blocks given by list, to be written to path
+ */
+static struct save_job *save_job_new(const char *path,
+									 const struct blocksaver *list,
+									 size_t num, uint32_t *size_hint,
+									 bool full)
+{
+	struct save_job *job = mem_zalloc(sizeof(*job));
+	size_t i;
+	int count = 0;
+
+	/* Generate a CharOutput.txt, mainly for angband.live, when saving. */
+	(void) save_charoutput();
+
+	my_strcpy(job->path, path, sizeof(job->path));
+	job->full = full;
+	job->num = num;
+	job->blocks = mem_zalloc(num * sizeof(*job->blocks));
+
+	/* Each block keeps the buffer it was written to */
+	for (i = 0; i < num; i++) {
+		struct saved_block *block = &job->blocks[i];
+
+		buffer_size = MAX(size_hint[i], BUFFER_INITIAL_SIZE);
+		buffer = mem_alloc(buffer_size);
 		buffer_pos = 0;
 		buffer_check = 0;
 
-		savers[i].save();
+		list[i].save();
+		size_hint[i] = buffer_pos;
+		my_strcpy(block->name, list[i].name, sizeof(block->name));
+		block->version = list[i].version;
+		block->data = buffer;
+		block->size = buffer_pos;
+		block->check = buffer_check;
+		if (list[i].save == wr_generation) job->generation_block = i;
+	}
+	buffer = NULL;
+	buffer_size = 0;
+
+	/* Names for the new file while it is written, and the old one while it
+	 * is replaced */
+	safe_setuid_grab();
+	strnfmt(job->old_path, sizeof(job->old_path), "%s%u.old", path,
+			Rand_simple(1000000));
+	while (file_exists(job->old_path) && (count++ < 100))
+		strnfmt(job->old_path, sizeof(job->old_path), "%s%u%u.old", path,
+				Rand_simple(1000000),count);
+
+	count = 0;
+
+	strnfmt(job->new_path, sizeof(job->new_path), "%s%u.new", path,
+			Rand_simple(1000000));
+	while (file_exists(job->new_path) && (count++ < 100))
+		strnfmt(job->new_path, sizeof(job->new_path), "%s%u%u.new", path,
+				Rand_simple(1000000),count);
+	safe_setuid_drop();
+
+	/* A full savefile does away with any journal */
+	if (full) {
+		journal_name(job->journal, sizeof(job->journal), path);
+	}
+
+	return job;
+}
+
+/**
+ * Write the blocks of a job to a savefile
+ */
+static bool try_save(ang_file *file, struct save_job *job)
+{
+	uint8_t savefile_head[SAVEFILE_HEAD_SIZE];
+	size_t i, pos;
+	bool success = true;
+	uint8_t *packed = NULL;
+	uint32_t packed_size = 0;
+
+	/* A full savefile is named for what is in it */
+	if (job->full) {
+		struct saved_block *block = &job->blocks[job->generation_block];
+		uint32_t generation = save_job_generation(job);
+
+		assert(block->size >= 4);
+		for (i = 0; i < 4; i++) {
+			block->check -= block->data[i];
+			block->data[i] = (generation >> (8 * i)) & 0xFF;
+			block->check += block->data[i];
+		}
+		job->generation = generation;
+	}
+
+	job->bytes = 8;
+	for (i = 0; i < job->num; i++) {
+		struct saved_block *block = &job->blocks[i];
+		uint32_t version, data_len, packed_len;
+		uint8_t *data;
+
+		packed_len = compress_block(block, &packed, &packed_size);
+		version = block->version;
+		data = block->data;
+		data_len = block->size;
+		if (packed_len) {
+			version |= BLOCK_COMPRESSED;
+			data = packed;
+			data_len = packed_len;
+		}
 
 		/* 16-byte block name */
 		pos = my_strcpy((char *)savefile_head,
-				savers[i].name,
+				block->name,
 				sizeof savefile_head);
 		while (pos < 16)
 			savefile_head[pos++] = 0;
@@ -346,9 +729,9 @@ static bool try_save(ang_file *file)
 		savefile_head[pos++] = ((v >> 16) & 0xFF); \
 		savefile_head[pos++] = ((v >> 24) & 0xFF);
 
-		SAVE_U32B(savers[i].version);
-		SAVE_U32B(buffer_pos);
-		SAVE_U32B(buffer_check);
+		SAVE_U32B(version);
+		SAVE_U32B(data_len);
+		SAVE_U32B(block->check);
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
@@ -356,86 +739,72 @@ static bool try_save(ang_file *file)
 				SAVEFILE_HEAD_SIZE)) {
 			success = false;
 		}
-		if (! file_write(file, (char *)buffer, buffer_pos)) {
+		if (! file_write(file, (char *)data, data_len)) {
 			success = false;
 		}
 
 		/* pad to 4 byte multiples */
-		if (buffer_pos % 4) {
-			if (! file_write(file, "xxx", 4 - (buffer_pos % 4))) {
+		if (data_len % 4) {
+			if (! file_write(file, "xxx", 4 - (data_len % 4))) {
 				success = false;
 			}
 		}
+		job->bytes += SAVEFILE_HEAD_SIZE + data_len + (4 - data_len % 4) % 4;
 	}
 
-	mem_free(buffer);
+	mem_free(packed);
 
 	return success;
 }
 
 /**
- * Attempt to save the player in a savefile
+ * Write out a serialised savefile, replacing the old one only once the whole
+ * of the new one is safely on disk.  This touches nothing but the job, so it
+ * can be done on another thread.
  */
-bool savefile_save(const char *path)
+static bool save_job_write(struct save_job *job)
 {
 	ang_file *file;
-	int count = 0;
-	char new_savefile[1024];
-	char old_savefile[1024];
+	bool written;
 
-	/* Generate a CharOutput.txt, mainly for angband.live, when saving. */
-	(void) save_charoutput();
-
-	/* New savefile */
 	safe_setuid_grab();
-	strnfmt(old_savefile, sizeof(old_savefile), "%s%u.old", path,
-			Rand_simple(1000000));
-	while (file_exists(old_savefile) && (count++ < 100))
-		strnfmt(old_savefile, sizeof(old_savefile), "%s%u%u.old", path,
-				Rand_simple(1000000),count);
-
-	count = 0;
-
-	/* Open the savefile */
-	strnfmt(new_savefile, sizeof(new_savefile), "%s%u.new", path,
-			Rand_simple(1000000));
-	while (file_exists(new_savefile) && (count++ < 100))
-		strnfmt(new_savefile, sizeof(new_savefile), "%s%u%u.new", path,
-				Rand_simple(1000000),count);
-
-	file = file_open(new_savefile, MODE_WRITE, FTYPE_SAVE);
+	file = file_open(job->new_path, MODE_WRITE, FTYPE_SAVE);
 	safe_setuid_drop();
 
 	if (file) {
 		if (file_write(file, (char *) &savefile_magic, 4)
 			&& file_write(file, (char *) &savefile_name, 4)) {
-			character_saved = try_save(file);
+			written = try_save(file, job) && file_sync(file);
 		} else {
-			character_saved = false;
+			written = false;
 		}
 		file_close(file);
 	} else {
-		character_saved = false;
+		written = false;
 	}
 
-	if (character_saved) {
+	if (written) {
 		bool err = false;
 
 		safe_setuid_grab();
 
-		if (file_exists(path) && !file_move(path, old_savefile))
+		if (file_exists(job->path) && !file_move(job->path, job->old_path))
 			err = true;
 
 		if (!err) {
-			if (!file_move(new_savefile, path))
+			if (!file_move(job->new_path, job->path))
 				err = true;
 
 			if (err)
-				file_move(old_savefile, path);
+				file_move(job->old_path, job->path);
 			else
-				file_delete(old_savefile);
+				file_delete(job->old_path);
 		} 
 
+		/* Any journal belongs to the previous generation */
+		if (!err && job->journal[0] && file_exists(job->journal))
+			file_delete(job->journal);
+
 		safe_setuid_drop();
 
 		return err ? false : true;
@@ -446,12 +815,215 @@ bool savefile_save(const char *path)
 		/* File is no longer valid, but it still points to a non zero
 		 * value if the file was created above */
 		safe_setuid_grab();
-		file_delete(new_savefile);
+		file_delete(job->new_path);
 		safe_setuid_drop();
 	}
 	return false;
 }
 
+/**
+ * Note the outcome of writing a savefile, and free the job
+ */
+static bool save_job_finish(struct save_job *job)
+{
+	bool success = job->success;
+	size_t i;
+
+	/* The game has carried on since a save written in the background was
+	 * taken, so that only counts as just saved if it failed */
+	if (!job->background || !success) character_saved = success;
+	if (success && job->full) {
+		/* Journals can now be made against this savefile */
+		my_strcpy(journal_base, job->path, sizeof(journal_base));
+		journal_generation = job->generation;
+		journal_base_bytes = job->bytes;
+		journal_bytes = 0;
+	} else if (success) {
+		journal_bytes = job->bytes;
+	}
+
+	for (i = 0; i < job->num; i++) {
+		mem_free(job->blocks[i].data);
+	}
+	mem_free(job->blocks);
+	mem_free(job);
+	return success;
+}
+
+#ifdef SAVE_IN_BACKGROUND
+static void *save_thread_run(void *arg)
+{
+	struct save_job *job = arg;
+
+	job->success = save_job_write(job);
+	pthread_mutex_lock(&save_mutex);
+	save_thread_done = true;
+	pthread_mutex_unlock(&save_mutex);
+	return NULL;
+}
+#endif
+
+/**
+ * Finish off a savefile being written in the background, waiting for it if
+ * wait is true, and tell the UI how it went.
+ * \return false if it is still being written
+ */
+static bool save_collect(bool wait, bool *success)
+{
+	struct save_job *job = save_pending;
+	bool result;
+
+	if (!job) return true;
+#ifdef SAVE_IN_BACKGROUND
+	if (save_thread_running) {
+		if (!wait) {
+			bool done;
+
+			pthread_mutex_lock(&save_mutex);
+			done = save_thread_done;
+			pthread_mutex_unlock(&save_mutex);
+			if (!done) return false;
+		}
+		pthread_join(save_thread, NULL);
+		save_thread_running = false;
+	}
+#endif
+
+	save_pending = NULL;
+	result = save_job_finish(job);
+	if (success) *success = result;
+	event_signal_flag(EVENT_SAVEFILE_WRITTEN, result);
+	return true;
+}
+
+/**
+ * Serialise a full savefile for path
+ */
+static struct save_job *save_job_full(const char *path)
+{
+	/* A new generation of savefile, with no journal yet */
+	journal_base[0] = '\0';
+	journal_generation = 0;
+	journal_saves = 0;
+
+	return save_job_new(path, savers, N_ELEMENTS(savers), block_size_hint,
+						true);
+}
+
+/**
+ * Serialise a journal for path if that is possible, and a full savefile
+ * otherwise
+ */
+static struct save_job *save_job_changes(const char *path)
+{
+	char journal[1024];
+
+	/* Write the full savefile if there isn't a good one to build on, or the
+	 * journal has been written often enough or got big enough */
+	if (player->is_dead || !streq(journal_base, path) ||
+		(journal_saves >= JOURNAL_MAX_SAVES) ||
+		(journal_bytes * JOURNAL_MAX_FRACTION > journal_base_bytes)) {
+		return save_job_full(path);
+	}
+
+	journal_saves++;
+	journal_name(journal, sizeof(journal), path);
+	return save_job_new(journal, journal_savers, N_ELEMENTS(journal_savers),
+						journal_size_hint, false);
+}
+
+/**
+ * Attempt to save the player in a savefile
+ */
+bool savefile_save(const char *path)
+{
+	struct save_job *job;
+
+	(void) save_collect(true, NULL);
+	job = save_job_full(path);
+	job->success = save_job_write(job);
+	return save_job_finish(job);
+}
+
+/**
+ * Attempt to save the player, writing just a journal of what has changed
+ * since the savefile was last saved in full if that is possible, and the
+ * full savefile otherwise
+ */
+bool savefile_save_changes(const char *path)
+{
+	struct save_job *job;
+
+	(void) save_collect(true, NULL);
+	job = save_job_changes(path);
+	job->success = save_job_write(job);
+	return save_job_finish(job);
+}
+
+/**
+ * Save the player as savefile_save_changes() does, but only take a copy of
+ * what is to be saved now, and write it out in the background where that is
+ * possible.  The outcome is signalled with EVENT_SAVEFILE_WRITTEN.
+ */
+bool savefile_save_background(const char *path)
+{
+	bool success = true;
+
+	(void) save_collect(true, NULL);
+	save_pending = save_job_changes(path);
+#ifdef SAVE_IN_BACKGROUND
+	save_thread_done = false;
+	if (!pthread_create(&save_thread, NULL, save_thread_run, save_pending)) {
+		save_pending->background = true;
+		save_thread_running = true;
+		character_saved = false;
+		return true;
+	}
+#endif
+
+	/* Write it now if there is no other thread to do it */
+	save_pending->success = save_job_write(save_pending);
+	(void) save_collect(true, &success);
+	return success;
+}
+
+/**
+ * Check whether a savefile is still being written in the background.
+ */
+bool savefile_save_pending(void)
+{
+	return save_pending != NULL;
+}
+
+/**
+ * Finish off a savefile being written in the background, if it is done.
+ */
+void savefile_save_poll(void)
+{
+	(void) save_collect(false, NULL);
+}
+
+/**
+ * Wait for a savefile being written in the background to be finished.
+ * Returns false if that failed.
+ */
+bool savefile_save_wait(void)
+{
+	bool success = true;
+
+	(void) save_collect(true, &success);
+	return success;
+}
+
+/**
+ * Forget the savefile the journal was being kept for, so the next save is a
+ * full one
+ */
+void savefile_journal_reset(void)
+{
+	journal_base[0] = '\0';
+}
+
 
 
 /**
@@ -496,6 +1068,8 @@ static errr next_blockheader(ang_file *f, struct blockheader *b) {
 
 	my_strcpy(b->name, (char *)&savefile_head, sizeof b->name);
 	b->version = RECONSTRUCT_U32B(16);
+	b->compressed = (b->version & BLOCK_COMPRESSED) != 0;
+	b->version &= ~BLOCK_COMPRESSED;
 	b->size = RECONSTRUCT_U32B(20);
 
 	/* Pad to 4 bytes */
@@ -535,8 +1109,38 @@ static bool load_block(ang_file *f, struct blockheader *b, loader_t loader)
 	buffer_check = 0;
 
 	buffer_size = file_read(f, (char *) buffer, b->size);
-	if (buffer_size != b->size ||
-			loader() != 0) {
+	if (buffer_size != b->size) {
+		mem_free(buffer);
+		return false;
+	}
+
+	/* Unpack a compressed block */
+	if (b->compressed) {
+		uint8_t *unpacked;
+		uint32_t raw;
+
+		if (b->size < 4) {
+			mem_free(buffer);
+			return false;
+		}
+		raw = (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8) |
+			((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+		if (!raw || (raw > BLOCK_MAX_SIZE)) {
+			mem_free(buffer);
+			return false;
+		}
+		unpacked = mem_alloc(raw);
+		if (!lz_decompress(buffer + 4, b->size - 4, unpacked, raw)) {
+			mem_free(unpacked);
+			mem_free(buffer);
+			return false;
+		}
+		mem_free(buffer);
+		buffer = unpacked;
+		buffer_size = raw;
+	}
+
+	if (loader() != 0) {
 		mem_free(buffer);
 		return false;
 	}
@@ -554,9 +1158,63 @@ static void skip_block(ang_file *f, struct blockheader *b)
 }
 
 /**
- * Try to load a savefile
+ * Find the block of a full savefile which a journal block holds the changes
+ * to, if any
  */
-static bool try_load(ang_file *f, const struct blockinfo *local_loaders)
+static const char *journal_block_base(const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(journal_savers); i++) {
+		if (streq(journal_savers[i].name, name)) {
+			return streq(savers[i].name, name) ? NULL : savers[i].name;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Load just the named block from the savefile at path
+ */
+static bool load_named_block(const char *path, const char *name,
+							 const struct blockinfo *local_loaders)
+{
+	struct blockheader b;
+	ang_file *f;
+	bool found = false, ok = false;
+
+	safe_setuid_grab();
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
+	safe_setuid_drop();
+	if (!f) return false;
+
+	if (check_header(f)) {
+		while (!next_blockheader(f, &b)) {
+			loader_t loader;
+
+			if (!streq(b.name, name)) {
+				skip_block(f, &b);
+				continue;
+			}
+			found = true;
+			loader = find_loader(&b, local_loaders);
+			ok = loader && load_block(f, &b, loader);
+			break;
+		}
+	}
+
+	file_close(f);
+	return found && ok;
+}
+
+/* Bytes read by the last call to try_load() */
+static size_t load_bytes;
+
+/**
+ * Try to load a savefile, or a journal on top of the savefile at base
+ */
+static bool try_load(ang_file *f, const struct blockinfo *local_loaders,
+					 const char *base)
 {
 	struct blockheader b;
 	errr err;
@@ -565,16 +1223,27 @@ static bool try_load(ang_file *f, const struct blockinfo *local_loaders)
 		note("Savefile is corrupted -- incorrect file header.");
 		return false;
 	}
+	load_bytes = 8;
 
 	/* Get the next block header */
 	while ((err = next_blockheader(f, &b)) == 0) {
 		loader_t loader = find_loader(&b, local_loaders);
+		load_bytes += SAVEFILE_HEAD_SIZE + b.size;
 		if (!loader) {
 			note("Savefile block can't be read.");
 			note("Maybe try and load the savefile in an earlier version of Angband.");
 			return false;
 		}
 
+		/* Changes in a journal go on top of the savefile's block */
+		if (base && journal_block_base(b.name) &&
+			!load_named_block(base, journal_block_base(b.name),
+							  local_loaders)) {
+			note(format("Savefile corrupted - Couldn't load block %s",
+						journal_block_base(b.name)));
+			return false;
+		}
+
 		if (!load_block(f, &b, loader)) {
 			note(format("Savefile corrupted - Couldn't load block %s", b.name));
 			return false;
@@ -589,6 +1258,55 @@ static bool try_load(ang_file *f, const struct blockinfo *local_loaders)
 	return true;
 }
 
+/* The generation read from a savefile, which journal it was, and the size
+ * of the full savefile */
+static uint32_t loaded_generation;
+static uint32_t loaded_saves;
+static uint32_t loaded_base_bytes;
+
+static int rd_generation(void)
+{
+	rd_u32b(&loaded_generation);
+	rd_u32b(&loaded_saves);
+	rd_u32b(&loaded_base_bytes);
+	return 0;
+}
+
+/**
+ * Read the generation of the savefile at path; 0 if it has none
+ */
+static uint32_t savefile_generation(const char *path)
+{
+	static const struct blockinfo generation_loader[] = {
+		{ "generation", rd_generation, 1 },
+		{ "", NULL, 0 }
+	};
+
+	loaded_generation = 0;
+	loaded_saves = 0;
+	if (!load_named_block(path, "generation", generation_loader)) {
+		loaded_generation = 0;
+	}
+	return loaded_generation;
+}
+
+/**
+ * Check whether the savefile at path has a journal to be loaded on top of it,
+ * and put the journal's name in buf if so
+ */
+static bool savefile_has_journal(const char *path, char *buf, size_t len)
+{
+	uint32_t generation = savefile_generation(path);
+	bool exists;
+
+	if (!generation) return false;
+	journal_name(buf, len, path);
+	safe_setuid_grab();
+	exists = file_exists(buf);
+	safe_setuid_drop();
+	return exists && (savefile_generation(buf) == generation);
+}
+
 /* XXX this isn't nice but it'll have to do */
 static char savefile_desc[120];
 
@@ -603,6 +1321,12 @@ static int get_desc(void) {
 const char *savefile_get_description(const char *path) {
 	struct blockheader b;
 	ang_file *f;
+	char journal[1024];
+
+	/* A journal has the latest description */
+	if (savefile_has_journal(path, journal, sizeof(journal))) {
+		path = journal;
+	}
 
 	safe_setuid_grab();
 	f = file_open(path, MODE_READ, FTYPE_TEXT);
@@ -637,18 +1361,30 @@ bool savefile_load(const char *path, bool cheat_death)
 {
 	bool ok;
 	ang_file *f;
+	char journal[1024];
+	bool has_journal = savefile_has_journal(path, journal, sizeof(journal));
 
 	safe_setuid_grab();
-	f = file_open(path, MODE_READ, FTYPE_TEXT);
+	f = file_open(has_journal ? journal : path, MODE_READ, FTYPE_TEXT);
 	safe_setuid_drop();
 	if (!f) {
 		note("Couldn't open savefile.");
 		return false;
 	}
 
-	ok = try_load(f, loaders);
+	ok = try_load(f, loaders, has_journal ? path : NULL);
 	file_close(f);
 
+	/* Further journals can be made against this savefile */
+	journal_base[0] = '\0';
+	if (ok && loaded_generation) {
+		my_strcpy(journal_base, path, sizeof(journal_base));
+		journal_generation = loaded_generation;
+		journal_saves = loaded_saves;
+		journal_base_bytes = has_journal ? loaded_base_bytes : load_bytes;
+		journal_bytes = has_journal ? load_bytes : 0;
+	}
+
 	if (player->chp < 0) {
 		player->is_dead = true;
 	}
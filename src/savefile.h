@@ -22,6 +22,11 @@
 #define ITEM_VERSION	5
 #define EGO_ART_KNOWN 0xffffffff
 
+/**
+ * Added to the name of a savefile to get the name of its journal
+ */
+#define SAVEFILE_JOURNAL_SUFFIX	".journal"
+
 /**
  * ------------------------------------------------------------------------
  * Savefile API
@@ -37,6 +42,42 @@ extern bool character_saved;
  */
 bool savefile_save(const char *path);
 
+/**
+ * Save to the given location, writing only what has changed since the last
+ * full save to a journal beside it when possible.  Returns true on success,
+ * false otherwise.
+ */
+bool savefile_save_changes(const char *path);
+
+/**
+ * Save as savefile_save_changes() does, but write the file in the background
+ * when possible.  EVENT_SAVEFILE_WRITTEN is signalled once it is written.
+ * Returns false if the file was written straight away and that failed, true
+ * otherwise.
+ */
+bool savefile_save_background(const char *path);
+
+/**
+ * Check whether a save made in the background is still being written.
+ */
+bool savefile_save_pending(void);
+
+/**
+ * Finish off a save made in the background if it has been written.
+ */
+void savefile_save_poll(void);
+
+/**
+ * Wait for any save being made in the background.  Returns false if it
+ * failed, true otherwise.
+ */
+bool savefile_save_wait(void);
+
+/**
+ * Make the next save a full one.
+ */
+void savefile_journal_reset(void);
+
 /**
  * Load the savefile given.  Returns true on succcess, false otherwise.
  */
@@ -69,6 +110,7 @@ void wr_s16b(int16_t v);
 void wr_u32b(uint32_t v);
 void wr_s32b(int32_t v);
 void wr_string(const char *str);
+void wr_bytes(const void *bytes, size_t n);
 void pad_bytes(int n);
 
 /* Reading bits */
@@ -78,6 +120,7 @@ void rd_s16b(int16_t *ip);
 void rd_u32b(uint32_t *ip);
 void rd_s32b(int32_t *ip);
 void rd_string(char *str, int max);
+void rd_bytes(void *bytes, size_t n);
 void strip_bytes(int n);
 
 
@@ -91,11 +134,14 @@ int rd_object_memory(void);
 int rd_artifacts(void);
 int rd_player(void);
 int rd_ignore(void);
+int rd_misc_1(void);
 int rd_misc(void);
 int rd_gear(void);
 int rd_dungeon(void);
 int rd_chunks(void);
+int rd_chunk_changes(void);
 int rd_locations(void);
+int rd_location_changes(void);
 int rd_objects(void);
 int rd_monsters(void);
 int rd_monster_groups(void);
@@ -118,7 +164,9 @@ void wr_randarts(void);
 void wr_gear(void);
 void wr_dungeon(void);
 void wr_chunks(void);
+void wr_chunk_changes(void);
 void wr_locations(void);
+void wr_location_changes(void);
 void wr_objects(void);
 void wr_monsters(void);
 void wr_monster_groups(void);
@@ -49,6 +49,7 @@ static enum parser_error parse_song_name(struct parser *p) {
 	/* Static initialisation means first entry has index 0 */
 	s->index = song_index;
 	song_index++;
+	s->ability = ability_index(format("Song of %s", name));
 	
     return PARSE_ERROR_NONE;
 }
@@ -263,7 +264,7 @@ void player_change_song(struct player *p, struct song *song, bool exchange)
 {
 	int song_to_change;
 
-	if (player_active_ability(p, "Woven Themes") && p->song[SONG_MAIN] && song){
+	if (player_active_ability(p, PA_WOVEN_THEMES) && p->song[SONG_MAIN] && song){
 		song_to_change = SONG_MINOR;
 	} else {
 		song_to_change = SONG_MAIN;
@@ -378,10 +379,9 @@ void player_sing(struct player *p)
 	/* Abort song if out of voice, lost the ability to weave themes,
 	 * or lost either song ability */
 	if ((p->csp < 1) ||
-		(p->song[SONG_MINOR] && !player_active_ability(p, "Woven Themes")) ||
-		(!player_active_ability(p, format("Song of %s", smain->name))) ||
-		(p->song[SONG_MINOR] &&
-		 !player_active_ability(p, format("Song of %s", minor->name)))) {
+		(p->song[SONG_MINOR] && !player_active_ability(p, PA_WOVEN_THEMES)) ||
+		(!player_active_ability(p, smain->ability)) ||
+		(p->song[SONG_MINOR] && !player_active_ability(p, minor->ability))) {
 		/* Stop singing */
 		player_change_song(p, NULL, false);
 
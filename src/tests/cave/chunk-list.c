@@ -0,0 +1,163 @@
+/* cave/chunk-list */
+
+#include "unit-test.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+
+int setup_tests(void **state) {
+	z_info = mem_zalloc(sizeof(struct angband_constants));
+	z_info->chunk_cache = 64;
+	chunk_list_init();
+	turn = 1;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	chunk_list_cleanup();
+	mem_free(z_info);
+	z_info = NULL;
+	return 0;
+}
+
+static int store(int z_pos, int y_pos, int x_pos) {
+	return chunk_store(0, 0, 1, z_pos, y_pos, x_pos, 0, false);
+}
+
+static int find(int z_pos, int y_pos, int x_pos) {
+	struct chunk_ref ref = { 0 };
+
+	ref.z_pos = z_pos;
+	ref.y_pos = y_pos;
+	ref.x_pos = x_pos;
+	return chunk_find(ref);
+}
+
+static int test_find(void *state) {
+	int y, x, idx[3][3];
+
+	for (y = 0; y < 3; y++) {
+		for (x = 0; x < 3; x++) {
+			idx[y][x] = store(0, 100 + y, 200 + x);
+			require(idx[y][x] < MAX_CHUNKS);
+		}
+	}
+	for (y = 0; y < 3; y++) {
+		for (x = 0; x < 3; x++) {
+			eq(find(0, 100 + y, 200 + x), idx[y][x]);
+			eq(chunk_list[idx[y][x]].place, idx[y][x]);
+		}
+	}
+	eq(find(0, 103, 200), MAX_CHUNKS);
+	eq(find(1, 101, 201), MAX_CHUNKS);
+
+	/* Storing again gives the same slot */
+	eq(store(0, 101, 201), idx[1][1]);
+	ok;
+}
+
+static int test_adjacent(void *state) {
+	int centre = find(0, 101, 201), below;
+	struct chunk_ref *ref = &chunk_list[centre];
+
+	eq(ref->adjacent[DIR_NONE], centre);
+	eq(ref->adjacent[DIR_N], find(0, 100, 201));
+	eq(ref->adjacent[DIR_S], find(0, 102, 201));
+	eq(ref->adjacent[DIR_W], find(0, 101, 200));
+	eq(ref->adjacent[DIR_E], find(0, 101, 202));
+	eq(ref->adjacent[DIR_NW], find(0, 100, 200));
+	eq(ref->adjacent[DIR_SE], find(0, 102, 202));
+	eq(ref->adjacent[DIR_UP], MAX_CHUNKS);
+	eq(ref->adjacent[DIR_DOWN], MAX_CHUNKS);
+	eq(chunk_list[find(0, 100, 200)].adjacent[DIR_N], MAX_CHUNKS);
+
+	/* A new chunk is linked in both directions */
+	below = store(1, 101, 201);
+	eq(ref->adjacent[DIR_DOWN], below);
+	eq(chunk_list[below].adjacent[DIR_UP], centre);
+	eq(chunk_list[below].adjacent[DIR_N], MAX_CHUNKS);
+	ok;
+}
+
+static int test_evict(void *state) {
+	int i;
+
+	/* Fill the list with newer chunks far away so the old ones go */
+	for (i = 0; i < 2 * MAX_CHUNKS; i++) {
+		turn++;
+		store(0, 1000 + i / 50, 1000 + i % 50);
+	}
+	eq(find(0, 101, 201), MAX_CHUNKS);
+	eq(find(1, 101, 201), MAX_CHUNKS);
+	eq(chunk_cnt, MAX_CHUNKS);
+	require(chunk_cache_stats.evictions > 0);
+
+	/* Every live chunk is still found in its slot, and adjacency is
+	 * consistent both ways */
+	for (i = 0; i < MAX_CHUNKS; i++) {
+		struct chunk_ref *ref = &chunk_list[i];
+		int d;
+
+		if (!ref->region) continue;
+		eq(find(ref->z_pos, ref->y_pos, ref->x_pos), i);
+		for (d = 0; d < DIR_MAX; d++) {
+			int adj = ref->adjacent[d];
+			if (d == DIR_NONE || adj == MAX_CHUNKS) continue;
+			require(chunk_list[adj].region);
+			eq(chunk_list[adj].adjacent[opposite_dir(d)], i);
+		}
+	}
+	ok;
+}
+
+static int test_lru(void *state) {
+	int i, first, second;
+
+	/* The list is full, so each new chunk evicts the least recently used */
+	turn++;
+	first = store(0, 2000, 2000);
+	turn++;
+	second = store(0, 2000, 2001);
+
+	/* Using the first again saves it from eviction */
+	turn++;
+	eq(store(0, 2000, 2000), first);
+	for (i = 0; i < MAX_CHUNKS - 1; i++) {
+		turn++;
+		store(0, 3000, 3000 + i);
+	}
+	eq(find(0, 2000, 2000), first);
+	eq(find(0, 2000, 2001), MAX_CHUNKS);
+	require(second < MAX_CHUNKS);
+	eq(chunk_cnt, MAX_CHUNKS);
+	ok;
+}
+
+static int test_reserve(void *state) {
+	int i, old_max = MAX_CHUNKS, idx = find(0, 2000, 2000);
+
+	chunk_list_reserve(2 * old_max);
+	eq(MAX_CHUNKS, 2 * old_max);
+	eq(chunk_cnt, old_max);
+
+	/* Existing entries are kept, and new ones use the extra room */
+	eq(find(0, 2000, 2000), idx);
+	for (i = 0; i < old_max; i++) {
+		turn++;
+		store(0, 4000, 4000 + i);
+	}
+	eq(find(0, 2000, 2000), idx);
+	eq(chunk_cnt, 2 * old_max);
+	ok;
+}
+
+const char *suite_name = "cave/chunk-list";
+struct test tests[] = {
+	{ "find", test_find },
+	{ "adjacent", test_adjacent },
+	{ "evict", test_evict },
+	{ "lru", test_lru },
+	{ "reserve", test_reserve },
+	{ NULL, NULL }
+};
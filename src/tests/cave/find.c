@@ -100,42 +100,47 @@ static int test_cave_find_in_range_0(void *state) {
 	ul.y = -2;
 	br.x = 0;
 	br.y = 0;
-	require(!cave_find_in_range(c, &grid, ul, br, square_in_bounds_fully));
-	require(cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(!cave_find_in_range(c, Rand_ctx, &grid, ul, br,
+		square_in_bounds_fully));
+	require(cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 	require(loc_eq(grid, br));
 
 	ul.x = c->width - 1;
 	ul.y = -1;
 	br.x = c->width + 5;
 	br.y = 0;
-	require(!cave_find_in_range(c, &grid, ul, br, square_in_bounds_fully));
-	require(cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(!cave_find_in_range(c, Rand_ctx, &grid, ul, br,
+		square_in_bounds_fully));
+	require(cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 	require(loc_eq(grid, loc(c->width - 1, 0)));
 
 	ul.x = -1;
 	ul.y = c->height - 1;
 	br.x = 0;
 	br.y = c->height + 2;
-	require(!cave_find_in_range(c, &grid, ul, br, square_in_bounds_fully));
-	require(cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(!cave_find_in_range(c, Rand_ctx, &grid, ul, br,
+		square_in_bounds_fully));
+	require(cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 	require(loc_eq(grid, loc(0, c->height - 1)));
 
 	ul.x = c->width - 1;
 	ul.y = c->height - 1;
 	br.x = c->width + 2;
 	br.y = c->height + 3;
-	require(!cave_find_in_range(c, &grid, ul, br, square_in_bounds_fully));
-	require(cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(!cave_find_in_range(c, Rand_ctx, &grid, ul, br,
+		square_in_bounds_fully));
+	require(cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 	require(loc_eq(grid, ul));
 
 	ul.x = 0;
 	ul.y = 0;
 	br.x = c->width - 1;
 	br.y = c->height - 1;
-	require(cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 	require(grid.x >= 0 && grid.x < c->width && grid.y >= 0 &&
 		grid.y < c->height);
-	require(cave_find_in_range(c, &grid, ul, br, square_in_bounds_fully));
+	require(cave_find_in_range(c, Rand_ctx, &grid, ul, br,
+		square_in_bounds_fully));
 	require(grid.x >= 1 && grid.x < c->width - 1 && grid.y >= 1
 		&& grid.y < c->height - 1);
 
@@ -144,13 +149,13 @@ static int test_cave_find_in_range_0(void *state) {
 	ul.y = c->height / 2;
 	br.x = ul.x - 3;
 	br.y = ul.y + 3;
-	require(!cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(!cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 	br.x = ul.x + 4;
 	br.y = ul.y - 2;
-	require(!cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(!cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 	br.x = ul.x - 2;
 	br.y = ul.y - 4;
-	require(!cave_find_in_range(c, &grid, ul, br, square_in_bounds));
+	require(!cave_find_in_range(c, Rand_ctx, &grid, ul, br, square_in_bounds));
 
 	ok;
 }
@@ -159,28 +164,28 @@ static int test_find_nearby_grid_0(void *state) {
 	struct chunk *c = state;
 	struct loc grid;
 
-	require(!find_nearby_grid(c, &grid, loc(-4, -3), 2, 3));
-	require(!find_nearby_grid(c, &grid, loc(c->width + 2, 1), 3, 1));
-	require(!find_nearby_grid(c, &grid, loc(-3, c->height + 4), 4, 2));
-	require(!find_nearby_grid(c, &grid, loc(c->width + 2, c->height + 1),
-		1, 2));
+	require(!find_nearby_grid(c, Rand_ctx, &grid, loc(-4, -3), 2, 3));
+	require(!find_nearby_grid(c, Rand_ctx, &grid, loc(c->width + 2, 1), 3, 1));
+	require(!find_nearby_grid(c, Rand_ctx, &grid, loc(-3, c->height + 4), 4, 2));
+	require(!find_nearby_grid(c, Rand_ctx, &grid,
+		loc(c->width + 2, c->height + 1), 1, 2));
 
-	require(find_nearby_grid(c, &grid, loc(c->width / 2, -1), 2, 1));
+	require(find_nearby_grid(c, Rand_ctx, &grid, loc(c->width / 2, -1), 2, 1));
 	require(grid.x >= c->width / 2 - 1 && grid.x <= c->width / 2 + 1
 		&& grid.y == 1);
 
-	require(find_nearby_grid(c, &grid, loc(c->width / 2, c->height + 1),
-		3, 1));
+	require(find_nearby_grid(c, Rand_ctx, &grid,
+		loc(c->width / 2, c->height + 1), 3, 1));
 	require(grid.x >= c->width / 2 - 1 && grid.x <= c->width / 2 + 1
 		&& grid.y == c->height - 2);
 
-	require(find_nearby_grid(c, &grid, loc(-1, c->height / 2),
+	require(find_nearby_grid(c, Rand_ctx, &grid, loc(-1, c->height / 2),
 		1, 2));
 	require(grid.x == 1 && grid.y >= c->height / 2 - 1
 		&& grid.y <= c->height / 2 + 1);
 
-	require(find_nearby_grid(c, &grid, loc(c->width + 2, c->height / 2),
-		1, 4));
+	require(find_nearby_grid(c, Rand_ctx, &grid,
+		loc(c->width + 2, c->height / 2), 1, 4));
 	require(grid.x == c->width - 2 && grid.y >= c->height / 2 - 1
 		&& grid.y <= c->height / 2 + 1);
 
@@ -197,7 +202,7 @@ static int test_unbundled_find_0(void *state) {
 
 	find_state = cave_find_init(NULL, loc(1, 1),
 		loc(c->width - 2, c->height - 2));
-	while (cave_find_get_grid(NULL, &grid, find_state)) {
+	while (cave_find_get_grid(Rand_ctx, NULL, &grid, find_state)) {
 		if (square_in_bounds_fully(c, grid) && !square_isroom(c, grid)) {
 			sqinfo_on(square(c, grid)->info, SQUARE_ROOM);
 		} else {
@@ -215,7 +220,7 @@ static int test_unbundled_find_0(void *state) {
 	}
 
 	cave_find_reset(find_state);
-	while (cave_find_get_grid(NULL, &grid, find_state)) {
+	while (cave_find_get_grid(Rand_ctx, NULL, &grid, find_state)) {
 		if (square_in_bounds_fully(c, grid) && square_isroom(c, grid)) {
 			sqinfo_off(square(c, grid)->info, SQUARE_ROOM);
 		} else {
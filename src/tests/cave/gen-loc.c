@@ -0,0 +1,93 @@
+/* cave/gen-loc */
+
+#include "unit-test.h"
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+
+#define SIDE 80
+
+int setup_tests(void **state) {
+	square_miles_init();
+	gen_loc_cnt = 0;
+	gen_loc_list_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	gen_loc_list_cleanup();
+	square_miles_cleanup();
+	return 0;
+}
+
+static int test_make(void *state) {
+	int y, x, z, lower, upper;
+
+	/* New locations go on the end */
+	for (y = 0; y < SIDE; y++) {
+		for (x = 0; x < SIDE; x++) {
+			for (z = 0; z < 2; z++) {
+				int want = (y * SIDE + x) * 2 + z;
+				require(!gen_loc_find(x, y, z, &lower, &upper));
+				eq(upper, want);
+				eq(lower, want);
+				gen_loc_make(x, y, z, upper);
+				gen_loc_list[upper].seed = want + 1;
+			}
+		}
+	}
+	eq(gen_loc_cnt, SIDE * SIDE * 2);
+	require(gen_loc_max >= gen_loc_cnt);
+	ok;
+}
+
+static int test_find(void *state) {
+	int y, x, z, lower, upper;
+
+	/* Everything keeps the place it was made in */
+	for (y = 0; y < SIDE; y++) {
+		for (x = 0; x < SIDE; x++) {
+			for (z = 0; z < 2; z++) {
+				int want = (y * SIDE + x) * 2 + z;
+				require(gen_loc_find(x, y, z, &lower, &upper));
+				eq(upper, want);
+				eq(lower, want);
+				eq(gen_loc_list[upper].seed, (uint32_t) want + 1);
+			}
+		}
+	}
+	require(!gen_loc_find(0, 0, 2, &lower, &upper));
+	eq(upper, (int) gen_loc_cnt);
+	require(!gen_loc_find(SIDE, 0, 0, &lower, &upper));
+	require(!gen_loc_find(0, SIDE, 1, &lower, &upper));
+	ok;
+}
+
+static int test_reindex(void *state) {
+	int lower, upper;
+	struct gen_loc first = gen_loc_list[0];
+
+	/* Reloaded lists are found again once reindexed */
+	gen_loc_list[0] = gen_loc_list[gen_loc_cnt - 1];
+	gen_loc_list[gen_loc_cnt - 1] = first;
+	gen_loc_list_reindex();
+	require(gen_loc_find(0, 0, 0, &lower, &upper));
+	eq(upper, (int) gen_loc_cnt - 1);
+	require(gen_loc_find(SIDE - 1, SIDE - 1, 1, &lower, &upper));
+	eq(upper, 0);
+
+	/* An emptied list finds nothing */
+	gen_loc_cnt = 0;
+	gen_loc_list_reindex();
+	require(!gen_loc_find(0, 0, 0, &lower, &upper));
+	eq(upper, 0);
+	ok;
+}
+
+const char *suite_name = "cave/gen-loc";
+struct test tests[] = {
+	{ "make", test_make },
+	{ "find", test_find },
+	{ "reindex", test_reindex },
+	{ NULL, NULL }
+};
@@ -0,0 +1,274 @@
+/* cave/pregen */
+/* Check chunks generated ahead of the player match those generated when
+ * the player arrives. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "player-birth.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list();
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Move the player directly, without any of the side effects of moving in play
+ */
+static void move_player(struct chunk *c, struct loc grid)
+{
+	square_set_mon(c, player->grid, 0);
+	player->grid = grid;
+	square_set_mon(c, grid, -1);
+}
+
+/**
+ * Find the chunk list entry for a chunk relative to the player's
+ */
+static int find_near(int y_offset, int x_offset)
+{
+	struct chunk_ref ref = { 0 };
+
+	ref.y_pos = chunk_list[player->place].y_pos + y_offset;
+	ref.x_pos = chunk_list[player->place].x_pos + x_offset;
+	return chunk_find(ref);
+}
+
+static uint8_t ahead[ARENA_CHUNKS][CHUNK_SIDE][CHUNK_SIDE];
+
+static int test_ahead(void *state) {
+	struct chunk_cache_stats before = chunk_cache_stats;
+	struct rng_ctx game = Rand_game;
+	int centre = (ARENA_CHUNKS / 2) * CHUNK_SIDE;
+	int i, y, x;
+
+	require(!player->depth);
+	eq(cave->width, ARENA_SIDE);
+
+	/* Head for the east edge of the centre chunk */
+	move_player(cave, loc(centre + CHUNK_SIDE - 3, centre + CHUNK_SIDE / 2));
+	for (i = 0; i < ARENA_CHUNKS; i++) {
+		chunk_pregenerate(player);
+	}
+	eq(chunk_cache_stats.pregenerated - before.pregenerated, ARENA_CHUNKS);
+	eq(chunk_cache_stats.hits, before.hits);
+
+	/* None of it draws from the game's generator */
+	eq(Rand_game.state_i, game.state_i);
+	require(!memcmp(Rand_game.state, game.state, sizeof(game.state)));
+
+	/* The chunks beyond that edge are waiting in the chunk list */
+	for (i = 0; i < ARENA_CHUNKS; i++) {
+		int idx = find_near(i - ARENA_CHUNKS / 2, ARENA_CHUNKS / 2 + 1);
+		struct chunk *c;
+
+		require(idx != MAX_CHUNKS);
+		require(chunk_is_staged(idx));
+		c = chunk_list[idx].chunk;
+		require(c);
+		for (y = 0; y < CHUNK_SIDE; y++) {
+			for (x = 0; x < CHUNK_SIDE; x++) {
+				ahead[i][y][x] = square(c, loc(x, y))->feat;
+			}
+		}
+	}
+
+	/* Nothing more is needed */
+	chunk_pregenerate(player);
+	eq(chunk_cache_stats.pregenerated - before.pregenerated, ARENA_CHUNKS);
+	ok;
+}
+
+static int test_cross(void *state) {
+	struct chunk_cache_stats before = chunk_cache_stats;
+	int i, y, x, x0 = (ARENA_CHUNKS - 1) * CHUNK_SIDE;
+	struct chunk_ref ref = { 0 };
+
+	/* Crossing reads the chunks in rather than generating them */
+	chunk_change(player, 0, 0, 1);
+	eq(chunk_cache_stats.misses, before.misses);
+	eq(chunk_cache_stats.pregen_used - before.pregen_used, ARENA_CHUNKS);
+	for (i = 0; i < ARENA_CHUNKS; i++) {
+		int idx = find_near(i - ARENA_CHUNKS / 2, ARENA_CHUNKS / 2);
+		int y0 = i * CHUNK_SIDE;
+
+		require(idx != MAX_CHUNKS);
+		require(!chunk_is_staged(idx));
+		ptreq(chunk_list[idx].chunk, NULL);
+		for (y = 0; y < CHUNK_SIDE; y++) {
+			for (x = 0; x < CHUNK_SIDE; x++) {
+				eq(square(cave, loc(x0 + x, y0 + y))->feat, ahead[i][y][x]);
+			}
+		}
+	}
+
+	/* Generating the last of them now gives the same terrain */
+	ref.y_pos = chunk_list[player->place].y_pos + ARENA_CHUNKS / 2;
+	ref.x_pos = chunk_list[player->place].x_pos + ARENA_CHUNKS / 2;
+	(void) chunk_fill(cave, &ref, ARENA_CHUNKS - 1, ARENA_CHUNKS - 1);
+	for (y = 0; y < CHUNK_SIDE; y++) {
+		for (x = 0; x < CHUNK_SIDE; x++) {
+			eq(square(cave, loc(x0 + x, x0 + y))->feat,
+			   ahead[ARENA_CHUNKS - 1][y][x]);
+		}
+	}
+	ok;
+}
+
+static int test_rng(void *state) {
+	struct chunk_ref ref = chunk_list[player->place];
+	struct chunk *c1 = chunk_new(ARENA_SIDE, ARENA_SIDE);
+	struct chunk *c2 = chunk_new(ARENA_SIDE, ARENA_SIDE);
+	struct rng_ctx rng, other, before;
+	int lower, upper, y, x;
+	uint32_t seed;
+
+	require(gen_loc_find(ref.x_pos, ref.y_pos, 0, &lower, &upper));
+	seed = gen_loc_list[upper].seed;
+	require(seed);
+
+	/* Surface terrain only draws from the generator it is given */
+	rng_state_init(&other, 7);
+	before = other;
+	rng_use(&other);
+	rng_quick_init(&rng, seed);
+	(void) surface_gen(c1, &ref, 1, 1, NULL, &rng);
+	ptreq(Rand_ctx, &other);
+	rng_use_game();
+	eq(other.state_i, before.state_i);
+	require(!memcmp(other.state, before.state, sizeof(other.state)));
+
+	/* So it comes out the same whatever else is going on */
+	rng_quick_init(&rng, seed);
+	(void) surface_gen(c2, &ref, 1, 1, NULL, &rng);
+	for (y = CHUNK_SIDE; y < 2 * CHUNK_SIDE; y++) {
+		for (x = CHUNK_SIDE; x < 2 * CHUNK_SIDE; x++) {
+			eq(square(c1, loc(x, y))->feat, square(c2, loc(x, y))->feat);
+		}
+	}
+	chunk_wipe(c1);
+	chunk_wipe(c2);
+	ok;
+}
+
+/**
+ * Take a copy of the terrain of a whole level
+ */
+static uint8_t *copy_terrain(struct chunk *c)
+{
+	uint8_t *feat = mem_zalloc(c->height * c->width * sizeof(*feat));
+	int y, x;
+
+	for (y = 0; y < c->height; y++) {
+		for (x = 0; x < c->width; x++) {
+			feat[y * c->width + x] = square(c, loc(x, y))->feat;
+		}
+	}
+	return feat;
+}
+
+static int test_dungeon(void *state) {
+	struct loc grid = player->grid;
+	uint8_t *first, *again;
+	int i;
+
+	/* The first visit places monsters and objects as it goes */
+	chunk_change(player, 1, 0, 0);
+	prepare_next_level(player);
+	eq(player->depth, 1);
+	first = copy_terrain(cave);
+
+	/* Go back up, and move the game's generator on */
+	chunk_change(player, -1, 0, 0);
+	player->grid = grid;
+	prepare_next_level(player);
+	eq(player->depth, 0);
+	for (i = 0; i < 1000; i++) {
+		(void) randint0(100);
+	}
+
+	/* Rebuilding the level without them gives the same terrain */
+	chunk_change(player, 1, 0, 0);
+	prepare_next_level(player);
+	eq(player->depth, 1);
+	again = copy_terrain(cave);
+	require(!memcmp(first, again, cave->height * cave->width));
+	mem_free(first);
+	mem_free(again);
+	ok;
+}
+
+static int test_vault(void *state) {
+	struct dun_data dun_body = { 0 };
+	struct chunk *c1 = chunk_new(ARENA_SIDE, ARENA_SIDE);
+	struct chunk *c2 = chunk_new(ARENA_SIDE, ARENA_SIDE);
+	struct loc centre = loc(ARENA_SIDE / 2, ARENA_SIDE / 2);
+	struct rng_ctx rng, other;
+	struct vault *v1, *v2;
+	bool rotated = false;
+	uint8_t *first, *again;
+
+	/* Rebuilding, so only terrain is made */
+	dun = &dun_body;
+	c1->depth = c2->depth = 10;
+	fill_rectangle(c1, 0, 0, c1->height - 1, c1->width - 1, FEAT_GRANITE,
+				   SQUARE_NONE);
+	fill_rectangle(c2, 0, 0, c2->height - 1, c2->width - 1, FEAT_GRANITE,
+				   SQUARE_NONE);
+
+	/* The vault and its terrain come from the generator it is given */
+	rng_quick_init(&rng, 1234);
+	v1 = random_vault(&rng, c1->depth, "Lesser vault", false);
+	require(v1);
+	require(build_vault(c1, &rng, &centre, &rotated, v1));
+
+	/* Whatever generator is bound meanwhile */
+	rng_state_init(&other, 7);
+	rng_use(&other);
+	centre = loc(ARENA_SIDE / 2, ARENA_SIDE / 2);
+	rng_quick_init(&rng, 1234);
+	v2 = random_vault(&rng, c2->depth, "Lesser vault", false);
+	ptreq(v2, v1);
+	require(build_vault(c2, &rng, &centre, &rotated, v2));
+	ptreq(Rand_ctx, &other);
+	rng_use_game();
+
+	first = copy_terrain(c1);
+	again = copy_terrain(c2);
+	require(!memcmp(first, again, c1->height * c1->width));
+	mem_free(first);
+	mem_free(again);
+	chunk_wipe(c1);
+	chunk_wipe(c2);
+	dun = NULL;
+	ok;
+}
+
+const char *suite_name = "cave/pregen";
+struct test tests[] = {
+	{ "ahead", test_ahead },
+	{ "cross", test_cross },
+	{ "rng", test_rng },
+	{ "dungeon", test_dungeon },
+	{ "vault", test_vault },
+	{ NULL, NULL }
+};
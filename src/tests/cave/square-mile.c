@@ -0,0 +1,290 @@
+/* cave/square-mile */
+/* Check the square miles of the map, and that they come through the cache
+ * of the map intact. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "parser.h"
+#include "player-birth.h"
+#include <time.h>
+
+#define MILES (MAX_Y_REGION * MAX_X_REGION)
+
+/**
+ * What is known about a river mile, to compare the map before and after it
+ * goes through the cache
+ */
+struct mile_record {
+	int river;
+	int stretch;
+	enum river_part part;
+	struct loc grid;
+	struct loc upstream;
+	struct loc next;
+	bool head;
+};
+
+static uint8_t biomes[MILES];
+static uint16_t regions[MILES];
+static struct mile_record *records;
+static int num_records;
+
+int setup_tests(void **state) {
+	set_file_paths();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(records);
+	wipe_mon_list();
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Go through the river miles of all the rivers, either noting them or
+ * checking they are as noted
+ */
+static bool check_rivers(bool note) {
+	int i, n = 0;
+
+	for (i = 0; i < z_info->river_max; i++) {
+		struct river_stretch *stretch;
+
+		for (stretch = river_info[i].stretch; stretch;
+			 stretch = stretch->next) {
+			struct river_mile *r_mile;
+
+			for (r_mile = stretch->miles; r_mile; r_mile = r_mile->downstream) {
+				struct mile_record rec = { 0 };
+
+				rec.river = r_mile->river->index;
+				rec.stretch = r_mile->stretch->index;
+				rec.part = r_mile->part;
+				rec.grid = r_mile->sq_mile;
+				rec.upstream = r_mile->upstream ? r_mile->upstream->sq_mile :
+					loc(-1, -1);
+				rec.next = r_mile->next ? r_mile->next->sq_mile : loc(-1, -1);
+				rec.head = square_mile_river_miles(r_mile->sq_mile) == r_mile;
+				if (note) {
+					records = mem_realloc(records, (n + 1) * sizeof(rec));
+					records[n] = rec;
+				} else if ((n >= num_records) ||
+						   memcmp(&records[n], &rec, sizeof(rec))) {
+					return false;
+				}
+				n++;
+			}
+		}
+	}
+	if (note) num_records = n;
+	return n == num_records;
+}
+
+/**
+ * Start the game and get the player onto the first level, giving the wall
+ * clock time taken, or a negative time if it failed
+ */
+static double time_to_first_frame(void)
+{
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (!init_angband()) return -1.0;
+	if (!player_make_simple(NULL, NULL, NULL, "Tester")) return -1.0;
+	prepare_next_level(player);
+	on_new_level();
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (double) (end.tv_sec - start.tv_sec) +
+		(double) (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+static int test_cache(void *state) {
+	char path[1024];
+	double cold, warm;
+	struct loc grid;
+
+	/* Without the cache the map is parsed, and the cache written */
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, "world-map.dat");
+	if (file_exists(path)) file_delete(path);
+	cold = time_to_first_frame();
+	require(cold >= 0.0);
+	require(file_exists(path));
+	for (grid.y = 0; grid.y < MAX_Y_REGION; grid.y++) {
+		for (grid.x = 0; grid.x < MAX_X_REGION; grid.x++) {
+			struct square_mile sq_mile = square_mile(grid);
+			biomes[grid.y * MAX_X_REGION + grid.x] = sq_mile.biome;
+			regions[grid.y * MAX_X_REGION + grid.x] = square_mile_region(grid);
+		}
+	}
+	require(check_rivers(true));
+	require(num_records > 0);
+	wipe_mon_list();
+	play_again = true;
+	cleanup_angband();
+	play_again = false;
+
+	/* With it the map is the same */
+	warm = time_to_first_frame();
+	require(warm >= 0.0);
+	for (grid.y = 0; grid.y < MAX_Y_REGION; grid.y++) {
+		for (grid.x = 0; grid.x < MAX_X_REGION; grid.x++) {
+			eq(square_mile_biome(grid), biomes[grid.y * MAX_X_REGION + grid.x]);
+			eq(square_mile_region(grid),
+			   regions[grid.y * MAX_X_REGION + grid.x]);
+		}
+	}
+	require(check_rivers(false));
+
+	if (verbose) {
+		printf("\n    first frame after %.3fs without the map cache, "
+			   "%.3fs with it  ", cold, warm);
+	}
+	ok;
+}
+
+static int test_regions(void *state) {
+	struct parser *p = init_parse_region();
+	struct world_region *reg, *next;
+	uint8_t *src_biomes = mem_alloc(MILES);
+	uint16_t *src_regions = mem_zalloc(MILES * sizeof(*src_regions));
+	struct loc grid;
+	int i, y, x;
+
+	/* Read region.txt again; as in the game, the last region in the file
+	 * is the first in the list, and each region overwrites those before it
+	 * in the list */
+	memset(src_biomes, BIOME_OCEAN, MILES);
+	eq(parse_file_quit_not_found(p, "region"), 0);
+	for (reg = parser_priv(p), i = 1; reg; reg = reg->next, i++) {
+		require(i < z_info->region_max);
+		require(streq(reg->name, region_info[i].name));
+		for (y = 0; y < reg->height; y++) {
+			for (x = 0; x < reg->width; x++) {
+				char terrain = reg->text[y * reg->width + x];
+				int idx = (y + reg->y_offset) * MAX_X_REGION +
+					x + reg->x_offset;
+
+				if (terrain == ' ') continue;
+				src_biomes[idx] = terrain;
+				src_regions[idx] = i;
+			}
+		}
+	}
+	eq(i, z_info->region_max);
+	for (reg = parser_priv(p); reg; reg = next) {
+		next = reg->next;
+		mem_free(reg->name);
+		mem_free(reg->text);
+		mem_free(reg);
+	}
+	parser_destroy(p);
+
+	/* The square miles are as it says */
+	for (grid.y = 0; grid.y < MAX_Y_REGION; grid.y++) {
+		for (grid.x = 0; grid.x < MAX_X_REGION; grid.x++) {
+			int idx = grid.y * MAX_X_REGION + grid.x;
+
+			eq(square_mile_biome(grid), src_biomes[idx]);
+			eq(square_mile_region(grid), src_regions[idx]);
+		}
+	}
+	mem_free(src_biomes);
+	mem_free(src_regions);
+
+	for (i = 1; i < z_info->region_max; i++) {
+		struct world_region *reg = &region_info[i];
+		int count = 0;
+
+		for (y = 0; y < reg->height; y++) {
+			for (x = 0; x < reg->width; x++) {
+				struct loc grid = loc(x + reg->x_offset, y + reg->y_offset);
+				struct square_mile sq_mile = square_mile(grid);
+
+				if (square_mile_region(grid) != i) continue;
+				count++;
+				ptreq(sq_mile.region, reg);
+				eq(find_region(grid.y * CPM + CPM / 2, grid.x * CPM), i);
+				eq(sq_mile.map_grid.x, grid.x);
+				eq(sq_mile.map_grid.y, grid.y);
+				eq(sq_mile.map_square.number, grid.x / MPS + 1);
+				eq(sq_mile.map_square_grid.y, grid.y % MPS);
+			}
+		}
+		require(count > 0);
+	}
+
+	/* Off the map is all ocean */
+	eq(square_mile_biome(loc(-1, 0)), BIOME_OCEAN);
+	eq(square_mile_biome(loc(0, MAX_Y_REGION)), BIOME_OCEAN);
+	eq(square_mile_region(loc(MAX_X_REGION, 0)), 0);
+	ok;
+}
+
+static int test_grid(void *state) {
+	struct square_mile sq_mile = square_mile(square_mile_grid(L'J', 3, 4, 5));
+
+	eq(sq_mile.map_square.letter, 'J');
+	eq(sq_mile.map_square.number, 3);
+	eq(sq_mile.map_square_grid.y, 4);
+	eq(sq_mile.map_square_grid.x, 5);
+	eq(sq_mile.map_grid.y, 8 * MPS + 4);
+	eq(sq_mile.map_grid.x, 2 * MPS + 5);
+	ok;
+}
+
+static int test_rivers(void *state) {
+	int i, miles = 0;
+
+	/* Every river mile can be found from its square mile */
+	for (i = 0; i < z_info->river_max; i++) {
+		struct river_stretch *stretch;
+
+		for (stretch = river_info[i].stretch; stretch;
+			 stretch = stretch->next) {
+			struct river_mile *r_mile;
+
+			for (r_mile = stretch->miles; r_mile; r_mile = r_mile->downstream) {
+				struct river_mile *check;
+
+				if (r_mile->stretch != stretch) continue;
+				check = square_mile_river_miles(r_mile->sq_mile);
+				while (check && (check->river != r_mile->river)) {
+					check = check->next;
+				}
+				notnull(check);
+				miles++;
+			}
+		}
+	}
+	require(miles > 0);
+	ptreq(square_mile_river_miles(loc(-1, -1)), NULL);
+	ok;
+}
+
+static int test_mapped(void *state) {
+	struct loc grid = loc(MAX_X_REGION - 1, MAX_Y_REGION - 1);
+
+	eq(square_mile_is_mapped(grid), false);
+	square_mile_set_mapped(grid);
+	eq(square_mile_is_mapped(grid), true);
+	eq(square_mile(grid).mapped, true);
+	eq(square_mile_is_mapped(loc(grid.x - 1, grid.y)), false);
+	eq(square_mile_is_mapped(loc(-1, -1)), false);
+	ok;
+}
+
+const char *suite_name = "cave/square-mile";
+struct test tests[] = {
+	{ "cache", test_cache },
+	{ "regions", test_regions },
+	{ "grid", test_grid },
+	{ "rivers", test_rivers },
+	{ "mapped", test_mapped },
+	{ NULL, NULL }
+};
@@ -1,3 +1,8 @@
 TESTPROGS += \
+	cave/chunk-list \
 	cave/find \
-	cave/scatter
+	cave/gen-loc \
+	cave/pregen \
+	cave/scatter \
+	cave/square-mile \
+	cave/view
@@ -0,0 +1,227 @@
+/* cave/view */
+/* Check update_view() against a view worked out for every grid. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "player-birth.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+
+#define VIEW_MOVES 150
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list();
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Whether a grid should be in the view, and whether seen and close, using
+ * the rules of update_view() applied to every grid of the chunk
+ */
+static void reference_view(struct chunk *c, struct player *p, struct loc grid,
+						   bool *view, bool *seen, bool *close)
+{
+	int x = grid.x, y = grid.y, xc = x, yc = y;
+	int d = distance(grid, p->grid);
+
+	*view = *seen = *close = false;
+
+	/* The player grid */
+	if (loc_eq(grid, p->grid)) {
+		*view = true;
+		*seen = *close = (p->upkeep->cur_light > 0) ||
+			square_islit(c, grid);
+		return;
+	}
+
+	/* Too far away */
+	if (d > z_info->max_sight) return;
+
+	/* Walls may take line of sight from the grid towards the player */
+	if (!square_allowslos(c, grid)) {
+		int dx = x - p->grid.x, dy = y - p->grid.y;
+		int sx = dx > 0 ? 1 : -1, sy = dy > 0 ? 1 : -1;
+
+		xc = (x < p->grid.x) ? (x + 1) : (x > p->grid.x) ? (x - 1) : x;
+		yc = (y < p->grid.y) ? (y + 1) : (y > p->grid.y) ? (y - 1) : y;
+		if (!square_allowslos(c, loc(xc, yc))) {
+			xc = x;
+			yc = y;
+		}
+		if ((ABS(dx) == 2) && (ABS(dy) == 1)) {
+			if (square_allowslos(c, loc(x - sx, y)) &&
+				!square_allowslos(c, loc(x - sx, y - sy))) {
+				xc = x;
+				yc = y;
+			}
+		} else if ((ABS(dx) == 1) && (ABS(dy) == 2)) {
+			if (square_allowslos(c, loc(x, y - sy)) &&
+				!square_allowslos(c, loc(x - sx, y - sy))) {
+				xc = x;
+				yc = y;
+			}
+		}
+	}
+	if (!los(c, p->grid, loc(xc, yc))) return;
+
+	*view = true;
+	*close = (d < p->upkeep->cur_light) || is_daylight();
+	*seen = *close;
+	if (square_islit(c, grid)) {
+		if (square_allowslos(c, grid)) {
+			*seen = true;
+		} else {
+			xc = (x < p->grid.x) ? (x + 1) : (x > p->grid.x) ? (x - 1) : x;
+			yc = (y < p->grid.y) ? (y + 1) : (y > p->grid.y) ? (y - 1) : y;
+			if (square_islit(c, loc(xc, yc))) *seen = true;
+		}
+	}
+}
+
+/**
+ * Move the player directly, without any of the side effects of moving in play
+ */
+static void move_player(struct chunk *c, struct loc grid)
+{
+	square_set_mon(c, player->grid, 0);
+	player->grid = grid;
+	square_set_mon(c, grid, -1);
+}
+
+static int test_same(void *state) {
+	struct chunk *c = cave;
+	int max_sight = z_info->max_sight;
+	int i;
+
+	for (i = 0; i < VIEW_MOVES; i++) {
+		struct loc grid;
+		int y, x;
+
+		/* Half the time see less far than the whole chunk */
+		z_info->max_sight = (i < VIEW_MOVES / 2) ? 20 : max_sight;
+
+		/* Mostly step, sometimes jump far away */
+		if (one_in_(5)) {
+			grid = loc(rand_range(1, c->width - 2),
+					   rand_range(1, c->height - 2));
+		} else {
+			grid = loc_sum(player->grid, ddgrid_ddd[randint0(8)]);
+		}
+		if (square_in_bounds_fully(c, grid) && square_ispassable(c, grid) &&
+			!square_monster(c, grid)) {
+			move_player(c, grid);
+		}
+
+		/* Change some terrain */
+		grid = loc(rand_range(1, c->width - 2), rand_range(1, c->height - 2));
+		if (!square(c, grid)->mon && !square_object(c, grid)) {
+			square_set_feat(c, grid, one_in_(2) ? FEAT_GRANITE : FEAT_FLOOR);
+		}
+
+		/* Vary the light, and sometimes write stray view flags as copying
+		 * in stored chunks can */
+		player->upkeep->cur_light = randint0(4);
+		if (one_in_(10)) {
+			grid = loc(rand_range(1, c->width - 2),
+					   rand_range(1, c->height - 2));
+			sqinfo_on(square(c, grid)->info, SQUARE_VIEW);
+			sqinfo_on(square(c, grid)->info, SQUARE_SEEN);
+			forget_view(c);
+		}
+
+		update_view(c, player);
+		for (y = 0; y < c->height; y++) {
+			for (x = 0; x < c->width; x++) {
+				bool view, seen, close;
+
+				grid = loc(x, y);
+				reference_view(c, player, grid, &view, &seen, &close);
+				eq(square_isview(c, grid), view);
+				eq(square_isseen(c, grid), seen);
+				eq(sqinfo_has(square(c, grid)->info, SQUARE_CLOSE_PLAYER),
+				   close);
+				eq(square_wasseen(c, grid), false);
+			}
+		}
+	}
+	z_info->max_sight = max_sight;
+	ok;
+}
+
+/**
+ * Whether every grid strictly between two in the same row is projectable,
+ * going by the terrain itself
+ */
+static bool reference_row_los(struct chunk *c, struct loc grid1,
+							  struct loc grid2)
+{
+	int x;
+
+	for (x = MIN(grid1.x, grid2.x) + 1; x < MAX(grid1.x, grid2.x); x++) {
+		if (!feat_is_projectable(square(c, loc(x, grid1.y))->feat)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int test_layers(void *state) {
+	struct chunk *c = cave;
+	struct loc grid;
+	int i;
+
+	/* Change terrain to all sorts of features */
+	for (i = 0; i < 2000; i++) {
+		grid = loc(rand_range(1, c->width - 2), rand_range(1, c->height - 2));
+		if (square(c, grid)->mon || square_object(c, grid)) continue;
+		square_set_feat(c, grid, randint1(FEAT_MAX - 1));
+	}
+
+	/* The layers agree with the terrain everywhere */
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			int feat = square(c, grid)->feat;
+
+			eq(square_isprojectable(c, grid), feat_is_projectable(feat));
+			eq(square_ispassable(c, grid), feat_is_passable(feat));
+			eq(square_allowslos(c, grid), feat_is_los(feat));
+		}
+	}
+
+	/* Sight along rows, which is checked a word at a time */
+	for (i = 0; i < 2000; i++) {
+		struct loc grid1 = loc(randint0(c->width), randint0(c->height));
+		struct loc grid2 = loc(randint0(c->width), grid1.y);
+
+		if (ABS(grid2.x - grid1.x) < 2) continue;
+		eq(los(c, grid1, grid2), reference_row_los(c, grid1, grid2));
+	}
+	ok;
+}
+
+const char *suite_name = "cave/view";
+struct test tests[] = {
+	{ "same", test_same },
+	{ "layers", test_layers },
+	{ NULL, NULL }
+};
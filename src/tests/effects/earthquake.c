@@ -42,6 +42,8 @@ static struct chunk *create_empty_cave(int height, int width) {
 	struct chunk *c = chunk_new(height, width);
 	struct loc grid;
 
+	chunk_set_live(c);
+
 	grid.y = 0;
 	for (grid.x = 0; grid.x < width; ++grid.x) {
 		square_set_feat(c, grid, FEAT_PERM);
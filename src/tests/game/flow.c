@@ -0,0 +1,355 @@
+/* game/flow */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "player-birth.h"
+#include "player-calcs.h"
+#include "player-util.h"
+#include "z-queue.h"
+#include "z-rand.h"
+
+#include <time.h>
+
+#define FLOW_HGT 66
+#define FLOW_WID 132
+#define FLOW_MOVES 400
+#define FLOW_MONSTERS 12
+
+static struct loc moves[FLOW_MOVES];
+static struct loc doors[FLOW_MOVES];
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * The cost of a grid to a flow, as originally calculated
+ */
+static int reference_cost(struct chunk *c, struct loc grid,
+						  struct monster *mon)
+{
+	int cost = 0;
+
+	if (mon) {
+		bool bash = false;
+		int chance = monster_entry_chance(c, mon, grid, &bash);
+
+		if (chance <= 0) return -1;
+		cost += (100 / chance) - 1;
+		if (square_iscloseddoor(c, grid)) {
+			if (!(bash || rf_has(mon->race->flags, RF_PASS_DOOR) ||
+				  rf_has(mon->race->flags, RF_PASS_WALL))) {
+				cost += 1;
+			}
+		} else if (square_isdiggable(c, grid) &&
+				   rf_has(mon->race->flags, RF_TUNNEL_WALL)) {
+			cost += square_isrubble(c, grid) ? 1 : 2;
+		} else if (square_iswall(c, grid) &&
+				   rf_has(mon->race->flags, RF_KILL_WALL)) {
+			cost += 1;
+		}
+	} else {
+		if (square_iswall(c, grid) && !square_isdoor(c, grid)) {
+			return -1;
+		}
+		if (square_iscloseddoor(c, grid) || square_issecretdoor(c, grid)) {
+			cost += 5;
+		}
+	}
+	return cost;
+}
+
+/**
+ * A flow as originally calculated, with a full reset and a breadth-first
+ * search which re-queues grids until their value comes up
+ */
+static void reference_flow(struct chunk *c, struct flow *flow,
+						   struct monster *mon)
+{
+	struct loc next = flow->centre;
+	int y, x, d;
+	int value = 0;
+	struct queue *queue = q_new(c->height * c->width);
+
+	for (y = 1; y < c->height - 1; y++) {
+		for (x = 1; x < c->width - 1; x++) {
+			flow->grids[y][x] = z_info->flow_max;
+		}
+	}
+	flow->grids[next.y][next.x] = 0;
+	q_push_int(queue, next.y * c->width + next.x);
+	value++;
+	while ((q_len(queue) > 0) && (value < z_info->flow_max)) {
+		int count = q_len(queue);
+		while (count) {
+			int i = q_pop_int(queue);
+			next = loc(i % c->width, i / c->width);
+			count--;
+			if (flow->grids[next.y][next.x] > value) {
+				q_push_int(queue, i);
+				continue;
+			}
+			for (d = 0; d < 8; d++)	{
+				struct loc grid = loc_sum(next, ddgrid_ddd[d]);
+				struct monster *grid_mon;
+				int cost;
+
+				if (!square_in_bounds(c, grid)) continue;
+				if (flow->grids[grid.y][grid.x] < z_info->flow_max) continue;
+				cost = reference_cost(c, grid, mon);
+				if (cost < 0) continue;
+				flow->grids[grid.y][grid.x] = value + cost;
+				q_push_int(queue, grid.y * c->width + grid.x);
+				grid_mon = square_monster(c, grid);
+				if (grid_mon) {
+					grid_mon->target.grid = loc(0, 0);
+				}
+			}
+		}
+		value++;
+	}
+	q_free(queue);
+}
+
+/**
+ * Make a maze-like cave with walls and doors, and record a random walk
+ * through it, with some turns standing still and some doors changing
+ */
+static struct chunk *make_cave(void)
+{
+	struct chunk *c = t_build_arena(FLOW_HGT, FLOW_WID);
+	struct loc grid = loc(FLOW_WID / 2, FLOW_HGT / 2);
+	int i;
+
+	for (i = 0; i < FLOW_HGT * FLOW_WID / 3; i++) {
+		struct loc wall = loc(rand_range(1, FLOW_WID - 2),
+							  rand_range(1, FLOW_HGT - 2));
+		if (loc_eq(wall, grid)) continue;
+		square_set_feat(c, wall, one_in_(6) ? FEAT_CLOSED : FEAT_GRANITE);
+	}
+	for (i = 0; i < FLOW_MOVES; i++) {
+		struct loc step = loc_sum(grid, ddgrid_ddd[randint0(8)]);
+
+		/* Stand still sometimes, otherwise move onto any passable grid */
+		if (!one_in_(4) && square_in_bounds_fully(c, step) &&
+			square_ispassable(c, step)) {
+			grid = step;
+		}
+		moves[i] = grid;
+
+		/* Sometimes change a door */
+		doors[i] = one_in_(5) ? loc(rand_range(1, FLOW_WID - 2),
+									rand_range(1, FLOW_HGT - 2)) : loc(0, 0);
+		if (loc_eq(doors[i], grid)) doors[i] = loc(0, 0);
+	}
+	return c;
+}
+
+static void toggle_door(struct chunk *c, struct loc grid)
+{
+	if (loc_is_zero(grid)) return;
+	square_set_feat(c, grid, square_iscloseddoor(c, grid) ?
+					FEAT_OPEN : FEAT_CLOSED);
+}
+
+static int test_same(void *state) {
+	struct chunk *c;
+	struct flow flow, ref;
+	int i, y, x;
+
+	Rand_init();
+	c = make_cave();
+	flow_new(c, &flow);
+	flow_new(c, &ref);
+	for (i = 0; i < FLOW_MOVES; i++) {
+		toggle_door(c, doors[i]);
+		flow.centre = moves[i];
+		ref.centre = moves[i];
+		update_flow(c, &flow, NULL);
+		reference_flow(c, &ref, NULL);
+		for (y = 0; y < c->height; y++) {
+			for (x = 0; x < c->width; x++) {
+				eq(flow.grids[y][x], ref.grids[y][x]);
+			}
+		}
+	}
+	flow_free(c, &flow);
+	flow_free(c, &ref);
+	chunk_wipe(c);
+	ok;
+}
+
+/**
+ * Move a monster or the player directly, without any of the side effects of
+ * moving in play
+ */
+static void move_occupant(struct chunk *c, struct loc from, struct loc to)
+{
+	int midx = square(c, from)->mon;
+
+	if (midx > 0) {
+		monster(midx)->grid = to;
+	} else {
+		player->grid = to;
+	}
+	square_set_mon(c, from, 0);
+	square_set_mon(c, to, midx);
+}
+
+static void move_randomly(struct chunk *c, struct loc from)
+{
+	struct loc to = loc_sum(from, ddgrid_ddd[randint0(8)]);
+
+	if (square_in_bounds_fully(c, to) && square_isempty(c, to)) {
+		move_occupant(c, from, to);
+	}
+}
+
+static void mark_targets(void)
+{
+	int i;
+
+	for (i = 1; i < mon_max; i++) {
+		monster(i)->target.grid = loc(1, 1);
+	}
+}
+
+static int test_monsters(void *state) {
+	struct monster *mons[FLOW_MONSTERS];
+	struct flow ref;
+	bool reset[FLOW_MONSTERS];
+	int i, j, k, y, x;
+
+	Rand_init();
+	character_dungeon = false;
+	cave = make_cave();
+	player->cave = chunk_new(cave->height, cave->width);
+	player_place(cave, player, moves[0]);
+	for (i = 0; i < FLOW_MONSTERS; i++) {
+		struct loc grid;
+
+		do {
+			grid = loc(rand_range(1, FLOW_WID - 2),
+					   rand_range(1, FLOW_HGT - 2));
+		} while (!square_isempty(cave, grid));
+		mons[i] = t_add_monster(cave, grid,
+								(i % 3) ? "Orc soldier" : "Orc archer");
+		mons[i]->alertness = ALERTNESS_ALERT;
+	}
+	character_dungeon = true;
+	flow_new(cave, &ref);
+	memset(&flow_cache_stats, 0, sizeof(flow_cache_stats));
+
+	for (i = 0; i < FLOW_MOVES / 4; i++) {
+		toggle_door(cave, doors[i]);
+		if (one_in_(2)) move_randomly(cave, player->grid);
+		for (j = 0; j < FLOW_MONSTERS; j++) {
+			struct monster *mon = mons[j];
+
+			/* Move some monsters between flows, and frighten others */
+			if (one_in_(4)) {
+				move_randomly(cave, mons[randint0(FLOW_MONSTERS)]->grid);
+			}
+			if (one_in_(20)) {
+				mons[randint0(FLOW_MONSTERS)]->stance = STANCE_FLEEING;
+			}
+
+			/* The original flow, and which targets it resets */
+			mark_targets();
+			ref.centre = player->grid;
+			reference_flow(cave, &ref, mon);
+			for (k = 0; k < FLOW_MONSTERS; k++) {
+				reset[k] = loc_is_zero(mons[k]->target.grid);
+			}
+
+			/* The flow now */
+			mark_targets();
+			mon->flow.centre = player->grid;
+			update_flow(cave, &mon->flow, mon);
+			for (k = 0; k < FLOW_MONSTERS; k++) {
+				eq(loc_is_zero(mons[k]->target.grid), reset[k]);
+			}
+			for (y = 0; y < cave->height; y++) {
+				for (x = 0; x < cave->width; x++) {
+					eq(mon->flow.grids[y][x], ref.grids[y][x]);
+				}
+			}
+		}
+	}
+
+	/* Monsters standing still have shared */
+	require(flow_cache_stats.shared > 0);
+	require(flow_cache_stats.calculated > 0);
+
+	flow_free(cave, &ref);
+	chunk_wipe(player->cave);
+	player->cave = NULL;
+	chunk_wipe(cave);
+	cave = NULL;
+	ok;
+}
+
+/**
+ * Time the original and the current calculation over the same moves
+ */
+static int test_benchmark(void *state) {
+	struct chunk *c;
+	struct flow flow;
+	clock_t start;
+	double full, current;
+	int i;
+
+	Rand_init();
+	c = make_cave();
+	flow_new(c, &flow);
+
+	start = clock();
+	for (i = 0; i < FLOW_MOVES; i++) {
+		toggle_door(c, doors[i]);
+		flow.centre = moves[i];
+		reference_flow(c, &flow, NULL);
+	}
+	full = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (i = 0; i < FLOW_MOVES; i++) {
+		toggle_door(c, doors[i]);
+		flow.centre = moves[i];
+		update_flow(c, &flow, NULL);
+	}
+	current = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	if (verbose) {
+		printf("\n    %d flows: full %.3fs, incremental %.3fs  ",
+			   FLOW_MOVES, full, current);
+	}
+	flow_free(c, &flow);
+	chunk_wipe(c);
+	ok;
+}
+
+const char *suite_name = "game/flow";
+struct test tests[] = {
+	{ "same", test_same },
+	{ "monsters", test_monsters },
+	{ "benchmark", test_benchmark },
+	{ NULL, NULL }
+};
@@ -0,0 +1,151 @@
+/* game/rest */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <time.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-util.h"
+#include "savefile.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+#ifdef UNIX
+	/* Necessary for creating the randart file. */
+	create_needed_dirs();
+#endif
+	if (!player_make_simple(NULL, NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete("Rest");
+	file_delete("Rest" SAVEFILE_JOURNAL_SUFFIX);
+	wipe_mon_list();
+	cleanup_angband();
+	return 0;
+}
+
+static int test_rest_full(void *state) {
+	int32_t start_turn = turn;
+	int start_player_turn = player->resting_turn;
+	clock_t start = clock();
+	double elapsed;
+	int i;
+
+	/* Wound the player, then rest until healed or disturbed */
+	player->upkeep->playing = true;
+	for (i = 0; i < 20; i++) {
+		int32_t rest_turn = turn;
+
+		player->chp = 1;
+		player->csp = 0;
+		cmdq_push(CMD_REST);
+		cmd_set_arg_choice(cmdq_peek(), "choice", REST_ALL_POINTS);
+		run_game_loop();
+		require(!player->is_dead);
+		require(!player_is_resting(player));
+		require(turn > rest_turn);
+		require((player->chp == player->mhp) || (player->chp > 1));
+	}
+	elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+	if (verbose) {
+		printf("    %d player turns, %ld game turns, %.3fs\n",
+			   player->resting_turn - start_player_turn,
+			   (long) (turn - start_turn), elapsed);
+	}
+	ok;
+}
+
+/**
+ * Load the game saved in "Rest", then wound the player and rest until healed
+ * or disturbed a number of times
+ */
+static bool rest_from_save(bool skip, bool batch, int rests, int *chp,
+						   struct rng_ctx *rng) {
+	int i;
+
+	play_again = true;
+	wipe_mon_list();
+	cleanup_angband();
+	init_angband();
+	play_again = false;
+	if (!savefile_load("Rest", false)) return false;
+	on_new_level();
+
+	set_turn_skipping(skip, batch);
+	player->upkeep->playing = true;
+	for (i = 0; i < rests; i++) {
+		player->chp = 1;
+		player->csp = 0;
+		cmdq_push(CMD_REST);
+		cmd_set_arg_choice(cmdq_peek(), "choice", REST_ALL_POINTS);
+		run_game_loop();
+		if (player->is_dead) return false;
+	}
+	set_turn_skipping(true, true);
+	*chp = player->chp;
+	*rng = Rand_game;
+	return true;
+}
+
+static int test_rest_same(void *state) {
+	int32_t skip_turn;
+	int skip_chp, chp;
+	struct rng_ctx skip_rng, rng;
+
+	/* Resting gives the same result whether idle turns are skipped or not */
+	eq(savefile_save("Rest"), true);
+	require(rest_from_save(true, false, 5, &skip_chp, &skip_rng));
+	skip_turn = turn;
+	require(rest_from_save(false, false, 5, &chp, &rng));
+	eq(turn, skip_turn);
+	eq(chp, skip_chp);
+	eq(rng.value, skip_rng.value);
+	eq(rng.state_i, skip_rng.state_i);
+	require(!memcmp(rng.state, skip_rng.state, sizeof(rng.state)));
+	ok;
+}
+
+static int test_rest_batch(void *state) {
+	int32_t batch_turn, batch_player_turn;
+	int batch_chp, batch_csp, chp;
+	struct rng_ctx batch_rng, rng;
+
+	/* A rest with no monster awake ends on the same turn in the same state
+	 * when it is fast-forwarded, without the rolls for monsters hearing */
+	require(rest_from_save(true, true, 1, &batch_chp, &batch_rng));
+	batch_turn = turn;
+	batch_player_turn = player->turn;
+	batch_csp = player->csp;
+	require(rest_from_save(true, false, 1, &chp, &rng));
+	require(chp > 1);
+	eq(chp, batch_chp);
+	eq(player->csp, batch_csp);
+	eq(turn, batch_turn);
+	eq(player->turn, batch_player_turn);
+	require(memcmp(rng.state, batch_rng.state, sizeof(rng.state)) ||
+			(rng.state_i != batch_rng.state_i));
+	ok;
+}
+
+const char *suite_name = "game/rest";
+struct test tests[] = {
+	{ "rest-full", test_rest_full },
+	{ "rest-same", test_rest_same },
+	{ "rest-batch", test_rest_batch },
+	{ NULL, NULL }
+};
@@ -0,0 +1,436 @@
+/* game/save.c */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include <time.h>
+#include "cave.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "savefile.h"
+#include "player.h"
+#include "player-birth.h"
+#include "z-util.h"
+
+/* A well-travelled world: LOC_SIDE x LOC_SIDE locations on each of LOC_DEPTH
+ * levels, each with some terrain changes and edge joins */
+#define LOC_SIDE 100
+#define LOC_DEPTH 4
+#define LOC_CHANGES 10
+#define LOC_JOINS 4
+
+static uint32_t locations;
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+static void reset_before_load(void) {
+	play_again = true;
+	wipe_mon_list();
+	cleanup_angband();
+	init_angband();
+	play_again = false;
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+#ifdef UNIX
+	/* Necessary for creating the randart file. */
+	create_needed_dirs();
+#endif
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete("Test2");
+	file_delete("Test2" SAVEFILE_JOURNAL_SUFFIX);
+	file_delete("Test3");
+	file_delete("Test3" SAVEFILE_JOURNAL_SUFFIX);
+	wipe_mon_list();
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Fill the generated locations list with a large synthetic world
+ */
+static void make_world(void) {
+	int y, x, z, i;
+	struct chunk_ref *centre = &chunk_list[player->place];
+
+	for (z = 1; z <= LOC_DEPTH; z++) {
+		for (y = 0; y < LOC_SIDE; y++) {
+			for (x = 0; x < LOC_SIDE; x++) {
+				int lower, upper;
+				struct gen_loc *location;
+
+				if (gen_loc_find(centre->x_pos + x, centre->y_pos + y, z,
+								 &lower, &upper)) {
+					continue;
+				}
+				gen_loc_make(centre->x_pos + x, centre->y_pos + y, z, upper);
+				location = &gen_loc_list[upper];
+				location->seed = (uint32_t) upper * 2654435761U + 1;
+				for (i = 0; i < LOC_CHANGES; i++) {
+					struct terrain_change *change = terrain_change_new();
+					change->grid = loc(i, (x + i) % CHUNK_SIDE);
+					change->feat = FEAT_FLOOR;
+					change->next = location->change;
+					location->change = change;
+				}
+				for (i = 0; i < LOC_JOINS; i++) {
+					struct connector *join = connector_new();
+					join->grid = loc(i, CHUNK_SIDE - 1);
+					join->feat = FEAT_FLOOR;
+					join->info[0] = (bitflag) (y + i);
+					join->next = location->join;
+					location->join = join;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Get the size of a file in bytes
+ */
+static long file_bytes(const char *name) {
+	FILE *f = fopen(name, "rb");
+	long size;
+
+	if (!f) return -1;
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fclose(f);
+	return size;
+}
+
+static int test_large(void *state) {
+	clock_t start;
+	double first, again, load;
+	long bytes;
+	struct chunk_ref centre;
+	struct gen_loc *location;
+	struct terrain_change *change;
+	int lower, upper, num_changes = 0;
+
+	eq(player_make_simple(NULL, NULL, NULL, "Tester"), true);
+	prepare_next_level(player);
+	on_new_level();
+	notnull(cave);
+	make_world();
+	locations = gen_loc_cnt;
+	require(locations >= LOC_SIDE * LOC_SIDE * LOC_DEPTH);
+	centre = chunk_list[player->place];
+
+	/* Save twice; the second save knows how big each block will be */
+	start = clock();
+	eq(savefile_save("Test2"), true);
+	first = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	eq(savefile_save("Test2"), true);
+	again = (double) (clock() - start) / CLOCKS_PER_SEC;
+	bytes = file_bytes("Test2");
+	require(bytes > 0);
+
+	reset_before_load();
+	start = clock();
+	eq(savefile_load("Test2", false), true);
+	load = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	/* Everything came back */
+	eq(gen_loc_cnt, locations);
+	require(gen_loc_find(centre.x_pos + LOC_SIDE - 1,
+						 centre.y_pos + LOC_SIDE - 1, LOC_DEPTH,
+						 &lower, &upper));
+	location = &gen_loc_list[upper];
+	eq(location->seed, (uint32_t) upper * 2654435761U + 1);
+	for (change = location->change; change; change = change->next) {
+		num_changes++;
+	}
+	eq(num_changes, LOC_CHANGES);
+	notnull(location->join);
+	eq(location->join->info[0], (bitflag) (LOC_SIDE - 1));
+
+	if (verbose) {
+		printf("\n    %lu locations, %ld bytes: save %.3fs, save again %.3fs, "
+			   "load %.3fs  ", (unsigned long) locations, bytes, first, again,
+			   load);
+	}
+	ok;
+}
+
+static int test_journal(void *state) {
+	clock_t start;
+	double full, changes;
+	long bytes, journal_bytes;
+	struct chunk_ref centre = chunk_list[player->place];
+	struct gen_loc *location;
+	int lower, upper, new_x = centre.x_pos + LOC_SIDE, new_y = centre.y_pos;
+	uint32_t count;
+
+	/* Start from a full save */
+	start = clock();
+	eq(savefile_save("Test2"), true);
+	full = (double) (clock() - start) / CLOCKS_PER_SEC;
+	bytes = file_bytes("Test2");
+	eq(file_exists("Test2" SAVEFILE_JOURNAL_SUFFIX), false);
+	count = gen_loc_cnt;
+
+	/* Change one location and add another */
+	require(gen_loc_find(centre.x_pos, centre.y_pos, 1, &lower, &upper));
+	location = &gen_loc_list[upper];
+	location->seed = 12345;
+	location->dirty = true;
+	require(!gen_loc_find(new_x, new_y, 1, &lower, &upper));
+	gen_loc_make(new_x, new_y, 1, upper);
+	gen_loc_list[upper].seed = 54321;
+
+	/* Only the changes are written, and the savefile is left alone */
+	start = clock();
+	eq(savefile_save_changes("Test2"), true);
+	changes = (double) (clock() - start) / CLOCKS_PER_SEC;
+	eq(file_bytes("Test2"), bytes);
+	journal_bytes = file_bytes("Test2" SAVEFILE_JOURNAL_SUFFIX);
+	require(journal_bytes > 0);
+	require(journal_bytes * 10 < bytes);
+
+	/* Loading puts the two together */
+	reset_before_load();
+	eq(savefile_load("Test2", false), true);
+	eq(gen_loc_cnt, count + 1);
+	require(gen_loc_find(centre.x_pos, centre.y_pos, 1, &lower, &upper));
+	eq(gen_loc_list[upper].seed, 12345);
+	require(gen_loc_find(new_x, new_y, 1, &lower, &upper));
+	eq(gen_loc_list[upper].seed, 54321);
+	require(gen_loc_find(centre.x_pos + 1, centre.y_pos, 1, &lower, &upper));
+	eq(gen_loc_list[upper].seed, (uint32_t) upper * 2654435761U + 1);
+	notnull(gen_loc_list[upper].join);
+
+	/* More journals build on the same savefile */
+	eq(savefile_save_changes("Test2"), true);
+	eq(file_bytes("Test2"), bytes);
+
+	/* A full save does away with the journal */
+	eq(savefile_save("Test2"), true);
+	eq(file_exists("Test2" SAVEFILE_JOURNAL_SUFFIX), false);
+
+	if (verbose) {
+		printf("\n    %ld byte save %.3fs, %ld byte journal %.3fs  ", bytes,
+			   full, journal_bytes, changes);
+	}
+	ok;
+}
+
+/**
+ * Get the terrain of the chunk staged at a position, if any
+ */
+static bool staged_terrain(int y_pos, int x_pos,
+						   uint8_t feats[CHUNK_SIDE][CHUNK_SIDE]) {
+	struct chunk_ref ref = { 0 };
+	int idx, y, x;
+
+	ref.y_pos = y_pos;
+	ref.x_pos = x_pos;
+	idx = chunk_find(ref);
+	if ((idx == MAX_CHUNKS) || !chunk_is_staged(idx)) return false;
+	for (y = 0; y < CHUNK_SIDE; y++) {
+		for (x = 0; x < CHUNK_SIDE; x++) {
+			feats[y][x] = square(chunk_list[idx].chunk, loc(x, y))->feat;
+		}
+	}
+	return true;
+}
+
+static int test_generated(void *state) {
+	static uint8_t before[CHUNK_SIDE][CHUNK_SIDE], after[CHUNK_SIDE][CHUNK_SIDE];
+	struct chunk_ref centre = chunk_list[player->place];
+	int side = (ARENA_CHUNKS / 2) * CHUNK_SIDE;
+	int y_pos = centre.y_pos - ARENA_CHUNKS / 2;
+	int x_pos = centre.x_pos + ARENA_CHUNKS / 2 + 1;
+	int lower, upper, y, x;
+	uint32_t seed;
+
+	/* Head for the east edge, and make the first location beyond it known,
+	 * as river mapping would, but not yet generated */
+	require(!player->depth);
+	square_set_mon(cave, player->grid, 0);
+	player->grid = loc(side + CHUNK_SIDE - 3, side + CHUNK_SIDE / 2);
+	square_set_mon(cave, player->grid, -1);
+	if (!gen_loc_find(x_pos, y_pos, 0, &lower, &upper)) {
+		gen_loc_make(x_pos, y_pos, 0, upper);
+	}
+	gen_loc_list[upper].seed = 0;
+	eq(savefile_save("Test2"), true);
+	require(gen_loc_find(x_pos, y_pos, 0, &lower, &upper));
+	require(!gen_loc_list[upper].dirty);
+
+	/* Generating it gives it a seed, which the journal keeps */
+	chunk_pregenerate(player);
+	require(staged_terrain(y_pos, x_pos, before));
+	require(gen_loc_find(x_pos, y_pos, 0, &lower, &upper));
+	seed = gen_loc_list[upper].seed;
+	require(seed);
+	require(gen_loc_list[upper].dirty);
+	eq(savefile_save_changes("Test2"), true);
+
+	/* So after loading it comes out the same */
+	reset_before_load();
+	eq(savefile_load("Test2", false), true);
+	require(gen_loc_find(x_pos, y_pos, 0, &lower, &upper));
+	eq(gen_loc_list[upper].seed, seed);
+	chunk_pregenerate(player);
+	require(staged_terrain(y_pos, x_pos, after));
+	for (y = 0; y < CHUNK_SIDE; y++) {
+		for (x = 0; x < CHUNK_SIDE; x++) {
+			eq(after[y][x], before[y][x]);
+		}
+	}
+	eq(savefile_save("Test2"), true);
+	ok;
+}
+
+/**
+ * Check whether two files have the same contents
+ */
+static bool same_bytes(const char *name1, const char *name2) {
+	FILE *f1 = fopen(name1, "rb"), *f2 = fopen(name2, "rb");
+	bool same = f1 && f2;
+	int c1, c2;
+
+	while (same) {
+		c1 = fgetc(f1);
+		c2 = fgetc(f2);
+		if (c1 != c2) same = false;
+		if (c1 == EOF) break;
+	}
+	if (f1) fclose(f1);
+	if (f2) fclose(f2);
+	return same;
+}
+
+static int written;
+
+static void note_written(game_event_type type, game_event_data *data,
+						 void *user) {
+	written = data->flag ? 1 : -1;
+}
+
+static int test_background(void *state) {
+	struct chunk_ref centre = chunk_list[player->place];
+	int lower, upper;
+
+	event_add_handler(EVENT_SAVEFILE_WRITTEN, note_written, NULL);
+
+	/* Writing in the background gives just what writing it now does */
+	eq(savefile_save("Test2"), true);
+	written = 0;
+	eq(savefile_save_background("Test3"), true);
+	eq(savefile_save_wait(), true);
+	eq(written, 1);
+	require(!savefile_save_pending());
+	require(same_bytes("Test2", "Test3"));
+
+	/* Later ones are journals, which load as usual */
+	require(gen_loc_find(centre.x_pos, centre.y_pos, 1, &lower, &upper));
+	gen_loc_list[upper].seed = 23456;
+	gen_loc_list[upper].dirty = true;
+	written = 0;
+	eq(savefile_save_background("Test3"), true);
+	eq(savefile_save_wait(), true);
+	eq(written, 1);
+	require(same_bytes("Test2", "Test3"));
+	eq(file_exists("Test3" SAVEFILE_JOURNAL_SUFFIX), true);
+
+	/* Nothing is left to wait for */
+	written = 0;
+	eq(savefile_save_wait(), true);
+	eq(written, 0);
+	event_remove_handler(EVENT_SAVEFILE_WRITTEN, note_written, NULL);
+
+	reset_before_load();
+	eq(savefile_load("Test3", false), true);
+	require(gen_loc_find(centre.x_pos, centre.y_pos, 1, &lower, &upper));
+	eq(gen_loc_list[upper].seed, 23456);
+	ok;
+}
+
+static int test_staged(void *state) {
+	struct chunk_ref centre = chunk_list[player->place];
+	struct chunk_ref west = centre;
+	int side = (ARENA_CHUNKS / 2) * CHUNK_SIDE;
+	int y_pos = centre.y_pos - ARENA_CHUNKS / 2;
+	int x_pos = centre.x_pos + ARENA_CHUNKS / 2 + 1;
+	struct loc grid;
+	int idx, y, staged = 0;
+
+	/* Stage the chunks beyond the east edge */
+	require(!player->depth);
+	square_set_mon(cave, player->grid, 0);
+	player->grid = loc(side + CHUNK_SIDE - 3, side + CHUNK_SIDE / 2);
+	square_set_mon(cave, player->grid, -1);
+	chunk_pregenerate(player);
+	chunk_pregenerate(player);
+	chunk_pregenerate(player);
+	for (y = 0; y < ARENA_CHUNKS; y++) {
+		struct chunk_ref ref = { 0 };
+		ref.y_pos = y_pos + y;
+		ref.x_pos = x_pos;
+		idx = chunk_find(ref);
+		if ((idx != MAX_CHUNKS) && chunk_is_staged(idx)) staged++;
+	}
+	require(staged);
+
+	/* Save with them, and load; they are left to be generated again */
+	eq(savefile_save("Test2"), true);
+	reset_before_load();
+	eq(savefile_load("Test2", false), true);
+	for (y = 0; y < ARENA_CHUNKS; y++) {
+		struct chunk_ref ref = { 0 };
+		ref.y_pos = y_pos + y;
+		ref.x_pos = x_pos;
+		eq(chunk_find(ref), MAX_CHUNKS);
+	}
+
+	/* The centre is found from the player, even off centre */
+	eq(chunk_get_centre(), player->place);
+	centre = chunk_list[player->place];
+	west.x_pos = centre.x_pos - 1;
+	west.y_pos = centre.y_pos;
+	idx = chunk_find(west);
+	require(idx != MAX_CHUNKS);
+	grid = player->grid;
+	player->grid = loc(side - 1, side + CHUNK_SIDE / 2);
+	player->place = idx;
+	eq(chunk_get_centre(), chunk_find(centre));
+	player->grid = grid;
+	player->place = chunk_find(centre);
+
+	/* And it loads again */
+	eq(savefile_save("Test3"), true);
+	reset_before_load();
+	eq(savefile_load("Test3", false), true);
+	eq(chunk_get_centre(), player->place);
+	ok;
+}
+
+const char *suite_name = "game/save";
+struct test tests[] = {
+	{ "large", test_large },
+	{ "journal", test_journal },
+	{ "generated", test_generated },
+	{ "background", test_background },
+	{ "staged", test_staged },
+	{ NULL, NULL }
+};
@@ -1 +1,4 @@
 TESTPROGS += game/basic
+TESTPROGS += game/flow
+TESTPROGS += game/rest
+TESTPROGS += game/save
@@ -0,0 +1,146 @@
+/* monster/group */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-group.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "player.h"
+#include "player-birth.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	if (!player_make_simple(NULL, NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list();
+	cleanup_angband();
+	return 0;
+}
+
+static struct loc empty_grid(void)
+{
+	struct loc grid;
+
+	do {
+		grid = loc(randint1(cave->width - 2), randint1(cave->height - 2));
+	} while (!square_isempty(cave, grid));
+	return grid;
+}
+
+static int test_destinations(void *state) {
+	struct loc grid;
+	int i, num, count = 0;
+	struct loc *grids = wandering_destinations(cave, &num);
+
+	for (i = 0; i < num; i++) {
+		require(square_in_bounds_fully(cave, grids[i]));
+		require(square_isfloor(cave, grids[i]));
+		require(square_isroom(cave, grids[i]));
+		require(!square_isvault(cave, grids[i]));
+	}
+	for (grid.y = 0; grid.y < cave->height; grid.y++) {
+		for (grid.x = 0; grid.x < cave->width; grid.x++) {
+			if (square_in_bounds_fully(cave, grid) &&
+				square_isfloor(cave, grid) && square_isroom(cave, grid) &&
+				!square_isvault(cave, grid)) {
+				count++;
+			}
+		}
+	}
+	eq(num, count);
+
+	/* The list is kept while the terrain is unchanged */
+	require(wandering_destinations(cave, &count) == grids);
+	eq(count, num);
+	ok;
+}
+
+static int test_destinations_gen(void *state) {
+	struct chunk *c = chunk_new(10, 10);
+	struct point_set *room = get_rectangle_point_set(2, 2, 4, 5);
+	struct loc *grids;
+	int num;
+
+	/* A chunk being generated keeps its list until the room marks change */
+	require(!c->live);
+	fill_rectangle(c, 0, 0, 9, 9, FEAT_FLOOR, SQUARE_NONE);
+	grids = wandering_destinations(c, &num);
+	eq(num, 0);
+	require(wandering_destinations(c, &num) == grids);
+	generate_mark(c, room, SQUARE_ROOM);
+	grids = wandering_destinations(c, &num);
+	eq(num, 12);
+	require(wandering_destinations(c, &num) == grids);
+	eq(num, 12);
+	point_set_dispose(room);
+	chunk_wipe(c);
+	ok;
+}
+
+static int test_shared(void *state) {
+	struct loc centre = empty_grid(), other = empty_grid();
+	struct monster *mon1 = t_add_monster(cave, empty_grid(), "Orc soldier");
+	struct monster *mon2 = t_add_monster(cave, empty_grid(), "Orc soldier");
+	struct monster_group *group1 = monster_group_by_index(
+		mon1->group_info.index);
+	struct monster_group *group2 = monster_group_by_index(
+		mon2->group_info.index);
+	struct flow *flow;
+
+	require(group1 != group2);
+	mon1->alertness = ALERTNESS_UNWARY;
+	mon2->alertness = ALERTNESS_UNWARY;
+
+	/* Choosing a destination doesn't calculate the flow */
+	monster_group_new_wandering_flow(mon1, centre);
+	monster_group_new_wandering_flow(mon2, centre);
+	require(loc_eq(group1->centre, centre));
+	require(!group1->flow);
+	require(!group2->flow);
+
+	/* Using it does, once for both groups */
+	flow = monster_group_flow(group1, mon1);
+	require(flow);
+	require(loc_eq(flow->centre, centre));
+	eq(flow_dist(*flow, centre), 0);
+	require(monster_group_flow(group2, mon2) == flow);
+	require(group1->flow == group2->flow);
+
+	/* A group whose leader no longer moves alike stops sharing */
+	mon2->alertness = ALERTNESS_ALERT;
+	require(monster_group_flow(group2, mon2) != flow);
+	require(monster_group_flow(group1, mon1) == flow);
+	mon2->alertness = ALERTNESS_UNWARY;
+	require(monster_group_flow(group2, mon2) == flow);
+
+	/* A group which moves on stops sharing */
+	monster_group_new_wandering_flow(mon2, other);
+	require(!group2->flow);
+	require(monster_group_flow(group2, mon2) != flow);
+	require(monster_group_flow(group1, mon1) == flow);
+
+	delete_monster_idx(mon1->midx);
+	delete_monster_idx(mon2->midx);
+	ok;
+}
+
+const char *suite_name = "monster/group";
+struct test tests[] = {
+	{ "destinations", test_destinations },
+	{ "destinations-gen", test_destinations_gen },
+	{ "shared", test_shared },
+	{ NULL, NULL }
+};
@@ -0,0 +1,174 @@
+/* monster/place */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "player.h"
+#include "player-birth.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	if (!player_make_simple(NULL, NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+
+	/* The first level's monsters join the arena when it is next realigned */
+	set_monster_place_current();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list();
+	cleanup_angband();
+	return 0;
+}
+
+/* Check the live list against a scan of the whole monster array */
+static bool live_list_ok(void)
+{
+	int i, m_idx = 0;
+
+	for (i = 1; i < mon_max; i++) {
+		struct monster *mon = monster(i);
+		if (!mon->race || (mon->place != CHUNK_CUR)) continue;
+		m_idx = live_monster_after(m_idx);
+		if (m_idx != i) return false;
+	}
+	return live_monster_after(m_idx) == 0;
+}
+
+static bool at_place(int place, int m_idx)
+{
+	int i, num;
+	bool found = false;
+	uint16_t *list = monsters_at_place(place, &num);
+
+	for (i = 0; i < num; i++) {
+		if (list[i] == m_idx) found = true;
+		if (i && (list[i - 1] >= list[i])) found = false;
+	}
+	mem_free(list);
+	return found;
+}
+
+static int test_live(void *state) {
+	int m_idx = live_monster_before(mon_max);
+
+	require(mon_cnt > 0);
+	require(m_idx > 0);
+	require(live_list_ok());
+	eq(live_monster_before(live_monster_after(0)), 0);
+	require(at_place(CHUNK_CUR, m_idx));
+	ok;
+}
+
+static int test_store(void *state) {
+	int m_idx = live_monster_before(mon_max);
+	struct monster *mon = monster(m_idx);
+
+	/* Storing takes the monster out of the arena */
+	monster_set_place(mon, 0);
+	require(!at_place(CHUNK_CUR, m_idx));
+	require(at_place(0, m_idx));
+	require(!monster_handled(mon));
+	require(live_list_ok());
+
+	/* Restoring puts it back */
+	monster_set_place(mon, CHUNK_CUR);
+	require(at_place(CHUNK_CUR, m_idx));
+	require(!at_place(0, m_idx));
+	require(live_list_ok());
+	ok;
+}
+
+static int test_turns(void *state) {
+	int *energy = mem_zalloc(z_info->monster_max * sizeof(*energy));
+	int *hp = mem_zalloc(z_info->monster_max * sizeof(*hp));
+	int i, t, num = 0;
+
+	/* Put everything to sleep, wound it, and remember how much energy it
+	 * has */
+	for (i = live_monster_after(0); i; i = live_monster_after(i)) {
+		struct monster *mon = monster(i);
+		mon->alertness = ALERTNESS_MIN;
+		mon->maxhp = 1000;
+		mon->hp = hp[i] = 10;
+		energy[i] = monster_energy(mon);
+		require(!monster_handled(mon));
+		num++;
+	}
+	require(num > 0);
+
+	/* Run some game turns, following the energy the old way; an early call
+	 * handles every monster with enough energy, even if it can't move */
+	for (t = 0; t < 55; t++) {
+		int minimum = (t % 2) ? z_info->move_energy / 2 : z_info->move_energy;
+
+		process_monsters(minimum);
+		for (i = live_monster_after(0); i; i = live_monster_after(i)) {
+			eq(monster_handled(monster(i)), energy[i] >= minimum);
+		}
+		process_monsters(0);
+		for (i = live_monster_after(0); i; i = live_monster_after(i)) {
+			struct monster *mon = monster(i);
+			bool moving = energy[i] >= z_info->move_energy;
+			int period = z_info->mon_regen_hp_period;
+			require(monster_handled(mon));
+			energy[i] += turn_energy(mon->mspeed);
+			if (moving) energy[i] -= z_info->move_energy;
+			if (turn % 10 == 0) {
+				if (rf_has(mon->race->flags, RF_REGENERATE)) period /= 5;
+				hp[i] += regen_amount(turn / 10, mon->maxhp, period);
+				hp[i] = MIN(hp[i], mon->maxhp);
+			}
+		}
+		turn++;
+		for (i = live_monster_after(0); i; i = live_monster_after(i)) {
+			struct monster *mon = monster(i);
+			require(!monster_handled(mon));
+			eq(monster_energy(mon), energy[i]);
+		}
+	}
+
+	/* Regeneration every ten game turns has been kept track of too */
+	for (i = live_monster_after(0); i; i = live_monster_after(i)) {
+		struct monster *mon = monster(i);
+		monster_energy_sync(mon);
+		eq(mon->hp, hp[i]);
+	}
+	mem_free(energy);
+	mem_free(hp);
+	ok;
+}
+
+static int test_delete(void *state) {
+	int m_idx = live_monster_after(0), count = mon_cnt;
+
+	delete_monster_idx(m_idx);
+	eq(mon_cnt, count - 1);
+	require(!at_place(CHUNK_CUR, m_idx));
+	require(live_list_ok());
+
+	/* Compacting moves monsters but keeps the list in order */
+	compact_monsters(0);
+	require(live_list_ok());
+	ok;
+}
+
+const char *suite_name = "monster/place";
+struct test tests[] = {
+	{ "live", test_live },
+	{ "store", test_store },
+	{ "turns", test_turns },
+	{ "delete", test_delete },
+	{ NULL, NULL }
+};
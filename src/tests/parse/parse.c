@@ -103,6 +103,53 @@ static int test_reg_str(void *state) {
 	ok;
 }
 
+static enum parser_error helper_first(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = 1;
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error helper_second(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = parser_getint(p, "i0");
+	return PARSE_ERROR_NONE;
+}
+
+static int test_reg_supersede(void *state) {
+	int which = 0;
+	errr r = parser_reg(state, "test-supersede", helper_first);
+	eq(r, 0);
+	parser_setpriv(state, &which);
+	r = parser_parse(state, "test-supersede");
+	eq(r, PARSE_ERROR_NONE);
+	eq(which, 1);
+	r = parser_reg(state, "test-supersede int i0", helper_second);
+	eq(r, 0);
+	r = parser_parse(state, "test-supersede:2");
+	eq(r, PARSE_ERROR_NONE);
+	eq(which, 2);
+	ok;
+}
+
+static int test_reg_many(void *state) {
+	char fmt[32], line[32];
+	int i, which = 0;
+
+	parser_setpriv(state, &which);
+	for (i = 0; i < 200; i++) {
+		strnfmt(fmt, sizeof(fmt), "test-many-%d int i0", i);
+		eq(parser_reg(state, fmt, helper_second), 0);
+	}
+	for (i = 0; i < 200; i++) {
+		strnfmt(line, sizeof(line), "test-many-%d:%d", i, i + 1);
+		eq(parser_parse(state, line), PARSE_ERROR_NONE);
+		eq(which, i + 1);
+	}
+	eq(parser_parse(state, "test-many-200:1"),
+		PARSE_ERROR_UNDEFINED_DIRECTIVE);
+	ok;
+}
+
 static enum parser_error helper_sym0(struct parser *p) {
 	const char *s = parser_getsym(p, "foo");
 	int *wasok = parser_priv(p);
@@ -606,5 +653,8 @@ struct test tests[] = {
 
 	{ "baddir", test_baddir },
 
+	{ "reg-supersede", test_reg_supersede },
+	{ "reg-many", test_reg_many },
+
 	{ NULL, NULL }
 };
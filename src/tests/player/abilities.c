@@ -0,0 +1,64 @@
+/* player/abilities */
+
+#include "unit-test.h"
+#include "player.h"
+#include "player-abilities.h"
+
+NOSETUP
+NOTEARDOWN
+
+static int test_index(void *state) {
+	eq(ability_index("Rapid Attack"), PA_RAPID_ATTACK);
+	eq(ability_index("Song of the Trees"), PA_SONG_OF_THE_TREES);
+	eq(ability_index("Lore-Master"), PA_LORE_MASTER);
+	eq(ability_index("No Such Ability"), PA_NONE);
+	eq(ability_index(""), PA_NONE);
+	ok;
+}
+
+static int test_active(void *state) {
+	struct player p;
+	struct ability innate[2], item;
+
+	memset(&p, 0, sizeof(p));
+	memset(innate, 0, sizeof(innate));
+	memset(&item, 0, sizeof(item));
+	innate[0].index = PA_STRENGTH;
+	innate[0].active = true;
+	innate[0].next = &innate[1];
+	innate[1].index = PA_VANISH;
+	innate[1].active = false;
+	item.index = PA_STRENGTH;
+	item.active = true;
+	p.abilities = innate;
+	p.item_abilities = &item;
+
+	player_update_abilities(&p);
+	require(player_active_ability(&p, PA_STRENGTH));
+	require(!player_active_ability(&p, PA_VANISH));
+	require(!player_active_ability(&p, PA_NONE));
+	require(!player_active_ability(NULL, PA_STRENGTH));
+	eq(player_ability_count(&p, PA_STRENGTH), 2);
+	eq(player_ability_count(&p, PA_VANISH), 0);
+
+	/* Switching abilities on and off shows after an update */
+	innate[1].active = true;
+	item.active = false;
+	player_update_abilities(&p);
+	require(player_active_ability(&p, PA_VANISH));
+	require(player_active_ability(&p, PA_STRENGTH));
+	eq(player_ability_count(&p, PA_STRENGTH), 1);
+
+	p.item_abilities = NULL;
+	innate[0].active = false;
+	player_update_abilities(&p);
+	require(!player_active_ability(&p, PA_STRENGTH));
+	ok;
+}
+
+const char *suite_name = "player/abilities";
+struct test tests[] = {
+	{ "index", test_index },
+	{ "active", test_active },
+	{ NULL, NULL }
+};
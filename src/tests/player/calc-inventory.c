@@ -73,6 +73,7 @@ static bool flush_gear(void) {
 		}
 		curr = gear_object_for_use(player, curr, curr->number, false,
 			&none_left);
+		if (curr->known) object_free(curr->known);
 		object_free(curr);
 		curr = next;
 		if (!none_left) {
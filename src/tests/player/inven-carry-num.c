@@ -79,8 +79,11 @@ int setup_tests(void **state) {
 int teardown_tests(void *state) {
 	struct carry_num_state *cns = state;
 
+	object_free(cns->torch->known);
 	object_free(cns->torch);
+	object_free(cns->arrow->known);
 	object_free(cns->arrow);
+	object_free(cns->flask->known);
 	object_free(cns->flask);
 	mem_free(state);
 
@@ -102,6 +105,7 @@ static bool fill_pack(struct carry_num_state *cns, int n_pack,
 
 			curr = gear_object_for_use(cns->p, curr, curr->number,
 				false, &none_left);
+			if (curr->known) object_free(curr->known);
 			object_free(curr);
 			curr = next;
 			if (!none_left) {
@@ -1,4 +1,5 @@
-TESTPROGS += player/birth \
+TESTPROGS += player/abilities \
+             player/birth \
              player/calc-inventory \
              player/combine-pack \
              player/history \
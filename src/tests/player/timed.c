@@ -160,6 +160,7 @@ static void cleanup_event_handlers(struct test_timed_state *st)
 	if (st) {
 		string_free(st->last_tracked_msg);
 		string_free(st->last_recover_msg);
+		object_free(st->weapon->known);
 		object_free(st->weapon);
 		mem_free(st);
 	}
@@ -91,6 +91,7 @@ struct chunk *t_build_arena(int height, int width) {
 		width = z_info->dungeon_wid;
 	struct chunk *c = chunk_new(height, width);
 
+	chunk_set_live(c);
 	for (int y = 0; y < height; y++)
 		for (int x = 0; x < width; x++)
 			square_set_feat(c, loc(x, y), FEAT_FLOOR);
@@ -0,0 +1,129 @@
+/* z-compress/compress.c */
+
+#include "unit-test.h"
+#include "z-compress.h"
+#include "z-rand.h"
+#include "z-virt.h"
+
+#define DATA_SIZE 100000
+
+int setup_tests(void **state) {
+	Rand_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	return 0;
+}
+
+/**
+ * Compress and decompress, checking the bytes come back the same.
+ * \return the compressed size
+ */
+static size_t round_trip(const uint8_t *data, size_t n) {
+	size_t cap = lz_compress_bound(n), len;
+	uint8_t *packed = mem_alloc(cap);
+	uint8_t *unpacked = mem_alloc(n + 1);
+	bool same;
+
+	len = lz_compress(data, n, packed, cap);
+	if (!len || !lz_decompress(packed, len, unpacked, n)) {
+		len = 0;
+	} else {
+		same = !memcmp(data, unpacked, n);
+		if (!same) len = 0;
+	}
+	mem_free(unpacked);
+	mem_free(packed);
+	return len;
+}
+
+/* Small inputs, including ones too short for any match */
+static int test_small(void *state) {
+	uint8_t data[20];
+	size_t n;
+
+	memset(data, 'a', sizeof(data));
+	for (n = 0; n <= sizeof(data); n++) {
+		require(round_trip(data, n) || !n);
+	}
+	ok;
+}
+
+/* Runs and repeats, with matches which overlap what they produce */
+static int test_repetitive(void *state) {
+	uint8_t *data = mem_alloc(DATA_SIZE);
+	size_t i, len;
+
+	memset(data, 0, DATA_SIZE);
+	len = round_trip(data, DATA_SIZE);
+	require(len > 0);
+	require(len < DATA_SIZE / 100);
+
+	for (i = 0; i < DATA_SIZE; i++) {
+		data[i] = (i % 37 < 20) ? (uint8_t) (i % 7) : (uint8_t) randint0(4);
+	}
+	len = round_trip(data, DATA_SIZE);
+	require(len > 0);
+	require(len < DATA_SIZE / 2);
+	mem_free(data);
+	ok;
+}
+
+/* Random bytes don't compress, but stay within the bound */
+static int test_random(void *state) {
+	uint8_t *data = mem_alloc(DATA_SIZE), *packed;
+	size_t i, len;
+
+	for (i = 0; i < DATA_SIZE; i++) {
+		data[i] = (uint8_t) randint0(256);
+	}
+	len = round_trip(data, DATA_SIZE);
+	require(len > 0);
+	require(len <= lz_compress_bound(DATA_SIZE));
+
+	/* Too little room is refused */
+	packed = mem_alloc(DATA_SIZE / 2);
+	eq(lz_compress(data, DATA_SIZE, packed, DATA_SIZE / 2), 0);
+	mem_free(packed);
+	mem_free(data);
+	ok;
+}
+
+/* Broken data is refused, not followed off the end of a buffer */
+static int test_corrupt(void *state) {
+	uint8_t data[1000], out[1000];
+	uint8_t packed[1200], broken[1200];
+	size_t i, len;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t) (i % 10);
+	}
+	len = lz_compress(data, sizeof(data), packed, sizeof(packed));
+	require(len > 0);
+
+	/* Wrong sizes */
+	require(!lz_decompress(packed, len, out, sizeof(out) - 1));
+	require(!lz_decompress(packed, len - 1, out, sizeof(out)));
+
+	/* Padding after the data is fine */
+	memcpy(broken, packed, len);
+	memset(broken + len, 'x', 3);
+	require(lz_decompress(broken, len + 3, out, sizeof(out)));
+
+	/* An offset reaching back before the start */
+	memcpy(broken, packed, len);
+	broken[11] = 0xFF;
+	broken[12] = 0xFF;
+	require(!lz_decompress(broken, len, out, sizeof(out)));
+	ok;
+}
+
+const char *suite_name = "z-compress/compress";
+struct test tests[] = {
+	{ "small", test_small },
+	{ "repetitive", test_repetitive },
+	{ "random", test_random },
+	{ "corrupt", test_corrupt },
+	{ NULL, NULL }
+};
@@ -2,6 +2,11 @@
 
 #include "unit-test.h"
 #include "z-quark.h"
+#include "z-form.h"
+#include <time.h>
+
+#define SCALE_QUARKS 100000
+#define SCALE_BATCHES 5
 
 int setup_tests(void **state) {
 	quarks_init();
@@ -46,9 +51,52 @@ static int test_dedup(void *state) {
 	ok;
 }
 
+/**
+ * Intern many strings, checking each gets its own quark and is found again;
+ * the timings are only reported, as they depend on the machine and its load.
+ * Interning should take about as long for the last strings added as for the
+ * first, where a linear search would make the last batch many times slower.
+ */
+static int test_scale(void *state) {
+	int batch_size = SCALE_QUARKS / SCALE_BATCHES;
+	double times[SCALE_BATCHES];
+	quark_t first = 0;
+	char buf[32];
+	int i, j;
+
+	for (i = 0; i < SCALE_BATCHES; i++) {
+		clock_t start = clock();
+
+		for (j = 0; j < batch_size; j++) {
+			quark_t q;
+
+			strnfmt(buf, sizeof(buf), "2-%d", i * batch_size + j);
+			q = quark_add(buf);
+			if (!first) first = q;
+			eq(q, first + i * batch_size + j);
+		}
+		times[i] = (double) (clock() - start) / CLOCKS_PER_SEC;
+	}
+
+	/* Adding them again finds the same quarks */
+	for (i = 0; i < SCALE_QUARKS; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		eq(quark_add(buf), first + i);
+		require(streq(quark_str(first + i), buf));
+	}
+
+	if (verbose) {
+		printf("\n    %d quarks, first %d in %.4fs, last %d in %.4fs  ",
+			SCALE_QUARKS, batch_size, times[0], batch_size,
+			times[SCALE_BATCHES - 1]);
+	}
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "scale", test_scale },
 	{ NULL, NULL }
 };
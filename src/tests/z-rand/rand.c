@@ -0,0 +1,82 @@
+/* z-rand/rand.c */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+#define RAND_DRAWS 1000
+
+int setup_tests(void **state) {
+	Rand_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	return 0;
+}
+
+/* Two generators seeded alike give the same numbers */
+static int test_same_seed(void *state) {
+	struct rng_ctx a, b;
+	int i;
+
+	rng_state_init(&a, 12345);
+	rng_state_init(&b, 12345);
+	for (i = 0; i < RAND_DRAWS; i++) {
+		eq(rng_div(&a, 1000000), rng_div(&b, 1000000));
+	}
+
+	rng_quick_init(&a, 6789);
+	rng_quick_init(&b, 6789);
+	for (i = 0; i < RAND_DRAWS; i++) {
+		eq(rng_div(&a, 1000000), rng_div(&b, 1000000));
+	}
+	ok;
+}
+
+/* Drawing from the game generator does not disturb another one */
+static int test_independent(void *state) {
+	struct rng_ctx a, b;
+	uint32_t first[RAND_DRAWS];
+	int i;
+
+	rng_quick_init(&a, 424242);
+	b = a;
+	for (i = 0; i < RAND_DRAWS; i++) {
+		first[i] = rng_div(&a, 0x10000000);
+	}
+	for (i = 0; i < RAND_DRAWS; i++) {
+		(void) randint0(100);
+		eq(rng_div(&b, 0x10000000), first[i]);
+	}
+	ok;
+}
+
+/* Binding a generator as current makes the usual calls draw from it */
+static int test_use(void *state) {
+	struct rng_ctx a, b;
+	struct rng_ctx *old;
+	int i;
+
+	rng_state_init(&a, 999);
+	b = a;
+	old = rng_use(&a);
+	ptreq(old, &Rand_game);
+	for (i = 0; i < RAND_DRAWS; i++) {
+		int n = randint0(77);
+		eq(n, rng_int0(&b, 77));
+	}
+	eq(rng_normal(&b, 50, 10), Rand_normal(50, 10));
+	eq(rng_range(&b, -5, 5), rand_range(-5, 5));
+	rng_use_game();
+	ptreq(Rand_ctx, &Rand_game);
+	require(!Rand_game.quick);
+	ok;
+}
+
+const char *suite_name = "z-rand/rand";
+struct test tests[] = {
+	{ "same-seed", test_same_seed },
+	{ "independent", test_independent },
+	{ "use", test_use },
+	{ NULL, NULL }
+};
@@ -25,9 +25,63 @@ static int test_realloc(void *state) {
 	return 0;
 }
 
+struct pool_test {
+	char c;
+	double d;
+	void *p;
+};
+
+static int test_pool(void *state) {
+	static struct mem_pool pool = MEM_POOL_INIT("test", struct pool_test);
+	struct pool_test *blocks[1000];
+	struct mem_pool_stats stats[16];
+	size_t i, n;
+
+	/* Blocks are distinct, zeroed and aligned */
+	for (i = 0; i < N_ELEMENTS(blocks); i++) {
+		blocks[i] = mem_pool_alloc(&pool);
+		require(blocks[i]->c == 0 && blocks[i]->p == NULL);
+		eq((uintptr_t) blocks[i] % sizeof(double), 0);
+		blocks[i]->c = 1;
+		blocks[i]->d = (double) i;
+		if (i) require(blocks[i] != blocks[i - 1]);
+	}
+	for (i = 0; i < N_ELEMENTS(blocks); i++) {
+		require(blocks[i]->d == (double) i);
+	}
+	eq(pool.live, N_ELEMENTS(blocks));
+	eq(pool.peak, N_ELEMENTS(blocks));
+
+	/* Freed blocks are reused, and come back zeroed */
+	mem_pool_free(&pool, blocks[10]);
+	eq(pool.live, N_ELEMENTS(blocks) - 1);
+	ptreq(mem_pool_alloc(&pool), blocks[10]);
+	eq(blocks[10]->c, 0);
+
+	/* The pool shows up in the statistics */
+	n = mem_pool_stats(stats, N_ELEMENTS(stats));
+	require(n >= 1 && n <= N_ELEMENTS(stats));
+	for (i = 0; i < n; i++) {
+		if (streq(stats[i].name, "test")) break;
+	}
+	require(i < n);
+	eq(stats[i].live, N_ELEMENTS(blocks));
+	require(stats[i].bytes >= N_ELEMENTS(blocks) * sizeof(struct pool_test));
+
+	for (i = 0; i < N_ELEMENTS(blocks); i++) {
+		mem_pool_free(&pool, blocks[i]);
+	}
+	eq(pool.live, 0);
+	eq(pool.peak, N_ELEMENTS(blocks));
+	mem_pool_release(&pool);
+	eq(pool.bytes, 0);
+	ok;
+}
+
 const char *suite_name = "z-virt/mem";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "realloc", test_realloc },
+	{ "pool", test_pool },
 	{ NULL, NULL }
 };
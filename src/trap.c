@@ -722,6 +722,7 @@ bool square_remove_trap(struct chunk *c, struct loc grid, int t_idx_remove)
 
 			if (prev_trap) {
 				prev_trap->next = next_trap;
+				c->terrain_stamp++;
 			} else {
 				square_set_trap(c, grid, next_trap);
 			}
@@ -1124,6 +1125,7 @@ void square_set_door_lock(struct chunk *c, struct loc grid, int power)
 			trap->power = power;
 		trap = trap->next;
 	}
+	c->terrain_stamp++;
 }
 
 /**
@@ -1176,6 +1178,7 @@ void square_set_door_jam(struct chunk *c, struct loc grid, int power)
 			trap->power = power;
 		trap = trap->next;
 	}
+	c->terrain_stamp++;
 }
 
 /**
@@ -927,6 +927,7 @@ void tutorial_prepare_section(const char *name, struct player *p)
 	/* Set up the authoritative version of the cave. */
 	cave = chunk_new(section->v.section.rows + 2,
 		section->v.section.columns + 2);
+	chunk_set_live(cave);
 	cave->depth = p->depth;
 	cave->turn = turn;
 	/* Encase in permanent rock. */
@@ -152,7 +152,7 @@ static void ability_display(struct menu *menu, int oid, bool cursor, int row,
 	if (innate) {
 		attr = innate->active ? COLOUR_WHITE : COLOUR_RED;
 		if (innate->skill == SKILL_PERCEPTION
-				&& streq(innate->name, "Bane")
+				&& innate->index == PA_BANE
 				&& player->bane_type > 0) {
 			name_allocated = string_make(format("%s-Bane",
 				bane_types[player->bane_type].name));
@@ -191,14 +191,15 @@ static bool ability_action(struct menu *m, const ui_event *event, int oid)
 				possessed->active = true;
 				put_str("Ability now switched on.", 0, 0);
 			}
+			player_update_abilities(player);
 		} else if (player_has_prereq_abilities(player, choice[oid]) && points) {
 			if (player_can_gain_ability(player, choice[oid])) {
-				if (streq(choice[oid]->name, "Bane")) {
+				if (choice[oid]->index == PA_BANE) {
 					if (!bane_menu()) return false;
 				}
 				if (player_gain_ability(player, choice[oid])) {
 					put_str("Ability gained.", 0, 0);
-				} else if (streq(choice[oid]->name, "Bane")) {
+				} else if (choice[oid]->index == PA_BANE) {
 					/* Rejected the selection so clear. */
 					player->bane_type = 0;
 				}
@@ -282,7 +283,7 @@ static void ability_browser(int oid, void *data, const region *loc)
 			}
 		}
 	} else if (current->skill == SKILL_PERCEPTION
-			&& streq(current->name, "Bane")
+			&& current->index == PA_BANE
 			&& player->bane_type > 0) {
 		/* Or if you have the ability and it is Bane... */
 		Term_gotoxy(text_out_indent, 10);
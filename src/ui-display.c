@@ -274,7 +274,7 @@ static void prt_mel(int row, int col)
 			player->state.mdd, player->state.mds);
 	put_str(format("%12s", buf), row + mod, col);
 
-	if (player_active_ability(player, "Rapid Attack")) {
+	if (player_active_ability(player, PA_RAPID_ATTACK)) {
 		put_str("2x", row + mod, col);
 	}
 
@@ -303,7 +303,7 @@ static void prt_arc(int row, int col)
 				player->state.add, player->state.ads);
 		c_put_str(COLOUR_UMBER, format("%12s", buf), row, col);
 
-		if (player_active_ability(player, "Rapid Fire")) {
+		if (player_active_ability(player, PA_RAPID_FIRE)) {
 			c_put_str(COLOUR_UMBER, "2x", row, col);
 		}
 	}
@@ -2556,7 +2556,7 @@ static void new_level_display_update(game_event_type type,
 
 	/* If autosave is pending, do it now. */
 	if (player->upkeep->autosave) {
-		save_game();
+		autosave_game();
 		player->upkeep->autosave = false;
 	}
 
@@ -2584,6 +2584,15 @@ static void cheat_death(game_event_type type, game_event_data *data, void *user)
 	wiz_cheat_death();
 }
 
+static void savefile_written(game_event_type type, game_event_data *data,
+							 void *user)
+{
+	if (!data->flag) {
+		msg("Autosave failed!");
+		event_signal(EVENT_MESSAGE_FLUSH);
+	}
+}
+
 static void check_panel(game_event_type type, game_event_data *data, void *user)
 {
 	verify_panel();
@@ -2825,6 +2834,7 @@ static void ui_enter_world(game_event_type type, game_event_data *data,
 
 	/* Allow the player to cheat death, if appropriate */
 	event_add_handler(EVENT_CHEAT_DEATH, cheat_death, NULL);
+	event_add_handler(EVENT_SAVEFILE_WRITTEN, savefile_written, NULL);
 
 	/* Record the player's death in glorious technicolour */
 	event_add_handler(EVENT_DEATH, mini_screenshot, NULL);
@@ -2904,6 +2914,7 @@ static void ui_leave_world(game_event_type type, game_event_data *data,
 
 	/* Allow the player to cheat death, if appropriate */
 	event_remove_handler(EVENT_CHEAT_DEATH, cheat_death, NULL);
+	event_remove_handler(EVENT_SAVEFILE_WRITTEN, savefile_written, NULL);
 
 	/* Record the player's death in glorious technicolour */
 	event_remove_handler(EVENT_DEATH, mini_screenshot, NULL);
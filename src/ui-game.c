@@ -296,6 +296,8 @@ struct cmd_info cmd_debug_stats[] =
 	{ "Pits", { 'P' }, CMD_WIZ_COLLECT_PIT_STATS, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 	{ "Disconnected levels", { 'D' }, CMD_WIZ_COLLECT_DISCONNECT_STATS, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 	{ "Obj/mon alternate key", { 'f' }, CMD_WIZ_COLLECT_OBJ_MON_STATS, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
+	{ "Chunk cache", { 'K' }, CMD_WIZ_QUERY_CHUNK_CACHE, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
+	{ "Memory pools", { 'p' }, CMD_WIZ_QUERY_MEMORY_POOLS, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 };
 
 struct cmd_info cmd_debug_query[] =
@@ -950,6 +952,7 @@ void play_game(enum game_mode_type mode)
 		 * until the command queue is empty and a new player command
 		 * is needed */
 		while (!player->is_dead && player->upkeep->playing) {
+			savefile_save_poll();
 			pre_turn_refresh();
 			cmd_get_hook(CTX_GAME);
 			run_game_loop();
@@ -1029,11 +1032,11 @@ void save_game(void)
 }
 
 /**
- * Save the game.
+ * Save the game with the given savefile function.
  *
  * \return whether the save was successful.
  */
-bool save_game_checked(void)
+static bool save_game_aux(bool (*save)(const char *path))
 {
 	char path[1024];
 	bool result;
@@ -1060,12 +1063,16 @@ bool save_game_checked(void)
 	signals_ignore_tstp();
 
 	/* Save the player */
-	if (savefile_save(savefile)) {
-		prt("Saving game... done.", 0, 0);
-		result = true;
-	} else {
+	if (!save(savefile)) {
 		prt("Saving game... failed!", 0, 0);
 		result = false;
+	} else if (savefile_save_pending()) {
+		/* Failure is reported once the file has been written */
+		prt("Saving game... writing in the background.", 0, 0);
+		result = true;
+	} else {
+		prt("Saving game... done.", 0, 0);
+		result = true;
 	}
 
 	/* Refresh */
@@ -1097,6 +1104,26 @@ bool save_game_checked(void)
 	return result;
 }
 
+/**
+ * Save the game.
+ *
+ * \return whether the save was successful.
+ */
+bool save_game_checked(void)
+{
+	return save_game_aux(savefile_save);
+}
+
+/**
+ * Save the game automatically, which only writes out what has changed since
+ * the last full save if it can, and lets the game carry on while the file is
+ * written.
+ */
+void autosave_game(void)
+{
+	(void) save_game_aux(savefile_save_background);
+}
+
 /**
  * Close up the current game (player may or may not be dead).
  *
@@ -1252,6 +1279,11 @@ bool got_savefile(savefile_getter *pg)
 		}
 #endif
 
+		/* Journals go with their savefiles */
+		if (suffix(fname, SAVEFILE_JOURNAL_SUFFIX)) {
+			continue;
+		}
+
 		path_build(path, sizeof(path), ANGBAND_DIR_SAVE, fname);
 		desc = savefile_get_description(path);
 		string_free((*pg)->details.fnam);
@@ -309,7 +309,7 @@ static struct panel *get_panel_combat(void) {
 	mel = player->state.skill_use[SKILL_MELEE];
 	panel_line(p, COLOUR_L_BLUE, "Melee", "(%+d,%dd%d)", mel, player->state.mdd,
 			   player->state.mds);
-	if (player_active_ability(player, "Rapid Attack")) {
+	if (player_active_ability(player, PA_RAPID_ATTACK)) {
 		add_lines--;
 		panel_line(p, COLOUR_L_BLUE, "", "(%+d,%dd%d)", mel, player->state.mdd,
 				   player->state.mds);
@@ -325,7 +325,7 @@ static struct panel *get_panel_combat(void) {
 	arc = player->state.skill_use[SKILL_ARCHERY];
 	panel_line(p, COLOUR_L_BLUE, "Bows", "(%+d,%dd%d)", arc, player->state.add,
 			   player->state.ads);
-	if (player_active_ability(player, "Rapid Fire")) {
+	if (player_active_ability(player, PA_RAPID_FIRE)) {
 		add_lines--;
 		panel_line(p, COLOUR_L_BLUE, "", "(%+d,%dd%d)", arc, player->state.add,
 			   player->state.ads);
@@ -479,11 +479,11 @@ static void tval_display(struct menu *menu, int oid, bool cursor, int row,
 	uint8_t attr = COLOUR_RED;
 
 	if (((smithing_tvals[oid].category == SMITH_TYPE_WEAPON) &&
-		 player_active_ability(player, "Weaponsmith")) ||
+		 player_active_ability(player, PA_WEAPONSMITH)) ||
 		((smithing_tvals[oid].category == SMITH_TYPE_JEWELRY) &&
-		 player_active_ability(player, "Jeweller")) ||
+		 player_active_ability(player, PA_JEWELLER)) ||
 		((smithing_tvals[oid].category == SMITH_TYPE_ARMOUR) &&
-		 player_active_ability(player, "Armoursmith"))) {
+		 player_active_ability(player, PA_ARMOURSMITH))) {
 		attr = COLOUR_WHITE;
 	}
 
@@ -1380,9 +1380,9 @@ static void check_smithing_menu_row_colors(void)
 	/* Recognise which actions are valid, and which need a new ability */
 	for (i = 0; i < N_ELEMENTS(smithing_actions); i++) {
 		if (i == 0) {
-			if (player_active_ability(player, "Weaponsmith") ||
-				player_active_ability(player, "Armoursmith") ||
-				player_active_ability(player, "Jeweller")) {
+			if (player_active_ability(player, PA_WEAPONSMITH) ||
+				player_active_ability(player, PA_ARMOURSMITH) ||
+				player_active_ability(player, PA_JEWELLER)) {
 				smithing_actions[i].flags = 0;
 			} else {
 				smithing_actions[i].flags = MN_ACT_MAYBE;
@@ -1393,7 +1393,7 @@ static void check_smithing_menu_row_colors(void)
 				tval_is_jewelry(smith_obj) || tval_is_horn(smith_obj) ||
 				strstr(smith_obj->kind->name, "Shovel")) {
 				smithing_actions[i].flags = MN_ACT_GRAYED;
-			} else if (player_active_ability(player, "Enchantment")) {
+			} else if (player_active_ability(player, PA_ENCHANTMENT)) {
 				smithing_actions[i].flags = 0;
 			} else {
 				smithing_actions[i].flags = MN_ACT_MAYBE;
@@ -1403,7 +1403,7 @@ static void check_smithing_menu_row_colors(void)
 			if (!smith_obj->kind || smith_obj->ego || tval_is_horn(smith_obj) ||
 				(player->self_made_arts >= z_info->self_arts_max)) {
 				smithing_actions[i].flags = MN_ACT_GRAYED;
-			} else if (player_active_ability(player, "Artifice")) {
+			} else if (player_active_ability(player, PA_ARTIFICE)) {
 				smithing_actions[i].flags = 0;
 			} else {
 				smithing_actions[i].flags = MN_ACT_MAYBE;
@@ -1519,9 +1519,9 @@ struct object *textui_smith_object(struct smithing_cost *cost)
 static struct object_kind **itemlist;
 static int get_crafting_items(void)
 {
-	bool wood = player_active_ability(player, "Woodcraft");
-	bool leather = player_active_ability(player, "Leatherwork");
-	bool boat = player_active_ability(player, "Boat Building") &&
+	bool wood = player_active_ability(player, PA_WOODCRAFT);
+	bool leather = player_active_ability(player, PA_LEATHERWORK);
+	bool boat = player_active_ability(player, PA_BOAT_BUILDING) &&
 		square_iswater(cave, player->grid);
 	int i, count = 0;
 	for (i = 0; i < z_info->k_max; i++) {
@@ -1561,7 +1561,7 @@ static bool craft_action(struct menu *menu, const ui_event *event, int oid)
 	struct object_kind *kind = choice[oid];
 	if (event->type == EVT_SELECT) {
 		/* Make the object by hand */
-		struct object *obj = mem_zalloc(sizeof(*obj));
+		struct object *obj = object_new();
 		object_prep(obj, kind, player_danger_level(player), RANDOMISE);
 
 		/* Drop it near the player */
@@ -516,6 +516,7 @@ void start_tutorial(void)
 				a->v.archetype.added_abilities[i]);
 			assert(anew);
 			anew->active = true;
+			player_update_abilities(player);
 		}
 
 		/* Adjust the pool of unspent experience if necesary. */
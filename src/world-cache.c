@@ -0,0 +1,555 @@
+/**
+ * \file world-cache.c
+ * \brief Binary cache of the world map
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * Parsing region.txt and the river files is most of the work of starting the
+ * game, so what they produce is kept in a file in the user directory and read
+ * straight back in next time.  The file has:
+ * - a header: magic number, version, byte order check, a key made from the
+ *   build version and the sizes of what is read straight into memory, the
+ *   number of source files, and the size and checksum of the data at the end
+ * - the name and hash of each source file; the cache is only used if all of
+ *   these still match
+ * - the square mile biome and region planes, read directly into place
+ * - the regions, then the rivers with their stretches and river miles, with
+ *   the links between them given by their place in the order written
+ */
+
+#include "angband.h"
+#include "buildid.h"
+#include "datafile.h"
+#include "game-world.h"
+#include "init.h"
+#include "world-cache.h"
+
+#define WORLD_CACHE_NAME		"world-map.dat"
+#define WORLD_CACHE_VERSION		2
+#define WORLD_CACHE_ORDER		0x01020304U
+
+static const char world_cache_magic[4] = { 'B', 'W', 'M', 'C' };
+
+/**
+ * Header of the cache file
+ */
+struct world_cache_header {
+	char magic[4];
+	uint32_t version;
+	uint32_t order;
+	uint64_t build;
+	uint32_t num_sources;
+	uint32_t data_size;
+	uint64_t data_check;
+};
+
+/**
+ * Buffer the regions and rivers are written to and read from
+ */
+struct world_cache_buf {
+	uint8_t *data;
+	size_t size;
+	size_t pos;
+};
+
+/**
+ * Hash some bytes, carrying on from a previous hash
+ */
+static uint64_t world_cache_hash(uint64_t hash, const uint8_t *data, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		hash = (hash ^ data[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+#define WORLD_CACHE_HASH_START	14695981039346656037ULL
+
+/**
+ * Hash the build version and the sizes of everything whose layout the cache
+ * depends on, so a cache from a different build is never used
+ */
+static uint64_t world_cache_build(void)
+{
+	uint32_t sizes[] = {
+		MAX_Y_REGION,
+		MAX_X_REGION,
+		sizeof(struct world_region),
+		sizeof(struct river),
+		sizeof(struct river_stretch),
+		sizeof(struct river_mile),
+		sizeof(enum river_part),
+		sizeof(struct loc)
+	};
+	uint64_t hash = WORLD_CACHE_HASH_START;
+
+	hash = world_cache_hash(hash, (const uint8_t *) buildver, strlen(buildver));
+	return world_cache_hash(hash, (const uint8_t *) sizes, sizeof(sizes));
+}
+
+/**
+ * Hash a source file, or give 0 if it can't be read
+ */
+static uint64_t world_cache_hash_source(const char *name)
+{
+	ang_file *f = parse_file_open(name, NULL);
+	uint64_t hash = WORLD_CACHE_HASH_START;
+	char buf[4096];
+	int n;
+
+	if (!f) return 0;
+	while ((n = file_read(f, buf, sizeof(buf))) > 0) {
+		hash = world_cache_hash(hash, (uint8_t *) buf, n);
+	}
+	file_close(f);
+	return (n < 0) ? 0 : hash;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Writing the cache
+ * ------------------------------------------------------------------------ */
+static void put_bytes(struct world_cache_buf *b, const void *data, size_t n)
+{
+	if (b->pos + n > b->size) {
+		while (b->pos + n > b->size) {
+			b->size *= 2;
+		}
+		b->data = mem_realloc(b->data, b->size);
+	}
+	memcpy(b->data + b->pos, data, n);
+	b->pos += n;
+}
+
+static void put_u32(struct world_cache_buf *b, uint32_t v)
+{
+	put_bytes(b, &v, sizeof(v));
+}
+
+static void put_string(struct world_cache_buf *b, const char *str)
+{
+	uint32_t len = str ? strlen(str) + 1 : 0;
+
+	put_u32(b, len);
+	if (len) put_bytes(b, str, len);
+}
+
+/**
+ * Place of a stretch or river mile in the order written, or 0 for none
+ */
+struct world_cache_place {
+	const void *ptr;
+	uint32_t place;
+};
+
+static int cmp_place(const void *a, const void *b)
+{
+	const struct world_cache_place *pa = a, *pb = b;
+
+	if (pa->ptr < pb->ptr) return -1;
+	return (pa->ptr > pb->ptr) ? 1 : 0;
+}
+
+static uint32_t find_place(const struct world_cache_place *places, size_t num,
+						   const void *ptr)
+{
+	struct world_cache_place key, *found;
+
+	if (!ptr) return 0;
+	key.ptr = ptr;
+	found = bsearch(&key, places, num, sizeof(*places), cmp_place);
+	assert(found);
+	return found->place;
+}
+
+/**
+ * Number the stretches and river miles of all the rivers in the order they
+ * are written, starting from 1
+ */
+static struct world_cache_place *number_rivers(size_t *num_stretches,
+											   size_t *num_miles,
+											   struct world_cache_place **miles)
+{
+	struct world_cache_place *stretches = NULL;
+	size_t max_stretches = 0, max_miles = 0;
+	int i;
+
+	*num_stretches = 0;
+	*num_miles = 0;
+	*miles = NULL;
+	for (i = 0; i < z_info->river_max; i++) {
+		struct river_stretch *stretch;
+
+		for (stretch = river_info[i].stretch; stretch; stretch = stretch->next) {
+			struct river_mile *mile;
+
+			if (*num_stretches == max_stretches) {
+				max_stretches = max_stretches ? 2 * max_stretches : 64;
+				stretches = mem_realloc(stretches,
+										max_stretches * sizeof(*stretches));
+			}
+			stretches[*num_stretches].ptr = stretch;
+			stretches[*num_stretches].place = *num_stretches + 1;
+			(*num_stretches)++;
+
+			for (mile = stretch->miles; mile; mile = mile->downstream) {
+				if (*num_miles == max_miles) {
+					max_miles = max_miles ? 2 * max_miles : 256;
+					*miles = mem_realloc(*miles, max_miles * sizeof(**miles));
+				}
+				(*miles)[*num_miles].ptr = mile;
+				(*miles)[*num_miles].place = *num_miles + 1;
+				(*num_miles)++;
+			}
+		}
+	}
+
+	if (*num_stretches) {
+		qsort(stretches, *num_stretches, sizeof(*stretches), cmp_place);
+	}
+	if (*num_miles) {
+		qsort(*miles, *num_miles, sizeof(**miles), cmp_place);
+	}
+	return stretches;
+}
+
+/**
+ * Write the regions and rivers
+ */
+static void put_world(struct world_cache_buf *b)
+{
+	struct world_cache_place *stretches, *miles;
+	size_t num_stretches, num_miles;
+	int i;
+
+	/* Regions, which start at 1 */
+	put_u32(b, z_info->region_max);
+	for (i = 1; i < z_info->region_max; i++) {
+		struct world_region *region = &region_info[i];
+
+		put_string(b, region->name);
+		put_bytes(b, &region->realm, sizeof(region->realm));
+		put_bytes(b, &region->danger, sizeof(region->danger));
+		put_bytes(b, &region->density, sizeof(region->density));
+		put_bytes(b, &region->height, sizeof(region->height));
+		put_bytes(b, &region->width, sizeof(region->width));
+		put_bytes(b, &region->y_offset, sizeof(region->y_offset));
+		put_bytes(b, &region->x_offset, sizeof(region->x_offset));
+	}
+
+	/* Rivers */
+	stretches = number_rivers(&num_stretches, &num_miles, &miles);
+	put_u32(b, z_info->river_max);
+	put_u32(b, num_stretches);
+	put_u32(b, num_miles);
+	for (i = 0; i < z_info->river_max; i++) {
+		struct river *river = &river_info[i];
+		struct river_stretch *stretch;
+		uint32_t count = 0;
+
+		put_string(b, river->name);
+		put_string(b, river->filename);
+		put_string(b, river->join);
+		put_u32(b, river->next ? river->next->index + 1 : 0);
+		for (stretch = river->stretch; stretch; stretch = stretch->next) {
+			count++;
+		}
+		put_u32(b, count);
+
+		for (stretch = river->stretch; stretch; stretch = stretch->next) {
+			struct river_mile *mile;
+
+			put_u32(b, stretch->index);
+			put_u32(b, find_place(stretches, num_stretches, stretch->in1));
+			put_u32(b, find_place(stretches, num_stretches, stretch->in2));
+			put_u32(b, find_place(stretches, num_stretches, stretch->out1));
+			put_u32(b, find_place(stretches, num_stretches, stretch->out2));
+			for (count = 0, mile = stretch->miles; mile;
+				 mile = mile->downstream) {
+				count++;
+			}
+			put_u32(b, count);
+
+			for (mile = stretch->miles; mile; mile = mile->downstream) {
+				uint8_t head = (square_mile_river_miles(mile->sq_mile) == mile);
+
+				put_u32(b, mile->river->index);
+				put_u32(b, mile->part);
+				put_u32(b, find_place(stretches, num_stretches, mile->stretch));
+				put_u32(b, mile->sq_mile.x);
+				put_u32(b, mile->sq_mile.y);
+				put_u32(b, find_place(miles, num_miles, mile->upstream));
+				put_u32(b, find_place(miles, num_miles, mile->next));
+				put_bytes(b, &head, 1);
+			}
+		}
+	}
+
+	mem_free(stretches);
+	mem_free(miles);
+}
+
+/**
+ * Write the cache of the world map, after parsing region.txt and the rivers
+ */
+bool world_cache_save(void)
+{
+	char path[1024];
+	struct world_cache_header header;
+	struct world_cache_buf b;
+	ang_file *f;
+	bool success;
+	int i;
+
+	/* The sources are region.txt, river.txt and each river's own file */
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, world_cache_magic, sizeof(header.magic));
+	header.version = WORLD_CACHE_VERSION;
+	header.order = WORLD_CACHE_ORDER;
+	header.build = world_cache_build();
+	header.num_sources = 2 + z_info->river_max;
+
+	b.size = 4096;
+	b.data = mem_alloc(b.size);
+	b.pos = 0;
+	put_world(&b);
+	header.data_size = b.pos;
+	header.data_check = world_cache_hash(WORLD_CACHE_HASH_START, b.data, b.pos);
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, WORLD_CACHE_NAME);
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!f) {
+		mem_free(b.data);
+		return false;
+	}
+
+	success = file_write(f, (const char *) &header, sizeof(header));
+	for (i = -2; success && i < z_info->river_max; i++) {
+		const char *name = (i == -2) ? "region" :
+			((i == -1) ? "river" : river_info[i].filename);
+		uint64_t hash = world_cache_hash_source(name);
+		uint32_t len = strlen(name) + 1;
+
+		success = hash && file_write(f, (const char *) &len, sizeof(len)) &&
+			file_write(f, name, len) &&
+			file_write(f, (const char *) &hash, sizeof(hash));
+	}
+	success = success && square_miles_write(f) &&
+		file_write(f, (const char *) b.data, b.pos);
+	file_close(f);
+	mem_free(b.data);
+
+	/* Don't leave a broken cache around */
+	if (!success) file_delete(path);
+	return success;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Reading the cache
+ * ------------------------------------------------------------------------ */
+static void get_bytes(struct world_cache_buf *b, void *data, size_t n)
+{
+	assert(b->pos + n <= b->size);
+	memcpy(data, b->data + b->pos, n);
+	b->pos += n;
+}
+
+static uint32_t get_u32(struct world_cache_buf *b)
+{
+	uint32_t v;
+
+	get_bytes(b, &v, sizeof(v));
+	return v;
+}
+
+static char *get_string(struct world_cache_buf *b)
+{
+	uint32_t len = get_u32(b);
+	char *str;
+
+	if (!len) return NULL;
+	assert(b->pos + len <= b->size);
+	str = string_make((const char *) b->data + b->pos);
+	b->pos += len;
+	return str;
+}
+
+/**
+ * Read the regions and rivers, which are known to be as written
+ */
+static void get_world(struct world_cache_buf *b)
+{
+	struct river_stretch **stretches;
+	struct river_mile **miles;
+	uint32_t num_stretches, num_miles, s = 0, m = 0;
+	int i;
+
+	/* Regions */
+	z_info->region_max = get_u32(b);
+	region_info = mem_zalloc(z_info->region_max * sizeof(*region_info));
+	for (i = 1; i < z_info->region_max; i++) {
+		struct world_region *region = &region_info[i];
+
+		region->index = i;
+		region->name = get_string(b);
+		get_bytes(b, &region->realm, sizeof(region->realm));
+		get_bytes(b, &region->danger, sizeof(region->danger));
+		get_bytes(b, &region->density, sizeof(region->density));
+		get_bytes(b, &region->height, sizeof(region->height));
+		get_bytes(b, &region->width, sizeof(region->width));
+		get_bytes(b, &region->y_offset, sizeof(region->y_offset));
+		get_bytes(b, &region->x_offset, sizeof(region->x_offset));
+	}
+
+	/* Rivers; the stretches and miles are all made first so they can be
+	 * linked up as they are read */
+	z_info->river_max = get_u32(b);
+	num_stretches = get_u32(b);
+	num_miles = get_u32(b);
+	river_info = mem_zalloc(z_info->river_max * sizeof(*river_info));
+	stretches = mem_zalloc((num_stretches + 1) * sizeof(*stretches));
+	miles = mem_zalloc((num_miles + 1) * sizeof(*miles));
+	for (s = 1; s <= num_stretches; s++) {
+		stretches[s] = mem_zalloc(sizeof(**stretches));
+	}
+	for (m = 1; m <= num_miles; m++) {
+		miles[m] = mem_zalloc(sizeof(**miles));
+	}
+
+	s = 0;
+	m = 0;
+	for (i = 0; i < z_info->river_max; i++) {
+		struct river *river = &river_info[i];
+		struct river_stretch *last_stretch = NULL;
+		uint32_t next, count;
+
+		river->index = i;
+		river->name = get_string(b);
+		river->filename = get_string(b);
+		river->join = get_string(b);
+		next = get_u32(b);
+		river->next = next ? &river_info[next - 1] : NULL;
+
+		for (count = get_u32(b); count; count--) {
+			struct river_stretch *stretch = stretches[++s];
+			struct river_mile *last_mile = NULL;
+			uint32_t num;
+
+			stretch->river = river;
+			stretch->index = get_u32(b);
+			stretch->in1 = stretches[get_u32(b)];
+			stretch->in2 = stretches[get_u32(b)];
+			stretch->out1 = stretches[get_u32(b)];
+			stretch->out2 = stretches[get_u32(b)];
+			if (last_stretch) {
+				last_stretch->next = stretch;
+			} else {
+				river->stretch = stretch;
+			}
+			last_stretch = stretch;
+
+			for (num = get_u32(b); num; num--) {
+				struct river_mile *mile = miles[++m];
+				uint8_t head;
+
+				mile->river = &river_info[get_u32(b)];
+				mile->part = get_u32(b);
+				mile->stretch = stretches[get_u32(b)];
+				mile->sq_mile.x = get_u32(b);
+				mile->sq_mile.y = get_u32(b);
+				mile->upstream = miles[get_u32(b)];
+				mile->next = miles[get_u32(b)];
+				get_bytes(b, &head, 1);
+				if (head) {
+					square_mile_set_river_miles(mile->sq_mile, mile);
+				}
+				if (last_mile) {
+					last_mile->downstream = mile;
+				} else {
+					stretch->miles = mile;
+				}
+				last_mile = mile;
+			}
+		}
+	}
+	assert((s == num_stretches) && (m == num_miles) && (b->pos == b->size));
+
+	mem_free(stretches);
+	mem_free(miles);
+}
+
+/**
+ * Read the world map from its cache if that is there and up to date.
+ * Returns true if it was, and region.txt and the rivers don't need parsing;
+ * otherwise nothing is set up.
+ */
+bool world_cache_load(void)
+{
+	char path[1024];
+	struct world_cache_header header;
+	struct world_cache_buf b;
+	ang_file *f;
+	bool valid;
+	uint32_t i;
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, WORLD_CACHE_NAME);
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f) return false;
+
+	/* Check it was written by this build, on this sort of machine */
+	valid = (file_read(f, (char *) &header, sizeof(header)) ==
+			 (int) sizeof(header)) &&
+		!memcmp(header.magic, world_cache_magic, sizeof(header.magic)) &&
+		(header.version == WORLD_CACHE_VERSION) &&
+		(header.order == WORLD_CACHE_ORDER) &&
+		(header.build == world_cache_build());
+
+	/* Check the sources haven't changed */
+	for (i = 0; valid && (i < header.num_sources); i++) {
+		char name[1024];
+		uint32_t len;
+		uint64_t hash;
+
+		valid = (file_read(f, (char *) &len, sizeof(len)) == sizeof(len)) &&
+			(len > 0) && (len <= sizeof(name)) &&
+			(file_read(f, name, len) == (int) len) && !name[len - 1] &&
+			(file_read(f, (char *) &hash, sizeof(hash)) == sizeof(hash)) &&
+			(world_cache_hash_source(name) == hash);
+	}
+	if (!valid) {
+		file_close(f);
+		return false;
+	}
+
+	/* Read the square miles into place, and check the rest */
+	square_miles_init();
+	b.size = header.data_size;
+	b.data = mem_alloc(MAX(b.size, 1));
+	b.pos = 0;
+	valid = square_miles_read(f) &&
+		(file_read(f, (char *) b.data, b.size) == (int) b.size) &&
+		(world_cache_hash(WORLD_CACHE_HASH_START, b.data, b.size) ==
+		 header.data_check);
+	file_close(f);
+	if (!valid) {
+		mem_free(b.data);
+		square_miles_cleanup();
+		return false;
+	}
+
+	get_world(&b);
+	mem_free(b.data);
+	return true;
+}
@@ -0,0 +1,23 @@
+/**
+ * \file world-cache.h
+ * \brief Binary cache of the world map
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_WORLD_CACHE_H
+#define INCLUDED_WORLD_CACHE_H
+
+bool world_cache_load(void);
+bool world_cache_save(void);
+
+#endif /* INCLUDED_WORLD_CACHE_H */
@@ -0,0 +1,204 @@
+/**
+ * \file z-compress.c
+ * \brief Small, fast lossless compression of byte buffers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * The compressed data is a series of sequences in the LZ4 block layout.  Each
+ * sequence is a token byte, whose high and low four bits give the number of
+ * literal bytes and the match length less four, then any extra literal length
+ * bytes, the literals, a two byte little-endian offset back to the match, and
+ * any extra match length bytes.  A length nibble of 15 is continued in the
+ * following bytes, each adding up to 255.  The last sequence has only
+ * literals; matches end at least LZ_LAST_LITERALS bytes before the end of the
+ * input and start at least LZ_MATCH_LIMIT bytes before it.
+ */
+
+#include "z-compress.h"
+
+#define LZ_MIN_MATCH		4
+#define LZ_LAST_LITERALS	5
+#define LZ_MATCH_LIMIT		12
+#define LZ_MAX_OFFSET		65535
+#define LZ_HASH_BITS		12
+
+static uint32_t lz_read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, 4);
+	return v;
+}
+
+static uint32_t lz_hash(uint32_t seq)
+{
+	return (seq * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+/**
+ * Write a length continued past its token nibble
+ */
+static size_t lz_put_length(uint8_t *dst, size_t cap, size_t op, size_t len)
+{
+	while (len >= 255) {
+		if (op >= cap) return 0;
+		dst[op++] = 255;
+		len -= 255;
+	}
+	if (op >= cap) return 0;
+	dst[op++] = (uint8_t) len;
+	return op;
+}
+
+/**
+ * Write one sequence; a match length of zero means literals only.
+ * Return the new output position, or 0 if it would not fit.
+ */
+static size_t lz_put_sequence(uint8_t *dst, size_t cap, size_t op,
+							  const uint8_t *literals, size_t num_literals,
+							  size_t offset, size_t match)
+{
+	size_t match_code = match ? match - LZ_MIN_MATCH : 0;
+	uint8_t *token;
+
+	if (op >= cap) return 0;
+	token = &dst[op++];
+	*token = (uint8_t) ((MIN(num_literals, 15) << 4) | MIN(match_code, 15));
+
+	/* Literals */
+	if (num_literals >= 15) {
+		op = lz_put_length(dst, cap, op, num_literals - 15);
+		if (!op) return 0;
+	}
+	if (num_literals > cap - op) return 0;
+	memcpy(dst + op, literals, num_literals);
+	op += num_literals;
+	if (!match) return op;
+
+	/* Match */
+	if (cap - op < 2) return 0;
+	dst[op++] = (uint8_t) (offset & 0xFF);
+	dst[op++] = (uint8_t) (offset >> 8);
+	if (match_code >= 15) {
+		op = lz_put_length(dst, cap, op, match_code - 15);
+	}
+	return op;
+}
+
+size_t lz_compress_bound(size_t n)
+{
+	return n + n / 255 + 16;
+}
+
+size_t lz_compress(const uint8_t *src, size_t n, uint8_t *dst, size_t cap)
+{
+	uint32_t table[1 << LZ_HASH_BITS];
+	size_t ip = 0, anchor = 0, op = 0;
+
+	memset(table, 0, sizeof(table));
+
+	if (n > LZ_MATCH_LIMIT) {
+		size_t start_limit = n - LZ_MATCH_LIMIT;
+		size_t end_limit = n - LZ_LAST_LITERALS;
+
+		while (ip < start_limit) {
+			uint32_t seq = lz_read32(src + ip);
+			uint32_t h = lz_hash(seq);
+			size_t ref = table[h], len = LZ_MIN_MATCH;
+
+			table[h] = (uint32_t) ip;
+			if ((ref >= ip) || (ip - ref > LZ_MAX_OFFSET) ||
+				(lz_read32(src + ref) != seq)) {
+				ip++;
+				continue;
+			}
+
+			/* Extend the match forwards, then backwards over the literals */
+			while ((ip + len < end_limit) && (src[ref + len] == src[ip + len]))
+				len++;
+			while ((ip > anchor) && (ref > 0) && (src[ip - 1] == src[ref - 1])) {
+				ip--;
+				ref--;
+				len++;
+			}
+
+			op = lz_put_sequence(dst, cap, op, src + anchor, ip - anchor,
+								 ip - ref, len);
+			if (!op) return 0;
+			ip += len;
+			anchor = ip;
+
+			/* Remember a position inside the match too */
+			if (ip - 2 < start_limit) {
+				table[lz_hash(lz_read32(src + ip - 2))] = (uint32_t) (ip - 2);
+			}
+		}
+	}
+
+	/* Whatever is left goes out as literals */
+	return lz_put_sequence(dst, cap, op, src + anchor, n - anchor, 0, 0);
+}
+
+/**
+ * Read a length continued past its token nibble
+ */
+static bool lz_get_length(const uint8_t *src, size_t n, size_t *ip,
+						  size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= n) return false;
+		b = src[(*ip)++];
+		*len += b;
+	} while (b == 255);
+	return true;
+}
+
+bool lz_decompress(const uint8_t *src, size_t n, uint8_t *dst, size_t raw)
+{
+	size_t ip = 0, op = 0;
+
+	while (op < raw) {
+		uint8_t token;
+		size_t num_literals, match, offset;
+
+		if (ip >= n) return false;
+		token = src[ip++];
+
+		/* Literals */
+		num_literals = token >> 4;
+		if ((num_literals == 15) && !lz_get_length(src, n, &ip, &num_literals))
+			return false;
+		if ((num_literals > n - ip) || (num_literals > raw - op)) return false;
+		memcpy(dst + op, src + ip, num_literals);
+		ip += num_literals;
+		op += num_literals;
+		if (op == raw) break;
+
+		/* Match, which may overlap the bytes it produces */
+		if (n - ip < 2) return false;
+		offset = src[ip] | ((size_t) src[ip + 1] << 8);
+		ip += 2;
+		if (!offset || (offset > op)) return false;
+		match = token & 15;
+		if ((match == 15) && !lz_get_length(src, n, &ip, &match)) return false;
+		match += LZ_MIN_MATCH;
+		if (match > raw - op) return false;
+		while (match--) {
+			dst[op] = dst[op - offset];
+			op++;
+		}
+	}
+
+	return true;
+}
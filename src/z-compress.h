@@ -0,0 +1,42 @@
+/**
+ * \file z-compress.h
+ * \brief Small, fast lossless compression of byte buffers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_COMPRESS_H
+#define INCLUDED_Z_COMPRESS_H
+
+#include "h-basic.h"
+
+/**
+ * Largest number of bytes lz_compress() can produce from n bytes of input.
+ */
+size_t lz_compress_bound(size_t n);
+
+/**
+ * Compress n bytes from src into dst, which has room for cap bytes.
+ *
+ * Return the compressed size, or 0 if it would not fit.
+ */
+size_t lz_compress(const uint8_t *src, size_t n, uint8_t *dst, size_t cap);
+
+/**
+ * Decompress src, which is at most n bytes long, into the raw bytes of dst.
+ *
+ * Decompression stops when dst is full, so src may be followed by padding.
+ * Return false if src is not a valid compression of exactly raw bytes.
+ */
+bool lz_decompress(const uint8_t *src, size_t n, uint8_t *dst, size_t raw);
+
+#endif /* INCLUDED_Z_COMPRESS_H */
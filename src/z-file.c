@@ -984,6 +984,26 @@ ang_file *file_open(const char *fname, file_mode mode, file_type ftype)
 }
 
 
+/**
+ * Make sure everything written to file handle 'f' is on disk.
+ */
+bool file_sync(ang_file *f)
+{
+	if (fflush(f->fh) != 0)
+		return false;
+
+#if defined(WINDOWS) && !defined(CYGWIN)
+	if (_commit(_fileno(f->fh)) != 0)
+		return false;
+#elif defined(UNIX)
+	if (fsync(fileno(f->fh)) != 0)
+		return false;
+#endif
+
+	return true;
+}
+
+
 /**
  * Close file handle 'f'.
  */
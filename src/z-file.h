@@ -183,6 +183,15 @@ ang_file *file_open(const char *buf, file_mode mode, file_type ftype);
 extern void (*file_open_hook)(const char *path, file_type ftype);
 
 
+/**
+ * Flush anything written to the file handle `f` and make sure it reaches the
+ * disk.
+ *
+ * Returns true if successful, false otherwise.
+ */
+bool file_sync(ang_file *f);
+
+
 /**
  * Attempt to close the file handle `f`.
  *
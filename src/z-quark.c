@@ -26,16 +26,44 @@ static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/**
+ * Open hash table of quarks by string; zero marks an empty slot
+ */
+static quark_t *quark_index;
+static size_t index_size = 0;
+
 #define QUARKS_INIT	16
 
-quark_t quark_add(const char *str)
+static uint32_t quark_hash(const char *str)
 {
-	quark_t q;
+	uint32_t h = 2166136261U;
 
-	for (q = 1; q < nr_quarks; q++) {
-		if (streq(quarks[q], str))
-			return q;
+	while (*str) {
+		h ^= (unsigned char) *str++;
+		h *= 16777619U;
 	}
+	return h;
+}
+
+/**
+ * Find the index slot for a string; it holds either the quark for that
+ * string or zero.
+ */
+static quark_t *quark_slot(const char *str)
+{
+	size_t i = quark_hash(str) & (index_size - 1);
+
+	while (quark_index[i] && !streq(quarks[quark_index[i]], str))
+		i = (i + 1) & (index_size - 1);
+	return &quark_index[i];
+}
+
+quark_t quark_add(const char *str)
+{
+	quark_t *slot = quark_slot(str);
+	quark_t q = *slot;
+
+	if (q) return q;
 
 	if (nr_quarks == alloc_quarks) {
 		alloc_quarks *= 2;
@@ -44,6 +72,18 @@ quark_t quark_add(const char *str)
 
 	q = nr_quarks++;
 	quarks[q] = string_make(str);
+	*slot = q;
+
+	/* Keep the index at most half full */
+	if (nr_quarks * 2 > index_size) {
+		quark_t i;
+
+		mem_free(quark_index);
+		index_size *= 2;
+		quark_index = mem_zalloc(index_size * sizeof(quark_t));
+		for (i = 1; i < nr_quarks; i++)
+			*quark_slot(quarks[i]) = i;
+	}
 
 	return q;
 }
@@ -58,6 +98,8 @@ void quarks_init(void)
 	nr_quarks = 1;
 	alloc_quarks = QUARKS_INIT;
 	quarks = mem_zalloc(alloc_quarks * sizeof(char*));
+	index_size = QUARKS_INIT * 2;
+	quark_index = mem_zalloc(index_size * sizeof(quark_t));
 }
 
 void quarks_free(void)
@@ -69,6 +111,7 @@ void quarks_free(void)
 		string_free(quarks[i]);
 
 	mem_free(quarks);
+	mem_free(quark_index);
 }
 
 struct init_module z_quark_module = {
@@ -32,10 +32,15 @@
  * algorithm, used with permission. See below for copyright information
  * about the WELL implementation.
  *
- * To use of the "simple" RNG, activate it via "Rand_quick = true" and
- * "Rand_value = seed". After that it will be automatically used instead of
- * the "complex" RNG. When you are done, you can de-activate it via
- * "Rand_quick = false". You can also choose a new seed.
+ * Each generator's state is kept in a struct rng_ctx, and the rng_*()
+ * functions take the one to use.  Rand_div() and everything built on it,
+ * including randint0() and friends, use Rand_ctx, which is normally the
+ * game's own generator Rand_game.
+ *
+ * To use the "simple" RNG for reproducible results, set up a generator with
+ * rng_quick_init(ctx, seed) and either pass it to the rng_*() functions, or
+ * make it the one in use with rng_use(ctx).  When you are done, go back to
+ * the game's generator with rng_use() or rng_use_game().
  */
 
 /* begin WELL RNG
@@ -53,29 +58,23 @@
 #define MAT0NEG(t, v) (v ^ (v << (-(t))))
 #define Identity(v) (v)
 
-uint32_t state_i = 0;
-uint32_t STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0};
-
-#define V0    STATE[state_i]
-#define VM1   STATE[(state_i + M1) & 0x0000001fU]
-#define VM2   STATE[(state_i + M2) & 0x0000001fU]
-#define VM3   STATE[(state_i + M3) & 0x0000001fU]
-#define VRm1  STATE[(state_i + 31) & 0x0000001fU]
-#define newV0 STATE[(state_i + 31) & 0x0000001fU]
-#define newV1 STATE[state_i]
-
-static uint32_t WELLRNG1024a (void){
+#define V0    ctx->state[ctx->state_i]
+#define VM1   ctx->state[(ctx->state_i + M1) & 0x0000001fU]
+#define VM2   ctx->state[(ctx->state_i + M2) & 0x0000001fU]
+#define VM3   ctx->state[(ctx->state_i + M3) & 0x0000001fU]
+#define VRm1  ctx->state[(ctx->state_i + 31) & 0x0000001fU]
+#define newV0 ctx->state[(ctx->state_i + 31) & 0x0000001fU]
+#define newV1 ctx->state[ctx->state_i]
+
+static uint32_t WELLRNG1024a (struct rng_ctx *ctx){
 	uint32_t z0 = VRm1;
 	uint32_t z1 = Identity(V0) ^ MAT0POS (8, VM1);
 	uint32_t z2 = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
 
 	newV1   = z1 ^ z2; 
 	newV0   = MAT0NEG (-11,z0) ^ MAT0NEG(-7,z1) ^ MAT0NEG(-13,z2);
-	state_i = (state_i + 31) & 0x0000001fU;
-	return STATE[state_i];
+	ctx->state_i = (ctx->state_i + 31) & 0x0000001fU;
+	return ctx->state[ctx->state_i];
 }
 /* end WELL RNG */
 
@@ -86,52 +85,100 @@ static uint32_t WELLRNG1024a (void){
 
 
 /**
- * Whether to use the simple RNG or not.
+ * The game's generator, which uses the simple RNG until initialised
  */
-bool Rand_quick = true;
+struct rng_ctx Rand_game = { true, 0, 0, { 0 } };
 
 /**
- * The current "seed" of the simple RNG.
+ * The generator in use
  */
-uint32_t Rand_value;
+struct rng_ctx *Rand_ctx = &Rand_game;
 
 static bool rand_fixed = false;
 static uint32_t rand_fixval = 0;
 
 /**
- * Initialize the complex RNG using a new seed.
+ * Seed the complex RNG of a generator, carrying on from its current index.
  */
-void Rand_state_init(uint32_t seed)
+static void rng_seed_state(struct rng_ctx *ctx, uint32_t seed)
 {
 	int i, j;
 
 	/* Seed the table */
-	STATE[0] = seed;
+	ctx->state[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		ctx->state[i] = LCRNG(ctx->state[i - 1]);
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (ctx->state_i + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		ctx->state[j] += ctx->state[ctx->state_i];
 
 		/* Advance the index */
-		state_i = j;
+		ctx->state_i = j;
 	}
 }
 
+/**
+ * Set a generator to use the complex RNG, initialised from a seed.
+ */
+void rng_state_init(struct rng_ctx *ctx, uint32_t seed)
+{
+	ctx->quick = false;
+	ctx->value = 0;
+	ctx->state_i = 0;
+	rng_seed_state(ctx, seed);
+}
+
+/**
+ * Initialize the game's complex RNG using a new seed.
+ */
+void Rand_state_init(uint32_t seed)
+{
+	rng_seed_state(&Rand_game, seed);
+}
+
+/**
+ * Set a generator to use the simple RNG, starting from a seed.
+ */
+void rng_quick_init(struct rng_ctx *ctx, uint32_t seed)
+{
+	ctx->quick = true;
+	ctx->value = seed;
+}
+
+/**
+ * Make a generator the one used by Rand_div(), and so by randint0() and the
+ * rest, and return the one used before so it can be put back.
+ */
+struct rng_ctx *rng_use(struct rng_ctx *ctx)
+{
+	struct rng_ctx *old = Rand_ctx;
+	Rand_ctx = ctx;
+	return old;
+}
+
+/**
+ * Go back to the game's generator, using its complex RNG.
+ */
+void rng_use_game(void)
+{
+	Rand_game.quick = false;
+	Rand_ctx = &Rand_game;
+}
+
 /**
  * Initialise the RNG
  */
 void Rand_init(void)
 {
 	/* Init RNG */
-	if (Rand_quick) {
+	if (Rand_game.quick) {
 		uint32_t seed;
 
 		/* Basic seed */
@@ -146,7 +193,7 @@ void Rand_init(void)
 #endif
 
 		/* Use the complex RNG */
-		Rand_quick = false;
+		Rand_game.quick = false;
 
 		/* Seed the "complex" RNG */
 		Rand_state_init(seed);
@@ -165,7 +212,7 @@ void Rand_init(void)
  * This method has no bias, and is much less affected by patterns in the "low"
  * bits of the underlying RNG's. However, it is potentially non-terminating.
  */
-uint32_t Rand_div(uint32_t m)
+uint32_t rng_div(struct rng_ctx *ctx, uint32_t m)
 {
 	uint32_t n, r = 0;
 
@@ -181,12 +228,12 @@ uint32_t Rand_div(uint32_t m)
 	/* Partition size */
 	n = (0x10000000 / m);
 
-	if (Rand_quick) {
+	if (ctx->quick) {
 		/* Use a simple RNG */
 		/* Wait for it */
 		while (1) {
 			/* Cycle the generator */
-			r = (Rand_value = LCRNG(Rand_value));
+			r = (ctx->value = LCRNG(ctx->value));
 
 			/* Mutate a 28-bit "random" number */
 			r = ((r >> 4) & 0x0FFFFFFF) / n;
@@ -198,7 +245,7 @@ uint32_t Rand_div(uint32_t m)
 		/* Use a complex RNG */
 		while (1) {
 			/* Get the next pseudorandom number */
-			r = WELLRNG1024a();
+			r = WELLRNG1024a(ctx);
 
 			/* Mutate a 28-bit "random" number */
 			r = ((r >> 4) & 0x0FFFFFFF) / n;
@@ -212,6 +259,14 @@ uint32_t Rand_div(uint32_t m)
 	return (r);
 }
 
+/**
+ * Extract a "random" number from 0 to m - 1 from the generator in use.
+ */
+uint32_t Rand_div(uint32_t m)
+{
+	return rng_div(Rand_ctx, m);
+}
+
 
 /**
  * The number of entries in the "Rand_normal_table"
@@ -284,7 +339,7 @@ static int16_t Rand_normal_table[RANDNOR_NUM] = {
  *
  * Note that the binary search takes up to 16 quick iterations.
  */
-int16_t Rand_normal(int mean, int stand)
+int16_t rng_normal(struct rng_ctx *ctx, int mean, int stand)
 {
 	int16_t tmp, offset;
 
@@ -295,7 +350,7 @@ int16_t Rand_normal(int mean, int stand)
 	if (stand < 1) return (mean);
 
 	/* Roll for probability */
-	tmp = (int16_t)randint0(32768);
+	tmp = (int16_t)rng_int0(ctx, 32768);
 
 	/* Binary Search */
 	while (low < high) {
@@ -313,12 +368,21 @@ int16_t Rand_normal(int mean, int stand)
 	offset = (int16_t)((long)stand * (long)low / RANDNOR_STD);
 
 	/* One half should be negative */
-	if (one_in_(2)) return (mean - offset);
+	if (rng_one_in(ctx, 2)) return (mean - offset);
 
 	/* One half should be positive */
 	return (mean + offset);
 }
 
+/**
+ * Generate a random integer number of NORMAL distribution from the generator
+ * in use.
+ */
+int16_t Rand_normal(int mean, int stand)
+{
+	return rng_normal(Rand_ctx, mean, stand);
+}
+
 
 /**
  * Choose an integer from a distribution where we know the mean and approximate
@@ -332,9 +396,10 @@ int16_t Rand_normal(int mean, int stand)
  * The function chooses an integer from a normal distribution, and then scales
  * it to fit the target distribution.
  */
-int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
+int rng_sample(struct rng_ctx *ctx, int mean, int upper, int lower,
+			   int stand_u, int stand_l)
 {
-	int pick = Rand_normal(0, 1000);
+	int pick = rng_normal(ctx, 0, 1000);
 
 	/* Scale to fit */
 	if (pick > 0) {
@@ -351,9 +416,17 @@ int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
 }
 
 /**
- * Generates damage for "2d6" style dice rolls
+ * Choose an integer as above from the generator in use.
  */
-int damroll(int num, int sides)
+int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l)
+{
+	return rng_sample(Rand_ctx, mean, upper, lower, stand_u, stand_l);
+}
+
+/**
+ * Generates damage for "2d6" style dice rolls, using the given generator
+ */
+int rng_damroll(struct rng_ctx *ctx, int num, int sides)
 {
 	int i;
 	int sum = 0;
@@ -361,21 +434,29 @@ int damroll(int num, int sides)
 	if (sides <= 0) return 0;
 
 	for (i = 0; i < num; i++)
-		sum += randint1(sides);
+		sum += rng_int1(ctx, sides);
 	return sum;
 }
 
+/**
+ * Generates damage for "2d6" style dice rolls from the generator in use
+ */
+int damroll(int num, int sides)
+{
+	return rng_damroll(Rand_ctx, num, sides);
+}
 
 
 /**
- * Calculation helper function for damroll
+ * Calculation helper function for rng_damroll
  */
-int damcalc(int num, int sides, aspect dam_aspect)
+static int rng_damcalc(struct rng_ctx *ctx, int num, int sides,
+					   aspect dam_aspect)
 {
 	switch (dam_aspect) {
 		case MAXIMISE:
 		case EXTREMIFY: return num * sides;
-		case RANDOMISE: return damroll(num, sides);
+		case RANDOMISE: return rng_damroll(ctx, num, sides);
 		case MINIMISE: return num;
 		case AVERAGE: return num * (sides + 1) / 2;
 	}
@@ -384,6 +465,14 @@ int damcalc(int num, int sides, aspect dam_aspect)
 	return 0;
 }
 
+/**
+ * Calculation helper function for damroll
+ */
+int damcalc(int num, int sides, aspect dam_aspect)
+{
+	return rng_damcalc(Rand_ctx, num, sides, dam_aspect);
+}
+
 
 /**
  * Generates a random signed long integer X where `A` <= X <= `B`.
@@ -391,12 +480,21 @@ int damcalc(int num, int sides, aspect dam_aspect)
  *
  * Note that "rand_range(0, N-1)" == "randint0(N)".
  */
-int rand_range(int A, int B)
+int rng_range(struct rng_ctx *ctx, int A, int B)
 {
 	if (A == B) return A;
 	assert(A < B);
 
-	return A + (int32_t)Rand_div(1 + B - A);
+	return A + (int32_t)rng_div(ctx, 1 + B - A);
+}
+
+/**
+ * Generates a random signed long integer X where `A` <= X <= `B` from the
+ * generator in use.
+ */
+int rand_range(int A, int B)
+{
+	return rng_range(Rand_ctx, A, B);
 }
 
 
@@ -411,15 +509,16 @@ int16_t m_bonus(int divisor, int level)
 
 
 /**
- * Calculation helper function for m_bonus
+ * Calculation helper function for m_bonus, using the given generator
  */
-int16_t m_bonus_calc(int divisor, int level, aspect bonus_aspect)
+static int16_t rng_m_bonus_calc(struct rng_ctx *ctx, int divisor, int level,
+								aspect bonus_aspect)
 {
 	if (!divisor) return 0;
 	switch (bonus_aspect) {
 		case EXTREMIFY:
 		case MAXIMISE:  return (level + 10) / divisor;
-		case RANDOMISE: return m_bonus(divisor, level);
+		case RANDOMISE: return (level + rng_int1(ctx, 10)) / divisor;
 		case MINIMISE:  return 0;
 		case AVERAGE:   return (2 * level + 11) / (2 * divisor);
 	}
@@ -428,24 +527,42 @@ int16_t m_bonus_calc(int divisor, int level, aspect bonus_aspect)
 	return 0;
 }
 
+/**
+ * Calculation helper function for m_bonus
+ */
+int16_t m_bonus_calc(int divisor, int level, aspect bonus_aspect)
+{
+	return rng_m_bonus_calc(Rand_ctx, divisor, level, bonus_aspect);
+}
+
 
 /**
- * Calculation helper function for random_value structs
+ * Calculation helper function for random_value structs, using the given
+ * generator
  */
-int randcalc(random_value v, int level, aspect rand_aspect)
+int rng_randcalc(struct rng_ctx *ctx, random_value v, int level,
+				 aspect rand_aspect)
 {
 	if (rand_aspect == EXTREMIFY) {
-		int min = randcalc(v, level, MINIMISE);
-		int max = randcalc(v, level, MAXIMISE);
+		int min = rng_randcalc(ctx, v, level, MINIMISE);
+		int max = rng_randcalc(ctx, v, level, MAXIMISE);
 		return abs(min) > abs(max) ? min : max;
 
 	} else {
-		int dmg   = damcalc(v.dice, v.sides, rand_aspect);
-		int bonus = m_bonus_calc(v.m_bonus, level, rand_aspect);
+		int dmg   = rng_damcalc(ctx, v.dice, v.sides, rand_aspect);
+		int bonus = rng_m_bonus_calc(ctx, v.m_bonus, level, rand_aspect);
 		return v.base + dmg + bonus;
 	}
 }
 
+/**
+ * Calculation helper function for random_value structs
+ */
+int randcalc(random_value v, int level, aspect rand_aspect)
+{
+	return rng_randcalc(Rand_ctx, v, level, rand_aspect);
+}
+
 
 /**
  * Test to see if a value is within a random_value's range
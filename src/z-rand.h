@@ -69,6 +69,17 @@ typedef enum {
 } aspect;
 
 
+/**
+ * The state of one random number generator.  Each runs independently of the
+ * others, so several can be in use at once.
+ */
+struct rng_ctx {
+	bool quick;					/**< Use the simple RNG, not the complex */
+	uint32_t value;				/**< The state of the simple RNG */
+	uint32_t state_i;			/**< The state of the complex RNG */
+	uint32_t state[RAND_DEG];
+};
+
 /**
  * Generates a random signed long integer X where "0 <= X < M" holds.
  *
@@ -103,24 +114,61 @@ typedef enum {
 #define percent_chance(X) (randint0(100) < X)
 
 /**
- * Whether we are currently using the "quick" method or not.
+ * The same, using a given generator
+ */
+#define rng_int0(R, M) ((int32_t) rng_div(R, M))
+#define rng_int1(R, M) ((int32_t) rng_div(R, M) + 1)
+#define rng_one_in(R, x) (!rng_int0(R, x))
+
+/**
+ * The game's own generator, which is saved with the game.
+ */
+extern struct rng_ctx Rand_game;
+
+/**
+ * The generator used by Rand_div() and everything built on it.  This is the
+ * game's own, except while something wants reproducible results.
  */
-extern bool Rand_quick;
+extern struct rng_ctx *Rand_ctx;
+
 
 /**
- * The state used by the "quick" RNG.
+ * Set a generator to use the complex RNG, initialised from the given seed.
  */
-extern uint32_t Rand_value;
+void rng_state_init(struct rng_ctx *ctx, uint32_t seed);
 
 /**
- * The state used by the "complex" RNG.
+ * Set a generator to use the simple RNG from the given seed.
  */
-extern uint32_t state_i;
-extern uint32_t STATE[RAND_DEG];
+void rng_quick_init(struct rng_ctx *ctx, uint32_t seed);
 
+/**
+ * Make a generator the one used by Rand_div() and the rest, returning the
+ * one used before.
+ */
+struct rng_ctx *rng_use(struct rng_ctx *ctx);
 
 /**
- * Initialise the RNG state with the given seed.
+ * Go back to using the complex RNG of the game's own generator.
+ */
+void rng_use_game(void);
+
+/**
+ * Generates a random unsigned long integer X where "0 <= X < M" holds, using
+ * the given generator.
+ */
+uint32_t rng_div(struct rng_ctx *ctx, uint32_t m);
+
+/**
+ * Rand_normal(), Rand_sample() and rand_range(), using the given generator.
+ */
+int16_t rng_normal(struct rng_ctx *ctx, int mean, int stand);
+int rng_sample(struct rng_ctx *ctx, int mean, int upper, int lower,
+			   int stand_u, int stand_l);
+int rng_range(struct rng_ctx *ctx, int A, int B);
+
+/**
+ * Initialise the game's RNG state with the given seed.
  */
 void Rand_state_init(uint32_t seed);
 
@@ -157,6 +205,12 @@ int Rand_sample(int mean, int upper, int lower, int stand_u, int stand_l);
  */
 uint32_t Rand_simple(uint32_t m);
 
+/**
+ * Emulate a number `num` of dice rolls of dice with `sides` sides, using the
+ * given generator.
+ */
+int rng_damroll(struct rng_ctx *ctx, int num, int sides);
+
 /**
  * Emulate a number `num` of dice rolls of dice with `sides` sides.
  */
@@ -186,6 +240,13 @@ int16_t m_bonus(int max, int level);
  */
 int16_t m_bonus_calc(int max, int level, aspect bonus_aspect);
 
+/**
+ * Calculation helper function for random_value structs, using the given
+ * generator.
+ */
+int rng_randcalc(struct rng_ctx *ctx, random_value v, int level,
+				 aspect rand_aspect);
+
 /**
  * Calculation helper function for random_value structs.
  */
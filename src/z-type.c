@@ -19,6 +19,7 @@
 #include "z-rand.h"
 #include "z-type.h"
 #include "z-virt.h"
+#include "init.h"
 
 struct loc loc(int x, int y) {
 	struct loc p;
@@ -72,12 +73,15 @@ struct loc loc_offset(struct loc grid, int dx, int dy)
 	return loc(grid.x + dx, grid.y + dy);
 }
 
+static struct mem_pool point_set_pool =
+	MEM_POOL_INIT("point sets", struct point_set);
+
 /**
  * Utility functions to work with point_sets
  */
 struct point_set *point_set_new(int initial_size)
 {
-	struct point_set *ps = mem_alloc(sizeof(struct point_set));
+	struct point_set *ps = mem_pool_alloc(&point_set_pool);
 	ps->n = 0;
 	ps->allocated = initial_size;
 	ps->pts = mem_zalloc(sizeof(*(ps->pts)) * ps->allocated);
@@ -87,9 +91,20 @@ struct point_set *point_set_new(int initial_size)
 void point_set_dispose(struct point_set *ps)
 {
 	mem_free(ps->pts);
-	mem_free(ps);
+	mem_pool_free(&point_set_pool, ps);
 }
 
+static void point_sets_free(void)
+{
+	mem_pool_release(&point_set_pool);
+}
+
+struct init_module z_type_module = {
+	.name = "z-type",
+	.init = NULL,
+	.cleanup = point_sets_free
+};
+
 /**
  * Add the point to the given point set, making more space if there is
  * no more space left.
@@ -131,11 +146,11 @@ int point_set_contains(struct point_set *ps, struct loc grid)
 	return 0;
 }
 
-struct loc point_set_random(struct point_set *ps)
+struct loc point_set_random(struct rng_ctx *rng, struct point_set *ps)
 {
 	int i;
 	for (i = 0; i < ps->n; i++)
-		if (one_in_(ps->n - i))
+		if (rng_one_in(rng, ps->n - i))
 			return ps->pts[i];
 	return ps->pts[ps->n - 1];
 }
@@ -21,6 +21,8 @@
 
 #include "h-basic.h"
 
+struct rng_ctx;
+
 struct loc {
 	int x;
 	int y;
@@ -59,7 +61,7 @@ void add_to_point_set(struct point_set *ps, struct loc grid);
 void point_set_union(struct point_set *ps1, struct point_set *ps2);
 int point_set_size(struct point_set *ps);
 int point_set_contains(struct point_set *ps, struct loc grid);
-struct loc point_set_random(struct point_set *ps);
+struct loc point_set_random(struct rng_ctx *rng, struct point_set *ps);
 struct point_set *point_set_subtract(struct point_set *big,
 									 struct point_set *small);
 
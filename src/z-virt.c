@@ -67,6 +67,123 @@ void *mem_realloc(void *p, size_t len)
 	return p;
 }
 
+/**
+ * Blocks are rounded up to this size so that any structure is aligned
+ */
+#define MEM_POOL_ALIGN sizeof(union { void *p; long l; double d; int64_t i; })
+
+/**
+ * Aim for slabs of about this many bytes, with at least a few blocks each
+ */
+#define MEM_POOL_SLAB_BYTES 16384
+#define MEM_POOL_SLAB_MIN 8
+
+/**
+ * All pools which have been used, for statistics
+ */
+static struct mem_pool *pools;
+
+static size_t mem_pool_block_size(const struct mem_pool *pool)
+{
+	size_t size = MAX(pool->size, sizeof(void *));
+	return (size + MEM_POOL_ALIGN - 1) / MEM_POOL_ALIGN * MEM_POOL_ALIGN;
+}
+
+/**
+ * Add a slab to a pool and put its blocks on the free list.  The first block
+ * of each slab links the pool's slabs together.
+ */
+static void mem_pool_grow(struct mem_pool *pool)
+{
+	size_t block = mem_pool_block_size(pool);
+	size_t num = MAX(MEM_POOL_SLAB_BYTES / block, MEM_POOL_SLAB_MIN);
+	char *slab = mem_alloc(num * block);
+	size_t i;
+
+	*(void **) slab = pool->slabs;
+	pool->slabs = slab;
+	pool->bytes += num * block;
+
+	for (i = num - 1; i > 0; i--) {
+		void *p = slab + i * block;
+		*(void **) p = pool->free_list;
+		pool->free_list = p;
+	}
+}
+
+/**
+ * Allocate a zeroed block from a pool.
+ */
+void *mem_pool_alloc(struct mem_pool *pool)
+{
+	void *p;
+
+	if (!pool->registered) {
+		pool->next = pools;
+		pools = pool;
+		pool->registered = true;
+	}
+
+	if (!pool->free_list)
+		mem_pool_grow(pool);
+	p = pool->free_list;
+	pool->free_list = *(void **) p;
+	memset(p, 0, pool->size);
+
+	pool->live++;
+	if (pool->live > pool->peak)
+		pool->peak = pool->live;
+	return p;
+}
+
+/**
+ * Return a block to its pool.  Like mem_free(), NULL is ignored.
+ */
+void mem_pool_free(struct mem_pool *pool, void *p)
+{
+	if (!p) return;
+	assert(pool->live);
+	*(void **) p = pool->free_list;
+	pool->free_list = p;
+	pool->live--;
+}
+
+/**
+ * Give all of a pool's slabs back; no block from the pool may be in use.
+ */
+void mem_pool_release(struct mem_pool *pool)
+{
+	assert(!pool->live);
+	while (pool->slabs) {
+		void *slab = pool->slabs;
+		pool->slabs = *(void **) slab;
+		mem_free(slab);
+	}
+	pool->free_list = NULL;
+	pool->bytes = 0;
+}
+
+/**
+ * Fill in statistics for up to max pools; return the number of pools in use.
+ */
+size_t mem_pool_stats(struct mem_pool_stats *stats, size_t max)
+{
+	struct mem_pool *pool;
+	size_t n = 0;
+
+	for (pool = pools; pool; pool = pool->next) {
+		if (n < max) {
+			stats[n].name = pool->name;
+			stats[n].size = pool->size;
+			stats[n].live = pool->live;
+			stats[n].peak = pool->peak;
+			stats[n].bytes = pool->bytes;
+		}
+		n++;
+	}
+	return n;
+}
+
 /**
  * Duplicates an existing string `str`, allocating as much memory as necessary.
  */
@@ -42,6 +42,43 @@ bool mem_is_alt_alloc(void *p);
 #define mem_is_alt_alloc(p) (false)
 #endif
 
+/**
+ * Pools of fixed-size blocks, for structures which are allocated and freed
+ * often.  Blocks are carved from slabs and freed blocks are kept on a list
+ * for reuse; slabs are only given back by mem_pool_release().  Pools are
+ * declared statically with MEM_POOL_INIT and register themselves on first
+ * use.  They are not thread-safe, so only use them from the main thread.
+ */
+struct mem_pool {
+	const char *name;
+	size_t size;
+	void *free_list;
+	void *slabs;
+	size_t live;
+	size_t peak;
+	size_t bytes;
+	struct mem_pool *next;
+	bool registered;
+};
+
+#define MEM_POOL_INIT(name, type) { name, sizeof(type), NULL, NULL, 0, 0, 0, NULL, false }
+
+/**
+ * Statistics for one pool
+ */
+struct mem_pool_stats {
+	const char *name;
+	size_t size;	/**< Size of each block */
+	size_t live;	/**< Blocks in use */
+	size_t peak;	/**< Most blocks ever in use at once */
+	size_t bytes;	/**< Memory held in slabs */
+};
+
+void *mem_pool_alloc(struct mem_pool *pool);
+void mem_pool_free(struct mem_pool *pool, void *p);
+void mem_pool_release(struct mem_pool *pool);
+size_t mem_pool_stats(struct mem_pool_stats *stats, size_t max);
+
 char *string_make(const char *str);
 void string_free(char *str);
 char *string_append(char *s1, const char *s2);